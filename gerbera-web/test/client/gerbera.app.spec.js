@@ -106,6 +106,7 @@ describe('Gerbera UI App', () => {
       spyOn(GERBERA.Trail, 'initialize');
       spyOn(GERBERA.Autoscan, 'initialize');
       spyOn(GERBERA.Updates, 'initialize');
+      spyOn(GERBERA.Updates, 'watch');
       spyOn(GERBERA.Auth, 'isLoggedIn').and.returnValue(true);
 
       await GERBERA.App.initialize();
@@ -114,6 +115,7 @@ describe('Gerbera UI App', () => {
       expect(GERBERA.Trail.initialize).toHaveBeenCalled();
       expect(GERBERA.Autoscan.initialize).toHaveBeenCalled();
       expect(GERBERA.Updates.initialize).toHaveBeenCalled();
+      expect(GERBERA.Updates.watch).toHaveBeenCalled();
     });
   });
 
@@ -87,6 +87,7 @@ describe('Gerbera Auth', () => {
       spyOn(GERBERA.Trail, 'initialize');
       spyOn(GERBERA.Autoscan, 'initialize');
       spyOn(GERBERA.Updates, 'initialize');
+      spyOn(GERBERA.Updates, 'watch');
 
       await GERBERA.Auth.authenticate();
       expect(GERBERA.Auth.isLoggedIn()).toBeTruthy();
@@ -97,6 +98,7 @@ describe('Gerbera Auth', () => {
       expect(GERBERA.Trail.initialize).toHaveBeenCalled();
       expect(GERBERA.Autoscan.initialize).toHaveBeenCalled();
       expect(GERBERA.Updates.initialize).toHaveBeenCalled();
+      expect(GERBERA.Updates.watch).toHaveBeenCalled();
     });
   });
 
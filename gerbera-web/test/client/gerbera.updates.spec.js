@@ -35,10 +35,6 @@ describe('Gerbera Updates', function () {
       spyOn(GERBERA.Auth, 'isLoggedIn').and.returnValue(true);
       spyOn(GERBERA.App, 'getType').and.returnValue('db');
 
-      spyOn(GERBERA.Updates, 'updateTask').and.callFake(() => {
-        return $.Deferred().resolve({}).promise();
-      });
-
       await GERBERA.Updates.getUpdates();
 
       expect(ajaxSpy.calls.mostRecent().args[0]['url']).toEqual('content/interface');
@@ -53,9 +49,6 @@ describe('Gerbera Updates', function () {
       spyOn(GERBERA.Auth, 'getSessionId').and.returnValue('SESSION_ID');
       spyOn(GERBERA.Auth, 'isLoggedIn').and.returnValue(true);
       spyOn(GERBERA.App, 'getType').and.returnValue('db');
-      spyOn(GERBERA.Updates, 'updateTask').and.callFake(() => {
-        return $.Deferred().resolve({}).promise();
-      });
 
       const force = true;
       GERBERA.Updates.getUpdates(force);
@@ -68,25 +61,9 @@ describe('Gerbera Updates', function () {
       });
     });
 
-    it('updates the current task when response from server', async () => {
-      spyOn(GERBERA.Auth, 'getSessionId').and.returnValue('SESSION_ID');
-      spyOn(GERBERA.Auth, 'isLoggedIn').and.returnValue(true);
-
-      spyOn(GERBERA.Updates, 'updateTask').and.callFake(() => {
-        return $.Deferred().resolve({}).promise();
-      });
-
-      await GERBERA.Updates.getUpdates();
-
-      expect(GERBERA.Updates.updateTask).toHaveBeenCalled();
-    });
-
     it('updates the timer to call back to the server', async () => {
       spyOn(GERBERA.Auth, 'getSessionId').and.returnValue('SESSION_ID');
       spyOn(GERBERA.Auth, 'isLoggedIn').and.returnValue(true);
-      spyOn(GERBERA.Updates, 'updateTask').and.callFake(() => {
-        return $.Deferred().resolve({}).promise();
-      });
       spyOn(GERBERA.Updates, 'updateUi').and.callFake(() => {
         return $.Deferred().resolve({}).promise();
       });
@@ -104,7 +81,6 @@ describe('Gerbera Updates', function () {
 
       spyOn(GERBERA.Auth, 'getSessionId').and.returnValue('SESSION_ID');
       spyOn(GERBERA.Auth, 'isLoggedIn').and.returnValue(true);
-      spyOn(GERBERA.Updates, 'updateTask');
       spyOn(GERBERA.Updates, 'updateUi');
       spyOn(GERBERA.Updates, 'clearAll').and.callFake(() => {
         return $.Deferred().resolve({}).promise();
@@ -113,67 +89,74 @@ describe('Gerbera Updates', function () {
       try {
         await GERBERA.Updates.getUpdates();
       } catch (err) {
-        expect(GERBERA.Updates.updateTask).not.toHaveBeenCalled();
         expect(GERBERA.Updates.updateUi).not.toHaveBeenCalled();
         expect(GERBERA.Updates.clearAll).toHaveBeenCalled();
       }
     });
   });
 
-  describe('updateTask()', () => {
-    let response;
+  describe('watch()', () => {
+    let ajaxSpy, response;
 
-    beforeEach(function () {
-      loadJSONFixtures('updates-no-taskId.json');
+    beforeEach(() => {
       loadJSONFixtures('updates-with-task.json');
-      loadJSONFixtures('updates-with-no-task.json');
-    });
-
-    it('clears the polling interval when task ID is negative', async () => {
-      response = getJSONFixture('updates-no-taskId.json');
-      spyOn(GERBERA.Updates, 'clearTaskInterval').and.returnValue($.Deferred().resolve(response).promise());
-
-      const promisedResponse = await GERBERA.Updates.updateTask(response);
-
-      expect(GERBERA.Updates.clearTaskInterval).toHaveBeenCalled();
-      expect(promisedResponse).toEqual(response);
-    });
-
-    it('updates the task information if task exists', async () => {
       response = getJSONFixture('updates-with-task.json');
-      spyOn(GERBERA.Updates, 'addTaskInterval');
-
-      const promisedResponse = await GERBERA.Updates.updateTask(response);
-
-      expect($('#grb-toast-msg').text()).toEqual('Performing full scan: /Movies');
-      expect(promisedResponse).toEqual(response);
+      ajaxSpy = spyOn($, 'ajax').and.callFake(() => {
+        return $.Deferred().resolve(response).promise();
+      });
+      spyOn(GERBERA.Auth, 'getSessionId').and.returnValue('SESSION_ID');
+      spyOn(GERBERA.App, 'getType').and.returnValue('db');
     });
 
-    it('creates a polling interval when tasks still exist', async () => {
-      response = getJSONFixture('updates-with-task.json');
-      spyOn(GERBERA.Updates, 'addTaskInterval');
+    it('does not call the server when not logged in', async () => {
+      spyOn(GERBERA.Auth, 'isLoggedIn').and.returnValue(false);
 
-      const promisedResponse = await GERBERA.Updates.updateTask(response);
+      await GERBERA.Updates.watch();
 
-      expect(GERBERA.Updates.addTaskInterval).toHaveBeenCalled();
-      expect(promisedResponse).toEqual(response);
+      expect(ajaxSpy).not.toHaveBeenCalled();
     });
 
-    it('passes the response onto the next method', async () => {
-      response = getJSONFixture('updates-with-task.json');
-      spyOn(GERBERA.Updates, 'addTaskInterval');
+    it('waits for events and shows the current task', async () => {
+      spyOn(GERBERA.Auth, 'isLoggedIn').and.returnValue(true);
+      spyOn(GERBERA.Updates, 'updateTreeByIds');
+      const watchSpy = spyOn(GERBERA.Updates, 'watch').and.callThrough();
+      ajaxSpy.and.callFake(() => {
+        // the next request is only counted
+        watchSpy.and.stub();
+        return $.Deferred().resolve(response).promise();
+      });
 
-      const promisedResponse = await GERBERA.Updates.updateTask(response);
+      await GERBERA.Updates.watch();
 
-      expect(promisedResponse).toEqual(response);
+      expect(ajaxSpy.calls.mostRecent().args[0]['data']).toEqual({
+        req_type: 'events',
+        sid: 'SESSION_ID',
+        timeout: 25
+      });
+      expect($('#grb-toast-msg').text()).toEqual('Performing full scan: /Movies');
+      expect(GERBERA.Updates.updateTreeByIds).toHaveBeenCalledWith(response);
+      expect(watchSpy.calls.count()).toBe(2);
     });
 
-    it('passes the response onto the next method when no task exists', async () => {
-      response = getJSONFixture('updates-with-no-task.json');
+    it('asks again later when the server tells it to', async () => {
+      spyOn(GERBERA.Auth, 'isLoggedIn').and.returnValue(true);
+      spyOn(GERBERA.Updates, 'updateTreeByIds');
+      const watchSpy = spyOn(GERBERA.Updates, 'watch').and.callThrough();
+      response = $.extend({retry: 2}, response);
+      ajaxSpy.and.callFake(() => {
+        watchSpy.and.stub();
+        return $.Deferred().resolve(response).promise();
+      });
+      jasmine.clock().install();
 
-      const promisedResponse = await GERBERA.Updates.updateTask(response);
+      GERBERA.Updates.watch();
+      expect(watchSpy.calls.count()).toBe(1);
+      jasmine.clock().tick(1999);
+      expect(watchSpy.calls.count()).toBe(1);
+      jasmine.clock().tick(1);
+      expect(watchSpy.calls.count()).toBe(2);
 
-      expect(promisedResponse).toEqual(response);
+      jasmine.clock().uninstall();
     });
   });
 
@@ -330,36 +313,6 @@ describe('Gerbera Updates', function () {
     });
   });
 
-  describe('addTaskInterval()', () => {
-    let updateSpy;
-    beforeAll(function () {
-      updateSpy = spyOn(GERBERA.Updates, 'getUpdates');
-    });
-
-    beforeEach(() => {
-      updateSpy.calls.reset();
-      GERBERA.Updates.clearAll();
-    });
-
-    it('sets a recurring interval based on the poll-interval configuration', (done) => {
-      GERBERA.App.serverConfig = {};
-      GERBERA.App.serverConfig['poll-interval'] = 100;
-      const startTime = new Date().getTime();
-      let totalCount = 0;
-      updateSpy.and.callFake(() => {
-        totalCount++;
-        let currentTime = new Date().getTime();
-        if (totalCount >= 2) {
-          expect((currentTime - startTime) >= 195).toBeTruthy('Interval should accumulate time from start but was ' + (currentTime - startTime));
-          expect((currentTime - startTime) <= 210).toBeTruthy('Interval should accumulate time from start but was ' + (currentTime - startTime));
-          done();
-        }
-      });
-
-      GERBERA.Updates.addTaskInterval();
-    });
-  });
-
   describe('updateTreeByIds()', () => {
     let response;
 
@@ -30,6 +30,7 @@
 /// \file action_request.cc
 
 #include "action_request.h"
+#include "tools.h"
 
 using namespace zmm;
 using namespace mxml;
@@ -39,7 +40,8 @@ ActionRequest::ActionRequest(UpnpActionRequest *upnp_request) : Object(),
     errCode(UPNP_E_SUCCESS),
     actionName(UpnpActionRequest_get_ActionName_cstr(upnp_request)),
     UDN(UpnpActionRequest_get_DevUDN_cstr(upnp_request)),
-    serviceID(UpnpActionRequest_get_ServiceID_cstr(upnp_request))
+    serviceID(UpnpActionRequest_get_ServiceID_cstr(upnp_request)),
+    client(sockAddrToIP(UpnpActionRequest_get_CtrlPtIPAddr(upnp_request)))
 {
     DOMString cxml = ixmlPrintDocument(UpnpActionRequest_get_ActionRequest(upnp_request));
     String xml = cxml;
@@ -62,6 +64,10 @@ String ActionRequest::getServiceID()
 {
     return serviceID;
 }
+std::string ActionRequest::getClient()
+{
+    return client;
+}
 Ref<Element> ActionRequest::getRequest()
 {
     return request;
@@ -33,6 +33,7 @@
 #ifndef __ACTION_REQUEST_H__
 #define __ACTION_REQUEST_H__
 
+#include <string>
 #include <upnp.h>
 
 #include "common.h"
@@ -68,6 +69,11 @@ protected:
     /// Returned by getServiceID()
     zmm::String serviceID;
 
+    /// \brief IP address of the control point that sent the request.
+    ///
+    /// Returned by getClient()
+    std::string client;
+
     /// \brief XML holding the request that comes to us.
     ///
     /// Returned by getRequest()
@@ -92,6 +98,9 @@ public:
     /// \brief Returns the ID of the service (the action is for this service id)
     zmm::String getServiceID();
 
+    /// \brief Returns the IP address of the control point that sent the request.
+    std::string getClient();
+
     /// \brief Returns the XML representation of the request.
     zmm::Ref<mxml::Element> getRequest();
 
@@ -52,9 +52,8 @@ ATrailersService::ATrailersService()
 {
     url = Ref<URL>(new URL());
     pid = 0;
-    curl_handle = curl_easy_init();
-    if (!curl_handle)
-        throw _Exception(_("failed to initialize curl!\n"));
+    client = HTTPClient::getInstance();
+    curl_handle = client->getHandle();
 
     if (ConfigManager::getInstance()->getOption(CFG_ONLINE_CONTENT_ATRAILERS_RESOLUTION) == "640")
         service_url = _(ATRAILERS_SERVICE_URL_640);
@@ -64,8 +63,7 @@ ATrailersService::ATrailersService()
 
 ATrailersService::~ATrailersService()
 {
-    if (curl_handle)
-        curl_easy_cleanup(curl_handle);
+    client->returnHandle(curl_handle);
 }
 
 service_type_t ATrailersService::getServiceType()
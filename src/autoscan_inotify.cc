@@ -34,7 +34,9 @@
 #include <cassert>
 
 #include "autoscan_inotify.h"
+#include "config_manager.h"
 #include "content_manager.h"
+#include "directory_walker.h"
 
 #include <dirent.h>
 #include <sys/stat.h>
@@ -57,7 +59,6 @@ AutoscanInotify::AutoscanInotify()
         }
     }
 
-    watches = make_shared<unordered_map<int, Ref<Wd>>>();
     shutdownFlag = true;
     monitorQueue = Ref<ObjectQueue<AutoscanDirectory>>(new ObjectQueue<AutoscanDirectory>(AUTOSCAN_INOTIFY_INITIAL_QUEUE_SIZE));
     unmonitorQueue = Ref<ObjectQueue<AutoscanDirectory>>(new ObjectQueue<AutoscanDirectory>(AUTOSCAN_INOTIFY_INITIAL_QUEUE_SIZE));
@@ -70,12 +71,13 @@ AutoscanInotify::~AutoscanInotify()
     if (!shutdownFlag) {
         log_debug("start\n");
         shutdownFlag = true;
-        inotify->stop();
+        wakeUp();
         lock.unlock();
         thread_.join();
         log_debug("inotify thread died.\n");
         inotify = nullptr;
-        watches->clear();
+        fanotify = nullptr;
+        watches.clear();
     }
 }
 
@@ -84,8 +86,15 @@ void AutoscanInotify::run()
     AutoLock lock(mutex);
     if (shutdownFlag) {
         shutdownFlag = false;
-        inotify = Ref<Inotify>(new Inotify());
-        thread_ = thread{ &AutoscanInotify::threadProc, this };
+        Ref<ConfigManager> config = ConfigManager::getInstance();
+        aggregator.setWindow(config->getIntOption(CFG_IMPORT_AUTOSCAN_INOTIFY_DEBOUNCE));
+        if (config->getBoolOption(CFG_IMPORT_AUTOSCAN_USE_FANOTIFY)) {
+            fanotify = Ref<Fanotify>(new Fanotify());
+            thread_ = thread{ &AutoscanInotify::fanotifyThreadProc, this };
+        } else {
+            inotify = Ref<Inotify>(new Inotify());
+            thread_ = thread{ &AutoscanInotify::threadProc, this };
+        }
     }
 }
 
@@ -153,8 +162,8 @@ void AutoscanInotify::threadProc()
 
             lock.unlock();
 
-            /* --- get event --- (blocking) */
-            event = inotify->nextEvent();
+            /* --- get event --- (blocking until the next file event is due) */
+            event = inotify->nextEvent(aggregator.getTimeout());
             /* --- */
 
             if (event) {
@@ -165,14 +174,14 @@ void AutoscanInotify::threadProc()
 
                 Ref<Wd> wdObj = nullptr;
                 try {
-                    wdObj = watches->at(wd);
+                    wdObj = watches.at(wd);
                 } catch (const out_of_range& ex) {
                     inotify->removeWatch(wd);
                     continue;
                 }
 
                 std::ostringstream pathBuf;
-                pathBuf << wdObj->getPath();
+                pathBuf << getPath(wdObj);
                 if (!(mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT)))
                     pathBuf << name;
                 String path(pathBuf.str());
@@ -216,8 +225,19 @@ void AutoscanInotify::threadProc()
                     else
                         fullPath = path;
 
-                    if (!(mask & (IN_MOVED_TO | IN_CREATE))) {
+                    if (!(mask & (IN_ISDIR | IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT))) {
+                        // files settle in the aggregator, see processDueEvents()
+                        InotifyAction action;
+                        if (mask & (IN_MOVED_TO | IN_CREATE))
+                            action = InotifyAction::Add;
+                        else if (mask & IN_CLOSE_WRITE)
+                            action = InotifyAction::Update;
+                        else
+                            action = InotifyAction::Remove;
+                        aggregator.record(fullPath.c_str(), action, mask & IN_CREATE, RefCast(adir, Object));
+                    } else if (!(mask & (IN_MOVED_TO | IN_CREATE))) {
                         log_debug("deleting %s\n", fullPath.c_str());
+                        aggregator.discardBelow(fullPath.c_str());
 
                         if (mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT)) {
                             if (IN_MOVE_SELF)
@@ -235,21 +255,21 @@ void AutoscanInotify::threadProc()
                         if (objectID != INVALID_OBJECT_ID)
                             cm->removeObject(objectID);
                     }
-                    if (mask & (IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE)) {
+                    if ((mask & IN_ISDIR) && (mask & (IN_MOVED_TO | IN_CREATE))) {
                         log_debug("adding %s\n", path.c_str());
                         // path, recursive, async, hidden, low priority, cancellable
                         cm->addFile(fullPath, adir->getLocation(), adir->getRecursive(), true, adir->getHidden(), true, false);
-
-                        if (mask & IN_ISDIR)
-                            monitorUnmonitorRecursive(path, false, adir, watchAs->getNormalizedAutoscanPath(), false);
+                        monitorUnmonitorRecursive(path, false, adir, watchAs->getNormalizedAutoscanPath(), false);
                     }
                 }
                 if (mask & IN_IGNORED) {
                     removeWatchMoves(wd);
                     removeDescendants(wd);
-                    watches->erase(wd);
+                    removeWd(wd);
                 }
             }
+
+            processDueEvents(cm, st);
         } catch (const Exception& e) {
             log_error("Inotify thread caught exception: %s\n", e.getMessage().c_str());
             e.printStackTrace();
@@ -257,13 +277,216 @@ void AutoscanInotify::threadProc()
     }
 }
 
+void AutoscanInotify::fanotifyThreadProc()
+{
+    Ref<ContentManager> cm;
+    Ref<Storage> st;
+
+    try {
+        cm = ContentManager::getInstance();
+        st = Storage::getInstance();
+    } catch (const Exception& e) {
+        log_error("Fanotify thread caught: %s\n", e.getMessage().c_str());
+        e.printStackTrace();
+        shutdownFlag = true;
+    }
+    while (!shutdownFlag) {
+        try {
+            Ref<AutoscanDirectory> adir;
+
+            unique_lock<std::mutex> lock(mutex);
+            while ((adir = unmonitorQueue->dequeue()) != nullptr) {
+                log_debug("removing fanotify autoscan: %s\n", adir->getLocation().c_str());
+                for (auto it = fanotifyDirectories.begin(); it != fanotifyDirectories.end(); ++it) {
+                    if (it->second->getLocation() == adir->getLocation()) {
+                        fanotifyDirectories.erase(it);
+                        break;
+                    }
+                }
+            }
+
+            while ((adir = monitorQueue->dequeue()) != nullptr) {
+                lock.unlock();
+
+                String location = normalizePathNoEx(adir->getLocation());
+                if (string_ok(location)) {
+                    // a persistent autoscan may not exist yet, its filesystem
+                    // is the one of the closest existing parent
+                    String existing = location;
+                    while (existing.length() > 1 && !check_path(existing, true)) {
+                        int slash = existing.rindex(DIR_SEPARATOR);
+                        existing = (slash > 0) ? existing.substring(0, slash) : String(_("/"));
+                    }
+                    try {
+                        fanotify->markFilesystem(existing);
+                    } catch (const Exception& e) {
+                        log_error("%s\n", e.getMessage().c_str());
+                    }
+                    log_debug("adding fanotify autoscan: %s\n", location.c_str());
+                    fanotifyDirectories.emplace_back(location.c_str(), adir);
+                    cm->rescanDirectory(adir->getObjectID(), adir->getScanID(), adir->getScanMode(), nullptr, false);
+                }
+
+                lock.lock();
+            }
+
+            lock.unlock();
+
+            FanotifyEvent event;
+            if (fanotify->nextEvent(event, aggregator.getTimeout()))
+                handleFanotifyEvent(cm, st, event);
+
+            processDueEvents(cm, st);
+        } catch (const Exception& e) {
+            log_error("Fanotify thread caught exception: %s\n", e.getMessage().c_str());
+            e.printStackTrace();
+        }
+    }
+}
+
+void AutoscanInotify::handleFanotifyEvent(Ref<ContentManager> cm, Ref<Storage> st, const FanotifyEvent& event)
+{
+    if (event.mask & FAN_Q_OVERFLOW) {
+        log_warning("Fanotify queue overflowed, rescanning all inotify autoscan directories\n");
+        for (auto& dir : fanotifyDirectories) {
+            Ref<AutoscanDirectory> adir = dir.second;
+            cm->rescanDirectory(adir->getObjectID(), adir->getScanID(), adir->getScanMode(), nullptr, false);
+        }
+        return;
+    }
+
+    bool isDirectory = event.mask & FAN_ONDIR;
+    bool added = event.mask & (FAN_CREATE | FAN_MOVED_TO | FAN_CLOSE_WRITE);
+    bool removed = event.mask & (FAN_DELETE | FAN_MOVED_FROM);
+    // the kernel merges events on the same name, whatever is there now wins
+    bool replaced = false;
+    if (added && removed) {
+        if (check_path(String(event.path.c_str()), isDirectory)) {
+            removed = false;
+            replaced = true;
+        } else {
+            added = false;
+        }
+    }
+    log_debug("fanotify event: %llx %s\n", (unsigned long long)event.mask, event.path.c_str());
+
+    if (isDirectory) {
+        for (auto& dir : fanotifyDirectories) {
+            Ref<AutoscanDirectory> adir = dir.second;
+            if (dir.first != event.path || !adir->persistent())
+                continue;
+            if (removed || replaced)
+                cm->handlePeristentAutoscanRemove(adir->getScanID(), ScanMode::INotify);
+            if (added)
+                cm->handlePersistentAutoscanRecreate(adir->getScanID(), ScanMode::INotify);
+        }
+    }
+
+    Ref<AutoscanDirectory> adir = getFanotifyAutoscan(event.path, isDirectory);
+    if (adir == nullptr)
+        return;
+
+    if (!isDirectory) {
+        InotifyAction action;
+        if (removed)
+            action = InotifyAction::Remove;
+        else if (!replaced && (event.mask & (FAN_CREATE | FAN_MOVED_TO)))
+            action = InotifyAction::Add;
+        else
+            action = InotifyAction::Update;
+        aggregator.record(event.path, action, (event.mask & FAN_CREATE) && !removed && !replaced, RefCast(adir, Object));
+        return;
+    }
+
+    String fullPath = String(event.path.c_str()) + DIR_SEPARATOR;
+    if (removed || replaced) {
+        log_debug("deleting %s\n", fullPath.c_str());
+        aggregator.discardBelow(fullPath.c_str());
+        int objectID = st->findObjectIDByPath(fullPath);
+        if (objectID != INVALID_OBJECT_ID)
+            cm->removeObject(objectID);
+    }
+    if (added) {
+        log_debug("adding %s\n", fullPath.c_str());
+        // path, recursive, async, hidden, low priority, cancellable
+        cm->addFile(fullPath, adir->getLocation(), adir->getRecursive(), true, adir->getHidden(), true, false);
+    }
+}
+
+Ref<AutoscanDirectory> AutoscanInotify::getFanotifyAutoscan(const std::string& path, bool isDirectory)
+{
+    // the whole filesystem is watched, most events are outside the autoscans
+    Ref<AutoscanDirectory> bestMatch;
+    size_t bestLength = 0;
+    for (auto& dir : fanotifyDirectories) {
+        const std::string& location = dir.first;
+        size_t length = location.length();
+        if (length <= bestLength || path.length() <= length || path.compare(0, length, location) != 0)
+            continue;
+        if (location.back() != DIR_SEPARATOR && path[length] != DIR_SEPARATOR)
+            continue;
+
+        Ref<AutoscanDirectory> adir = dir.second;
+        size_t start = (location.back() == DIR_SEPARATOR) ? length : length + 1;
+        std::string relative = path.substr(start);
+        if (!adir->getRecursive() && (isDirectory || relative.find(DIR_SEPARATOR) != std::string::npos))
+            continue;
+        if (!adir->getHidden() && (relative[0] == '.' || relative.find(std::string(1, DIR_SEPARATOR) + '.') != std::string::npos))
+            continue;
+
+        bestMatch = adir;
+        bestLength = length;
+    }
+    return bestMatch;
+}
+
+void AutoscanInotify::wakeUp()
+{
+    if (inotify != nullptr)
+        inotify->stop();
+    if (fanotify != nullptr)
+        fanotify->stop();
+}
+
+void AutoscanInotify::processDueEvents(Ref<ContentManager> cm, Ref<Storage> st)
+{
+    std::vector<InotifyWorkItem> items;
+    aggregator.takeDue(items);
+    if (items.empty())
+        return;
+
+    InotifyEventStatistics statistics = aggregator.getStatistics();
+    log_debug("processing %d inotify work items, %d pending, %ld events collapsed\n",
+        (int)items.size(), statistics.pending, statistics.collapsed);
+
+    for (auto& item : items) {
+        String path(item.path.c_str());
+        Ref<AutoscanDirectory> adir = RefCast(item.context, AutoscanDirectory);
+        try {
+            if (item.action != InotifyAction::Add) {
+                log_debug("deleting %s\n", path.c_str());
+                int objectID = st->findObjectIDByPath(path);
+                if (objectID != INVALID_OBJECT_ID)
+                    cm->removeObject(objectID);
+            }
+            if (item.action != InotifyAction::Remove) {
+                log_debug("adding %s\n", path.c_str());
+                // path, recursive, async, hidden, low priority, cancellable
+                cm->addFile(path, adir->getLocation(), adir->getRecursive(), true, adir->getHidden(), true, false);
+            }
+        } catch (const Exception& e) {
+            log_error("Inotify could not process %s: %s\n", path.c_str(), e.getMessage().c_str());
+        }
+    }
+}
+
 void AutoscanInotify::monitor(zmm::Ref<AutoscanDirectory> dir)
 {
     assert(dir->getScanMode() == ScanMode::INotify);
     log_debug("Requested to monitor \"%s\"\n", dir->getLocation().c_str());
     AutoLock lock(mutex);
     monitorQueue->enqueue(dir);
-    inotify->stop();
+    wakeUp();
 }
 
 void AutoscanInotify::unmonitor(zmm::Ref<AutoscanDirectory> dir)
@@ -274,7 +497,7 @@ void AutoscanInotify::unmonitor(zmm::Ref<AutoscanDirectory> dir)
     log_debug("Requested to stop monitoring \"%s\"\n", dir->getLocation().c_str());
     AutoLock lock(mutex);
     unmonitorQueue->enqueue(dir);
-    inotify->stop();
+    wakeUp();
 }
 
 int AutoscanInotify::watchPathForMoves(String path, int wd)
@@ -301,7 +524,7 @@ int AutoscanInotify::addMoveWatch(String path, int removeWd, int parentWd)
 
         Ref<Wd> wdObj = nullptr;
         try {
-            wdObj = watches->at(wd);
+            wdObj = watches.at(wd);
 
             int parentWdSet = wdObj->getParentWd();
             if (parentWdSet >= 0) {
@@ -317,8 +540,7 @@ int AutoscanInotify::addMoveWatch(String path, int removeWd, int parentWd)
             //FIXME: not finished?
 
         } catch (const out_of_range& ex) {
-            wdObj = Ref<Wd>(new Wd(path, wd, parentWd));
-            watches->emplace(wd, wdObj);
+            wdObj = addWd(path, wd, parentWd);
         }
 
         if (!alreadyThere) {
@@ -353,7 +575,7 @@ void AutoscanInotify::recheckNonexistingMonitor(int curWd, Ref<Array<StringBase>
         //        log_debug("checking %s: %d\n", buf->c_str(), pathExists);
         if (pathExists) {
             if (curWd != -1)
-                removeNonexistingMonitor(curWd, watches->at(curWd), pathAr);
+                removeNonexistingMonitor(curWd, watches.at(curWd), pathAr);
 
             String path = buf.str() + DIR_SEPARATOR;
             if (first) {
@@ -386,11 +608,11 @@ void AutoscanInotify::checkMoveWatches(int wd, Ref<Wd> wdObj)
             watchMv = RefCast(watch, WatchMove);
             int removeWd = watchMv->getRemoveWd();
             try {
-                Ref<Wd> wdToRemove = watches->at(removeWd);
+                Ref<Wd> wdToRemove = watches.at(removeWd);
 
                 recheckNonexistingMonitors(removeWd, wdToRemove);
 
-                String path = wdToRemove->getPath();
+                String path = getPath(wdToRemove);
                 log_debug("found wd to remove because of move event: %d %s\n", removeWd, path.c_str());
 
                 inotify->removeWatch(removeWd);
@@ -465,35 +687,22 @@ void AutoscanInotify::monitorUnmonitorRecursive(String startPath, bool unmonitor
             return;
     }
 
-    struct dirent* dent;
-    struct stat statbuf;
-
-    DIR* dir = opendir(startPath.c_str());
-    if (!dir) {
+    // only the type of the entries is needed, which readdir() mostly knows
+    DirectoryWalker walker(true, 0);
+    std::vector<DirectoryEntry> entries;
+    try {
+        walker.readDirectory(startPath.c_str(), entries);
+    } catch (const Exception& e) {
         log_warning("Could not open %s\n", startPath.c_str());
         return;
     }
 
-    while ((dent = readdir(dir)) != nullptr && !shutdownFlag) {
-        char* name = dent->d_name;
-        if (name[0] == '.') {
-            if (name[1] == 0)
-                continue;
-            else if (name[1] == '.' && name[2] == 0)
-                continue;
-        }
-
-        String fullPath = startPath + DIR_SEPARATOR + name;
-
-        if (stat(fullPath.c_str(), &statbuf) != 0)
-            continue;
-
-        if (S_ISDIR(statbuf.st_mode)) {
-            monitorUnmonitorRecursive(fullPath, unmonitor, adir, normalizedAutoscanPath, false);
-        }
+    for (const auto& entry : entries) {
+        if (shutdownFlag)
+            break;
+        if (entry.isDirectory())
+            monitorUnmonitorRecursive(startPath + DIR_SEPARATOR + entry.name.c_str(), unmonitor, adir, normalizedAutoscanPath, false);
     }
-
-    closedir(dir);
 }
 
 int AutoscanInotify::monitorDirectory(String pathOri, Ref<AutoscanDirectory> adir, String normalizedAutoscanPath, bool startPoint, Ref<Array<StringBase>> pathArray)
@@ -516,7 +725,7 @@ int AutoscanInotify::monitorDirectory(String pathOri, Ref<AutoscanDirectory> adi
 
         Ref<Wd> wdObj = nullptr;
         try {
-            wdObj = watches->at(wd);
+            wdObj = watches.at(wd);
             if (parentWd >= 0 && wdObj->getParentWd() < 0) {
                 wdObj->setParentWd(parentWd);
             }
@@ -527,23 +736,26 @@ int AutoscanInotify::monitorDirectory(String pathOri, Ref<AutoscanDirectory> adi
             // should we check for already existing "nonexisting" watches?
             // ...
         } catch (const out_of_range& ex) {
-            wdObj = Ref<Wd>(new Wd(path, wd, parentWd));
-            watches->emplace(wd, wdObj);
+            wdObj = addWd(path, wd, parentWd);
         }
 
         if (!alreadyWatching) {
-            Ref<WatchAutoscan> watch(new WatchAutoscan(startPoint, adir, normalizedAutoscanPath));
-            if (pathArray != nullptr) {
-                watch->setNonexistingPathArray(pathArray);
+            Ref<WatchAutoscan> watch;
+            Ref<WatchAutoscan> startWatch;
+            if (!startPoint && pathArray == nullptr)
+                startWatch = getStartPointWatch(normalizedAutoscanPath, adir);
+
+            if (startWatch != nullptr) {
+                // all directories below a start point share one watch
+                watch = startWatch->getDescendantWatch();
+                startWatch->addDescendant(wd);
+            } else {
+                watch = Ref<WatchAutoscan>(new WatchAutoscan(startPoint, adir, normalizedAutoscanPath));
+                if (pathArray != nullptr) {
+                    watch->setNonexistingPathArray(pathArray);
+                }
             }
             wdObj->getWdWatches()->append(RefCast(watch, Watch));
-
-            if (!startPoint) {
-                int startPointWd = inotify->addWatch(normalizedAutoscanPath, events);
-                log_debug("getting start point for %s -> %s wd=%d\n", pathOri.c_str(), normalizedAutoscanPath.c_str(), startPointWd);
-                if (wd >= 0)
-                    addDescendant(startPointWd, wd, adir);
-            }
         }
     }
     return wd;
@@ -555,10 +767,8 @@ void AutoscanInotify::unmonitorDirectory(String path, Ref<AutoscanDirectory> adi
         path = path + DIR_SEPARATOR;
     }
 
-    // maybe there is a faster method...
-    // we use addWatch, because it returns the wd to the filename
-    // this should not add a new watch, because it should be already watched
-    int wd = inotify->addWatch(path, events);
+    uint32_t node = paths.find(path.c_str());
+    int wd = (node == PATH_TABLE_NONE) ? -1 : paths.getValue(node);
 
     if (wd < 0) {
         // doesn't seem to be monitored currently
@@ -566,8 +776,10 @@ void AutoscanInotify::unmonitorDirectory(String path, Ref<AutoscanDirectory> adi
         return;
     }
 
-    Ref<Wd> wdObj = watches->at(wd);
-    if (wdObj == nullptr) {
+    Ref<Wd> wdObj;
+    try {
+        wdObj = watches.at(wd);
+    } catch (const out_of_range& ex) {
         log_error("wd not found in watches!? (%d, %s)\n", wd, path.c_str());
         return;
     }
@@ -647,7 +859,7 @@ void AutoscanInotify::removeWatchMoves(int wd)
     do {
         wdObj = nullptr;
         try {
-            wdObj = watches->at(checkWd);
+            wdObj = watches.at(checkWd);
         } catch (const out_of_range& ex) {
             break;
         }
@@ -720,32 +932,54 @@ Ref<AutoscanInotify::WatchAutoscan> AutoscanInotify::getStartPoint(Ref<Wd> wdObj
     return nullptr;
 }
 
-void AutoscanInotify::addDescendant(int startPointWd, int addWd, Ref<AutoscanDirectory> adir)
+Ref<AutoscanInotify::WatchAutoscan> AutoscanInotify::getStartPointWatch(String normalizedAutoscanPath, Ref<AutoscanDirectory> adir)
 {
-    //    log_debug("called for %d, (adir->path=%s); adding %d\n", startPointWd, adir->getLocation().c_str(), addWd);
-    Ref<Wd> wdObj = nullptr;
+    uint32_t node = paths.find(normalizedAutoscanPath.c_str());
+    if (node == PATH_TABLE_NONE)
+        return nullptr;
+
+    Ref<Wd> wdObj;
     try {
-        wdObj = watches->at(startPointWd);
-    } catch (const std::out_of_range& ex) {
-        return;
+        wdObj = watches.at(paths.getValue(node));
+    } catch (const out_of_range& ex) {
+        return nullptr;
     }
-    if (wdObj == nullptr)
-        return;
 
-    //   log_debug("found wdObj\n");
     Ref<WatchAutoscan> watch = getAppropriateAutoscan(wdObj, adir);
-    if (watch == nullptr)
+    if (watch == nullptr || !watch->isStartPoint())
+        return nullptr;
+    return watch;
+}
+
+Ref<AutoscanInotify::Wd> AutoscanInotify::addWd(String path, int wd, int parentWd)
+{
+    uint32_t node = paths.add(path.c_str());
+    paths.setValue(node, wd);
+    Ref<Wd> wdObj(new Wd(node, wd, parentWd));
+    watches.emplace(wd, wdObj);
+    return wdObj;
+}
+
+void AutoscanInotify::removeWd(int wd)
+{
+    Ref<Wd> wdObj;
+    try {
+        wdObj = watches.at(wd);
+    } catch (const out_of_range& ex) {
         return;
-    //    log_debug("adding descendant\n");
-    watch->addDescendant(addWd);
-    //    log_debug("added descendant to %d (adir->path=%s): %d; now: %s\n", startPointWd, adir->getLocation().c_str(), addWd, watch->getDescendants()->toCSV().c_str());
+    }
+    // a directory created again in the same place may have its new wd already
+    if (paths.getValue(wdObj->getPathNode()) == wd)
+        paths.setValue(wdObj->getPathNode(), -1);
+    paths.remove(wdObj->getPathNode());
+    watches.erase(wd);
 }
 
 void AutoscanInotify::removeDescendants(int wd)
 {
     Ref<Wd> wdObj = nullptr;
     try {
-        wdObj = watches->at(wd);
+        wdObj = watches.at(wd);
     } catch (const out_of_range& ex) {
         return;
     }
@@ -31,20 +31,26 @@
 #ifndef __AUTOSCAN_INOTIFY_H__
 #define __AUTOSCAN_INOTIFY_H__
 
-#include <memory>
+#include <stdexcept>
 #include <mutex>
 #include <thread>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "autoscan.h"
+#include "inotify_event_aggregator.h"
+#include "mt_fanotify.h"
 #include "mt_inotify.h"
+#include "path_table.h"
 #include "singleton.h"
 #include "zmm/zmmf.h"
 
 #define INOTIFY_ROOT -1
 #define INOTIFY_UNKNOWN_PARENT_WD -2
 
+class ContentManager;
+class Storage;
+
 class AutoscanInotify {
 public:
     AutoscanInotify();
@@ -58,13 +64,26 @@ public:
     /// \brief Stop monitoring a directory
     void unmonitor(zmm::Ref<AutoscanDirectory> dir);
 
+    InotifyEventStatistics getEventStatistics() { return aggregator.getStatistics(); }
+
 private:
     void threadProc();
+    void fanotifyThreadProc();
+    void handleFanotifyEvent(zmm::Ref<ContentManager> cm, zmm::Ref<Storage> st, const FanotifyEvent& event);
+    zmm::Ref<AutoscanDirectory> getFanotifyAutoscan(const std::string& path, bool isDirectory);
+    /// \brief interrupts the wait for the next event
+    void wakeUp();
+    void processDueEvents(zmm::Ref<ContentManager> cm, zmm::Ref<Storage> st);
 
     std::thread thread_;
 
     zmm::Ref<Inotify> inotify;
 
+    /// \brief replaces the watches when whole filesystems are watched
+    zmm::Ref<Fanotify> fanotify;
+    /// \brief normalized location and autoscan watched with fanotify
+    std::vector<std::pair<std::string, zmm::Ref<AutoscanDirectory>>> fanotifyDirectories;
+
     std::mutex mutex;
     using AutoLock = std::lock_guard<std::mutex>;
 
@@ -74,6 +93,9 @@ private:
     // event mask with events to watch for (set by constructor);
     int events;
 
+    // file events wait here for the debounce window
+    InotifyEventAggregator aggregator;
+
     enum class WatchType {
         Autoscan,
         Move
@@ -112,10 +134,18 @@ private:
             descendants.push_back(wd);
         }
         const std::vector<int>& getDescendants() const { return descendants; }
+        /// \brief the watch shared by all directories below a start point
+        zmm::Ref<WatchAutoscan> getDescendantWatch()
+        {
+            if (descendantWatch == nullptr)
+                descendantWatch = zmm::Ref<WatchAutoscan>(new WatchAutoscan(false, adir, normalizedAutoscanPath));
+            return descendantWatch;
+        }
     private:
         zmm::Ref<AutoscanDirectory> adir;
         bool startPoint;
         std::vector<int> descendants;
+        zmm::Ref<WatchAutoscan> descendantWatch;
         zmm::String normalizedAutoscanPath;
         zmm::Ref<zmm::Array<zmm::StringBase>> nonexistingPathArray;
     };
@@ -135,14 +165,15 @@ private:
 
     class Wd : public zmm::Object {
     public:
-        Wd(zmm::String path, int wd, int parentWd)
+        Wd(uint32_t pathNode, int wd, int parentWd)
         {
             wdWatches = zmm::Ref<zmm::Array<Watch>>(new zmm::Array<Watch>(1));
-            this->path = path;
+            this->pathNode = pathNode;
             this->wd = wd;
             this->parentWd = parentWd;
         }
-        zmm::String getPath() { return path; }
+        /// \brief the path in AutoscanInotify::paths
+        uint32_t getPathNode() { return pathNode; }
         int getWd() { return wd; }
         int getParentWd() { return parentWd; }
         void setParentWd(int parentWd) { this->parentWd = parentWd; }
@@ -150,12 +181,63 @@ private:
 
     private:
         zmm::Ref<zmm::Array<Watch>> wdWatches;
-        zmm::String path;
+        uint32_t pathNode;
         int parentWd;
         int wd;
     };
 
-    std::shared_ptr<std::unordered_map<int, zmm::Ref<Wd>>> watches;
+    /// \brief Wd objects indexed by their watch descriptor, which the
+    /// kernel hands out counting up from 1.
+    class WatchRegistry {
+    public:
+        WatchRegistry()
+            : count(0)
+        {
+        }
+        /// \brief throws std::out_of_range for unknown descriptors
+        zmm::Ref<Wd> at(int wd) const
+        {
+            if (wd < 0 || wd >= (int)wds.size() || wds[wd] == nullptr)
+                throw std::out_of_range("unknown watch descriptor");
+            return wds[wd];
+        }
+        void emplace(int wd, zmm::Ref<Wd> wdObj)
+        {
+            if (wd >= (int)wds.size())
+                wds.resize(wd + 1);
+            if (wds[wd] == nullptr)
+                count++;
+            wds[wd] = wdObj;
+        }
+        void erase(int wd)
+        {
+            if (wd < 0 || wd >= (int)wds.size() || wds[wd] == nullptr)
+                return;
+            wds[wd] = nullptr;
+            count--;
+            while (!wds.empty() && wds.back() == nullptr)
+                wds.pop_back();
+        }
+        void clear()
+        {
+            wds.clear();
+            count = 0;
+        }
+        size_t size() const { return count; }
+
+    private:
+        std::vector<zmm::Ref<Wd>> wds;
+        size_t count;
+    };
+
+    WatchRegistry watches;
+
+    /// \brief paths of all watched directories, the value is the wd
+    PathTable paths;
+
+    zmm::String getPath(zmm::Ref<Wd> wdObj) { return zmm::String(paths.getPath(wdObj->getPathNode()).c_str()); }
+    zmm::Ref<Wd> addWd(zmm::String path, int wd, int parentWd);
+    void removeWd(int wd);
 
     zmm::String normalizePathNoEx(zmm::String path);
 
@@ -181,7 +263,7 @@ private:
     void checkMoveWatches(int wd, zmm::Ref<Wd> wdObj);
     void removeWatchMoves(int wd);
 
-    void addDescendant(int startPointWd, int addWd, zmm::Ref<AutoscanDirectory> adir);
+    zmm::Ref<WatchAutoscan> getStartPointWatch(zmm::String normalizedAutoscanPath, zmm::Ref<AutoscanDirectory> adir);
     void removeDescendants(int wd);
 
     /// \brief is set to true by shutdown() if the inotify thread should terminate
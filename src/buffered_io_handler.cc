@@ -35,6 +35,10 @@
 #include "tools.h"
 
 
+// number of idle reactor ticks without data, after which we tell libupnp
+// to check the socket so that it can call our close() callback
+#define MAX_IDLE_TICKS 4
+
 using namespace zmm;
 using namespace std;
 
@@ -46,6 +50,7 @@ BufferedIOHandler::BufferedIOHandler(Ref<IOHandler> underlyingHandler, size_t bu
         throw _Exception(_("maxChunkSize must be positive"));
     this->underlyingHandler = underlyingHandler;
     this->maxChunkSize = maxChunkSize;
+    idleCount = 0;
     
     // test it first!
     //seekEnabled = true;
@@ -55,6 +60,9 @@ void BufferedIOHandler::open(IN enum UpnpOpenFileMode mode)
 {
     // do the open here instead of threadProc() because it may throw an exception
     underlyingHandler->open(mode);
+    // pipes and fifos are serviced by the reactor, everything else
+    // gets a thread
+    reactorDriven = (underlyingHandler->getPollFd() >= 0);
     IOHandlerBufferHelper::open(mode);
 }
 
@@ -210,3 +218,54 @@ void BufferedIOHandler::threadProc()
     // ensure that read() doesn't wait for me to fill the buffer
     cond.notify_one();
 }
+
+int BufferedIOHandler::reactorFd()
+{
+    return underlyingHandler->getPollFd();
+}
+
+void BufferedIOHandler::reactorProcess(IOReactor *reactor, bool idle)
+{
+    unique_lock<std::mutex> lock(mutex);
+    if (threadShutdown || eof || readError)
+        return;
+    
+    if (empty)
+        a = b = 0;
+    
+    size_t maxWrite = getContiguousFreeSpace();
+    if (maxWrite == 0)
+        return;
+    
+    lock.unlock();
+    size_t chunkSize = (maxChunkSize > maxWrite ? maxWrite : maxChunkSize);
+    ssize_t readBytes = underlyingHandler->readAvailable(buffer + b, chunkSize);
+    lock.lock();
+    
+    if (threadShutdown)
+        return;
+    
+    if (readBytes > 0)
+    {
+        idleCount = 0;
+        commitWrite(readBytes);
+    }
+    else if (readBytes == IO_WOULD_BLOCK)
+    {
+        if (idle && ++idleCount > MAX_IDLE_TICKS)
+        {
+            log_debug("max idle ticks, checking socket!\n");
+            idleCount = 0;
+            checkSocket = true;
+            cond.notify_one();
+        }
+    }
+    else
+    {
+        if (readBytes == 0)
+            eof = true;
+        else
+            readError = true;
+        cond.notify_one();
+    }
+}
@@ -59,8 +59,12 @@ public:
 private:
     zmm::Ref<IOHandler> underlyingHandler;
     size_t maxChunkSize;
+    int idleCount;
     
     virtual void threadProc();
+    
+    virtual int reactorFd();
+    virtual void reactorProcess(IOReactor *reactor, bool idle);
 };
 
 #endif // __BUFFERED_IO_HANDLER_H__
@@ -40,8 +40,8 @@ using namespace mxml;
 CdsObject::CdsObject() : Object()
 {
     metadata = Ref<Dictionary>(new Dictionary());
-    auxdata = Ref<Dictionary>(new Dictionary());
-    resources = Ref<Array<CdsResource> >(new Array<CdsResource>);
+    // resources and auxdata are created by decodeStoredOnce(), objects
+    // loaded for a browse result often never touch them
     id = INVALID_OBJECT_ID;
     parentID = INVALID_OBJECT_ID;
     refID = INVALID_OBJECT_ID;
@@ -50,6 +50,8 @@ CdsObject::CdsObject() : Object()
     virt = 0;
     sortPriority = 0;
     objectFlags = OBJECT_FLAG_RESTRICTED;
+    counted = false;
+    countedFileSize = 0;
 }
 
 void CdsObject::copyTo(Ref<CdsObject> obj)
@@ -64,11 +66,14 @@ void CdsObject::copyTo(Ref<CdsObject> obj)
     obj->setSizeOnDisk(sizeOnDisk);
     obj->setVirtual(virt);
     obj->setMetadata(metadata->clone());
+    decodeStored();
     obj->setAuxData(auxdata->clone());
     obj->setFlags(objectFlags);
     obj->setSortPriority(sortPriority);
     for (int i = 0; i < resources->size(); i++)
         obj->addResource(resources->get(i)->clone());
+    if (counted)
+        obj->setCounted(countedMimeType, countedLocation, countedFileSize);
 }
 int CdsObject::equals(Ref<CdsObject> obj, bool exactly)
 {
@@ -93,7 +98,7 @@ int CdsObject::equals(Ref<CdsObject> obj, bool exactly)
          mtime == obj->getMTime() &&
          sizeOnDisk == obj->getSizeOnDisk() &&
          virt == obj->isVirtual() &&
-         auxdata->equals(obj->auxdata) &&
+         getAuxData()->equals(obj->getAuxData()) &&
          objectFlags == obj->getFlags()
         ))
         return 0;
@@ -102,18 +107,38 @@ int CdsObject::equals(Ref<CdsObject> obj, bool exactly)
 
 int CdsObject::resourcesEqual(Ref<CdsObject> obj)
 {
-    if (resources->size() != obj->resources->size())
+    decodeStored();
+    Ref<Array<CdsResource> > otherResources = obj->getResources();
+    if (resources->size() != otherResources->size())
         return 0;
     
     // compare all resources
     for (int i = 0; i < resources->size(); i++)
     {
-        if (! resources->get(i)->equals(obj->resources->get(i)))
+        if (! resources->get(i)->equals(otherResources->get(i)))
             return 0;
     }
     return 1;
 }
 
+void CdsObject::decodeStoredOnce()
+{
+    if (encodedResources != nullptr)
+    {
+        resources = CdsResource::decodeCompact(encodedResources);
+        encodedResources = nullptr;
+    }
+    else
+        resources = Ref<Array<CdsResource> >(new Array<CdsResource>);
+
+    auxdata = Ref<Dictionary>(new Dictionary());
+    if (encodedAuxData != nullptr)
+    {
+        auxdata->decodeCompact(encodedAuxData);
+        encodedAuxData = nullptr;
+    }
+}
+
 void CdsObject::validate()
 {
     if (!string_ok(this->title))
@@ -316,6 +341,7 @@ void CdsContainer::validate()
 }
 void CdsObject::optimize()
 {
+    decodeStored();
     metadata->optimize();
     auxdata->optimize();
     resources->optimize();
@@ -32,6 +32,7 @@
 #ifndef __CDS_OBJECTS_H__
 #define __CDS_OBJECTS_H__
 
+#include <mutex>
 #include <sys/types.h>
 
 #include "common.h"
@@ -119,9 +120,27 @@ protected:
     zmm::Ref<Dictionary> auxdata;
     zmm::Ref<zmm::Array<CdsResource> > resources;
 
+    /// \brief resources and auxdata as stored in the database, they are
+    /// only decoded when they are accessed
+    zmm::String encodedResources;
+    zmm::String encodedAuxData;
+    std::once_flag decodeOnce;
+
+    /// \brief Decodes the stored resources and auxdata on first use, or
+    /// creates them empty if nothing was stored.
+    inline void decodeStored() { std::call_once(decodeOnce, &CdsObject::decodeStoredOnce, this); }
+    void decodeStoredOnce();
+
     /// \ brief IDs of the metadata attributes in the metadata table
     zmm::Ref<Dictionary> metadataIDs;
 
+    /// \brief mime type, location and file size the storage statistics
+    /// counted for the object when it was loaded
+    bool counted;
+    zmm::String countedMimeType;
+    zmm::String countedLocation;
+    off_t countedFileSize;
+
 public:
     /// \brief Constructor. Sets the default values.
     CdsObject();
@@ -244,46 +263,63 @@ public:
     
     /// \brief Query single auxdata value.
     inline zmm::String getAuxData(zmm::String key)
-    { return auxdata->get(key); }
+    { decodeStored(); return auxdata->get(key); }
 
     /// \brief Query entire auxdata dictionary.
-    inline zmm::Ref<Dictionary> getAuxData() { return auxdata; }
+    inline zmm::Ref<Dictionary> getAuxData() { decodeStored(); return auxdata; }
 
     /// \brief Set a single auxdata value.
     inline void setAuxData(zmm::String key, zmm::String value)
-    { auxdata->put(key, value); }
+    { decodeStored(); auxdata->put(key, value); }
     
     /// \brief Set entire auxdata dictionary.
     inline void setAuxData(zmm::Ref<Dictionary> auxdata)
-    { this->auxdata = auxdata; }
+    { decodeStored(); this->auxdata = auxdata; }
 
     /// \brief Removes auxdata with the given key
     inline void removeAuxData(zmm::String key)
-    { auxdata->remove(key); }
+    { decodeStored(); auxdata->remove(key); }
     
     
     /// \brief Get number of resource tags
-    inline int getResourceCount() { return resources->size(); }
+    inline int getResourceCount() { decodeStored(); return resources->size(); }
 
     /// \brief Query resources
     inline zmm::Ref<zmm::Array<CdsResource> > getResources()
-    { return resources; }
+    { decodeStored(); return resources; }
  
     /// \brief Set resources
     inline void setResources(zmm::Ref<zmm::Array<CdsResource> > res) 
-    { resources = res; }
+    { decodeStored(); resources = res; }
     
     /// \brief Query resource tag with the given index
     inline zmm::Ref<CdsResource> getResource(int index)
-    { return resources->get(index); }
+    { decodeStored(); return resources->get(index); }
     
     /// \brief Add resource tag
     inline void addResource(zmm::Ref<CdsResource> resource)
-    { resources->append(resource); } 
+    { decodeStored(); resources->append(resource); } 
   
     /// \brief Insert resource tag at index
     inline void insertResource(int index, zmm::Ref<CdsResource> resource)
-    { resources->insert(index, resource); }
+    { decodeStored(); resources->insert(index, resource); }
+
+    /// \brief Sets resources and auxdata as they are stored in the database.
+    ///
+    /// They are decoded when they are first accessed, so loading objects of
+    /// which only the title or the location is used stays cheap. Has to be
+    /// called before anything accesses the resources or auxdata.
+    inline void setEncodedResources(zmm::String resources, zmm::String auxdata)
+    { encodedResources = resources; encodedAuxData = auxdata; }
+
+    /// \brief Remembers what the storage counted for the object, so an
+    /// update can take it out of the statistics without a lookup.
+    inline void setCounted(zmm::String mimeType, zmm::String dbLocation, off_t fileSize)
+    { counted = true; countedMimeType = mimeType; countedLocation = dbLocation; countedFileSize = fileSize; }
+    inline bool isCounted() { return counted; }
+    inline zmm::String getCountedMimeType() { return countedMimeType; }
+    inline zmm::String getCountedLocation() { return countedLocation; }
+    inline off_t getCountedFileSize() { return countedFileSize; }
 
     /// \brief Copies all object properties to another object.
     /// \param obj target object (clone)
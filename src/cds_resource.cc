@@ -35,6 +35,7 @@
 #include <sstream>
 
 #define RESOURCE_PART_SEP '~'
+#define RESOURCE_SEP '|'
 
 using namespace zmm;
 
@@ -176,6 +177,59 @@ Ref<CdsResource> CdsResource::decode(String serial)
     return resource;
 }
 
+String CdsResource::encodeCompact(Ref<Array<CdsResource> > resources)
+{
+    std::ostringstream buf;
+    buf << COMPACT_ENCODING_PREFIX;
+    Dictionary::appendCompactNumber(buf, resources->size());
+    for (int i = 0; i < resources->size(); i++)
+    {
+        Ref<CdsResource> resource = resources->get(i);
+        Dictionary::appendCompactNumber(buf, resource->handlerType);
+        resource->attributes->appendCompact(buf);
+        resource->parameters->appendCompact(buf);
+        resource->options->appendCompact(buf);
+    }
+    return buf.str();
+}
+
+Ref<Array<CdsResource> > CdsResource::decodeCompact(String serial)
+{
+    Ref<Array<CdsResource> > resources(new Array<CdsResource>());
+    if (!string_ok(serial))
+        return resources;
+
+    if (!serial.startsWith(_(COMPACT_ENCODING_PREFIX)))
+    {
+        Ref<Array<StringBase> > parts = split_string(serial, RESOURCE_SEP);
+        for (int i = 0; i < parts->size(); i++)
+            resources->append(decode(parts->get(i)));
+        return resources;
+    }
+
+    const char *data = serial.c_str();
+    size_t length = serial.length();
+    size_t pos = COMPACT_ENCODING_PREFIX_LENGTH;
+    int count;
+    if (!Dictionary::readCompactNumber(data, length, pos, count) || count < 0)
+        throw _Exception(_("CdsResource::decodeCompact: Could not parse resources"));
+
+    for (int i = 0; i < count; i++)
+    {
+        int handlerType;
+        Ref<Dictionary> attr(new Dictionary());
+        Ref<Dictionary> par(new Dictionary());
+        Ref<Dictionary> opt(new Dictionary());
+        if (!Dictionary::readCompactNumber(data, length, pos, handlerType) ||
+            !attr->readCompact(data, length, pos) ||
+            !par->readCompact(data, length, pos) ||
+            !opt->readCompact(data, length, pos))
+            throw _Exception(_("CdsResource::decodeCompact: Could not parse resources"));
+        resources->append(Ref<CdsResource>(new CdsResource(handlerType, attr, par, opt)));
+    }
+    return resources;
+}
+
 void CdsResource::optimize()
 {
     attributes->optimize();
@@ -113,6 +113,14 @@ public:
     zmm::String encode();
     static zmm::Ref<CdsResource> decode(zmm::String serial);
 
+    /// \brief Encodes a list of resources in the compact encoding used in
+    /// the database.
+    static zmm::String encodeCompact(zmm::Ref<zmm::Array<CdsResource> > resources);
+
+    /// \brief Decodes a list of resources in the compact or in the old url
+    /// based encoding.
+    static zmm::Ref<zmm::Array<CdsResource> > decodeCompact(zmm::String serial);
+
     /// \brief Frees unnecessary memory
     void optimize();
 };
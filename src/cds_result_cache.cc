@@ -0,0 +1,185 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    cds_result_cache.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file cds_result_cache.cc
+
+#include "cds_result_cache.h"
+#include "config_manager.h"
+
+using namespace zmm;
+using namespace std;
+
+CdsResultCache::CdsResultCache()
+    : Singleton<CdsResultCache>()
+    , capacity(0)
+    , generation(0)
+    , lastChange(0)
+    , forgottenBefore(0)
+{
+}
+
+void CdsResultCache::init()
+{
+    capacity = ConfigManager::getInstance()->getIntOption(CFG_SERVER_UPNP_RESULT_CACHE_SIZE);
+    log_debug("caching up to %d replies\n", (int)capacity);
+}
+
+unsigned long CdsResultCache::getGeneration()
+{
+    AutoLock lock(mutex);
+    return generation;
+}
+
+bool CdsResultCache::get(const string &key, CdsCachedResult &result)
+{
+    AutoLock lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end())
+        return false;
+
+    lru.splice(lru.begin(), lru, it->second.lruPos);
+    result = it->second.result;
+    return true;
+}
+
+void CdsResultCache::put(const string &key, const CdsCachedResult &result,
+    const vector<int> &dependsOn, bool anyChange, unsigned long generation)
+{
+    if (result.didl.length() > CDS_RESULT_CACHE_MAX_ENTRY_SIZE)
+        return;
+
+    AutoLock lock(mutex);
+    if (capacity == 0 || changedSince(dependsOn, anyChange, generation))
+        return;
+
+    removeEntry(key);
+    while (entries.size() >= capacity)
+    {
+        string oldest = lru.back();
+        removeEntry(oldest);
+    }
+
+    lru.push_front(key);
+    Entry &entry = entries[key];
+    entry.result = result;
+    entry.dependsOn = dependsOn;
+    entry.anyChange = anyChange;
+    entry.lruPos = lru.begin();
+
+    if (anyChange)
+        anyChangeEntries.insert(key);
+    for (int objectID : dependsOn)
+        dependencies[objectID].insert(key);
+}
+
+void CdsResultCache::invalidate(int objectID)
+{
+    if (objectID == INVALID_OBJECT_ID)
+        return;
+    AutoLock lock(mutex);
+    invalidateUnlocked(objectID);
+}
+
+void CdsResultCache::invalidate(const vector<int> &objectIDs)
+{
+    AutoLock lock(mutex);
+    for (int objectID : objectIDs)
+        invalidateUnlocked(objectID);
+}
+
+void CdsResultCache::clear()
+{
+    AutoLock lock(mutex);
+    generation++;
+    forgottenBefore = generation;
+    invalidatedAt.clear();
+    entries.clear();
+    lru.clear();
+    dependencies.clear();
+    anyChangeEntries.clear();
+}
+
+size_t CdsResultCache::size()
+{
+    AutoLock lock(mutex);
+    return entries.size();
+}
+
+bool CdsResultCache::changedSince(const vector<int> &dependsOn, bool anyChange, unsigned long generation)
+{
+    if (generation < forgottenBefore)
+        return true;
+    if (anyChange)
+        return lastChange > generation;
+    for (int objectID : dependsOn)
+    {
+        auto it = invalidatedAt.find(objectID);
+        if (it != invalidatedAt.end() && it->second > generation)
+            return true;
+    }
+    return false;
+}
+
+void CdsResultCache::invalidateUnlocked(int objectID)
+{
+    generation++;
+    lastChange = generation;
+    if (invalidatedAt.size() >= CDS_RESULT_CACHE_MAX_INVALIDATIONS
+        && invalidatedAt.find(objectID) == invalidatedAt.end())
+    {
+        // replies being rendered right now are not cached
+        invalidatedAt.clear();
+        forgottenBefore = generation;
+    }
+    invalidatedAt[objectID] = generation;
+
+    // copies, removeEntry() modifies the sets
+    unordered_set<string> keys(anyChangeEntries);
+    auto it = dependencies.find(objectID);
+    if (it != dependencies.end())
+        keys.insert(it->second.begin(), it->second.end());
+
+    for (auto &key : keys)
+        removeEntry(key);
+}
+
+void CdsResultCache::removeEntry(const string &key)
+{
+    auto it = entries.find(key);
+    if (it == entries.end())
+        return;
+
+    for (int objectID : it->second.dependsOn)
+    {
+        auto dep = dependencies.find(objectID);
+        if (dep == dependencies.end())
+            continue;
+        dep->second.erase(key);
+        if (dep->second.empty())
+            dependencies.erase(dep);
+    }
+    if (it->second.anyChange)
+        anyChangeEntries.erase(key);
+    lru.erase(it->second.lruPos);
+    entries.erase(it);
+}
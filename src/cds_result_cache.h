@@ -0,0 +1,118 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    cds_result_cache.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file cds_result_cache.h
+/// \brief Definition of the CdsResultCache class.
+
+#ifndef __CDS_RESULT_CACHE_H__
+#define __CDS_RESULT_CACHE_H__
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common.h"
+#include "singleton.h"
+
+/// \brief responses bigger than this are not worth keeping around
+#define CDS_RESULT_CACHE_MAX_ENTRY_SIZE (1024 * 1024)
+
+/// \brief number of containers whose last invalidation is remembered
+#define CDS_RESULT_CACHE_MAX_INVALIDATIONS 4096
+
+/// \brief A rendered Browse or Search reply, without the UpdateID which
+/// is always filled in with the current SystemUpdateID.
+struct CdsCachedResult
+{
+    std::string didl;
+    int numberReturned;
+    int totalMatches;
+};
+
+/// \brief Bounded LRU cache of rendered ContentDirectory replies.
+///
+/// Every entry remembers the containers it was rendered from. Whenever the
+/// UpdateManager is told that a container changed (which is exactly when
+/// its update_id is bumped) all entries depending on it are dropped.
+/// Search replies depend on whole subtrees, they are dropped on any change.
+/// Entries on other containers stay cached.
+class CdsResultCache : public Singleton<CdsResultCache>
+{
+public:
+    CdsResultCache();
+    zmm::String getName() override { return _("CDS Result Cache"); }
+    void init() override;
+
+    /// \brief Counter that changes with every invalidation.
+    ///
+    /// Fetch it before reading from the storage and hand it to put(), so
+    /// that a reply which raced with a change of one of the containers it
+    /// depends on is not cached.
+    unsigned long getGeneration();
+
+    bool get(const std::string &key, CdsCachedResult &result);
+
+    /// \param dependsOn containers the result was rendered from
+    /// \param anyChange drop the result on every change (used for Search)
+    void put(const std::string &key, const CdsCachedResult &result,
+        const std::vector<int> &dependsOn, bool anyChange, unsigned long generation);
+
+    void invalidate(int objectID);
+    void invalidate(const std::vector<int> &objectIDs);
+    void clear();
+
+    size_t size();
+
+protected:
+    struct Entry
+    {
+        CdsCachedResult result;
+        std::vector<int> dependsOn;
+        bool anyChange;
+        std::list<std::string>::iterator lruPos;
+    };
+
+    size_t capacity;
+    unsigned long generation;
+    /// \brief generation of the last invalidation, for anyChange entries
+    unsigned long lastChange;
+    /// \brief replies read before this generation are not cached, the
+    /// invalidations before it are forgotten
+    unsigned long forgottenBefore;
+    /// \brief generation of the last invalidation of each container
+    std::unordered_map<int, unsigned long> invalidatedAt;
+
+    std::unordered_map<std::string, Entry> entries;
+    /// \brief most recently used first
+    std::list<std::string> lru;
+    std::unordered_map<int, std::unordered_set<std::string> > dependencies;
+    std::unordered_set<std::string> anyChangeEntries;
+
+    void invalidateUnlocked(int objectID);
+    bool changedSince(const std::vector<int> &dependsOn, bool anyChange, unsigned long generation);
+    void removeEntry(const std::string &key);
+};
+
+#endif // __CDS_RESULT_CACHE_H__
@@ -206,6 +206,9 @@
 #define DEFAULT_FILESYSTEM_CHARSET      "UTF-8"
 #define DEFAULT_FALLBACK_CHARSET        "US-ASCII"
 #define DEFAULT_JS_CHARSET              "UTF-8"
+#define DEFAULT_JS_RUNTIME_POOL_SIZE    0
+#define DEFAULT_INOTIFY_DEBOUNCE        500
+#define DEFAULT_USE_FANOTIFY            NO
 
 #define DEFAULT_CONFIG_HOME             ".config/gerbera"
 #define DEFAULT_TMPDIR                  "/tmp/"
@@ -230,6 +233,14 @@
 #define DEFAULT_JS_DIR                  "js"
 #define DEFAULT_HIDDEN_FILES_VALUE      NO
 #define DEFAULT_UPNP_STRING_LIMIT       (-1)
+#define DEFAULT_UPNP_RESULT_CACHE_SIZE  256
+#define DEFAULT_READ_AHEAD_MODE         NO
+#define DEFAULT_READ_AHEAD_THREADS      4
+#define DEFAULT_READ_AHEAD_MAX_WINDOW   (8 * 1024 * 1024)
+#define DEFAULT_READ_AHEAD_IO_URING     NO
+#define DEFAULT_PROXY_CACHE_ENABLED     NO
+#define DEFAULT_PROXY_CACHE_SIZE        1024
+#define DEFAULT_HTTP_CLIENT_HOST_CONNECTIONS 4
 #define DEFAULT_SESSION_TIMEOUT         30
 #define SESSION_TIMEOUT_CHECK_INTERVAL  (5 * 60)
 #define DEFAULT_PRES_URL_APPENDTO_ATTR  "none"
@@ -307,6 +318,7 @@
 #define INVALID_OBJECT_ID               (-333)
 #define INVALID_OBJECT_ID_2             (-666)
 #define CHECK_SOCKET                    (-666)
+#define IO_WOULD_BLOCK                  (-667)
 
 // storage
 #define LOC_DIR_PREFIX      'D'
@@ -32,6 +32,7 @@
 #include "config_manager.h"
 #include "common.h"
 #include "metadata_handler.h"
+#include "read_ahead_io_handler.h"
 #include "storage.h"
 #include "string_converter.h"
 #include "tools.h"
@@ -40,11 +41,14 @@
 #else
 #include <uuid/uuid.h>
 #endif
+#include <algorithm>
 #include <cstdio>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <thread>
 
 #ifdef HAVE_INOTIFY
+#include "mt_fanotify.h"
 #include "mt_inotify.h"
 #endif
 
@@ -771,6 +775,76 @@ void ConfigManager::validate(String serverhome)
     NEW_INT_OPTION(temp_int);
     SET_INT_OPTION(CFG_SERVER_UPNP_TITLE_AND_DESC_STRING_LIMIT);
 
+    temp_int = getIntOption(_("/server/upnp-result-cache-size"),
+        DEFAULT_UPNP_RESULT_CACHE_SIZE);
+    if (temp_int < 0) {
+        throw _Exception(_("Error in config file: invalid value for "
+                           "<upnp-result-cache-size>"));
+    }
+    NEW_INT_OPTION(temp_int);
+    SET_INT_OPTION(CFG_SERVER_UPNP_RESULT_CACHE_SIZE);
+
+    temp = getOption(_("/server/read-ahead/attribute::mode"),
+        _(DEFAULT_READ_AHEAD_MODE));
+    if (temp != "network" && !validateYesNo(temp))
+        throw _Exception(_("Error in config file: incorrect parameter for "
+                           "<read-ahead mode=\"\" /> attribute"));
+    NEW_OPTION(temp);
+    SET_OPTION(CFG_SERVER_READ_AHEAD_MODE);
+
+    temp_int = getIntOption(_("/server/read-ahead/attribute::threads"),
+        DEFAULT_READ_AHEAD_THREADS);
+    if (temp_int < 1)
+        throw _Exception(_("Error in config file: invalid \"threads\" "
+                           "attribute value in <read-ahead> tag"));
+    NEW_INT_OPTION(temp_int);
+    SET_INT_OPTION(CFG_SERVER_READ_AHEAD_THREADS);
+
+    temp_int = getIntOption(_("/server/read-ahead/attribute::max-window"),
+        DEFAULT_READ_AHEAD_MAX_WINDOW);
+    if (temp_int < READ_AHEAD_MIN_WINDOW)
+        throw _Exception(_("Error in config file: invalid \"max-window\" "
+                           "attribute value in <read-ahead> tag, must be at least ")
+            + READ_AHEAD_MIN_WINDOW);
+    NEW_INT_OPTION(temp_int);
+    SET_INT_OPTION(CFG_SERVER_READ_AHEAD_MAX_WINDOW);
+
+    temp = getOption(_("/server/read-ahead/attribute::io-uring"),
+        _(DEFAULT_READ_AHEAD_IO_URING));
+    if (!validateYesNo(temp))
+        throw _Exception(_("Error in config file: incorrect parameter for "
+                           "<read-ahead io-uring=\"\" /> attribute"));
+    NEW_BOOL_OPTION(temp == "yes" ? true : false);
+    SET_BOOL_OPTION(CFG_SERVER_READ_AHEAD_IO_URING);
+
+    temp = getOption(_("/server/proxy-cache/attribute::enabled"),
+        _(DEFAULT_PROXY_CACHE_ENABLED));
+    if (!validateYesNo(temp))
+        throw _Exception(_("Error in config file: incorrect parameter for "
+                           "<proxy-cache enabled=\"\" /> attribute"));
+    NEW_BOOL_OPTION(temp == "yes" ? true : false);
+    SET_BOOL_OPTION(CFG_SERVER_PROXY_CACHE_ENABLED);
+
+    temp_int = getIntOption(_("/server/proxy-cache/attribute::size"),
+        DEFAULT_PROXY_CACHE_SIZE);
+    if (temp_int < 1)
+        throw _Exception(_("Error in config file: invalid \"size\" "
+                           "attribute value in <proxy-cache> tag"));
+    NEW_INT_OPTION(temp_int);
+    SET_INT_OPTION(CFG_SERVER_PROXY_CACHE_SIZE);
+
+    // empty means a directory below the server home
+    NEW_OPTION(getOption(_("/server/proxy-cache/attribute::location"), _("")));
+    SET_OPTION(CFG_SERVER_PROXY_CACHE_LOCATION);
+
+    temp_int = getIntOption(_("/server/http-client/attribute::host-connections"),
+        DEFAULT_HTTP_CLIENT_HOST_CONNECTIONS);
+    if (temp_int < 0)
+        throw _Exception(_("Error in config file: invalid \"host-connections\" "
+                           "attribute value in <http-client> tag"));
+    NEW_INT_OPTION(temp_int);
+    SET_INT_OPTION(CFG_SERVER_HTTP_CLIENT_HOST_CONNECTIONS);
+
 #ifdef HAVE_JS
     temp = getOption(_("/import/scripting/playlist-script"),
         prefix_dir + DIR_SEPARATOR + _(DEFAULT_JS_DIR) + DIR_SEPARATOR + _(DEFAULT_PLAYLISTS_SCRIPT));
@@ -846,6 +920,17 @@ void ConfigManager::validate(String serverhome)
     NEW_OPTION(script_path);
     SET_OPTION(CFG_IMPORT_SCRIPTING_IMPORT_SCRIPT);
 
+    temp_int = getIntOption(_("/import/scripting/attribute::runtime-pool-size"),
+        DEFAULT_JS_RUNTIME_POOL_SIZE);
+    if (temp_int < 0)
+        throw _Exception(_("Error in config file: invalid \"runtime-pool-size\" "
+                           "attribute value in <scripting> tag"));
+    // 0 means one runtime per processor
+    if (temp_int == 0)
+        temp_int = std::max(1u, std::thread::hardware_concurrency());
+    NEW_INT_OPTION(temp_int);
+    SET_INT_OPTION(CFG_IMPORT_SCRIPTING_RUNTIME_POOL_SIZE);
+
 #endif
 
     // 0 means, that the SDK will any free port itself
@@ -919,6 +1004,30 @@ void ConfigManager::validate(String serverhome)
         NEW_BOOL_OPTION(false);
         SET_BOOL_OPTION(CFG_IMPORT_AUTOSCAN_USE_INOTIFY);
     }
+
+    temp_int = getIntOption(_("/import/autoscan/attribute::inotify-debounce"),
+        DEFAULT_INOTIFY_DEBOUNCE);
+    if (temp_int < 0)
+        throw _Exception(_("Error in config file: invalid \"inotify-debounce\" "
+                           "attribute value in <autoscan> tag"));
+    NEW_INT_OPTION(temp_int);
+    SET_INT_OPTION(CFG_IMPORT_AUTOSCAN_INOTIFY_DEBOUNCE);
+
+    temp = getOption(_("/import/autoscan/attribute::use-fanotify"), _(DEFAULT_USE_FANOTIFY));
+    if ((temp != "auto") && !validateYesNo(temp))
+        throw _Exception(_("Error in config file: incorrect parameter for "
+                           "\"<autoscan use-fanotify=\" attribute"));
+    bool use_fanotify = false;
+    if (getBoolOption(CFG_IMPORT_AUTOSCAN_USE_INOTIFY) && temp != NO) {
+        use_fanotify = Fanotify::supported();
+        if (!use_fanotify && temp == YES)
+            throw _Exception(_("You specified "
+                               "\"yes\" in \"<autoscan use-fanotify=\"\">"
+                               " however fanotify is not available, it needs "
+                               "Linux 5.9 and the CAP_SYS_ADMIN capability"));
+    }
+    NEW_BOOL_OPTION(use_fanotify);
+    SET_BOOL_OPTION(CFG_IMPORT_AUTOSCAN_USE_FANOTIFY);
 #endif
 
     temp = getOption(
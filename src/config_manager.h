@@ -74,6 +74,15 @@ typedef enum
     CFG_SERVER_BOOKMARK_FILE,
     CFG_SERVER_CUSTOM_HTTP_HEADERS,
     CFG_SERVER_UPNP_TITLE_AND_DESC_STRING_LIMIT,
+    CFG_SERVER_UPNP_RESULT_CACHE_SIZE,
+    CFG_SERVER_READ_AHEAD_MODE,
+    CFG_SERVER_READ_AHEAD_THREADS,
+    CFG_SERVER_READ_AHEAD_MAX_WINDOW,
+    CFG_SERVER_READ_AHEAD_IO_URING,
+    CFG_SERVER_PROXY_CACHE_ENABLED,
+    CFG_SERVER_PROXY_CACHE_SIZE,
+    CFG_SERVER_PROXY_CACHE_LOCATION,
+    CFG_SERVER_HTTP_CLIENT_HOST_CONNECTIONS,
     CFG_SERVER_UI_ENABLED,
     CFG_SERVER_UI_POLL_INTERVAL,
     CFG_SERVER_UI_POLL_WHEN_IDLE,
@@ -130,6 +139,7 @@ typedef enum
     CFG_IMPORT_SCRIPTING_PLAYLIST_SCRIPT,
     CFG_IMPORT_SCRIPTING_PLAYLIST_SCRIPT_LINK_OBJECTS,
     CFG_IMPORT_SCRIPTING_IMPORT_SCRIPT,
+    CFG_IMPORT_SCRIPTING_RUNTIME_POOL_SIZE,
 #endif // JS
     CFG_IMPORT_SCRIPTING_VIRTUAL_LAYOUT_TYPE,
 #ifdef HAVE_MAGIC
@@ -139,6 +149,8 @@ typedef enum
 #ifdef HAVE_INOTIFY
     CFG_IMPORT_AUTOSCAN_USE_INOTIFY,
     CFG_IMPORT_AUTOSCAN_INOTIFY_LIST,
+    CFG_IMPORT_AUTOSCAN_INOTIFY_DEBOUNCE,
+    CFG_IMPORT_AUTOSCAN_USE_FANOTIFY,
 #endif
     CFG_IMPORT_MAPPINGS_IGNORE_UNKNOWN_EXTENSIONS,
     CFG_IMPORT_MAPPINGS_EXTENSION_TO_MIMETYPE_CASE_SENSITIVE,
@@ -35,9 +35,13 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <vector>
 
+#include "cds_result_cache.h"
 #include "config_manager.h"
 #include "content_manager.h"
+#include "directory_walker.h"
+#include "file_probe.h"
 #include "filesystem.h"
 #include "layout/fallback_layout.h"
 #include "metadata_handler.h"
@@ -113,6 +117,9 @@ ContentManager::ContentManager()
     Ref<ConfigManager> cm = ConfigManager::getInstance();
     Ref<Element> tmpEl;
 
+    String journalFile = cm->getOption(CFG_SERVER_HOME) + DIR_SEPARATOR + IMPORT_JOURNAL_FILE;
+    importJournal = Ref<ImportJournal>(new ImportJournal(journalFile.c_str()));
+
     // loading extension - mimetype map
     // we can always be sure to get a valid element because everything was prepared by the config manager
     extension_mimetype_map = cm->getDictionaryOption(CFG_IMPORT_MAPPINGS_EXTENSION_TO_MIMETYPE_LIST);
@@ -273,6 +280,17 @@ void ContentManager::init()
 
     autoscan_timed->notifyAll(this);
 
+    for (auto& import : importJournal->getUnfinished()) {
+        String path = import.path.c_str();
+        if (!check_path(path, true)) {
+            importJournal->end(import.id);
+            continue;
+        }
+        log_info("Continuing interrupted import of %s\n", path.c_str());
+        String rootpath = import.rootpath.empty() ? nullptr : String(import.rootpath.c_str());
+        addFileInternal(path, rootpath, true, true, import.hidden, true, 0, true);
+    }
+
 #ifdef HAVE_INOTIFY
     if (ConfigManager::getInstance()->getBoolOption(CFG_IMPORT_AUTOSCAN_USE_INOTIFY)) {
         /// \todo change this (we need a new autoscan architecture)
@@ -507,8 +525,8 @@ int ContentManager::_addFile(String path, String rootpath, bool recursive, bool
                     String mimetype = RefCast(obj, CdsItem)->getMimeType();
                     String content_type = mimetype_contenttype_map->get(mimetype);
 #ifdef HAVE_JS
-                    if ((playlist_parser_script != nullptr) && (content_type == CONTENT_TYPE_PLAYLIST))
-                        playlist_parser_script->processPlaylistObject(obj, task);
+                    if ((playlist_parser_scripts != nullptr) && (content_type == CONTENT_TYPE_PLAYLIST))
+                        parsePlaylist(obj, task);
 #else
                     if (content_type == CONTENT_TYPE_PLAYLIST)
                         log_warning("Playlist %s will not be parsed: Gerbera was compiled without JS support!\n", obj->getLocation().c_str());
@@ -521,7 +539,23 @@ int ContentManager::_addFile(String path, String rootpath, bool recursive, bool
     }
 
     if (recursive && IS_CDS_CONTAINER(obj->getObjectType())) {
-        addRecursive(path, hidden, task);
+        if (!string_ok(rootpath) && (task != nullptr))
+            rootpath = RefCast(task, CMAddFileTask)->getRootPath();
+        int importID = importJournal->begin(path.c_str(), string_ok(rootpath) ? rootpath.c_str() : "", hidden);
+        try {
+            addRecursive(path, hidden, task, importID);
+        } catch (const Exception& e) {
+            importJournal->end(importID);
+            throw e;
+        }
+
+        storage->flushInserts();
+        // an import cut short by a shutdown continues on the next start,
+        // a cancelled one is forgotten
+        if (shutdownFlag)
+            importJournal->checkpoint();
+        else
+            importJournal->end(importID);
     }
     return obj->getID();
 }
@@ -562,8 +596,6 @@ int ContentManager::ensurePathExistence(zmm::String path)
 void ContentManager::_rescanDirectory(int containerID, int scanID, ScanMode scanMode, ScanLevel scanLevel, Ref<GenericTask> task)
 {
     log_debug("start\n");
-    int ret;
-    struct dirent* dent;
     struct stat statbuf;
     String location;
     String path;
@@ -631,9 +663,14 @@ void ContentManager::_rescanDirectory(int containerID, int scanID, ScanMode scan
         //throw _Exception(_("Container has no location information!\n"));
     }
 
-    DIR* dir = opendir(location.c_str());
-    if (!dir) {
-        log_warning("Could not open %s: %s\n", location.c_str(), strerror(errno));
+    // hidden entries are left out, so that turning on the hidden option
+    // changes the fingerprint of directories with hidden entries
+    DirectoryWalker walker(adir->getHidden(), 0);
+    std::vector<DirectoryEntry> entries;
+    try {
+        walker.readDirectory(location.c_str(), entries, &statbuf);
+    } catch (const Exception& e) {
+        log_warning("%s\n", e.getMessage().c_str());
         if (adir->persistent()) {
             removeObject(containerID, false);
             adir->setObjectID(INVALID_OBJECT_ID);
@@ -648,8 +685,28 @@ void ContentManager::_rescanDirectory(int containerID, int scanID, ScanMode scan
         }
     }
 
+    DirectoryFingerprint fingerprint;
+    fingerprint.mtime = statbuf.st_mtim.tv_sec * 1000000000LL + statbuf.st_mtim.tv_nsec;
+    fingerprint.ctime = statbuf.st_ctim.tv_sec * 1000000000LL + statbuf.st_ctim.tv_nsec;
+    fingerprint.inode = statbuf.st_ino;
+    fingerprint.childCount = entries.size();
+
+    // if no entry was added or removed since the last complete scan there
+    // is nothing to reconcile, only changed files and subdirectories are
+    // looked at
+    DirectoryFingerprint previous;
+    bool unchanged = storage->loadDirectoryFingerprint(containerID, previous)
+        && previous == fingerprint;
+    bool complete = true;
+    // files which were imported again took the fingerprint with them
+    bool readded = false;
+
     // request only items if non-recursive scan is wanted
-    shared_ptr<unordered_set<int>> list = storage->getObjects(containerID, !adir->getRecursive());
+    shared_ptr<unordered_set<int>> list;
+    if (!unchanged)
+        list = storage->getObjects(containerID, !adir->getRecursive());
+    else
+        log_debug("%s is unchanged since the last scan\n", location.c_str());
 
     unsigned int thisTaskID;
     if (task != nullptr) {
@@ -657,33 +714,34 @@ void ContentManager::_rescanDirectory(int containerID, int scanID, ScanMode scan
     } else
         thisTaskID = 0;
 
-    while (((dent = readdir(dir)) != nullptr) && (!shutdownFlag) && (task == nullptr || ((task != nullptr) && task->isValid()))) {
-        char* name = dent->d_name;
-        if (name[0] == '.') {
-            if (name[1] == 0) {
-                continue;
-            } else if (name[1] == '.' && name[2] == 0) {
-                continue;
-            } else if (!adir->getHidden()) {
-                continue;
-            }
-        }
+    for (auto& entry : entries) {
+        if (shutdownFlag || (task != nullptr && !task->isValid()))
+            break;
 
-        path = location + DIR_SEPARATOR + name;
-        ret = stat(path.c_str(), &statbuf);
-        if (ret != 0) {
-            log_error("Failed to stat %s, %s\n", path.c_str(), mt_strerror(errno).c_str());
-            continue;
-        }
+        path = location + DIR_SEPARATOR + entry.name.c_str();
 
         // it is possible that someone hits remove while the container is being scanned
         // in this case we will invalidate the autoscan entry
-        if (adir->getScanID() == INVALID_SCAN_ID) {
-            closedir(dir);
+        if (adir->getScanID() == INVALID_SCAN_ID)
             return;
-        }
 
-        if (S_ISREG(statbuf.st_mode)) {
+        if (entry.isRegular()) {
+            if (unchanged && scanLevel == ScanLevel::Basic)
+                continue;
+
+            // the listing only knows the type of the entry
+            if (!entry.statValid) {
+                if (stat(path.c_str(), &entry.statbuf) != 0) {
+                    log_error("Failed to stat %s, %s\n", path.c_str(), mt_strerror(errno).c_str());
+                    complete = false;
+                    continue;
+                }
+                entry.statValid = true;
+            }
+            statbuf = entry.statbuf;
+            if (unchanged && last_modified_current_max >= statbuf.st_mtime)
+                continue;
+
             int objectID = storage->findObjectIDByPath(String(path));
             if (objectID > 0) {
                 if (list != nullptr)
@@ -696,6 +754,7 @@ void ContentManager::_rescanDirectory(int containerID, int scanID, ScanMode scan
                         // layout
                         removeObject(objectID, false);
                         addFileInternal(path, location, false, false, adir->getHidden());
+                        readded = true;
                         // update time variable
                         last_modified_current_max = statbuf.st_mtime;
                     }
@@ -713,7 +772,7 @@ void ContentManager::_rescanDirectory(int containerID, int scanID, ScanMode scan
                         last_modified_current_max = statbuf.st_mtime;
                 }
             }
-        } else if (S_ISDIR(statbuf.st_mode) && (adir->getRecursive())) {
+        } else if (entry.isDirectory() && (adir->getRecursive())) {
             int objectID = storage->findObjectIDByPath(path + DIR_SEPARATOR);
             if (objectID > 0) {
                 if (list != nullptr)
@@ -730,18 +789,15 @@ void ContentManager::_rescanDirectory(int containerID, int scanID, ScanMode scan
 
                 // it is possible that someone hits remove while the container is being scanned
                 // in this case we will invalidate the autoscan entry
-                if (adir->getScanID() == INVALID_SCAN_ID) {
-                    closedir(dir);
+                if (adir->getScanID() == INVALID_SCAN_ID)
                     return;
-                }
 
                 // add directory, recursive, async, hidden flag, low priority
                 addFileInternal(path, location, true, true, adir->getHidden(), true, thisTaskID, task->isCancellable());
+                complete = false;
             }
         }
-    } // while
-
-    closedir(dir);
+    } // for
 
     if ((shutdownFlag) || ((task != nullptr) && !task->isValid()))
         return;
@@ -754,11 +810,14 @@ void ContentManager::_rescanDirectory(int containerID, int scanID, ScanMode scan
         }
     }
 
+    if (complete && (!unchanged || readded))
+        storage->storeDirectoryFingerprint(containerID, fingerprint);
+
     adir->setCurrentLMT(last_modified_current_max);
 }
 
 /* scans the given directory and adds everything recursively */
-void ContentManager::addRecursive(String path, bool hidden, Ref<GenericTask> task)
+void ContentManager::addRecursive(String path, bool hidden, Ref<GenericTask> task, int importID)
 {
     if (hidden == false) {
         log_debug("Checking path %s\n", path.c_str());
@@ -766,96 +825,87 @@ void ContentManager::addRecursive(String path, bool hidden, Ref<GenericTask> tas
             return;
     }
 
-    Ref<StringConverter> f2i = StringConverter::f2i();
-
-    Ref<UpdateManager> um = UpdateManager::getInstance();
     Ref<Storage> storage = Storage::getInstance();
-    DIR* dir = opendir(path.c_str());
-    if (!dir) {
-        throw _Exception(_("could not list directory ") + path + " : " + strerror(errno));
-    }
-    int parentID = storage->findObjectIDByPath(path + DIR_SEPARATOR);
-    struct dirent* dent;
-    // abort loop if either:
-    // no valid directory returned, server is about to shutdown, the task is there and was invalidated
-    if (task != nullptr) {
-        log_debug("IS TASK VALID? [%d], taskoath: [%s]\n", task->isValid(), path.c_str());
-    }
-    while (((dent = readdir(dir)) != nullptr) && (!shutdownFlag) && (task == nullptr || ((task != nullptr) && task->isValid()))) {
-        char* name = dent->d_name;
-        if (name[0] == '.') {
-            if (name[1] == 0) {
-                continue;
-            } else if (name[1] == '.' && name[2] == 0) {
-                continue;
-            } else if (hidden == false)
-                continue;
+    bool resumed = importJournal->isResumed(importID);
+
+    // the tree is listed on several threads, the objects are created here
+    DirectoryWalker walker(hidden, FS_MASK_FILES);
+    walker.walk(path.c_str(), [&](const std::string& dirPath, std::vector<DirectoryEntry>& entries) {
+        // imported before the restart, the walk still descends into it
+        if (resumed && importJournal->isDone(importID, dirPath))
+            return true;
+
+        String location = (dirPath == FS_ROOT_DIRECTORY) ? _("") : String(dirPath.c_str());
+        int parentID = storage->findObjectIDByPath(location + DIR_SEPARATOR);
+        // abort the walk if either:
+        // the server is about to shutdown, the task is there and was invalidated
+        if (task != nullptr) {
+            log_debug("IS TASK VALID? [%d], taskoath: [%s]\n", task->isValid(), location.c_str());
         }
-        String newPath = path + DIR_SEPARATOR + name;
+        for (auto& entry : entries) {
+            if (shutdownFlag || (task != nullptr && !task->isValid()))
+                return false;
 
-        if (ConfigManager::getInstance()->getConfigFilename() == newPath)
-            continue;
+            String newPath = location + DIR_SEPARATOR + entry.name.c_str();
 
-        // For the Web UI
-        if (task != nullptr) {
-            task->setDescription(_("Importing: ") + newPath);
-        }
+            if (ConfigManager::getInstance()->getConfigFilename() == newPath)
+                continue;
 
-        try {
-            Ref<CdsObject> obj = nullptr;
-            if (parentID > 0)
-                obj = storage->findObjectByPath(String(newPath));
-            if (obj == nullptr) // create object
-            {
-                obj = createObjectFromFile(newPath);
-
-                if (obj == nullptr) // object ignored
+            // For the Web UI
+            if (task != nullptr) {
+                task->setDescription(_("Importing: ") + newPath);
+            }
+
+            try {
+                Ref<CdsObject> obj = nullptr;
+                if (parentID > 0)
+                    obj = storage->findObjectByPath(String(newPath));
+                // the directory was not done before the restart, its items
+                // may have been added without the layout seeing them; the
+                // storage drops the virtual objects that exist already
+                if (obj == nullptr) // create object
                 {
-                    log_warning("file ignored: %s\n", newPath.c_str());
-                } else {
-                    //obj->setParentID(parentID);
-                    if (IS_CDS_ITEM(obj->getObjectType())) {
-                        addObject(obj);
-                        parentID = obj->getParentID();
+                    obj = createObjectFromFile(newPath, entry.statbuf);
+
+                    if (obj == nullptr) // object ignored
+                    {
+                        log_warning("file ignored: %s\n", newPath.c_str());
+                    } else {
+                        //obj->setParentID(parentID);
+                        if (IS_CDS_ITEM(obj->getObjectType())) {
+                            addObject(obj);
+                            parentID = obj->getParentID();
+                        }
                     }
                 }
-            }
-            if (obj != nullptr) {
-                //#ifdef HAVE_JS
-                if (IS_CDS_ITEM(obj->getObjectType())) {
-                    if (layout != nullptr) {
-                        try {
-                            String rootpath = nullptr;
-                            if (task != nullptr)
-                                rootpath = RefCast(task, CMAddFileTask)->getRootPath();
-                            layout->processCdsObject(obj, rootpath);
+                if (obj != nullptr && IS_CDS_ITEM(obj->getObjectType()) && layout != nullptr) {
+                    String rootpath = nullptr;
+                    if (task != nullptr)
+                        rootpath = RefCast(task, CMAddFileTask)->getRootPath();
+                    layout->processCdsObject(obj, rootpath);
 #ifdef HAVE_JS
-                            Ref<Dictionary> mappings = ConfigManager::getInstance()->getDictionaryOption(CFG_IMPORT_MAPPINGS_MIMETYPE_TO_CONTENTTYPE_LIST);
-                            String mimetype = RefCast(obj, CdsItem)->getMimeType();
-                            String content_type = mappings->get(mimetype);
-
-                            if ((playlist_parser_script != nullptr) && (content_type == CONTENT_TYPE_PLAYLIST))
-                                playlist_parser_script->processPlaylistObject(obj, task);
+                    Ref<Dictionary> mappings = ConfigManager::getInstance()->getDictionaryOption(CFG_IMPORT_MAPPINGS_MIMETYPE_TO_CONTENTTYPE_LIST);
+                    String mimetype = RefCast(obj, CdsItem)->getMimeType();
+                    String content_type = mappings->get(mimetype);
 
+                    if ((playlist_parser_scripts != nullptr) && (content_type == CONTENT_TYPE_PLAYLIST))
+                        parsePlaylist(obj, task);
 #endif // JS
-                        } catch (const Exception& e) {
-                            throw e;
-                        }
-                    }
-
-                    /// \todo Why was this statement here??? - It seems to be unnecessary
-                    //obj = createObjectFromFile(newPath);
-                }
-                //#endif
-                if (IS_CDS_CONTAINER(obj->getObjectType())) {
-                    addRecursive(newPath, hidden, task);
                 }
+                // subdirectories are listed by the walker
+            } catch (const Exception& e) {
+                log_warning("skipping %s : %s\n", newPath.c_str(), e.getMessage().c_str());
             }
-        } catch (const Exception& e) {
-            log_warning("skipping %s : %s\n", newPath.c_str(), e.getMessage().c_str());
         }
-    }
-    closedir(dir);
+
+        importJournal->directoryDone(importID, dirPath);
+        if (importJournal->checkpointDue()) {
+            // the objects have to be in the database before the journal says so
+            storage->flushInserts();
+            importJournal->checkpoint();
+        }
+        return true;
+    });
 }
 
 void ContentManager::updateObject(int objectID, Ref<Dictionary> parameters)
@@ -1062,6 +1112,11 @@ void ContentManager::updateObject(Ref<CdsObject> obj, bool send_updates)
         um->containerChanged(obj->getParentID());
         if (IS_CDS_CONTAINER(obj->getObjectType()))
             sm->containerChangedUI(obj->getParentID());
+    } else {
+        // no events, but renderers must still get the current data
+        Ref<CdsResultCache> cache = CdsResultCache::getInstance();
+        cache->invalidate(containerChanged);
+        cache->invalidate(obj->getParentID());
     }
 }
 
@@ -1084,8 +1139,6 @@ Ref<CdsObject> ContentManager::convertObject(Ref<CdsObject> oldObj, int newType)
 // returns nullptr if file ignored due to configuration
 Ref<CdsObject> ContentManager::createObjectFromFile(String path, bool magic, bool allow_fifo)
 {
-    String filename = get_filename(path);
-
     struct stat statbuf;
     int ret;
 
@@ -1094,6 +1147,13 @@ Ref<CdsObject> ContentManager::createObjectFromFile(String path, bool magic, boo
         throw _Exception(_("Failed to stat ") + path + _(" , ") + mt_strerror(errno));
     }
 
+    return createObjectFromFile(path, statbuf, magic, allow_fifo);
+}
+
+Ref<CdsObject> ContentManager::createObjectFromFile(String path, const struct stat& statbuf, bool magic, bool allow_fifo)
+{
+    String filename = get_filename(path);
+
     Ref<CdsObject> obj;
     if (S_ISREG(statbuf.st_mode) || (allow_fifo && S_ISFIFO(statbuf.st_mode))) // item
     {
@@ -1108,6 +1168,9 @@ Ref<CdsObject> ContentManager::createObjectFromFile(String path, bool magic, boo
         if (dotIndex > 0)
             extension = filename.substring(dotIndex + 1);
 
+        // everything below reads the file through this one probe
+        Ref<FileProbe> probe(new FileProbe(path, statbuf));
+
         if (magic)
             mimetype = extension2mimetype(extension);
 
@@ -1115,7 +1178,10 @@ Ref<CdsObject> ContentManager::createObjectFromFile(String path, bool magic, boo
             if (ignore_unknown_extensions)
                 return nullptr; // item should be ignored
 #ifdef HAVE_MAGIC
-            mimetype = get_mime_type(ms, reMimetype, path);
+            if (S_ISREG(statbuf.st_mode))
+                mimetype = get_mime_type_from_buffer(ms, reMimetype, probe->getHead(), probe->getHeadLength());
+            else
+                mimetype = get_mime_type(ms, reMimetype, path);
 #endif
         }
         if (mimetype != nullptr) {
@@ -1125,7 +1191,7 @@ Ref<CdsObject> ContentManager::createObjectFromFile(String path, bool magic, boo
         if (!string_ok(upnp_class)) {
             String content_type = mimetype_contenttype_map->get(mimetype);
             if (content_type == CONTENT_TYPE_OGG) {
-                if (isTheora(path))
+                if (probe->isTheora())
                     upnp_class = _(UPNP_DEFAULT_CLASS_VIDEO_ITEM);
                 else
                     upnp_class = _(UPNP_DEFAULT_CLASS_MUSIC_TRACK);
@@ -1144,7 +1210,7 @@ Ref<CdsObject> ContentManager::createObjectFromFile(String path, bool magic, boo
         Ref<StringConverter> f2i = StringConverter::f2i();
         obj->setTitle(f2i->convert(filename));
         if (magic)
-            MetadataHandler::setMetadata(item);
+            MetadataHandler::setMetadata(item, probe);
     } else if (S_ISDIR(statbuf.st_mode)) {
         Ref<CdsContainer> cont(new CdsContainer());
         obj = RefCast(cont, CdsObject);
@@ -1218,13 +1284,34 @@ void ContentManager::initLayout()
 #ifdef HAVE_JS
 void ContentManager::initJS()
 {
-    if (playlist_parser_script == nullptr)
-        playlist_parser_script = Ref<PlaylistParserScript>(new PlaylistParserScript(Runtime::getInstance()));
+    if (playlist_parser_scripts == nullptr) {
+        int poolSize = ConfigManager::getInstance()->getIntOption(CFG_IMPORT_SCRIPTING_RUNTIME_POOL_SIZE);
+        playlist_parser_scripts = Ref<ScriptPool<PlaylistParserScript>>(new ScriptPool<PlaylistParserScript>(poolSize));
+    }
 }
 
 void ContentManager::destroyJS()
 {
-    playlist_parser_script = nullptr;
+    playlist_parser_scripts = nullptr;
+}
+
+void ContentManager::parsePlaylist(Ref<CdsObject> obj, Ref<GenericTask> task)
+{
+    // a playlist referencing another playlist must not wait for a second
+    // parser while holding one, the pool may be exhausted
+    static thread_local bool parsing = false;
+    if (parsing)
+        throw _Exception(_("recursion not allowed!"));
+
+    parsing = true;
+    try {
+        ScriptPool<PlaylistParserScript>::Borrowed parser(playlist_parser_scripts);
+        parser->processPlaylistObject(obj, task);
+    } catch (...) {
+        parsing = false;
+        throw;
+    }
+    parsing = false;
 }
 
 #endif // HAVE_JS
@@ -1257,6 +1344,7 @@ void ContentManager::threadProc()
             currentTask = task;
         }
         lock.unlock();
+        SessionManager::getInstance()->taskChangedUI();
 
         // log_debug("content manager Async START %s\n", task->getDescription().c_str());
         try {
@@ -1271,6 +1359,7 @@ void ContentManager::threadProc()
         // log_debug("content manager ASYNC STOP  %s\n", task->getDescription().c_str());
 
         if (!shutdownFlag) {
+            SessionManager::getInstance()->taskChangedUI();
             lock.lock();
         }
     }
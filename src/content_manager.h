@@ -34,6 +34,7 @@
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <sys/stat.h>
 #include <unordered_set>
 
 #include "autoscan.h"
@@ -49,6 +50,7 @@
 // vice versa
 class PlaylistParserScript;
 #include "scripting/playlist_parser_script.h"
+#include "scripting/script_pool.h"
 
 #endif
 #include "layout/layout.h"
@@ -63,6 +65,7 @@ class PlaylistParserScript;
 #endif //ONLINE_SERVICES
 
 #include "executor.h"
+#include "import_journal.h"
 
 class CMAddFileTask : public GenericTask {
 protected:
@@ -223,6 +226,12 @@ public:
         bool magic = true,
         bool allow_fifo = false);
 
+    /// \brief Same as above for a file that was stat'ed already.
+    zmm::Ref<CdsObject> createObjectFromFile(zmm::String path,
+        const struct stat& statbuf,
+        bool magic = true,
+        bool allow_fifo = false);
+
 #ifdef ONLINE_SERVICES
     /// \brief Creates a layout based from data that is obtained from an
     /// online service (like YouTube, SopCast, etc.)
@@ -310,6 +319,11 @@ public:
     /// \brief returns an array of all autoscan directories
     zmm::Ref<zmm::Array<AutoscanDirectory>> getAutoscanDirectories();
 
+#ifdef HAVE_INOTIFY
+    /// \brief returns the counters of the inotify event debouncing
+    InotifyEventStatistics getInotifyEventStatistics() { return inotify.getEventStatistics(); }
+#endif
+
     /// \brief instructs ContentManager to reload scripting environment
     void reloadLayout();
 
@@ -340,6 +354,7 @@ protected:
 #ifdef HAVE_JS
     void initJS();
     void destroyJS();
+    void parsePlaylist(zmm::Ref<CdsObject> obj, zmm::Ref<GenericTask> task);
 #endif
 
     zmm::Ref<RExp> reMimetype;
@@ -373,7 +388,7 @@ protected:
 
     void _rescanDirectory(int containerID, int scanID, ScanMode scanMode, ScanLevel scanLevel, zmm::Ref<GenericTask> task = nullptr);
     /* for recursive addition */
-    void addRecursive(zmm::String path, bool hidden, zmm::Ref<GenericTask> task);
+    void addRecursive(zmm::String path, bool hidden, zmm::Ref<GenericTask> task, int importID);
     //void addRecursive2(zmm::Ref<DirCache> dirCache, zmm::String filename, bool recursive);
 
     zmm::String extension2mimetype(zmm::String extension);
@@ -395,7 +410,7 @@ protected:
 #endif //ONLINE_SERVICES
 
 #ifdef HAVE_JS
-    zmm::Ref<PlaylistParserScript> playlist_parser_script;
+    zmm::Ref<ScriptPool<PlaylistParserScript>> playlist_parser_scripts;
 #endif
 
     bool layout_enabled;
@@ -410,6 +425,9 @@ protected:
 
     zmm::Ref<CMAccounting> acct;
 
+    /// \brief progress of recursive imports, to resume them after a restart
+    zmm::Ref<ImportJournal> importJournal;
+
     pthread_t taskThread;
     std::condition_variable_any cond;
 
@@ -34,11 +34,12 @@
 #include "config_manager.h"
 #include "tools.h"
 #include "curl_io_handler.h"
+#include "io_reactor.h"
 
 using namespace zmm;
 using namespace std;
 
-CurlIOHandler::CurlIOHandler(String URL, CURL *curl_handle, size_t bufSize, size_t initialFillSize) : IOHandlerBufferHelper(bufSize, initialFillSize)
+CurlIOHandler::CurlIOHandler(String URL, CURL *curl_handle, size_t bufSize, size_t initialFillSize, off_t startOffset) : IOHandlerBufferHelper(bufSize, initialFillSize)
 {
     if (! string_ok(URL))
         throw _Exception(_("URL has not been set correctly"));
@@ -46,10 +47,14 @@ CurlIOHandler::CurlIOHandler(String URL, CURL *curl_handle, size_t bufSize, size
         throw _Exception(_("bufSize must be at least CURL_MAX_WRITE_SIZE(")+CURL_MAX_WRITE_SIZE+')');
     
     this->URL = URL;
+    this->startOffset = startOffset;
     this->external_curl_handle = (curl_handle != nullptr);
     this->curl_handle = curl_handle;
     //bytesCurl = 0;
+    pausedSize = 0;
     signalAfterEveryRead = true;
+    // the transfer is driven by the curl multi handle of the IOReactor
+    reactorDriven = true;
     
     // still todo:
     // * optimize seek if data already in buffer
@@ -58,29 +63,32 @@ CurlIOHandler::CurlIOHandler(String URL, CURL *curl_handle, size_t bufSize, size
 
 void CurlIOHandler::open(IN enum UpnpOpenFileMode mode)
 {
+    client = HTTPClient::getInstance();
     if (curl_handle == nullptr)
-    {
-        curl_handle = curl_easy_init();
-        if (curl_handle == nullptr)
-            throw _Exception(_("failed to init curl"));
-    }
+        curl_handle = client->getHandle();
     else
+    {
         curl_easy_reset(curl_handle);
+        client->prepareHandle(curl_handle);
+    }
     
     IOHandlerBufferHelper::open(mode);
+    posRead = startOffset;
 }
 
 void CurlIOHandler::close()
 {
     IOHandlerBufferHelper::close();
     
-    if (external_curl_handle && curl_handle != nullptr)
-        curl_easy_cleanup(curl_handle);
+    if (! external_curl_handle && curl_handle != nullptr)
+    {
+        client->returnHandle(curl_handle);
+        curl_handle = nullptr;
+    }
 }
 
-void CurlIOHandler::threadProc()
+void CurlIOHandler::reactorAttach(IOReactor *reactor)
 {
-    CURLcode res;
     assert(curl_handle != nullptr);
     assert(string_ok(URL));
     
@@ -88,9 +96,10 @@ void CurlIOHandler::threadProc()
     //curl_easy_setopt(curl_handle, CURLOPT_ERRORBUFFER, error_buffer);
     
     curl_easy_setopt(curl_handle, CURLOPT_URL, URL.c_str());
-    curl_easy_setopt(curl_handle, CURLOPT_NOSIGNAL, 1);
     curl_easy_setopt(curl_handle, CURLOPT_FOLLOWLOCATION, 1);
     curl_easy_setopt(curl_handle, CURLOPT_MAXREDIRS, -1);
+    if (startOffset > 0)
+        curl_easy_setopt(curl_handle, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)startOffset);
     
     bool logEnabled;
 #ifdef TOMBDEBUG
@@ -108,51 +117,121 @@ void CurlIOHandler::threadProc()
     curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, CurlIOHandler::curlCallback);
     curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *)this);
     
-    unique_lock<std::mutex> lock(mutex, std::defer_lock);
-    do
+    reactor->addCurlHandle(curl_handle, this);
+}
+
+void CurlIOHandler::reactorDetach(IOReactor *reactor)
+{
+    reactor->removeCurlHandle(curl_handle);
+}
+
+void CurlIOHandler::reactorProcess(IOReactor *reactor, bool idle)
+{
+    unique_lock<std::mutex> lock(mutex);
+    if (threadShutdown)
+        return;
+    
+    if (doSeek && ! empty && 
+            (
+                seekWhence == SEEK_SET ||
+                (seekWhence == SEEK_CUR && seekOffset > 0)
+            )
+        )
     {
-        lock.lock();
-        if (doSeek)
-        {
-            log_debug("SEEK: %lld %d\n", seekOffset, seekWhence);
-            
-            if (seekWhence == SEEK_SET)
-            {
-                posRead = seekOffset;
-                curl_easy_setopt(curl_handle, CURLOPT_RESUME_FROM_LARGE, seekOffset);
-            }
-            else if (seekWhence == SEEK_CUR)
-            {
-                posRead += seekOffset;
-                curl_easy_setopt(curl_handle, CURLOPT_RESUME_FROM_LARGE, posRead);
-            }
-            else
+        int currentFillSize = b - a;
+        if (currentFillSize <= 0)
+            currentFillSize += bufSize;
+        
+        int relSeek = seekOffset;
+        if (seekWhence == SEEK_SET)
+            relSeek -= posRead;
+        
+        if (relSeek <= currentFillSize)
+        { // we have everything we need in the buffer already
+            a += relSeek;
+            posRead += relSeek;
+            if (a >= bufSize)
+                a -= bufSize;
+            if (a == b)
             {
-                log_error("CurlIOHandler currently does not support SEEK_END\n");
-                assert(1);
+                empty = true;
+                a = b = 0;
             }
-            
-            /// \todo should we do that?
-            waitForInitialFillSize = (initialFillSize > 0);
+            /// \todo do we need to wait for initialFillSize again?
             
             doSeek = false;
             cond.notify_one();
         }
-        lock.unlock();
-        res = curl_easy_perform(curl_handle);
     }
-    while (doSeek);
     
-    if (res != CURLE_OK)
+    // note: seeking could be optimized some more (backward seeking)
+    // but this should suffice for now
+    
+    if (doSeek)
+    { // seek not been processed yet, restart the transfer at the new position
+        log_debug("SEEK: %lld %d\n", seekOffset, seekWhence);
+        reactor->removeCurlHandle(curl_handle);
+        
+        if (seekWhence == SEEK_SET)
+        {
+            posRead = seekOffset;
+            curl_easy_setopt(curl_handle, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)seekOffset);
+        }
+        else if (seekWhence == SEEK_CUR)
+        {
+            posRead += seekOffset;
+            curl_easy_setopt(curl_handle, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)posRead);
+        }
+        else
+        {
+            log_error("CurlIOHandler currently does not support SEEK_END\n");
+            assert(1);
+        }
+        
+        a = b = 0;
+        empty = true;
+        eof = false;
+        readError = false;
+        pausedSize = 0;
+        
+        /// \todo should we do that?
+        waitForInitialFillSize = (initialFillSize > 0);
+        
+        doSeek = false;
+        cond.notify_one();
+        
+        reactor->addCurlHandle(curl_handle, this);
+        return;
+    }
+    
+    if (pausedSize > 0)
+    {
+        if (empty)
+            a = b = 0;
+        if (getFreeSpace() >= pausedSize)
+        {
+            pausedSize = 0;
+            lock.unlock();
+            // this delivers the held back data to curlCallback right away
+            curl_easy_pause(curl_handle, CURLPAUSE_CONT);
+        }
+    }
+}
+
+void CurlIOHandler::reactorTransferDone(IOReactor *reactor, int result)
+{
+    unique_lock<std::mutex> lock(mutex);
+    if (result != CURLE_OK)
+    {
+        log_debug("transfer of %s failed: %s\n", URL.c_str(), curl_easy_strerror((CURLcode)result));
         readError = true;
+    }
     else
         eof = true;
     
     cond.notify_one();
 }
 
-
-
 size_t CurlIOHandler::curlCallback(void *ptr, size_t size, size_t nmemb, void *data)
 {
     auto * ego = (CurlIOHandler *) data;
@@ -164,83 +243,21 @@ size_t CurlIOHandler::curlCallback(void *ptr, size_t size, size_t nmemb, void *d
     
     unique_lock<std::mutex> lock(ego->mutex);
     
-    bool first = true;
+    if (ego->threadShutdown)
+        return 0;
     
-    int bufFree = 0;
-    do
+    if (ego->empty)
+        ego->a = ego->b = 0;
+    
+    if (ego->getFreeSpace() < wantWrite)
     {
-        if (ego->doSeek && ! ego->empty && 
-                (
-                    ego->seekWhence == SEEK_SET ||
-                    (ego->seekWhence == SEEK_CUR && ego->seekOffset > 0)
-                )
-            )
-        {
-            int currentFillSize = ego->b - ego->a;
-            if (currentFillSize <= 0)
-                currentFillSize += ego->bufSize;
-            
-            int relSeek = ego->seekOffset;
-            if (ego->seekWhence == SEEK_SET)
-                relSeek -= ego->posRead;
-            
-            if (relSeek <= currentFillSize)
-            { // we have everything we need in the buffer already
-                ego->a += relSeek;
-                ego->posRead += relSeek;
-                if (ego->a >= ego->bufSize)
-                    ego->a -= ego->bufSize;
-                if (ego->a == ego->b)
-                {
-                    ego->empty = true;
-                    ego->a = ego->b = 0;
-                }
-                /// \todo do we need to wait for initialFillSize again?
-            
-                ego->doSeek = false;
-                ego->cond.notify_one();
-            }
-        }
-        
-        // note: seeking could be optimized some more (backward seeking)
-        // but this should suffice for now
-        
-        if (ego->doSeek)
-        { // seek not been processed yet
-            ego->a = ego->b = 0;
-            ego->empty = true;
-            
-            // terminate this request, because we need a new request
-            // after the seek
-            return 0;
-        }
-        
-        if (! first)
-        {
-            ego->cond.wait(lock);
-        }
-        else
-            first = false;
-        
-        if (ego->threadShutdown)
-            return 0;
-        
-        if (ego->empty)
-        {
-            ego->a = ego->b = 0;
-            bufFree = ego->bufSize;
-        }
-        else
-        {
-            bufFree = ego->a - ego->b;
-            if (bufFree < 0)
-                bufFree += ego->bufSize;
-        }
+        // curl keeps the data for us, the reactor resumes the transfer
+        // once the reader made enough room
+        ego->pausedSize = wantWrite;
+        return CURL_WRITEFUNC_PAUSE;
     }
-    while ((size_t)bufFree < wantWrite);
-    
     
-    size_t maxWrite = (ego->empty ? ego->bufSize : (ego->a < ego->b ? ego->bufSize - ego->b : ego->a - ego->b));
+    size_t maxWrite = ego->getContiguousFreeSpace();
     size_t write1 = (wantWrite > maxWrite ? maxWrite : wantWrite);
     size_t write2 = (write1 < wantWrite ? wantWrite - write1 : 0);
     
@@ -255,26 +272,7 @@ size_t CurlIOHandler::curlCallback(void *ptr, size_t size, size_t nmemb, void *d
     lock.lock();
     
     //ego->bytesCurl += wantWrite;
-    ego->b += wantWrite;
-    if (ego->b >= ego->bufSize)
-        ego->b -= ego->bufSize;
-    if (ego->empty)
-    {
-        ego->empty = false;
-        ego->cond.notify_one();
-    }
-    if (ego->waitForInitialFillSize)
-    {
-        int currentFillSize = ego->b - ego->a;
-        if (currentFillSize <= 0)
-            currentFillSize += ego->bufSize;
-        if ((size_t)currentFillSize >= ego->initialFillSize)
-        {
-            log_debug("buffer: initial fillsize reached\n");
-            ego->waitForInitialFillSize = false;
-            ego->cond.notify_one();
-        }
-    }
+    ego->commitWrite(wantWrite);
     
     return wantWrite;
 }
@@ -38,25 +38,37 @@
 #include <upnp.h>
 
 #include "common.h"
+#include "http_client.h"
 #include "io_handler_buffer_helper.h"
 
 class CurlIOHandler : public IOHandlerBufferHelper
 {
 public:
     
-    CurlIOHandler(zmm::String URL, CURL *curl_handle, size_t bufSize, size_t initialFillSize);
+    /// \param startOffset the transfer starts at this byte of the resource
+    CurlIOHandler(zmm::String URL, CURL *curl_handle, size_t bufSize, size_t initialFillSize, off_t startOffset = 0);
     
     virtual void open(enum UpnpOpenFileMode mode);
     virtual void close();
     
 private:
+    zmm::Ref<HTTPClient> client;
     CURL *curl_handle;
     bool external_curl_handle;
     zmm::String URL;
+    off_t startOffset;
     //off_t bytesCurl;
     
+    /// \brief size of the chunk curl holds back while the transfer is
+    /// paused because the buffer is full, 0 if not paused
+    size_t pausedSize;
+    
     static size_t curlCallback(void *ptr, size_t size, size_t nmemb, void *stream);
-    virtual void threadProc();
+    
+    virtual void reactorAttach(IOReactor *reactor);
+    virtual void reactorDetach(IOReactor *reactor);
+    virtual void reactorProcess(IOReactor *reactor, bool idle);
+    virtual void reactorTransferDone(IOReactor *reactor, int result);
 };
 
 #endif // __CURL_IO_HANDLER_H__
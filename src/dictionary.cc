@@ -194,6 +194,100 @@ void Dictionary::decodeSimple(String url)
     while (last_pos < url.length());
 }
 
+// numbers end with ';', strings are prefixed with their length and ':'
+String Dictionary::encodeCompact()
+{
+    std::ostringstream buf;
+    buf << COMPACT_ENCODING_PREFIX;
+    appendCompact(buf);
+    return buf.str();
+}
+
+void Dictionary::decodeCompact(String data)
+{
+    if (data == nullptr)
+        return;
+
+    if (!data.startsWith(_(COMPACT_ENCODING_PREFIX)))
+    {
+        decode(data);
+        return;
+    }
+
+    size_t pos = COMPACT_ENCODING_PREFIX_LENGTH;
+    if (!readCompact(data.c_str(), data.length(), pos))
+        throw _Exception(_("Dictionary::decodeCompact: malformed data"));
+}
+
+void Dictionary::appendCompact(std::ostringstream &buf)
+{
+    int len = elements->size();
+    appendCompactNumber(buf, len);
+    for (int i = 0; i < len; i++)
+    {
+        Ref<DictionaryElement> el = elements->get(i);
+        String key = el->getKey();
+        String value = el->getValue();
+        buf << key.length() << ':';
+        buf.write(key.c_str(), key.length());
+        buf << value.length() << ':';
+        buf.write(value.c_str(), value.length());
+    }
+}
+
+static bool readCompactString(const char *data, size_t length, size_t &pos, String &str)
+{
+    size_t strLength = 0;
+    while (pos < length && data[pos] >= '0' && data[pos] <= '9')
+        strLength = strLength * 10 + (data[pos++] - '0');
+    if (pos >= length || data[pos] != ':' || length - pos - 1 < strLength)
+        return false;
+    pos++;
+    str = String(data + pos, strLength);
+    pos += strLength;
+    return true;
+}
+
+bool Dictionary::readCompact(const char *data, size_t length, size_t &pos)
+{
+    int count;
+    if (!readCompactNumber(data, length, pos, count) || count < 0)
+        return false;
+    for (int i = 0; i < count; i++)
+    {
+        String key;
+        String value;
+        if (!readCompactString(data, length, pos, key) ||
+            !readCompactString(data, length, pos, value))
+            return false;
+        // keys were unique when they were written, no need to look them up
+        elements->append(Ref<DictionaryElement>(new DictionaryElement(key, value)));
+    }
+    return true;
+}
+
+void Dictionary::appendCompactNumber(std::ostringstream &buf, int number)
+{
+    buf << number << ';';
+}
+
+bool Dictionary::readCompactNumber(const char *data, size_t length, size_t &pos, int &number)
+{
+    bool negative = (pos < length && data[pos] == '-');
+    if (negative)
+        pos++;
+    size_t start = pos;
+    number = 0;
+    while (pos < length && data[pos] >= '0' && data[pos] <= '9')
+        number = number * 10 + (data[pos++] - '0');
+    if (pos == start || pos >= length || data[pos] != ';')
+        return false;
+    pos++;
+    if (negative)
+        number = -number;
+    return true;
+}
+
 void Dictionary::clear()
 {
     elements->remove(0, elements->size());
@@ -33,8 +33,15 @@
 #define __DICTIONARY_H__
 
 #include <mutex>
+#include <sstream>
 #include "zmm/zmmf.h"
 
+/// \brief Marks data in the compact encoding, followed by the version of it.
+///
+/// The url encoding escapes '!', so old data never starts with it.
+#define COMPACT_ENCODING_PREFIX "!1"
+#define COMPACT_ENCODING_PREFIX_LENGTH 2
+
 /// \brief This class should never be used directly, it is being used by the Dictionary class.
 class DictionaryElement : public zmm::Object
 {
@@ -102,6 +109,27 @@ public:
     /// \brief Makes a dictionary out of simplified url encoded data.
     void decodeSimple(zmm::String url);
 
+    /// \brief Returns the dictionary in the compact encoding used in the
+    /// database.
+    ///
+    /// Keys and values are written with their length in front, so neither
+    /// writing nor reading them needs any escaping.
+    zmm::String encodeCompact();
+
+    /// \brief Makes a dictionary out of compact or url encoded data.
+    void decodeCompact(zmm::String data);
+
+    /// \brief Appends the elements in the compact encoding, without prefix.
+    void appendCompact(std::ostringstream& buf);
+
+    /// \brief Reads elements written by appendCompact().
+    /// \param pos position in data, moved behind the elements
+    /// \return false if the data is malformed
+    bool readCompact(const char* data, size_t length, size_t& pos);
+
+    static void appendCompactNumber(std::ostringstream& buf, int number);
+    static bool readCompactNumber(const char* data, size_t length, size_t& pos, int& number);
+
     /// \brief Makes a shallow copy of the dictionary
     zmm::Ref<Dictionary> clone();
 
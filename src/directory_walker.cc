@@ -0,0 +1,208 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    directory_walker.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file directory_walker.cc
+
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "directory_walker.h"
+#include "tools.h"
+
+using namespace zmm;
+
+DirectoryWalker::DirectoryWalker(bool hidden, int statMask)
+    : hidden(hidden)
+    , statMask(statMask)
+    , busyThreads(0)
+    , stopped(false)
+{
+}
+
+DirectoryWalker::~DirectoryWalker()
+{
+    stop();
+}
+
+void DirectoryWalker::readDirectory(const std::string& path, std::vector<DirectoryEntry>& entries, struct stat* dirStat)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    DIR* dir = (fd < 0) ? nullptr : fdopendir(fd);
+    if (dir == nullptr) {
+        String error = mt_strerror(errno);
+        if (fd >= 0)
+            close(fd);
+        throw _Exception(_("could not list directory ") + path.c_str() + " : " + error);
+    }
+    if (dirStat != nullptr && fstat(fd, dirStat) != 0) {
+        String error = mt_strerror(errno);
+        closedir(dir);
+        throw _Exception(_("could not stat directory ") + path.c_str() + " : " + error);
+    }
+
+    struct dirent* dent;
+    while ((dent = readdir(dir)) != nullptr) {
+        char* name = dent->d_name;
+        if (name[0] == '.') {
+            if (name[1] == 0) {
+                continue;
+            } else if (name[1] == '.' && name[2] == 0) {
+                continue;
+            } else if (!hidden) {
+                continue;
+            }
+        }
+
+        DirectoryEntry entry;
+        entry.name = name;
+        memset(&entry.statbuf, 0, sizeof(entry.statbuf));
+        entry.statValid = false;
+
+        // the type from readdir() saves the stat if that is all we need,
+        // symlinks and filesystems that do not report types are stat'ed
+        bool needStat = true;
+        if (dent->d_type == DT_REG) {
+            entry.statbuf.st_mode = S_IFREG;
+            needStat = (statMask & FS_MASK_FILES);
+        } else if (dent->d_type == DT_DIR) {
+            entry.statbuf.st_mode = S_IFDIR;
+            needStat = (statMask & FS_MASK_DIRECTORIES);
+        } else if (dent->d_type != DT_UNKNOWN && dent->d_type != DT_LNK) {
+            continue; // special file
+        }
+
+        if (needStat) {
+            if (fstatat(fd, name, &entry.statbuf, 0) != 0) {
+                log_debug("Failed to stat %s/%s, %s\n", path.c_str(), name, mt_strerror(errno).c_str());
+                continue;
+            }
+            entry.statValid = true;
+            if (!entry.isRegular() && !entry.isDirectory())
+                continue; // special file
+        }
+
+        entries.push_back(entry);
+    }
+    closedir(dir);
+}
+
+void DirectoryWalker::walk(const std::string& path, Visitor visitor)
+{
+    // the start directory is listed right here so that errors reach the caller
+    Listing first;
+    first.path = path;
+    readDirectory(path, first.entries);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    stopped = false;
+    busyThreads = 0;
+    pendingDirectories.clear();
+    listings.clear();
+    queueSubdirectories(path, first.entries);
+    listings.push_back(std::move(first));
+    if (!pendingDirectories.empty()) {
+        for (int i = 0; i < DIRECTORY_WALKER_THREADS; i++)
+            threads.emplace_back(&DirectoryWalker::work, this);
+    }
+
+    while (true) {
+        while (listings.empty() && (busyThreads > 0 || !pendingDirectories.empty()))
+            listingCond.wait(lock);
+        if (listings.empty())
+            break;
+
+        Listing listing = std::move(listings.front());
+        listings.pop_front();
+        workCond.notify_one();
+
+        lock.unlock();
+        bool proceed = visitor(listing.path, listing.entries);
+        lock.lock();
+        if (!proceed)
+            break;
+    }
+
+    lock.unlock();
+    stop();
+}
+
+void DirectoryWalker::work()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        while (!stopped && (pendingDirectories.empty() || listings.size() >= DIRECTORY_WALKER_MAX_PENDING_LISTINGS))
+            workCond.wait(lock);
+        if (stopped)
+            return;
+
+        Listing listing;
+        listing.path = std::move(pendingDirectories.back());
+        pendingDirectories.pop_back();
+        busyThreads++;
+        lock.unlock();
+
+        bool listed = true;
+        try {
+            readDirectory(listing.path, listing.entries);
+        } catch (const Exception& e) {
+            log_warning("skipping %s : %s\n", listing.path.c_str(), e.getMessage().c_str());
+            listed = false;
+        }
+
+        lock.lock();
+        busyThreads--;
+        if (listed) {
+            queueSubdirectories(listing.path, listing.entries);
+            listings.push_back(std::move(listing));
+            workCond.notify_all();
+        }
+        listingCond.notify_one();
+    }
+}
+
+void DirectoryWalker::queueSubdirectories(const std::string& path, const std::vector<DirectoryEntry>& entries)
+{
+    for (const auto& entry : entries) {
+        if (!entry.isDirectory())
+            continue;
+        if (path == FS_ROOT_DIRECTORY)
+            pendingDirectories.push_back(path + entry.name);
+        else
+            pendingDirectories.push_back(path + DIR_SEPARATOR + entry.name);
+    }
+}
+
+void DirectoryWalker::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+        workCond.notify_all();
+    }
+    for (auto& thread : threads)
+        thread.join();
+    threads.clear();
+}
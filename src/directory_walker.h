@@ -0,0 +1,121 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    directory_walker.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file directory_walker.h
+/// \brief Definition of the DirectoryWalker class.
+
+#ifndef __DIRECTORY_WALKER_H__
+#define __DIRECTORY_WALKER_H__
+
+#include <sys/stat.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+#include "filesystem.h"
+
+/// \brief number of threads listing directories during a walk
+#define DIRECTORY_WALKER_THREADS 4
+
+/// \brief listings a walk keeps ready before the threads wait for the visitor
+#define DIRECTORY_WALKER_MAX_PENDING_LISTINGS 16
+
+struct DirectoryEntry
+{
+    std::string name;
+
+    /// \brief only st_mode is filled in for entries which were not stat'ed
+    struct stat statbuf;
+    bool statValid;
+
+    bool isDirectory() const { return S_ISDIR(statbuf.st_mode); }
+    bool isRegular() const { return S_ISREG(statbuf.st_mode); }
+};
+
+/// \brief Lists directories with as few round trips to the filesystem as
+/// possible, which matters most on network mounts.
+///
+/// The type reported by readdir() is used where it is enough, the other
+/// entries are stat'ed relative to the directory fd. A walk lists the
+/// subdirectories of a tree on several threads, the listings are handed to
+/// the visitor on the calling thread.
+class DirectoryWalker
+{
+public:
+    /// \brief Called for every listed directory, returning false stops the walk.
+    typedef std::function<bool(const std::string &path, std::vector<DirectoryEntry> &entries)> Visitor;
+
+    /// \param hidden also list entries starting with a dot
+    /// \param statMask FS_MASK_FILES and/or FS_MASK_DIRECTORIES, which
+    /// entries need the full stat information
+    DirectoryWalker(bool hidden, int statMask);
+    ~DirectoryWalker();
+    DirectoryWalker(const DirectoryWalker &) = delete;
+    DirectoryWalker &operator=(const DirectoryWalker &) = delete;
+
+    /// \brief Lists a single directory, symlinks are followed.
+    ///
+    /// Entries which are neither regular files nor directories are left out.
+    /// Throws if the directory can not be opened.
+    /// \param dirStat if given, receives the stat of the directory itself
+    void readDirectory(const std::string &path, std::vector<DirectoryEntry> &entries, struct stat *dirStat = nullptr);
+
+    /// \brief Visits the given directory and all directories below it.
+    ///
+    /// Directories are visited in no particular order. Throws if the start
+    /// directory can not be listed, directories below it that can not be
+    /// listed are skipped.
+    void walk(const std::string &path, Visitor visitor);
+
+protected:
+    struct Listing
+    {
+        std::string path;
+        std::vector<DirectoryEntry> entries;
+    };
+
+    bool hidden;
+    int statMask;
+
+    std::mutex mutex;
+    std::condition_variable workCond;
+    std::condition_variable listingCond;
+    /// \brief directories waiting to be listed, taken from the back so that
+    /// the walk stays close to the directories listed last
+    std::vector<std::string> pendingDirectories;
+    std::deque<Listing> listings;
+    int busyThreads;
+    bool stopped;
+    std::vector<std::thread> threads;
+
+    void work();
+    void queueSubdirectories(const std::string &path, const std::vector<DirectoryEntry> &entries);
+    void stop();
+};
+
+#endif // __DIRECTORY_WALKER_H__
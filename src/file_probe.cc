@@ -0,0 +1,229 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    file_probe.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file file_probe.cc
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "file_probe.h"
+#include "memory.h"
+#include "tools.h"
+
+using namespace zmm;
+
+FileProbe::FileProbe(String path)
+    : path(path)
+    , fd(-1)
+    , head(nullptr)
+    , headLength(0)
+    , tail(nullptr)
+    , tailLength(0)
+    , tailOffset(0)
+    , mapping(nullptr)
+{
+    if (stat(path.c_str(), &statbuf) != 0)
+        throw _Exception(mt_strerror(errno) + ": " + path);
+    if (S_ISDIR(statbuf.st_mode))
+        throw _Exception(_("Not a file: ") + path);
+}
+
+FileProbe::FileProbe(String path, const struct stat& statbuf)
+    : path(path)
+    , statbuf(statbuf)
+    , fd(-1)
+    , head(nullptr)
+    , headLength(0)
+    , tail(nullptr)
+    , tailLength(0)
+    , tailOffset(0)
+    , mapping(nullptr)
+{
+}
+
+FileProbe::~FileProbe()
+{
+    if (mapping != nullptr)
+        munmap(mapping, statbuf.st_size);
+    if (head != nullptr)
+        FREE(head);
+    if (tail != nullptr)
+        FREE(tail);
+    if (fd >= 0)
+        close(fd);
+}
+
+void FileProbe::open()
+{
+    if (fd >= 0)
+        return;
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw _Exception(_("Error opening ") + path + _(" : ") + mt_strerror(errno));
+}
+
+int FileProbe::getFd()
+{
+    open();
+    return fd;
+}
+
+size_t FileProbe::readFile(off_t offset, char* buffer, size_t length)
+{
+    open();
+    size_t done = 0;
+    while (done < length) {
+        ssize_t bytes = pread(fd, buffer + done, length - done, offset + done);
+        if (bytes < 0) {
+            if (errno == EINTR)
+                continue;
+            throw _Exception(_("Error reading ") + path + _(" : ") + mt_strerror(errno));
+        }
+        if (bytes == 0)
+            break;
+        done += bytes;
+    }
+    return done;
+}
+
+void FileProbe::loadHead()
+{
+    if (head != nullptr)
+        return;
+    size_t length = FILE_PROBE_HEAD_SIZE;
+    if (S_ISREG(statbuf.st_mode) && statbuf.st_size < (off_t)length)
+        length = statbuf.st_size;
+    head = (char*)MALLOC(length + 1);
+    headLength = readFile(0, head, length);
+}
+
+void FileProbe::loadTail()
+{
+    if (tail != nullptr)
+        return;
+    // the part of the file that the head already holds is not read again
+    tailOffset = statbuf.st_size - FILE_PROBE_TAIL_SIZE;
+    if (tailOffset < FILE_PROBE_HEAD_SIZE)
+        tailOffset = FILE_PROBE_HEAD_SIZE;
+    size_t length = 0;
+    if (statbuf.st_size > tailOffset)
+        length = statbuf.st_size - tailOffset;
+    tail = (char*)MALLOC(length + 1);
+    tailLength = readFile(tailOffset, tail, length);
+}
+
+size_t FileProbe::read(off_t offset, void* buffer, size_t length)
+{
+    if (length == 0)
+        return 0;
+
+    if (offset < FILE_PROBE_HEAD_SIZE) {
+        loadHead();
+        if (offset + length <= headLength || headLength < FILE_PROBE_HEAD_SIZE) {
+            size_t available = (offset < (off_t)headLength) ? headLength - offset : 0;
+            if (length > available)
+                length = available;
+            memcpy(buffer, head + offset, length);
+            return length;
+        }
+    } else if (S_ISREG(statbuf.st_mode) && offset >= statbuf.st_size - FILE_PROBE_TAIL_SIZE) {
+        loadTail();
+        if (offset >= tailOffset) {
+            size_t available = (offset < tailOffset + (off_t)tailLength) ? tailOffset + tailLength - offset : 0;
+            if (length > available)
+                length = available;
+            memcpy(buffer, tail + (offset - tailOffset), length);
+            return length;
+        }
+    }
+
+    return readFile(offset, (char*)buffer, length);
+}
+
+const char* FileProbe::getHead()
+{
+    loadHead();
+    return head;
+}
+
+size_t FileProbe::getHeadLength()
+{
+    loadHead();
+    return headLength;
+}
+
+const char* FileProbe::map()
+{
+    if (mapping != nullptr)
+        return mapping;
+    if (!S_ISREG(statbuf.st_mode) || statbuf.st_size == 0)
+        return nullptr;
+
+    open();
+    void* address = mmap(nullptr, statbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED) {
+        log_debug("Could not map %s: %s\n", path.c_str(), mt_strerror(errno).c_str());
+        return nullptr;
+    }
+    mapping = (char*)address;
+    return mapping;
+}
+
+bool FileProbe::isTheora()
+{
+    const char* buffer = getHead();
+    if (headLength < 4)
+        throw _Exception(_("Error reading ") + path);
+
+    if (memcmp(buffer, "OggS", 4) != 0)
+        return false;
+
+    if (headLength < 28 + 7)
+        throw _Exception(_("Incomplete file ") + path);
+
+    return memcmp(buffer + 28, "\x80theora", 7) == 0;
+}
+
+String FileProbe::getAVIFourCC()
+{
+#define FCC_OFFSET 0xbc
+    const char* buffer = getHead();
+    if (headLength < FCC_OFFSET + 4)
+        throw _Exception(_("could not read header of ") + path);
+
+    if (strncmp(buffer, "RIFF", 4) != 0)
+        return nullptr;
+
+    if (strncmp(buffer + 8, "AVI ", 4) != 0)
+        return nullptr;
+
+    String fourcc = String(buffer + FCC_OFFSET, 4);
+
+    if (string_ok(fourcc))
+        return fourcc;
+    else
+        return nullptr;
+}
@@ -0,0 +1,107 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    file_probe.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file file_probe.h
+/// \brief Definition of the FileProbe class.
+
+#ifndef __FILE_PROBE_H__
+#define __FILE_PROBE_H__
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "zmm/zmmf.h"
+
+/// \brief bytes read at once from the start of the file, covers the
+/// headers the import looks at and most ID3v2 tags without cover art
+#define FILE_PROBE_HEAD_SIZE 65536
+
+/// \brief bytes read at once from the end of the file, covers ID3v1,
+/// APE and Lyrics3 tags
+#define FILE_PROBE_TAIL_SIZE 8192
+
+/// \brief One file opened once for the whole import of it.
+///
+/// The mime type detection, the theora and fourcc checks and the metadata
+/// handlers all read through the probe instead of opening the file on
+/// their own. The start and the end of the file, where the headers and
+/// tags live, are read once with a single pread() each and served from
+/// memory afterwards. The file is only opened when something reads it.
+class FileProbe : public zmm::Object {
+public:
+    /// \brief Probes the file, throws if it can not be stat'ed.
+    explicit FileProbe(zmm::String path);
+
+    /// \brief Probes a file that was stat'ed already.
+    FileProbe(zmm::String path, const struct stat& statbuf);
+
+    virtual ~FileProbe();
+
+    zmm::String getPath() { return path; }
+    off_t getSize() { return statbuf.st_size; }
+    const struct stat& getStat() { return statbuf; }
+
+    /// \brief Descriptor of the opened file, for libraries that need one.
+    int getFd();
+
+    /// \brief Reads from the file without moving any file position.
+    /// \return number of bytes read, less than length at the end of the file
+    size_t read(off_t offset, void* buffer, size_t length);
+
+    /// \brief The start of the file, at most FILE_PROBE_HEAD_SIZE bytes.
+    const char* getHead();
+    size_t getHeadLength();
+
+    /// \brief Maps the whole file read-only.
+    /// \return nullptr if the file can not be mapped
+    const char* map();
+
+    /// \brief Determines if the ogg file contains a video (theora).
+    bool isTheora();
+
+    /// \brief Retrieves the fourcc of the video stream of an AVI file.
+    ///
+    /// This code is based on offsets, so we will use it only if ffmpeg is
+    /// not available.
+    zmm::String getAVIFourCC();
+
+protected:
+    zmm::String path;
+    struct stat statbuf;
+    int fd;
+
+    char* head;
+    size_t headLength;
+    char* tail;
+    size_t tailLength;
+    off_t tailOffset;
+
+    char* mapping;
+
+    void open();
+    void loadHead();
+    void loadTail();
+    size_t readFile(off_t offset, char* buffer, size_t length);
+};
+
+#endif // __FILE_PROBE_H__
@@ -31,11 +31,11 @@
 
 #include <sys/stat.h>
 
-#include "file_io_handler.h"
 #include "file_request_handler.h"
 #include "metadata_handler.h"
 #include "play_hook.h"
 #include "process.h"
+#include "read_ahead_io_handler.h"
 #include "server.h"
 #include "session_manager.h"
 #include "update_manager.h"
@@ -526,11 +526,11 @@ Ref<IOHandler> FileRequestHandler::open(IN const char* filename,
                 info->http_header = ixmlCloneDOMString(header.c_str());
             */
 
-            Ref<IOHandler> io_handler(new FileIOHandler(path));
+            Ref<IOHandler> io_handler = ReadAheadIOHandler::create(path);
             io_handler->open(mode);
-            PlayHook::getInstance()->trigger(obj);
             log_debug("end\n");
-            return io_handler;
+            // the offset the client stops at is where it can resume
+            return PlayHook::getInstance()->trigger(obj, io_handler);
         }
     }
 }
@@ -36,6 +36,7 @@
 #include "common.h"
 #include "config_manager.h"
 #include "content_manager.h"
+#include "directory_walker.h"
 #include "filesystem.h"
 #include "mxml/mxml.h"
 #include "tools.h"
@@ -102,55 +103,30 @@ Ref<Array<FsObject> > Filesystem::readDirectory(String path, int mask,
     if (! fileAllowed(path))
         throw _Exception(_("Filesystem: file blocked: ") + path);
 
-    struct stat statbuf;
-    int ret;
-
     Ref<Array<FsObject> > files(new Array<FsObject>());
 
-    DIR *dir;
-    struct dirent *dent;
-
-    dir = opendir(path.c_str());
-    if (! dir)
-    {
-        throw _Exception(_("could not list directory ") +
-                        path + " : " + strerror(errno));
-    }
+    // the type of the entries is all we need
+    DirectoryWalker walker(mask & FS_MASK_HIDDEN, 0);
+    std::vector<DirectoryEntry> entries;
+    walker.readDirectory(path.c_str(), entries);
 
-    while ((dent = readdir(dir)) != nullptr)
+    for (const auto& entry : entries)
     {
-        char *name = dent->d_name;
-        if (name[0] == '.')
-        {
-            if (name[1] == 0)
-            {
-                continue;
-            }
-            else if (name[1] == '.' && name[2] == 0)
-            {
-                continue;
-            }
-            else if (!(mask & FS_MASK_HIDDEN))
-                continue;
-        }
         String childPath;
         if (path == FS_ROOT_DIRECTORY)
-            childPath = path + name;
+            childPath = path + entry.name.c_str();
         else
-            childPath = path + "/" + name;
+            childPath = path + "/" + entry.name.c_str();
         if (fileAllowed(childPath))
         {
             bool isDirectory = false;
             bool hasContent = false;
-            ret = stat(childPath.c_str(), &statbuf);
-            if (ret != 0)
-                continue;
-            if (S_ISREG(statbuf.st_mode))
+            if (entry.isRegular())
             {
                 if (! (mask & FS_MASK_FILES))
                     continue;
             }
-            else if (S_ISDIR(statbuf.st_mode))
+            else
             {
                 if (! (mask & FS_MASK_DIRECTORIES))
                     continue;
@@ -167,17 +143,14 @@ Ref<Array<FsObject> > Filesystem::readDirectory(String path, int mask,
                     }
                 }
             }
-            else
-                continue; // special file
             
             Ref<FsObject> obj(new FsObject());
-            obj->filename = name;
+            obj->filename = entry.name.c_str();
             obj->isDirectory = isDirectory;
             obj->hasContent = hasContent;
             files->append(obj);
         }
     }
-    closedir(dir);
 
     quicksort((COMPARABLE *)files->getObjectArray(), files->size(),
               FsObjectComparator);
@@ -197,64 +170,26 @@ bool Filesystem::have(String path, int mask)
     if (! fileAllowed(path))
         return false;
 
-    struct stat statbuf;
-    int ret;
-
-    Ref<Array<FsObject> > files(new Array<FsObject>());
-
-    DIR *dir;
-    struct dirent *dent;
+    DirectoryWalker walker(mask & FS_MASK_HIDDEN, 0);
+    std::vector<DirectoryEntry> entries;
+    walker.readDirectory(path.c_str(), entries);
 
-    dir = opendir(path.c_str());
-    if (! dir)
+    for (const auto& entry : entries)
     {
-        throw _Exception(_("could not list directory ")+
-                        path + " : " + strerror(errno));
-    }
-
-    bool result = false;
-    while ((dent = readdir(dir)) != nullptr)
-    {
-        char *name = dent->d_name;
-        if (name[0] == '.')
-        {
-            if (name[1] == 0)
-            {
-                continue;
-            }
-            else if (name[1] == '.' && name[2] == 0)
-            {
-                continue;
-            }            
-            else if (!(mask & FS_MASK_HIDDEN))
-                continue;
-        }
         String childPath;
         if (path == FS_ROOT_DIRECTORY)
-            childPath = path + name;
+            childPath = path + entry.name.c_str();
         else
-            childPath = path + "/" + name;
+            childPath = path + "/" + entry.name.c_str();
         if (fileAllowed(childPath))
         {
-            ret = stat(childPath.c_str(), &statbuf);
-            if (ret != 0)
-                continue;
-            if (S_ISREG(statbuf.st_mode) && mask & FS_MASK_FILES)
-            {
-                result = true;
-                break;
-            }
-            else if (S_ISDIR(statbuf.st_mode) && mask & FS_MASK_DIRECTORIES)
-            {
-                result = true;
-                break;
-            }
-            else
-                continue; // special file
+            if (entry.isRegular() && mask & FS_MASK_FILES)
+                return true;
+            else if (entry.isDirectory() && mask & FS_MASK_DIRECTORIES)
+                return true;
         }
     }
-    closedir(dir);
-    return result;
+    return false;
 }
 
 bool Filesystem::haveFiles(String dir)
@@ -0,0 +1,218 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    http_client.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+
+/// \file http_client.cc
+
+#ifdef HAVE_CURL
+
+#include <algorithm>
+#include <cctype>
+
+#include "config_manager.h"
+#include "http_client.h"
+
+using namespace zmm;
+using namespace std;
+
+HTTPClient::HTTPClient()
+    : Singleton<HTTPClient>()
+    , share(nullptr)
+    , shutdownFlag(false)
+    , hostConnections(0)
+    , statistics()
+{
+}
+
+HTTPClient::~HTTPClient()
+{
+    for (auto handle : idleHandles)
+        curl_easy_cleanup(handle);
+    if (share != nullptr)
+        curl_share_cleanup(share);
+}
+
+void HTTPClient::init()
+{
+    start(ConfigManager::getInstance()->getIntOption(CFG_SERVER_HTTP_CLIENT_HOST_CONNECTIONS));
+}
+
+void HTTPClient::start(int hostConnections)
+{
+    this->hostConnections = hostConnections;
+    share = curl_share_init();
+    if (share == nullptr)
+        throw _Exception(_("HTTPClient: failed to initialize curl share handle"));
+    curl_share_setopt(share, CURLSHOPT_LOCKFUNC, HTTPClient::lockShare);
+    curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, HTTPClient::unlockShare);
+    curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+}
+
+void HTTPClient::shutdown()
+{
+    AutoLock lock(mutex);
+    shutdownFlag = true;
+    for (auto handle : idleHandles)
+        curl_easy_cleanup(handle);
+    idleHandles.clear();
+    // handles that are still out keep the share alive until they are back
+    hostCond.notify_all();
+}
+
+CURL *HTTPClient::getHandle()
+{
+    CURL *handle = nullptr;
+    {
+        AutoLock lock(mutex);
+        if (!idleHandles.empty()) {
+            handle = idleHandles.back();
+            idleHandles.pop_back();
+        }
+    }
+
+    if (handle == nullptr) {
+        handle = curl_easy_init();
+        if (handle == nullptr)
+            throw _Exception(_("failed to init curl"));
+    } else
+        curl_easy_reset(handle);
+    prepareHandle(handle);
+    return handle;
+}
+
+void HTTPClient::returnHandle(CURL *handle)
+{
+    if (handle == nullptr)
+        return;
+    {
+        AutoLock lock(mutex);
+        if (!shutdownFlag && idleHandles.size() < HTTP_CLIENT_MAX_IDLE_HANDLES) {
+            idleHandles.push_back(handle);
+            return;
+        }
+    }
+    curl_easy_cleanup(handle);
+}
+
+void HTTPClient::prepareHandle(CURL *handle)
+{
+    curl_easy_setopt(handle, CURLOPT_SHARE, share);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1);
+}
+
+void HTTPClient::acquireHost(const std::string &host)
+{
+    unique_lock<mutex_type> lock(mutex);
+    if (hostConnections > 0)
+        hostCond.wait(lock, [&] { return shutdownFlag || hostTransfers[host] < hostConnections; });
+    hostTransfers[host]++;
+}
+
+void HTTPClient::releaseHost(const std::string &host)
+{
+    AutoLock lock(mutex);
+    auto it = hostTransfers.find(host);
+    if (it == hostTransfers.end())
+        return;
+    if (--it->second <= 0)
+        hostTransfers.erase(it);
+    hostCond.notify_all();
+}
+
+void HTTPClient::recordTransfer(CURL *handle, CURLcode result)
+{
+    long connects = 0;
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+
+#if LIBCURL_VERSION_NUM >= 0x073d00
+    curl_off_t dns = 0, connect = 0, tls = 0, total = 0, bytes = 0;
+    curl_easy_getinfo(handle, CURLINFO_NAMELOOKUP_TIME_T, &dns);
+    curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME_T, &connect);
+    curl_easy_getinfo(handle, CURLINFO_APPCONNECT_TIME_T, &tls);
+    curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME_T, &total);
+    curl_easy_getinfo(handle, CURLINFO_SIZE_DOWNLOAD_T, &bytes);
+#else
+    double dnsSeconds = 0, connectSeconds = 0, tlsSeconds = 0, totalSeconds = 0, size = 0;
+    curl_easy_getinfo(handle, CURLINFO_NAMELOOKUP_TIME, &dnsSeconds);
+    curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME, &connectSeconds);
+    curl_easy_getinfo(handle, CURLINFO_APPCONNECT_TIME, &tlsSeconds);
+    curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME, &totalSeconds);
+    curl_easy_getinfo(handle, CURLINFO_SIZE_DOWNLOAD, &size);
+    long long dns = dnsSeconds * 1000000, connect = connectSeconds * 1000000;
+    long long tls = tlsSeconds * 1000000, total = totalSeconds * 1000000, bytes = size;
+#endif
+
+    AutoLock lock(mutex);
+    statistics.requests++;
+    if (result != CURLE_OK)
+        statistics.failed++;
+    statistics.connects += connects;
+    // the times are counted from the start of the transfer, the phases
+    // are the differences
+    statistics.dnsTime += dns;
+    if (connect > dns)
+        statistics.connectTime += connect - dns;
+    if (tls > connect)
+        statistics.tlsTime += tls - connect;
+    statistics.totalTime += total;
+    statistics.bytes += bytes;
+}
+
+HTTPClientStatistics HTTPClient::getStatistics()
+{
+    AutoLock lock(mutex);
+    return statistics;
+}
+
+std::string HTTPClient::getHost(String url)
+{
+    std::string host(url.c_str());
+    size_t start = host.find("://");
+    start = (start == std::string::npos) ? 0 : start + 3;
+    size_t end = host.find_first_of("/?#", start);
+    host = host.substr(start, end == std::string::npos ? std::string::npos : end - start);
+    size_t at = host.rfind('@');
+    if (at != std::string::npos)
+        host.erase(0, at + 1);
+    std::transform(host.begin(), host.end(), host.begin(), ::tolower);
+    return host;
+}
+
+void HTTPClient::lockShare(CURL *handle, curl_lock_data data, curl_lock_access access, void *userp)
+{
+    auto *inst = (HTTPClient *)userp;
+    inst->shareLocks[data].lock();
+}
+
+void HTTPClient::unlockShare(CURL *handle, curl_lock_data data, void *userp)
+{
+    auto *inst = (HTTPClient *)userp;
+    inst->shareLocks[data].unlock();
+}
+
+#endif // HAVE_CURL
@@ -0,0 +1,133 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    http_client.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+
+/// \file http_client.h
+/// \brief Definition of the HTTPClient class.
+
+#ifdef HAVE_CURL
+
+#ifndef __HTTP_CLIENT_H__
+#define __HTTP_CLIENT_H__
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include "common.h"
+#include "singleton.h"
+
+/// \brief idle easy handles that are kept for reuse
+#define HTTP_CLIENT_MAX_IDLE_HANDLES 8
+
+struct HTTPClientStatistics {
+    /// \brief finished transfers
+    long requests;
+    long failed;
+    /// \brief connections that had to be set up, the other transfers
+    /// reused a connection
+    long connects;
+    /// \brief time spent in the phases of all transfers, in microseconds
+    long long dnsTime;
+    long long connectTime;
+    long long tlsTime;
+    long long totalTime;
+    long long bytes;
+};
+
+/// \brief Hands out curl handles that share DNS lookups, TLS sessions and
+/// connections, so that repeated requests to a host skip the handshakes.
+///
+/// Blocking fetches wait for a host slot, so that no more than the
+/// configured number of them talk to a host at the same time. Streams are
+/// driven by the curl multi handle of the IOReactor and use the same
+/// handles, they are not limited because a waiting stream stalls playback.
+class HTTPClient : public Singleton<HTTPClient>
+{
+public:
+    HTTPClient();
+    virtual ~HTTPClient();
+    zmm::String getName() override { return _("HTTP Client"); }
+
+    void init() override;
+    void shutdown() override;
+
+    /// \param hostConnections blocking fetches per host, 0 means unlimited
+    void start(int hostConnections);
+
+    /// \brief Returns a handle with default options that uses the shared
+    /// caches, every handle has to be handed back with returnHandle().
+    CURL *getHandle();
+    void returnHandle(CURL *handle);
+
+    /// \brief Attaches a handle to the shared caches again, needed after
+    /// curl_easy_reset().
+    void prepareHandle(CURL *handle);
+
+    /// \brief Waits until a blocking fetch from the host of the URL may
+    /// start, every acquireHost() needs a releaseHost().
+    void acquireHost(const std::string &host);
+    void releaseHost(const std::string &host);
+
+    /// \brief Adds the timings of a finished transfer to the statistics.
+    void recordTransfer(CURL *handle, CURLcode result);
+    HTTPClientStatistics getStatistics();
+
+    /// \brief Returns the lower case host and port of the URL.
+    static std::string getHost(zmm::String url);
+
+    /// \brief Holds a host slot for as long as it lives.
+    class HostSlot
+    {
+    public:
+        HostSlot(zmm::Ref<HTTPClient> client, zmm::String url)
+            : client(client), host(getHost(url)) { client->acquireHost(host); }
+        ~HostSlot() { client->releaseHost(host); }
+    protected:
+        zmm::Ref<HTTPClient> client;
+        std::string host;
+    };
+
+protected:
+    CURLSH *share;
+    std::mutex shareLocks[CURL_LOCK_DATA_LAST];
+    bool shutdownFlag;
+    std::vector<CURL *> idleHandles;
+
+    int hostConnections;
+    std::unordered_map<std::string, int> hostTransfers;
+    std::condition_variable hostCond;
+
+    HTTPClientStatistics statistics;
+
+    static void lockShare(CURL *handle, curl_lock_data data, curl_lock_access access, void *userp);
+    static void unlockShare(CURL *handle, curl_lock_data data, void *userp);
+};
+
+#endif // __HTTP_CLIENT_H__
+
+#endif // HAVE_CURL
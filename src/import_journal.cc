@@ -0,0 +1,276 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    import_journal.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file import_journal.cc
+
+#include <cerrno>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+#include "import_journal.h"
+#include "tools.h"
+
+using namespace zmm;
+
+// The journal is a text file with one record per line:
+//   B <id> <hidden> <path>\t<rootpath>   import started
+//   D <id> <directory>                   directory done
+//   E <id>                               import finished
+
+ImportJournal::ImportJournal(const std::string& filename)
+    : filename(filename)
+    , file(nullptr)
+    , nextId(1)
+    , lastCheckpoint(std::chrono::steady_clock::now())
+{
+    load();
+    // only the unfinished imports are kept
+    rewrite();
+}
+
+ImportJournal::~ImportJournal()
+{
+    if (file != nullptr)
+        fclose(file);
+}
+
+std::vector<ImportJournal::Import> ImportJournal::getUnfinished()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<Import> unfinished;
+    for (auto& entry : entries) {
+        if (entry.second.resumed)
+            unfinished.push_back(entry.second.import);
+    }
+    return unfinished;
+}
+
+int ImportJournal::begin(const std::string& path, const std::string& rootpath, bool hidden)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : entries) {
+        if (entry.second.resumed && entry.second.import.path == path) {
+            log_info("Resuming import of %s, %d directories were done already\n",
+                path.c_str(), (int)entry.second.done.size());
+            return entry.first;
+        }
+    }
+
+    int id = nextId++;
+    Entry& entry = entries[id];
+    entry.import.id = id;
+    entry.import.path = path;
+    entry.import.rootpath = rootpath;
+    entry.import.hidden = hidden;
+    entry.resumed = false;
+
+    std::ostringstream line;
+    line << "B " << id << ' ' << (hidden ? 1 : 0) << ' ' << escape(path) << '\t' << escape(rootpath);
+    write(line.str());
+    sync();
+    return id;
+}
+
+bool ImportJournal::isResumed(int id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto entry = entries.find(id);
+    return entry != entries.end() && entry->second.resumed;
+}
+
+bool ImportJournal::isDone(int id, const std::string& directory)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto entry = entries.find(id);
+    return entry != entries.end() && entry->second.done.count(directory) > 0;
+}
+
+void ImportJournal::directoryDone(int id, const std::string& directory)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    pendingDirectories.emplace_back(id, directory);
+}
+
+bool ImportJournal::checkpointDue()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pendingDirectories.empty())
+        return false;
+    return pendingDirectories.size() >= IMPORT_JOURNAL_CHECKPOINT_DIRECTORIES
+        || std::chrono::steady_clock::now() - lastCheckpoint >= std::chrono::seconds(IMPORT_JOURNAL_CHECKPOINT_SECONDS);
+}
+
+void ImportJournal::checkpoint()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& pending : pendingDirectories) {
+        std::ostringstream line;
+        line << "D " << pending.first << ' ' << escape(pending.second);
+        write(line.str());
+    }
+    pendingDirectories.clear();
+    sync();
+    lastCheckpoint = std::chrono::steady_clock::now();
+}
+
+void ImportJournal::end(int id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.erase(id);
+    for (auto it = pendingDirectories.begin(); it != pendingDirectories.end();) {
+        if (it->first == id)
+            it = pendingDirectories.erase(it);
+        else
+            ++it;
+    }
+
+    if (entries.empty() && pendingDirectories.empty()) {
+        // nothing left to resume, start over with an empty file
+        rewrite();
+    } else {
+        write("E " + std::to_string(id));
+        sync();
+    }
+}
+
+void ImportJournal::load()
+{
+    std::ifstream in(filename);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.length() < 3)
+            continue;
+        char type = line[0];
+        std::istringstream fields(line.substr(2));
+        int id;
+        if (!(fields >> id))
+            continue;
+        if (id >= nextId)
+            nextId = id + 1;
+
+        if (type == 'B') {
+            int hidden;
+            if (!(fields >> hidden))
+                continue;
+            fields.get();
+            std::string rest;
+            std::getline(fields, rest);
+            size_t tab = rest.find('\t');
+            if (tab == std::string::npos)
+                continue;
+            Entry& entry = entries[id];
+            entry.import.id = id;
+            entry.import.path = unescape(rest.substr(0, tab));
+            entry.import.rootpath = unescape(rest.substr(tab + 1));
+            entry.import.hidden = hidden != 0;
+            entry.resumed = true;
+        } else if (type == 'D') {
+            fields.get();
+            std::string directory;
+            std::getline(fields, directory);
+            auto entry = entries.find(id);
+            if (entry != entries.end())
+                entry->second.done.insert(unescape(directory));
+        } else if (type == 'E') {
+            entries.erase(id);
+        }
+    }
+}
+
+void ImportJournal::rewrite()
+{
+    if (file != nullptr)
+        fclose(file);
+
+    std::string tmpFilename = filename + ".tmp";
+    file = fopen(tmpFilename.c_str(), "w");
+    if (file == nullptr) {
+        log_error("Could not write import journal %s: %s\n", tmpFilename.c_str(), mt_strerror(errno).c_str());
+        return;
+    }
+    for (auto& entry : entries) {
+        std::ostringstream line;
+        line << "B " << entry.first << ' ' << (entry.second.import.hidden ? 1 : 0) << ' '
+             << escape(entry.second.import.path) << '\t' << escape(entry.second.import.rootpath);
+        write(line.str());
+        for (auto& directory : entry.second.done)
+            write("D " + std::to_string(entry.first) + ' ' + escape(directory));
+    }
+    sync();
+    if (rename(tmpFilename.c_str(), filename.c_str()) != 0)
+        log_error("Could not replace import journal %s: %s\n", filename.c_str(), mt_strerror(errno).c_str());
+}
+
+void ImportJournal::write(const std::string& line)
+{
+    if (file == nullptr)
+        return;
+    fputs(line.c_str(), file);
+    fputc('\n', file);
+}
+
+void ImportJournal::sync()
+{
+    if (file == nullptr)
+        return;
+    if (fflush(file) != 0 || fdatasync(fileno(file)) != 0)
+        log_error("Could not write import journal %s: %s\n", filename.c_str(), mt_strerror(errno).c_str());
+}
+
+std::string ImportJournal::escape(const std::string& text)
+{
+    std::string escaped;
+    escaped.reserve(text.length());
+    for (char c : text) {
+        if (c == '\\')
+            escaped += "\\\\";
+        else if (c == '\n')
+            escaped += "\\n";
+        else if (c == '\t')
+            escaped += "\\t";
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+std::string ImportJournal::unescape(const std::string& text)
+{
+    std::string unescaped;
+    unescaped.reserve(text.length());
+    for (size_t i = 0; i < text.length(); i++) {
+        if (text[i] != '\\' || i + 1 == text.length()) {
+            unescaped += text[i];
+            continue;
+        }
+        char c = text[++i];
+        if (c == 'n')
+            unescaped += '\n';
+        else if (c == 't')
+            unescaped += '\t';
+        else
+            unescaped += c;
+    }
+    return unescaped;
+}
@@ -0,0 +1,116 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    import_journal.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file import_journal.h
+/// \brief Definition of the ImportJournal class.
+
+#ifndef __IMPORT_JOURNAL_H__
+#define __IMPORT_JOURNAL_H__
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "zmm/zmmf.h"
+
+#define IMPORT_JOURNAL_FILE "import.journal"
+
+/// \brief completed directories are written out at least this often
+#define IMPORT_JOURNAL_CHECKPOINT_DIRECTORIES 64
+#define IMPORT_JOURNAL_CHECKPOINT_SECONDS 5
+
+/// \brief Remembers how far recursive imports got, so that an import cut
+/// short by a restart continues where it stopped.
+///
+/// A directory only counts as done once everything imported from it is in
+/// the database, so the caller has to write out the storage before
+/// checkpoint() or end(). Imports that were never ended are reported by
+/// getUnfinished() on the next start, and begin() for the same path picks
+/// up the directories that were already done.
+class ImportJournal : public zmm::Object {
+public:
+    struct Import {
+        int id;
+        std::string path;
+        std::string rootpath;
+        bool hidden;
+    };
+
+    /// \brief Opens the journal, reading what it holds from a previous run.
+    explicit ImportJournal(const std::string& filename);
+    virtual ~ImportJournal();
+
+    /// \brief Imports that were running when the server stopped.
+    std::vector<Import> getUnfinished();
+
+    /// \brief Starts or resumes the import of the given path.
+    /// \return id of the import
+    int begin(const std::string& path, const std::string& rootpath, bool hidden);
+
+    /// \brief The import continues an interrupted one.
+    bool isResumed(int id);
+
+    /// \brief All objects of the directory were imported before a restart.
+    bool isDone(int id, const std::string& directory);
+
+    /// \brief Marks a directory as imported with the next checkpoint.
+    void directoryDone(int id, const std::string& directory);
+
+    /// \brief Enough directories are waiting for a checkpoint.
+    bool checkpointDue();
+
+    /// \brief Writes the directories marked done to disk.
+    void checkpoint();
+
+    /// \brief Forgets the import, it finished or was cancelled.
+    void end(int id);
+
+protected:
+    struct Entry {
+        Import import;
+        bool resumed;
+        std::unordered_set<std::string> done;
+    };
+
+    std::mutex mutex;
+    std::string filename;
+    FILE* file;
+    int nextId;
+    std::map<int, Entry> entries;
+    std::vector<std::pair<int, std::string>> pendingDirectories;
+    std::chrono::steady_clock::time_point lastCheckpoint;
+
+    void load();
+    void rewrite();
+    void write(const std::string& line);
+    void sync();
+
+    static std::string escape(const std::string& text);
+    static std::string unescape(const std::string& text);
+};
+
+#endif // __IMPORT_JOURNAL_H__
@@ -0,0 +1,155 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    inotify_event_aggregator.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file inotify_event_aggregator.cc
+
+#include <algorithm>
+
+#include "inotify_event_aggregator.h"
+
+using namespace zmm;
+
+InotifyEventAggregator::InotifyEventAggregator(int window)
+    : window(std::max(0, window))
+    , statistics()
+{
+}
+
+void InotifyEventAggregator::setWindow(int window)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->window = std::chrono::milliseconds(std::max(0, window));
+}
+
+void InotifyEventAggregator::record(const std::string& path, InotifyAction action, bool created,
+    Ref<Object> context, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    statistics.received++;
+
+    auto it = pending.find(path);
+    if (it == pending.end()) {
+        Pending entry;
+        entry.action = action;
+        entry.created = created;
+        entry.context = context;
+        entry.firstSeen = now;
+        entry.deadline = now + window;
+        deadlines.emplace(entry.deadline, path);
+        pending.emplace(path, entry);
+        statistics.maxPending = std::max(statistics.maxPending, (int)pending.size());
+        return;
+    }
+
+    statistics.collapsed++;
+    Pending& entry = it->second;
+    switch (action) {
+    case InotifyAction::Remove:
+        if (entry.created) {
+            // came and went before anyone looked at it
+            pending.erase(it);
+            statistics.cancelled++;
+            return;
+        }
+        entry.action = InotifyAction::Remove;
+        break;
+    case InotifyAction::Add:
+    case InotifyAction::Update:
+        // whatever is in the database for a replaced file has to go
+        if (entry.action == InotifyAction::Remove)
+            entry.action = InotifyAction::Update;
+        else if (!entry.created)
+            entry.action = std::max(entry.action, action);
+        break;
+    }
+    entry.context = context;
+    entry.deadline = std::min(now + window, entry.firstSeen + window * INOTIFY_DEBOUNCE_MAX_DELAY_FACTOR);
+    deadlines.emplace(entry.deadline, path);
+}
+
+void InotifyEventAggregator::discardBelow(const std::string& directory)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (it->first.compare(0, directory.length(), directory) == 0)
+            it = pending.erase(it);
+        else
+            ++it;
+    }
+}
+
+void InotifyEventAggregator::takeDue(std::vector<InotifyWorkItem>& items, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t first = items.size();
+    while (!deadlines.empty() && deadlines.top().first <= now) {
+        Deadline deadline = deadlines.top();
+        deadlines.pop();
+
+        auto it = pending.find(deadline.second);
+        if (it == pending.end() || it->second.deadline != deadline.first)
+            continue;
+
+        InotifyWorkItem item;
+        item.path = it->first;
+        item.action = it->second.action;
+        item.context = it->second.context;
+        items.push_back(item);
+        pending.erase(it);
+    }
+    if (items.size() == first)
+        return;
+
+    std::stable_partition(items.begin() + first, items.end(), [](const InotifyWorkItem& item) {
+        return item.action == InotifyAction::Remove;
+    });
+    statistics.emitted += items.size() - first;
+    statistics.batches++;
+}
+
+int InotifyEventAggregator::getTimeout(Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    while (!deadlines.empty()) {
+        const Deadline& deadline = deadlines.top();
+        auto it = pending.find(deadline.second);
+        if (it != pending.end() && it->second.deadline == deadline.first)
+            break;
+        deadlines.pop();
+    }
+    if (deadlines.empty())
+        return -1;
+    if (deadlines.top().first <= now)
+        return 0;
+    // round up, waking up just before the deadline would be a wasted turn
+    auto wait = deadlines.top().first - now + std::chrono::milliseconds(1) - Clock::duration(1);
+    return (int)std::chrono::duration_cast<std::chrono::milliseconds>(wait).count();
+}
+
+InotifyEventStatistics InotifyEventAggregator::getStatistics()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    InotifyEventStatistics current = statistics;
+    current.pending = pending.size();
+    return current;
+}
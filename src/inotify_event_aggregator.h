@@ -0,0 +1,124 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    inotify_event_aggregator.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file inotify_event_aggregator.h
+/// \brief Definition of the InotifyEventAggregator class.
+
+#ifndef __INOTIFY_EVENT_AGGREGATOR_H__
+#define __INOTIFY_EVENT_AGGREGATOR_H__
+
+#include <chrono>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "zmm/zmmf.h"
+
+/// \brief a path that keeps changing is handed out at the latest after
+/// this many debounce windows
+#define INOTIFY_DEBOUNCE_MAX_DELAY_FACTOR 10
+
+enum class InotifyAction {
+    Add,
+    Update,
+    Remove
+};
+
+struct InotifyWorkItem {
+    std::string path;
+    InotifyAction action;
+    /// \brief whatever was passed with the last event for the path
+    zmm::Ref<zmm::Object> context;
+};
+
+struct InotifyEventStatistics {
+    /// \brief events passed to record()
+    long received;
+    /// \brief events merged into a path that was already pending
+    long collapsed;
+    /// \brief paths that were created and removed again within the window
+    long cancelled;
+    /// \brief work items handed out
+    long emitted;
+    long batches;
+    int pending;
+    int maxPending;
+};
+
+/// \brief Debounces inotify events per path.
+///
+/// Every event postpones the pending work for its path by the debounce
+/// window, a sequence like create, write, write, delete ends up as a single
+/// work item or none at all. Due work items are handed out in batches,
+/// removals first.
+class InotifyEventAggregator {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /// \param window debounce window in milliseconds, 0 hands out every
+    /// event right away
+    explicit InotifyEventAggregator(int window = 0);
+
+    void setWindow(int window);
+
+    /// \param created the event reported a newly created file, so there
+    /// can not be anything in the database for the path yet
+    void record(const std::string& path, InotifyAction action, bool created,
+        zmm::Ref<zmm::Object> context, Clock::time_point now = Clock::now());
+
+    /// \brief Forgets the pending work below a directory that is gone.
+    void discardBelow(const std::string& directory);
+
+    /// \brief Appends the work items whose window has passed.
+    void takeDue(std::vector<InotifyWorkItem>& items, Clock::time_point now = Clock::now());
+
+    /// \brief Milliseconds until the next work item is due, -1 if there is
+    /// nothing pending.
+    int getTimeout(Clock::time_point now = Clock::now());
+
+    InotifyEventStatistics getStatistics();
+
+protected:
+    struct Pending {
+        InotifyAction action;
+        bool created;
+        zmm::Ref<zmm::Object> context;
+        Clock::time_point firstSeen;
+        Clock::time_point deadline;
+    };
+
+    typedef std::pair<Clock::time_point, std::string> Deadline;
+
+    std::chrono::milliseconds window;
+    std::mutex mutex;
+    std::unordered_map<std::string, Pending> pending;
+    /// \brief may hold outdated deadlines, they are skipped when they do not
+    /// match the pending entry any more
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines;
+    InotifyEventStatistics statistics;
+};
+
+#endif // __INOTIFY_EVENT_AGGREGATOR_H__
@@ -122,3 +122,13 @@ void IOHandler::seek(IN off_t offset, IN int whence)
 void IOHandler::close()
 {
 }
+
+int IOHandler::getPollFd()
+{
+    return -1;
+}
+
+ssize_t IOHandler::readAvailable(OUT char *buf, IN size_t length)
+{
+    return -1;
+}
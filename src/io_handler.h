@@ -69,6 +69,23 @@ public:
 
     /// \brief Close/free previously opened/initialized data.
     virtual void close();
+
+    /// \brief Returns a file descriptor that becomes readable when data is
+    /// available, handlers that provide one can be serviced by the IOReactor
+    /// instead of a dedicated thread.
+    /// \return file descriptor or -1 if polling is not supported
+    virtual int getPollFd();
+
+    /// \brief Reads the data that is available without blocking, only
+    /// supported if getPollFd() returns a valid file descriptor.
+    ///
+    /// Is called on the IOReactor thread that serves all streams, cleaning
+    /// up after the end of the data belongs into close().
+    /// \param buf This buffer will be filled with the data.
+    /// \param length Maximum number of bytes to read.
+    /// \return number of bytes read, 0 at the end of the data, -1 on error
+    /// or IO_WOULD_BLOCK if nothing could be read right now
+    virtual ssize_t readAvailable(char *buf, size_t length);
 };
 
 
@@ -30,6 +30,7 @@
 /// \file io_handler_buffer_helper.cc
 
 #include "io_handler_buffer_helper.h"
+#include "io_reactor.h"
 #include "config_manager.h"
 
 using namespace zmm;
@@ -54,6 +55,8 @@ IOHandlerBufferHelper::IOHandlerBufferHelper(size_t bufSize, size_t initialFillS
     empty = true;
     signalAfterEveryRead = false;
     checkSocket = false;
+    bufferThread = 0;
+    reactorDriven = false;
     
     seekEnabled = false;
     doSeek = false;
@@ -67,7 +70,13 @@ void IOHandlerBufferHelper::open(IN enum UpnpOpenFileMode mode)
     if (buffer == nullptr)
         throw _Exception(_("Failed to allocate memory for transcoding buffer!"));
 
-    startBufferThread();
+    if (reactorDriven)
+    {
+        reactor = IOReactor::getInstance();
+        reactor->addSource(this);
+    }
+    else
+        startBufferThread();
     isOpen = true;
 }
 
@@ -143,6 +152,12 @@ size_t IOHandlerBufferHelper::read(OUT char *buf, IN size_t length)
     }
     
     posRead += didRead;
+    lock.unlock();
+    
+    // the reactor stops polling a source while its buffer is full
+    if (reactorDriven && signalled)
+        reactor->wakeup(this);
+    
     return didRead;
 }
 
@@ -173,6 +188,12 @@ void IOHandlerBufferHelper::seek(IN off_t offset, IN int whence)
     
     // tell the probably sleeping thread to process our seek
     cond.notify_one();
+    if (reactorDriven)
+    {
+        lock.unlock();
+        reactor->wakeup(this);
+        lock.lock();
+    }
     
     // wait until the seek has been processed
     cond.wait(lock, [&](){
@@ -185,11 +206,79 @@ void IOHandlerBufferHelper::close()
     if (! isOpen)
         throw _Exception(_("close called on closed IOHandlerBufferHelper"));
     isOpen = false;
-    stopBufferThread();
+    if (reactorDriven)
+    {
+        unique_lock<std::mutex> lock(mutex);
+        threadShutdown = true;
+        cond.notify_one();
+        lock.unlock();
+        
+        // the reactor won't touch us after this
+        reactor->removeSource(this);
+        reactor = nullptr;
+    }
+    else
+        stopBufferThread();
     FREE(buffer);
     buffer = nullptr;
 }
 
+size_t IOHandlerBufferHelper::getFreeSpace()
+{
+    if (empty)
+        return bufSize;
+    int bufFree = a - b;
+    if (bufFree < 0)
+        bufFree += bufSize;
+    return bufFree;
+}
+
+size_t IOHandlerBufferHelper::getContiguousFreeSpace()
+{
+    return (empty ? bufSize - b : (a < b ? bufSize - b : a - b));
+}
+
+void IOHandlerBufferHelper::commitWrite(size_t length)
+{
+    b += length;
+    if (b >= bufSize)
+        b -= bufSize;
+    if (empty)
+    {
+        empty = false;
+        cond.notify_one();
+    }
+    if (waitForInitialFillSize)
+    {
+        int currentFillSize = b - a;
+        if (currentFillSize <= 0)
+            currentFillSize += bufSize;
+        if ((size_t)currentFillSize >= initialFillSize)
+        {
+            log_debug("buffer: initial fillsize reached\n");
+            waitForInitialFillSize = false;
+            cond.notify_one();
+        }
+    }
+}
+
+// reactor stuff...
+
+bool IOHandlerBufferHelper::reactorWantsData()
+{
+    unique_lock<std::mutex> lock(mutex);
+    if (threadShutdown || eof || readError)
+        return false;
+    return (getFreeSpace() > 0);
+}
+
+void IOHandlerBufferHelper::reactorShutdown()
+{
+    unique_lock<std::mutex> lock(mutex);
+    threadShutdown = true;
+    cond.notify_one();
+}
+
 // thread stuff...
 
 void IOHandlerBufferHelper::startBufferThread()
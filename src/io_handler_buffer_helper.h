@@ -40,9 +40,15 @@
 #include "common.h"
 #include "io_handler.h"
 
+class IOReactor;
+
 /// \brief a IOHandler with buffer support
 /// the buffer is only for read(). write() is not supported
 /// the public functions of this class are *not* thread safe!
+///
+/// The buffer is either filled by a thread of its own (threadProc()) or,
+/// if reactorDriven is set, by the shared IOReactor which calls the
+/// reactor*() functions from its thread.
 class IOHandlerBufferHelper : public IOHandler
 {
 public:
@@ -85,17 +91,45 @@ protected:
     off_t seekOffset;
     int seekWhence;
     
+    // buffer helpers for the producer, mutex must be held
+    size_t getFreeSpace();
+    size_t getContiguousFreeSpace();
+    void commitWrite(size_t length);
+    
     // thread stuff..
     void startBufferThread();
     void stopBufferThread();
     static void *staticThreadProc(void *arg);
-    virtual void threadProc() = 0;
+    virtual void threadProc() { }
     
     pthread_t bufferThread;
     bool threadShutdown;
 
     std::condition_variable cond;
     std::mutex mutex;
+    
+    // reactor stuff..
+    bool reactorDriven;
+    zmm::Ref<IOReactor> reactor;
+    
+    /// \brief file descriptor the reactor should poll for us, -1 if none
+    virtual int reactorFd() { return -1; }
+    /// \brief true if the reactor should poll reactorFd() for data
+    virtual bool reactorWantsData();
+    /// \brief called on the reactor thread once the buffer is registered
+    virtual void reactorAttach(IOReactor *reactor) { }
+    /// \brief called on the reactor thread before the buffer is dropped
+    virtual void reactorDetach(IOReactor *reactor) { }
+    /// \brief called on the reactor thread when reactorFd() is readable,
+    /// after a wakeup() from the reader and periodically if idle is set
+    virtual void reactorProcess(IOReactor *reactor, bool idle) { }
+    /// \brief called on the reactor thread when a curl transfer which was
+    /// registered with IOReactor::addCurlHandle() has finished
+    virtual void reactorTransferDone(IOReactor *reactor, int result) { }
+    /// \brief the reactor is going down, give up
+    void reactorShutdown();
+    
+    friend class IOReactor;
 };
 
 #endif // __IO_HANDLER_BUFFER_HELPER_H__
@@ -0,0 +1,502 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    io_reactor.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file io_reactor.cc
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef HAVE_EPOLL
+    #include <sys/epoll.h>
+#else
+    #include <poll.h>
+#endif
+
+#include "io_reactor.h"
+#include "io_handler_buffer_helper.h"
+#include "tools.h"
+
+// sources get an idle tick at least this often (milliseconds), so they can
+// notice dead processes or aborted requests while no data is flowing
+#define REACTOR_IDLE_INTERVAL 1000
+#define REACTOR_MAX_EVENTS 64
+
+using namespace zmm;
+using namespace std;
+
+IOReactor::IOReactor()
+    : Singleton<IOReactor>()
+{
+    reactorThread = 0;
+    shutdownFlag = false;
+    running = false;
+    wakeupPipe[0] = -1;
+    wakeupPipe[1] = -1;
+#ifdef HAVE_EPOLL
+    epollFd = -1;
+#endif
+#ifdef HAVE_CURL
+    multiHandle = nullptr;
+    curlTimerSet = false;
+#endif
+}
+
+IOReactor::~IOReactor()
+{
+#ifdef HAVE_CURL
+    if (multiHandle != nullptr)
+        curl_multi_cleanup(multiHandle);
+#endif
+#ifdef HAVE_EPOLL
+    if (epollFd >= 0)
+        close(epollFd);
+#endif
+    if (wakeupPipe[0] >= 0)
+        close(wakeupPipe[0]);
+    if (wakeupPipe[1] >= 0)
+        close(wakeupPipe[1]);
+}
+
+void IOReactor::init()
+{
+    if (pipe(wakeupPipe) == -1)
+        throw _Exception(_("IOReactor: could not create wakeup pipe: ") + mt_strerror(errno));
+    for (int fd : wakeupPipe)
+    {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+
+#ifdef HAVE_EPOLL
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1)
+        throw _Exception(_("IOReactor: epoll_create1 failed: ") + mt_strerror(errno));
+#endif
+
+#ifdef HAVE_CURL
+    httpClient = HTTPClient::getInstance();
+    multiHandle = curl_multi_init();
+    if (multiHandle == nullptr)
+        throw _Exception(_("IOReactor: failed to initialize curl multi handle"));
+    curl_multi_setopt(multiHandle, CURLMOPT_SOCKETFUNCTION, IOReactor::curlSocketCallback);
+    curl_multi_setopt(multiHandle, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(multiHandle, CURLMOPT_TIMERFUNCTION, IOReactor::curlTimerCallback);
+    curl_multi_setopt(multiHandle, CURLMOPT_TIMERDATA, this);
+#endif
+
+    watch(wakeupPipe[0], IO_REACTOR_READ);
+
+    running = true;
+    pthread_create(
+        &reactorThread,
+        nullptr,
+        IOReactor::staticThreadProc,
+        this);
+}
+
+void IOReactor::shutdown()
+{
+    log_debug("start\n");
+    unique_lock<mutex_type> lock(mutex);
+    shutdownFlag = true;
+    lock.unlock();
+    write(wakeupPipe[1], "x", 1);
+    if (reactorThread)
+        pthread_join(reactorThread, nullptr);
+    reactorThread = 0;
+    log_debug("end\n");
+}
+
+void IOReactor::addSource(IOHandlerBufferHelper *source)
+{
+    unique_lock<mutex_type> lock(mutex);
+    if (!running)
+        throw _Exception(_("IOReactor: not running"));
+    pendingAdd.push_back(source);
+    lock.unlock();
+    write(wakeupPipe[1], "a", 1);
+}
+
+void IOReactor::removeSource(IOHandlerBufferHelper *source)
+{
+    unique_lock<mutex_type> lock(mutex);
+    if (!running)
+        return;
+
+    // never reached the reactor thread, nothing to wait for
+    for (auto it = pendingAdd.begin(); it != pendingAdd.end(); ++it)
+    {
+        if (*it == source)
+        {
+            pendingAdd.erase(it);
+            pendingWakeup.erase(source);
+            return;
+        }
+    }
+
+    pendingRemove.insert(source);
+    lock.unlock();
+    write(wakeupPipe[1], "r", 1);
+    lock.lock();
+    cond.wait(lock, [&] { return !running || pendingRemove.find(source) == pendingRemove.end(); });
+}
+
+void IOReactor::wakeup(IOHandlerBufferHelper *source)
+{
+    unique_lock<mutex_type> lock(mutex);
+    if (!running)
+        return;
+    // one byte in the pipe is enough to get the thread going
+    bool signal = pendingWakeup.empty();
+    pendingWakeup.insert(source);
+    lock.unlock();
+    if (signal)
+        write(wakeupPipe[1], "w", 1);
+}
+
+void IOReactor::watch(int fd, int events)
+{
+    auto it = watched.find(fd);
+    int current = (it == watched.end()) ? 0 : it->second;
+    if (events == current)
+        return;
+
+#ifdef HAVE_EPOLL
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.data.fd = fd;
+    if (events & IO_REACTOR_READ)
+        ev.events |= EPOLLIN;
+    if (events & IO_REACTOR_WRITE)
+        ev.events |= EPOLLOUT;
+
+    int op;
+    if (events == 0)
+        op = EPOLL_CTL_DEL;
+    else if (current == 0)
+        op = EPOLL_CTL_ADD;
+    else
+        op = EPOLL_CTL_MOD;
+
+    // a closed fd has already left the epoll set, EBADF/ENOENT is harmless
+    if (epoll_ctl(epollFd, op, fd, &ev) == -1 && events != 0)
+        log_debug("epoll_ctl failed for fd %d: %s\n", fd, mt_strerror(errno).c_str());
+#endif
+
+    if (events == 0)
+        watched.erase(fd);
+    else
+        watched[fd] = events;
+}
+
+void IOReactor::updateInterest(IOHandlerBufferHelper *source)
+{
+    int fd = source->reactorFd();
+    if (fd < 0)
+        return;
+    watch(fd, source->reactorWantsData() ? IO_REACTOR_READ : 0);
+}
+
+void IOReactor::waitForEvents(long timeoutMillis, vector<pair<int, int> > &events)
+{
+#ifdef HAVE_EPOLL
+    struct epoll_event evs[REACTOR_MAX_EVENTS];
+    int count = epoll_wait(epollFd, evs, REACTOR_MAX_EVENTS, (int)timeoutMillis);
+    for (int i = 0; i < count; i++)
+    {
+        int flags = 0;
+        if (evs[i].events & EPOLLIN)
+            flags |= IO_REACTOR_READ;
+        if (evs[i].events & EPOLLOUT)
+            flags |= IO_REACTOR_WRITE;
+        // let the owner find out about the hangup by reading
+        if (evs[i].events & (EPOLLERR | EPOLLHUP))
+            flags |= IO_REACTOR_ERROR | IO_REACTOR_READ;
+        events.emplace_back((int)evs[i].data.fd, flags);
+    }
+#else
+    vector<struct pollfd> fds;
+    fds.reserve(watched.size());
+    for (auto &entry : watched)
+    {
+        struct pollfd pfd;
+        pfd.fd = entry.first;
+        pfd.events = 0;
+        pfd.revents = 0;
+        if (entry.second & IO_REACTOR_READ)
+            pfd.events |= POLLIN;
+        if (entry.second & IO_REACTOR_WRITE)
+            pfd.events |= POLLOUT;
+        fds.push_back(pfd);
+    }
+
+    if (poll(fds.data(), fds.size(), (int)timeoutMillis) <= 0)
+        return;
+
+    for (auto &pfd : fds)
+    {
+        if (pfd.revents == 0)
+            continue;
+        int flags = 0;
+        if (pfd.revents & POLLIN)
+            flags |= IO_REACTOR_READ;
+        if (pfd.revents & POLLOUT)
+            flags |= IO_REACTOR_WRITE;
+        if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL))
+            flags |= IO_REACTOR_ERROR | IO_REACTOR_READ;
+        events.emplace_back(pfd.fd, flags);
+    }
+#endif
+}
+
+void IOReactor::processSource(IOHandlerBufferHelper *source, bool idle)
+{
+    source->reactorProcess(this, idle);
+    updateInterest(source);
+}
+
+void IOReactor::detachSource(IOHandlerBufferHelper *source)
+{
+    int fd = source->reactorFd();
+    if (fd >= 0)
+    {
+        watch(fd, 0);
+        fdSources.erase(fd);
+    }
+    source->reactorDetach(this);
+    sources.erase(source);
+}
+
+#ifdef HAVE_CURL
+void IOReactor::addCurlHandle(CURL *handle, IOHandlerBufferHelper *source)
+{
+    curl_easy_setopt(handle, CURLOPT_PRIVATE, source);
+    curl_multi_add_handle(multiHandle, handle);
+}
+
+void IOReactor::removeCurlHandle(CURL *handle)
+{
+    curl_multi_remove_handle(multiHandle, handle);
+}
+
+int IOReactor::curlSocketCallback(CURL *easy, curl_socket_t s, int what, void *userp, void *socketp)
+{
+    auto *inst = (IOReactor *)userp;
+    if (what == CURL_POLL_REMOVE)
+    {
+        inst->watch(s, 0);
+        inst->curlSockets.erase(s);
+        return 0;
+    }
+
+    int events = 0;
+    if (what & CURL_POLL_IN)
+        events |= IO_REACTOR_READ;
+    if (what & CURL_POLL_OUT)
+        events |= IO_REACTOR_WRITE;
+    inst->curlSockets[s] = what;
+    inst->watch(s, events);
+    return 0;
+}
+
+int IOReactor::curlTimerCallback(CURLM *multi, long timeoutMillis, void *userp)
+{
+    auto *inst = (IOReactor *)userp;
+    inst->curlTimerSet = (timeoutMillis >= 0);
+    if (inst->curlTimerSet)
+        getTimespecAfterMillis(timeoutMillis, &inst->curlDeadline);
+    return 0;
+}
+
+void IOReactor::checkCurlTransfers()
+{
+    CURLMsg *msg;
+    int left;
+    while ((msg = curl_multi_info_read(multiHandle, &left)) != nullptr)
+    {
+        if (msg->msg != CURLMSG_DONE)
+            continue;
+
+        // msg is gone once the handle is removed
+        CURL *handle = msg->easy_handle;
+        CURLcode result = msg->data.result;
+
+        char *priv = nullptr;
+        curl_easy_getinfo(handle, CURLINFO_PRIVATE, &priv);
+        curl_multi_remove_handle(multiHandle, handle);
+        httpClient->recordTransfer(handle, result);
+
+        auto *source = (IOHandlerBufferHelper *)priv;
+        if (source != nullptr && sources.find(source) != sources.end())
+            source->reactorTransferDone(this, result);
+    }
+}
+#endif
+
+void *IOReactor::staticThreadProc(void *arg)
+{
+    log_debug("starting io reactor thread... thread: %d\n", pthread_self());
+    auto *inst = (IOReactor *)arg;
+    inst->threadProc();
+    log_debug("io reactor thread shut down. thread: %d\n", pthread_self());
+    return nullptr;
+}
+
+void IOReactor::threadProc()
+{
+    vector<pair<int, int> > events;
+    struct timespec lastIdle;
+    getTimespecNow(&lastIdle);
+
+    unique_lock<mutex_type> lock(mutex, defer_lock);
+    while (true)
+    {
+        vector<IOHandlerBufferHelper *> added;
+        vector<IOHandlerBufferHelper *> removed;
+        unordered_set<IOHandlerBufferHelper *> woken;
+
+        lock.lock();
+        if (shutdownFlag)
+            break;
+        added.swap(pendingAdd);
+        removed.assign(pendingRemove.begin(), pendingRemove.end());
+        woken.swap(pendingWakeup);
+        lock.unlock();
+
+        for (auto source : removed)
+        {
+            if (sources.find(source) != sources.end())
+                detachSource(source);
+            woken.erase(source);
+        }
+        if (!removed.empty())
+        {
+            lock.lock();
+            for (auto source : removed)
+                pendingRemove.erase(source);
+            cond.notify_all();
+            lock.unlock();
+        }
+
+        for (auto source : added)
+        {
+            sources.insert(source);
+            int fd = source->reactorFd();
+            if (fd >= 0)
+                fdSources[fd] = source;
+            source->reactorAttach(this);
+            updateInterest(source);
+        }
+
+        for (auto source : woken)
+        {
+            if (sources.find(source) != sources.end())
+                processSource(source, false);
+        }
+
+        long timeout = REACTOR_IDLE_INTERVAL - getDeltaMillis(&lastIdle);
+#ifdef HAVE_CURL
+        if (curlTimerSet)
+        {
+            struct timespec now;
+            getTimespecNow(&now);
+            long curlWait = getDeltaMillis(&now, &curlDeadline);
+            if (curlWait < timeout)
+                timeout = curlWait;
+        }
+#endif
+        if (timeout < 0)
+            timeout = 0;
+
+        events.clear();
+        waitForEvents(timeout, events);
+
+        for (auto &event : events)
+        {
+            int fd = event.first;
+            if (fd == wakeupPipe[0])
+            {
+                char buf[64];
+                while (read(fd, buf, sizeof(buf)) > 0)
+                    ;
+                continue;
+            }
+
+            auto it = fdSources.find(fd);
+            if (it != fdSources.end())
+            {
+                processSource(it->second, false);
+                continue;
+            }
+
+#ifdef HAVE_CURL
+            if (curlSockets.find(fd) != curlSockets.end())
+            {
+                int flags = 0;
+                if (event.second & IO_REACTOR_READ)
+                    flags |= CURL_CSELECT_IN;
+                if (event.second & IO_REACTOR_WRITE)
+                    flags |= CURL_CSELECT_OUT;
+                if (event.second & IO_REACTOR_ERROR)
+                    flags |= CURL_CSELECT_ERR;
+                int runningHandles;
+                curl_multi_socket_action(multiHandle, fd, flags, &runningHandles);
+            }
+#endif
+        }
+
+#ifdef HAVE_CURL
+        if (curlTimerSet && getDeltaMillis(&curlDeadline) >= 0)
+        {
+            curlTimerSet = false;
+            int runningHandles;
+            curl_multi_socket_action(multiHandle, CURL_SOCKET_TIMEOUT, 0, &runningHandles);
+        }
+        checkCurlTransfers();
+#endif
+
+        if (getDeltaMillis(&lastIdle) >= REACTOR_IDLE_INTERVAL)
+        {
+            for (auto source : sources)
+                processSource(source, true);
+            getTimespecNow(&lastIdle);
+        }
+    }
+
+    // mutex is held here, readers must not wait for data anymore
+    for (auto source : sources)
+    {
+        source->reactorDetach(this);
+        source->reactorShutdown();
+    }
+    for (auto source : pendingAdd)
+        source->reactorShutdown();
+    sources.clear();
+    fdSources.clear();
+    pendingAdd.clear();
+    pendingRemove.clear();
+    pendingWakeup.clear();
+    running = false;
+    cond.notify_all();
+}
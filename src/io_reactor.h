@@ -0,0 +1,123 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    io_reactor.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file io_reactor.h
+
+#ifndef __IO_REACTOR_H__
+#define __IO_REACTOR_H__
+
+#include <pthread.h>
+#include <ctime>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common.h"
+#include "http_client.h"
+#include "singleton.h"
+
+class IOHandlerBufferHelper;
+
+#define IO_REACTOR_READ     1
+#define IO_REACTOR_WRITE    2
+#define IO_REACTOR_ERROR    4
+
+/// \brief One thread that fills the buffers of all buffered streams.
+///
+/// Pipes of transcoding processes are polled via epoll (poll() where epoll
+/// is not available), curl transfers are driven by a single curl multi
+/// handle on the same event loop. A source whose buffer is full is not
+/// polled until its reader made room again and called wakeup().
+class IOReactor : public Singleton<IOReactor>
+{
+public:
+    IOReactor();
+    virtual ~IOReactor();
+    zmm::String getName() override { return _("IO Reactor"); }
+
+    void init() override;
+    void shutdown() override;
+
+    /// \brief Starts filling the buffer of the given source.
+    void addSource(IOHandlerBufferHelper *source);
+
+    /// \brief Stops filling the buffer of the given source, once this
+    /// returns the reactor does not touch the source anymore.
+    void removeSource(IOHandlerBufferHelper *source);
+
+    /// \brief Tells the reactor that the reader of the source made room
+    /// in the buffer or requested a seek.
+    void wakeup(IOHandlerBufferHelper *source);
+
+#ifdef HAVE_CURL
+    /// \brief Adds a transfer to the multi handle, reactor thread only.
+    void addCurlHandle(CURL *handle, IOHandlerBufferHelper *source);
+
+    /// \brief Removes a transfer from the multi handle, reactor thread only.
+    void removeCurlHandle(CURL *handle);
+#endif
+
+protected:
+    pthread_t reactorThread;
+    bool shutdownFlag;
+    bool running;
+    std::condition_variable cond;
+    int wakeupPipe[2];
+
+    // handed over from other threads, protected by the mutex
+    std::vector<IOHandlerBufferHelper *> pendingAdd;
+    std::unordered_set<IOHandlerBufferHelper *> pendingRemove;
+    std::unordered_set<IOHandlerBufferHelper *> pendingWakeup;
+
+    // only used on the reactor thread
+    std::unordered_set<IOHandlerBufferHelper *> sources;
+    std::unordered_map<int, IOHandlerBufferHelper *> fdSources;
+    std::unordered_map<int, int> watched;
+#ifdef HAVE_EPOLL
+    int epollFd;
+#endif
+
+    void watch(int fd, int events);
+    void updateInterest(IOHandlerBufferHelper *source);
+    void waitForEvents(long timeoutMillis, std::vector<std::pair<int, int> > &events);
+    void processSource(IOHandlerBufferHelper *source, bool idle);
+    void detachSource(IOHandlerBufferHelper *source);
+
+#ifdef HAVE_CURL
+    CURLM *multiHandle;
+    zmm::Ref<HTTPClient> httpClient;
+    std::unordered_map<int, int> curlSockets;
+    bool curlTimerSet;
+    struct timespec curlDeadline;
+
+    static int curlSocketCallback(CURL *easy, curl_socket_t s, int what, void *userp, void *socketp);
+    static int curlTimerCallback(CURLM *multi, long timeoutMillis, void *userp);
+    void checkCurlTransfers();
+#endif
+
+    static void *staticThreadProc(void *arg);
+    void threadProc();
+};
+
+#endif // __IO_REACTOR_H__
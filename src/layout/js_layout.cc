@@ -32,13 +32,14 @@
 #ifdef HAVE_JS
 
 #include "js_layout.h"
-#include "scripting/runtime.h"
+#include "config_manager.h"
 
 using namespace zmm;
 
 JSLayout::JSLayout() : Layout()
 {
-    import_script = Ref<ImportScript>(new ImportScript(Runtime::getInstance()));
+    int poolSize = ConfigManager::getInstance()->getIntOption(CFG_IMPORT_SCRIPTING_RUNTIME_POOL_SIZE);
+    import_scripts = Ref<ScriptPool<ImportScript>>(new ScriptPool<ImportScript>(poolSize));
 }
 
 JSLayout::~JSLayout()
@@ -47,9 +48,10 @@ JSLayout::~JSLayout()
 
 void JSLayout::processCdsObject(Ref<CdsObject> obj, String rootpath)
 {
-    if (import_script == nullptr)
+    if (import_scripts == nullptr)
         return;
 
+    ScriptPool<ImportScript>::Borrowed import_script(import_scripts);
     import_script->processCdsObject(obj, rootpath);
 }
 
@@ -34,11 +34,12 @@
 
 #include "layout.h"
 #include "scripting/import_script.h"
+#include "scripting/script_pool.h"
 
 class JSLayout : public Layout
 {
 protected:
-    zmm::Ref<ImportScript> import_script;
+    zmm::Ref<ScriptPool<ImportScript>> import_scripts;
 
 public:
     JSLayout();
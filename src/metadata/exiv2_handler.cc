@@ -47,12 +47,23 @@ Exiv2Handler::Exiv2Handler()
 }
 
 void Exiv2Handler::fillMetadata(Ref<CdsItem> item)
+{
+    fillMetadata(item, Ref<FileProbe>(new FileProbe(item->getLocation())));
+}
+
+void Exiv2Handler::fillMetadata(Ref<CdsItem> item, Ref<FileProbe> probe)
 {
     try {
         String value;
         Ref<StringConverter> sc = StringConverter::m2i();
 
-        Exiv2::Image::AutoPtr image = Exiv2::ImageFactory::open(std::string(item->getLocation().c_str()));
+        // exiv2 reads the mapped file instead of opening it once more
+        Exiv2::Image::AutoPtr image;
+        const char* data = probe->map();
+        if (data != nullptr)
+            image = Exiv2::ImageFactory::open((const Exiv2::byte*)data, probe->getSize());
+        else
+            image = Exiv2::ImageFactory::open(std::string(item->getLocation().c_str()));
         image->readMetadata();
         Exiv2::ExifData& exifData = image->exifData();
         Exiv2::XmpData& xmpData = image->xmpData();
@@ -39,6 +39,7 @@ class Exiv2Handler : public MetadataHandler {
 public:
     Exiv2Handler();
     virtual void fillMetadata(zmm::Ref<CdsItem> item);
+    virtual void fillMetadata(zmm::Ref<CdsItem> item, zmm::Ref<FileProbe> probe);
     virtual zmm::Ref<IOHandler> serveContent(zmm::Ref<CdsItem> item, int resNum, off_t* data_size);
 };
 
@@ -75,6 +75,8 @@ extern "C" {
 
 using namespace zmm;
 
+#define FFMPEG_PROBE_IO_BUFFER_SIZE 32768
+
 // Default constructor
 FfmpegHandler::FfmpegHandler()
     : MetadataHandler()
@@ -247,7 +249,54 @@ void FfmpegNoOutputStub(void* ptr, int level, const char* fmt, va_list vl)
     // do nothing
 }
 
+// Custom ffmpeg IO reading through the FileProbe
+struct FfmpegProbeIO {
+    Ref<FileProbe> probe;
+    int64_t position;
+};
+
+static int ffmpegProbeRead(void* opaque, uint8_t* buf, int buf_size)
+{
+    auto* io = (FfmpegProbeIO*)opaque;
+    size_t bytes;
+    try {
+        bytes = io->probe->read(io->position, buf, buf_size);
+    } catch (const Exception& e) {
+        return AVERROR(EIO);
+    }
+    if (bytes == 0)
+        return AVERROR_EOF;
+    io->position += bytes;
+    return bytes;
+}
+
+static int64_t ffmpegProbeSeek(void* opaque, int64_t offset, int whence)
+{
+    auto* io = (FfmpegProbeIO*)opaque;
+    switch (whence & ~AVSEEK_FORCE) {
+    case AVSEEK_SIZE:
+        return io->probe->getSize();
+    case SEEK_SET:
+        io->position = offset;
+        break;
+    case SEEK_CUR:
+        io->position += offset;
+        break;
+    case SEEK_END:
+        io->position = io->probe->getSize() + offset;
+        break;
+    default:
+        return -1;
+    }
+    return io->position;
+}
+
 void FfmpegHandler::fillMetadata(Ref<CdsItem> item)
+{
+    fillMetadata(item, Ref<FileProbe>(new FileProbe(item->getLocation())));
+}
+
+void FfmpegHandler::fillMetadata(Ref<CdsItem> item, Ref<FileProbe> probe)
 {
     log_debug("Running ffmpeg handler on %s\n", item->getLocation().c_str());
 
@@ -262,26 +311,47 @@ void FfmpegHandler::fillMetadata(Ref<CdsItem> item)
     // Register all formats and codecs
     av_register_all();
 
-    // Open video file
+    pFormatCtx = avformat_alloc_context();
+    if (pFormatCtx == NULL)
+        return;
+
+    // Read through the probe, the headers come from memory and the file
+    // is not opened again
+    FfmpegProbeIO io = { probe, 0 };
+    auto* ioBuffer = (unsigned char*)av_malloc(FFMPEG_PROBE_IO_BUFFER_SIZE);
+    AVIOContext* ioCtx = NULL;
+    if (ioBuffer != NULL)
+        ioCtx = avio_alloc_context(ioBuffer, FFMPEG_PROBE_IO_BUFFER_SIZE, 0, &io, ffmpegProbeRead, NULL, ffmpegProbeSeek);
+    if (ioCtx == NULL) {
+        av_free(ioBuffer);
+        avformat_free_context(pFormatCtx);
+        return;
+    }
+    pFormatCtx->pb = ioCtx;
+    pFormatCtx->flags |= AVFMT_FLAG_CUSTOM_IO;
+
+    // Open video file, the name is only a hint for the format detection,
+    // a failed open frees the context
     if (avformat_open_input(&pFormatCtx,
             item->getLocation().c_str(), NULL, NULL)
-        != 0)
-        return; // Couldn't open file
+        == 0) {
+        // Retrieve stream information
+        if (avformat_find_stream_info(pFormatCtx, NULL) >= 0) {
+            // Add metadata using ffmpeg library calls
+            addFfmpegMetadataFields(item, pFormatCtx);
+            // Add auxdata
+            addFfmpegAuxdataFields(item, pFormatCtx);
+            // Add resources using ffmpeg library calls
+            addFfmpegResourceFields(item, pFormatCtx, &x, &y);
+        }
 
-    // Retrieve stream information
-    if (avformat_find_stream_info(pFormatCtx, NULL) < 0) {
+        // Close the video file
         avformat_close_input(&pFormatCtx);
-        return; // Couldn't find stream information
     }
-    // Add metadata using ffmpeg library calls
-    addFfmpegMetadataFields(item, pFormatCtx);
-    // Add auxdata
-    addFfmpegAuxdataFields(item, pFormatCtx);
-    // Add resources using ffmpeg library calls
-    addFfmpegResourceFields(item, pFormatCtx, &x, &y);
-
-    // Close the video file
-    avformat_close_input(&pFormatCtx);
+
+    // custom IO is left to the caller
+    av_freep(&ioCtx->buffer);
+    av_freep(&ioCtx);
 }
 
 #ifdef HAVE_FFMPEGTHUMBNAILER
@@ -32,6 +32,8 @@
 
 #ifdef HAVE_LIBEXIF
 
+#include <libexif/exif-loader.h>
+
 #include "libexif_handler.h"
 #include "tools.h"
 #include "config_manager.h"
@@ -356,13 +358,34 @@ void LibExifHandler::process_ifd (ExifContent *content, Ref<CdsItem> item, Ref<S
 
 
 void LibExifHandler::fillMetadata(Ref<CdsItem> item)
+{
+    fillMetadata(item, Ref<FileProbe>(new FileProbe(item->getLocation())));
+}
+
+void LibExifHandler::fillMetadata(Ref<CdsItem> item, Ref<FileProbe> probe)
 {
     ExifData    *ed;
     Ref<Array<StringBase> > aux;
     
     Ref<StringConverter> sc = StringConverter::m2i();
 
-    ed = exif_data_new_from_file(item->getLocation().c_str());
+    // the exif block is at the start of the file, usually the head that
+    // the probe read already holds all of it
+    ExifLoader *loader = exif_loader_new();
+    off_t offset = probe->getHeadLength();
+    if (exif_loader_write(loader, (unsigned char *)probe->getHead(), offset))
+    {
+        unsigned char buffer[4096];
+        size_t bytes;
+        while ((bytes = probe->read(offset, buffer, sizeof(buffer))) > 0)
+        {
+            offset += bytes;
+            if (!exif_loader_write(loader, buffer, bytes))
+                break;
+        }
+    }
+    ed = exif_loader_get_data(loader);
+    exif_loader_unref(loader);
 
     if (!ed)
     {
@@ -56,6 +56,7 @@ protected:
 public:
     LibExifHandler();
     virtual void fillMetadata(zmm::Ref<CdsItem> item);
+    virtual void fillMetadata(zmm::Ref<CdsItem> item, zmm::Ref<FileProbe> probe);
     virtual zmm::Ref<IOHandler> serveContent(zmm::Ref<CdsItem> item, int resNum, off_t *data_size);
 };
 
@@ -61,6 +61,55 @@ TagLibHandler::TagLibHandler() : MetadataHandler()
 {
 }
 
+/// \brief Read only TagLib stream on top of a FileProbe, so that the tags
+/// are read from the windows the probe already holds.
+class ProbeIOStream : public TagLib::IOStream {
+public:
+    explicit ProbeIOStream(Ref<FileProbe> probe)
+        : probe(probe)
+        , position(0)
+    {
+    }
+
+    TagLib::FileName name() const override { return probe->getPath().c_str(); }
+
+    TagLib::ByteVector readBlock(unsigned long length) override
+    {
+        if (position >= probe->getSize())
+            return TagLib::ByteVector();
+        if ((long)length > probe->getSize() - position)
+            length = probe->getSize() - position;
+        TagLib::ByteVector data((unsigned int)length, 0);
+        size_t bytes = probe->read(position, data.data(), length);
+        data.resize((unsigned int)bytes);
+        position += bytes;
+        return data;
+    }
+
+    void writeBlock(const TagLib::ByteVector& data) override { }
+    void insert(const TagLib::ByteVector& data, unsigned long start = 0, unsigned long replace = 0) override { }
+    void removeBlock(unsigned long start = 0, unsigned long length = 0) override { }
+    bool readOnly() const override { return true; }
+    bool isOpen() const override { return true; }
+
+    void seek(long offset, Position p = Beginning) override
+    {
+        if (p == Current)
+            offset += position;
+        else if (p == End)
+            offset += probe->getSize();
+        position = (offset < 0) ? 0 : offset;
+    }
+
+    long tell() const override { return position; }
+    long length() override { return probe->getSize(); }
+    void truncate(long length) override { }
+
+private:
+    Ref<FileProbe> probe;
+    long position;
+};
+
 static void addField(metadata_fields_t field, const TagLib::File& file, const TagLib::Tag* tag, Ref<CdsItem> item)
 {
     if (tag == nullptr)
@@ -203,11 +252,16 @@ void TagLibHandler::populateGenericTags(Ref<CdsItem> item, const TagLib::File& f
 }
 
 void TagLibHandler::fillMetadata(Ref<CdsItem> item)
+{
+    fillMetadata(item, Ref<FileProbe>(new FileProbe(item->getLocation())));
+}
+
+void TagLibHandler::fillMetadata(Ref<CdsItem> item, Ref<FileProbe> probe)
 {
     Ref<Dictionary> mappings = ConfigManager::getInstance()->getDictionaryOption(CFG_IMPORT_MAPPINGS_MIMETYPE_TO_CONTENTTYPE_LIST);
     String content_type = mappings->get(item->getMimeType());
 
-    TagLib::FileStream fs(item->getLocation().c_str(), true); // true = Read only
+    ProbeIOStream fs(probe);
 
     if (content_type == CONTENT_TYPE_MP3) {
         extractMP3(&fs, item);
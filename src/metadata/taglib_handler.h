@@ -47,6 +47,7 @@ class TagLibHandler : public MetadataHandler
 public:
     TagLibHandler();
     virtual void fillMetadata(zmm::Ref<CdsItem> item);
+    virtual void fillMetadata(zmm::Ref<CdsItem> item, zmm::Ref<FileProbe> probe);
     virtual zmm::Ref<IOHandler> serveContent(zmm::Ref<CdsItem> item, int resNum, off_t *data_size);
 private:
     void populateGenericTags(zmm::Ref<CdsItem> item, const TagLib::File& file) const;
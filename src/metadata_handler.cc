@@ -93,13 +93,14 @@ MetadataHandler::MetadataHandler() : Object()
 {
 }
        
-void MetadataHandler::setMetadata(Ref<CdsItem> item)
+void MetadataHandler::setMetadata(Ref<CdsItem> item, Ref<FileProbe> probe)
 {
     String location = item->getLocation();
-    off_t filesize;
 
     string_ok_ex(location);
-    check_path_ex(location, false, false, &filesize);
+    if (probe == nullptr)
+        probe = Ref<FileProbe>(new FileProbe(location));
+    off_t filesize = S_ISREG(probe->getStat().st_mode) ? probe->getSize() : 0;
 
     String mimetype = item->getMimeType();
 
@@ -109,10 +110,11 @@ void MetadataHandler::setMetadata(Ref<CdsItem> item)
     
     item->addResource(resource);
 
-    Ref<Dictionary> mappings = ConfigManager::getInstance()->getDictionaryOption(CFG_IMPORT_MAPPINGS_MIMETYPE_TO_CONTENTTYPE_LIST);
+    Ref<ConfigManager> cm = ConfigManager::getInstance();
+    Ref<Dictionary> mappings = cm->getDictionaryOption(CFG_IMPORT_MAPPINGS_MIMETYPE_TO_CONTENTTYPE_LIST);
     String content_type = mappings->get(mimetype);
    
-    if ((content_type == CONTENT_TYPE_OGG) && (isTheora(item->getLocation())))
+    if ((content_type == CONTENT_TYPE_OGG) && (probe->isTheora()))
             item->setFlag(OBJECT_FLAG_OGG_THEORA);
 
 #ifdef HAVE_TAGLIB
@@ -126,7 +128,7 @@ void MetadataHandler::setMetadata(Ref<CdsItem> item)
         (content_type == CONTENT_TYPE_APE) ||
         (content_type == CONTENT_TYPE_MP4))
     {
-        TagLibHandler().fillMetadata(item);
+        TagLibHandler().fillMetadata(item, probe);
     }
 #endif // HAVE_TAGLIB
 
@@ -134,7 +136,7 @@ void MetadataHandler::setMetadata(Ref<CdsItem> item)
         
     if (content_type == CONTENT_TYPE_JPG)
     {
-        Exiv2Handler().fillMetadata(item);
+        Exiv2Handler().fillMetadata(item, probe);
     } 
 
 #endif
@@ -142,23 +144,30 @@ void MetadataHandler::setMetadata(Ref<CdsItem> item)
 #ifdef HAVE_LIBEXIF
     if (content_type == CONTENT_TYPE_JPG)
     {
-        LibExifHandler().fillMetadata(item);
+        LibExifHandler().fillMetadata(item, probe);
     }
 #endif // HAVE_LIBEXIF
 
 #ifdef HAVE_FFMPEG
-    if (content_type != CONTENT_TYPE_PLAYLIST &&
+    // taglib already read the audio properties, ffmpeg would only parse
+    // the file once more unless it has to look for auxdata tags
+    Ref<Array<StringBase> > ffmpegAux = cm->getStringArrayOption(CFG_IMPORT_LIBOPTS_FFMPEG_AUXDATA_TAGS_LIST);
+    bool audioDone = item->getMimeType().startsWith(_("audio")) &&
+        string_ok(item->getResource(0)->getAttribute(getResAttrName(R_DURATION))) &&
+        (ffmpegAux == nullptr || ffmpegAux->size() == 0);
+
+    if (content_type != CONTENT_TYPE_PLAYLIST && !audioDone &&
         ((content_type == CONTENT_TYPE_OGG &&
          item->getFlag(OBJECT_FLAG_OGG_THEORA)) ||
         item->getMimeType().startsWith(_("video")) ||
         item->getMimeType().startsWith(_("audio"))))
     {
-        FfmpegHandler().fillMetadata(item);
+        FfmpegHandler().fillMetadata(item, probe);
     }
 #else
     if (content_type == CONTENT_TYPE_AVI)
     {
-        String fourcc = getAVIFourCC(item->getLocation());
+        String fourcc = probe->getAVIFourCC();
         if (string_ok(fourcc))
         {
             item->getResource(0)->addOption(_(RESOURCE_OPTION_FOURCC),
@@ -35,6 +35,7 @@
 #include "common.h"
 #include "dictionary.h"
 #include "cds_objects.h"
+#include "file_probe.h"
 #include "io_handler.h"
 
 // content handler Id's
@@ -146,13 +147,18 @@ public:
 
     MetadataHandler();
        
-    static void setMetadata(zmm::Ref<CdsItem> item);
+    /// \brief Adds the default resource and the metadata of the file.
+    /// \param probe the opened file, a new probe is made if not given
+    static void setMetadata(zmm::Ref<CdsItem> item, zmm::Ref<FileProbe> probe = nullptr);
     static zmm::String getMetaFieldName(metadata_fields_t field);
     static zmm::String getResAttrName(resource_attributes_t attr);
 
     static zmm::Ref<MetadataHandler> createHandler(int handlerType);
     
     virtual void fillMetadata(zmm::Ref<CdsItem> item) = 0;
+    /// \brief Same as fillMetadata(item), but reads through the probe instead
+    /// of opening the file again.
+    virtual void fillMetadata(zmm::Ref<CdsItem> item, zmm::Ref<FileProbe> probe) { fillMetadata(item); }
     virtual zmm::Ref<IOHandler> serveContent(zmm::Ref<CdsItem> item, int resNum, off_t *data_size) = 0;
     virtual zmm::String getMimeType();
 };
@@ -0,0 +1,227 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    mt_fanotify.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file mt_fanotify.cc
+
+#ifdef HAVE_INOTIFY
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/statfs.h>
+#include <unistd.h>
+
+#include "mt_fanotify.h"
+#include "tools.h"
+
+using namespace zmm;
+
+#ifdef FAN_REPORT_DFID_NAME
+#define FANOTIFY_INIT_FLAGS (FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_REPORT_DFID_NAME)
+#define FANOTIFY_EVENTS (FAN_CREATE | FAN_DELETE | FAN_MOVED_FROM | FAN_MOVED_TO | FAN_CLOSE_WRITE | FAN_ONDIR)
+#endif
+
+static uint64_t fsidKey(int val0, int val1)
+{
+    return ((uint64_t)(uint32_t)val0 << 32) | (uint32_t)val1;
+}
+
+Fanotify::Fanotify()
+    : bufferLength(0)
+    , bufferOffset(0)
+{
+#ifdef FAN_REPORT_DFID_NAME
+    fanotify_fd = fanotify_init(FANOTIFY_INIT_FLAGS, O_RDONLY | O_LARGEFILE);
+    if (fanotify_fd < 0)
+        throw _Exception(_("Unable to initialize fanotify: ") + mt_strerror(errno));
+#else
+    throw _Exception(_("This version of Gerbera was compiled without fanotify support"));
+#endif
+
+    int stop_fds_pipe[2];
+    if (pipe(stop_fds_pipe) < 0) {
+        close(fanotify_fd);
+        throw _Exception(_("Unable to create pipe!\n"));
+    }
+    stop_fd_read = stop_fds_pipe[0];
+    stop_fd_write = stop_fds_pipe[1];
+}
+
+Fanotify::~Fanotify()
+{
+    for (auto& mount : mountFds)
+        close(mount.second);
+    close(stop_fd_read);
+    close(stop_fd_write);
+    close(fanotify_fd);
+}
+
+bool Fanotify::supported()
+{
+#ifdef FAN_REPORT_DFID_NAME
+    int test_fd = fanotify_init(FANOTIFY_INIT_FLAGS, O_RDONLY);
+    if (test_fd < 0)
+        return false;
+    close(test_fd);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Fanotify::markFilesystem(String path)
+{
+#ifdef FAN_REPORT_DFID_NAME
+    struct statfs fs;
+    if (statfs(path.c_str(), &fs) != 0)
+        throw _Exception(_("Could not stat filesystem of ") + path + " : " + mt_strerror(errno));
+
+    uint64_t key = fsidKey(fs.f_fsid.__val[0], fs.f_fsid.__val[1]);
+    if (mountFds.find(key) != mountFds.end())
+        return;
+
+    if (fanotify_mark(fanotify_fd, FAN_MARK_ADD | FAN_MARK_FILESYSTEM, FANOTIFY_EVENTS, AT_FDCWD, path.c_str()) != 0)
+        throw _Exception(_("Could not add fanotify mark for ") + path + " : " + mt_strerror(errno));
+
+    // handles are resolved relative to any directory of the filesystem
+    int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+        throw _Exception(_("Could not open ") + path + " : " + mt_strerror(errno));
+    mountFds.emplace(key, fd);
+    log_debug("Added fanotify mark for the filesystem of %s\n", path.c_str());
+#endif
+}
+
+bool Fanotify::nextEvent(FanotifyEvent& event, int timeout)
+{
+    while (true) {
+        while (bufferOffset < bufferLength) {
+            auto* metadata = (const struct fanotify_event_metadata*)(buffer + bufferOffset);
+            ssize_t remaining = bufferLength - bufferOffset;
+            if (!FAN_EVENT_OK(metadata, remaining)) {
+                bufferOffset = bufferLength;
+                break;
+            }
+            bufferOffset += metadata->event_len;
+            if (parseEvent(metadata, event))
+                return true;
+        }
+
+        struct pollfd fds[2];
+        fds[0].fd = fanotify_fd;
+        fds[0].events = POLLIN;
+        fds[1].fd = stop_fd_read;
+        fds[1].events = POLLIN;
+        int rc = poll(fds, 2, timeout);
+        if (rc <= 0)
+            return false;
+
+        if (fds[1].revents & POLLIN) {
+            char buf;
+            if (read(stop_fd_read, &buf, 1) == -1) {
+                log_error("Fanotify: could not read stop: %s\n", mt_strerror(errno).c_str());
+            }
+            return false;
+        }
+
+        bufferOffset = 0;
+        bufferLength = read(fanotify_fd, buffer, sizeof(buffer));
+        if (bufferLength <= 0) {
+            bufferLength = 0;
+            if (errno != EAGAIN && errno != EINTR)
+                log_error("Fanotify: could not read events: %s\n", mt_strerror(errno).c_str());
+            return false;
+        }
+        // the timeout applies to the wait, not to every buffered event
+        timeout = 0;
+    }
+}
+
+bool Fanotify::parseEvent(const struct fanotify_event_metadata* metadata, FanotifyEvent& event)
+{
+    if (metadata->vers != FANOTIFY_METADATA_VERSION) {
+        log_error("Fanotify: unexpected metadata version %d\n", metadata->vers);
+        return false;
+    }
+
+    event.mask = metadata->mask;
+    event.path.clear();
+    if (metadata->mask & FAN_Q_OVERFLOW)
+        return true;
+
+#ifdef FAN_REPORT_DFID_NAME
+    const char* info = (const char*)metadata + metadata->metadata_len;
+    const char* end = (const char*)metadata + metadata->event_len;
+    while (info + sizeof(struct fanotify_event_info_header) <= end) {
+        auto* header = (const struct fanotify_event_info_header*)info;
+        if (header->len == 0 || info + header->len > end)
+            break;
+        if (header->info_type != FAN_EVENT_INFO_TYPE_DFID_NAME) {
+            info += header->len;
+            continue;
+        }
+
+        auto* fid = (const struct fanotify_event_info_fid*)info;
+        auto mount = mountFds.find(fsidKey(fid->fsid.val[0], fid->fsid.val[1]));
+        if (mount == mountFds.end())
+            return false;
+
+        auto* handle = (struct file_handle*)fid->handle;
+        const char* name = (const char*)handle->f_handle + handle->handle_bytes;
+
+        int dirFd = open_by_handle_at(mount->second, handle, O_PATH | O_CLOEXEC);
+        if (dirFd < 0) {
+            log_debug("Fanotify: could not open directory handle: %s\n", mt_strerror(errno).c_str());
+            return false;
+        }
+        char procPath[32];
+        char dirPath[PATH_MAX];
+        snprintf(procPath, sizeof(procPath), "/proc/self/fd/%d", dirFd);
+        ssize_t length = readlink(procPath, dirPath, sizeof(dirPath) - 1);
+        close(dirFd);
+        if (length <= 0)
+            return false;
+
+        event.path.assign(dirPath, length);
+        if (strcmp(name, ".") != 0) {
+            if (event.path.back() != DIR_SEPARATOR)
+                event.path += DIR_SEPARATOR;
+            event.path += name;
+        }
+        return true;
+    }
+#endif
+    return false;
+}
+
+void Fanotify::stop()
+{
+    char stop = 'S';
+    if (write(stop_fd_write, &stop, 1) == -1) {
+        log_error("Fanotify: could not send stop: %s\n", mt_strerror(errno).c_str());
+    }
+}
+
+#endif // HAVE_INOTIFY
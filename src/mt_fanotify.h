@@ -0,0 +1,98 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    mt_fanotify.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file mt_fanotify.h
+
+#ifndef __MT_FANOTIFY_H__
+#define __MT_FANOTIFY_H__
+
+#ifdef HAVE_INOTIFY
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <sys/fanotify.h>
+
+#include "zmm/zmmf.h"
+
+#define FANOTIFY_BUFFER_SIZE 65536
+
+struct FanotifyEvent {
+    /// \brief FAN_* event bits, FAN_ONDIR for directories
+    uint64_t mask;
+    /// \brief path of the file or directory the event is about, empty for
+    /// FAN_Q_OVERFLOW
+    std::string path;
+};
+
+/// \brief Fanotify interface watching whole filesystems.
+///
+/// Needs a kernel that reports the directory and name of an event
+/// (FAN_REPORT_DFID_NAME, Linux 5.9) and CAP_SYS_ADMIN. Paths are
+/// reported as the kernel sees them, symlinks are resolved.
+class Fanotify : public zmm::Object
+{
+public:
+    Fanotify();
+    virtual ~Fanotify();
+
+    /// \brief Watches the filesystem the given path lives on.
+    ///
+    /// Each filesystem is marked only once, no matter how many directories
+    /// of it are watched.
+    void markFilesystem(zmm::String path);
+
+    /// \brief Returns the next event.
+    ///
+    /// Events whose directory is already gone are skipped.
+    /// \param timeout milliseconds to wait at most, -1 waits until stop()
+    /// \return false if no event arrived
+    bool nextEvent(FanotifyEvent& event, int timeout = -1);
+
+    /// \brief Unblocks nextEvent().
+    void stop();
+
+    /// \brief Number of marked filesystems.
+    int getMarkCount() { return mountFds.size(); }
+
+    /// \brief Checks if the kernel and our privileges allow fanotify.
+    static bool supported();
+
+private:
+    int fanotify_fd;
+    int stop_fd_read;
+    int stop_fd_write;
+
+    /// \brief directory fds to resolve handles on, by filesystem id
+    std::unordered_map<uint64_t, int> mountFds;
+
+    char buffer[FANOTIFY_BUFFER_SIZE];
+    ssize_t bufferLength;
+    ssize_t bufferOffset;
+
+    bool parseEvent(const struct fanotify_event_metadata* metadata, FanotifyEvent& event);
+};
+
+#endif
+
+#endif // __MT_FANOTIFY_H__
@@ -60,7 +60,8 @@ public:
     /// This function will return the next inotify event that occurs, in case
     /// that there are no events the function will block indefinetely. It can
     /// be unblocked by the stop function.
-    struct inotify_event * nextEvent();
+    /// \param timeout milliseconds to wait at most, -1 waits indefinetely
+    struct inotify_event * nextEvent(int timeout = -1);
 
     /// \brief Unblock the next_event function.
     void stop();
@@ -0,0 +1,184 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    mt_io_uring.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file mt_io_uring.cc
+
+#ifdef HAVE_IO_URING
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "mt_io_uring.h"
+#include "tools.h"
+
+using namespace zmm;
+
+static int sys_io_uring_setup(unsigned int entries, struct io_uring_params* params)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int sys_io_uring_enter(int fd, unsigned int toSubmit, unsigned int minComplete, unsigned int flags)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, _NSIG / 8);
+}
+
+static int sys_io_uring_register(int fd, unsigned int opcode, void* arg, unsigned int nrArgs)
+{
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs);
+}
+
+IOUring::IOUring(unsigned int entries)
+    : ringFd(-1)
+    , entries(0)
+    , prepared(0)
+    , sqRing(MAP_FAILED)
+    , sqRingSize(0)
+    , cqRing(MAP_FAILED)
+    , cqRingSize(0)
+    , sqes(static_cast<struct io_uring_sqe*>(MAP_FAILED))
+    , sqesSize(0)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ringFd = sys_io_uring_setup(entries, &params);
+    if (ringFd < 0)
+        throw _Exception(_("Unable to initialize io_uring: ") + mt_strerror(errno));
+    this->entries = params.sq_entries;
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+    void* sqesMap = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    sqes = static_cast<struct io_uring_sqe*>(sqesMap);
+    if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqesMap == MAP_FAILED) {
+        int err = errno;
+        unmap();
+        ::close(ringFd);
+        throw _Exception(_("Unable to map io_uring: ") + mt_strerror(err));
+    }
+
+    char* sq = static_cast<char*>(sqRing);
+    sqHead = reinterpret_cast<unsigned int*>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+
+    char* cq = static_cast<char*>(cqRing);
+    cqHead = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+}
+
+IOUring::~IOUring()
+{
+    unmap();
+    if (ringFd >= 0)
+        ::close(ringFd);
+}
+
+void IOUring::unmap()
+{
+    if (sqRing != MAP_FAILED)
+        munmap(sqRing, sqRingSize);
+    if (cqRing != MAP_FAILED)
+        munmap(cqRing, cqRingSize);
+    if (sqes != MAP_FAILED)
+        munmap(sqes, sqesSize);
+    sqRing = MAP_FAILED;
+    cqRing = MAP_FAILED;
+    sqes = static_cast<struct io_uring_sqe*>(MAP_FAILED);
+}
+
+bool IOUring::supported()
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = sys_io_uring_setup(1, &params);
+    if (fd < 0)
+        return false;
+
+    // the probe itself needs Linux 5.6, as does IORING_OP_READ
+    size_t size = sizeof(struct io_uring_probe) + IORING_OP_LAST * sizeof(struct io_uring_probe_op);
+    auto* probe = static_cast<struct io_uring_probe*>(calloc(1, size));
+    bool ok = sys_io_uring_register(fd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) == 0
+        && probe->last_op >= IORING_OP_READ
+        && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+    free(probe);
+    ::close(fd);
+    return ok;
+}
+
+bool IOUring::prepareRead(int fd, void* buf, unsigned int length, off_t offset, uint64_t userData)
+{
+    unsigned int tail = *sqTail + prepared;
+    if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= entries)
+        return false;
+
+    unsigned int index = tail & *sqMask;
+    struct io_uring_sqe* sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = length;
+    sqe->off = offset;
+    sqe->user_data = userData;
+    sqArray[index] = index;
+    prepared++;
+    return true;
+}
+
+void IOUring::submit(unsigned int minComplete)
+{
+    if (prepared > 0) {
+        __atomic_store_n(sqTail, *sqTail + prepared, __ATOMIC_RELEASE);
+        prepared = 0;
+    }
+
+    unsigned int flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    while (true) {
+        // entries the kernel did not take last time are submitted again
+        unsigned int toSubmit = *sqTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (toSubmit == 0 && minComplete == 0)
+            return;
+        if (sys_io_uring_enter(ringFd, toSubmit, minComplete, flags) >= 0)
+            return;
+        if (errno == EINTR)
+            continue;
+        // the completion queue is full, the caller reaps and submits again
+        if (errno == EAGAIN || errno == EBUSY)
+            return;
+        throw _Exception(_("io_uring_enter failed: ") + mt_strerror(errno));
+    }
+}
+
+#endif // HAVE_IO_URING
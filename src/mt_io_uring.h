@@ -0,0 +1,109 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    mt_io_uring.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file mt_io_uring.h
+
+#ifndef __MT_IO_URING_H__
+#define __MT_IO_URING_H__
+
+#ifdef HAVE_IO_URING
+
+#include <cstdint>
+#include <sys/types.h>
+#include <linux/io_uring.h>
+
+#include "zmm/zmmf.h"
+
+/// \brief Minimal io_uring interface for reads.
+///
+/// Uses the system calls directly, no liburing needed. Entries are only
+/// prepared by one thread, which also submits them and reaps the
+/// completions.
+class IOUring : public zmm::Object
+{
+public:
+    /// \param entries size of the submission queue, the completion queue
+    /// is twice as large
+    explicit IOUring(unsigned int entries);
+    virtual ~IOUring();
+
+    /// \brief Checks if the kernel supports the operations we use,
+    /// IORING_OP_READ needs Linux 5.6.
+    static bool supported();
+
+    /// \brief Queues a read, it is handed to the kernel by submit().
+    /// \return false if the submission queue is full
+    bool prepareRead(int fd, void *buf, unsigned int length, off_t offset, uint64_t userData);
+
+    /// \brief Hands all prepared entries to the kernel with a single
+    /// system call.
+    /// \param minComplete waits until this many completions are available
+    void submit(unsigned int minComplete);
+
+    /// \brief Calls handler(userData, result) for every completion.
+    /// \return number of completions
+    template <typename Handler>
+    unsigned int reap(Handler handler)
+    {
+        unsigned int count = 0;
+        unsigned int head = *cqHead;
+        while (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+            struct io_uring_cqe *cqe = &cqes[head & *cqMask];
+            handler(cqe->user_data, cqe->res);
+            head++;
+            count++;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        return count;
+    }
+
+    inline unsigned int getEntries() { return entries; }
+
+protected:
+    int ringFd;
+    unsigned int entries;
+    /// \brief prepared entries not yet handed to the kernel
+    unsigned int prepared;
+
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    struct io_uring_sqe *sqes;
+    size_t sqesSize;
+
+    unsigned int *sqHead;
+    unsigned int *sqTail;
+    unsigned int *sqMask;
+    unsigned int *sqArray;
+    unsigned int *cqHead;
+    unsigned int *cqTail;
+    unsigned int *cqMask;
+    struct io_uring_cqe *cqes;
+
+    void unmap();
+};
+
+#endif // HAVE_IO_URING
+
+#endif // __MT_IO_URING_H__
@@ -55,5 +55,6 @@ enum mxml_value_type
 #include "parseexception.h"
 #include "parser.h"
 #include "xml_to_json.h"
+#include "response_writer.h"
 
 #endif // __MXML_H__
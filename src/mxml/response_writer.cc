@@ -0,0 +1,240 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    response_writer.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file response_writer.cc
+
+#include <cassert>
+#include <cstring>
+
+#include "response_writer.h"
+
+using namespace zmm;
+using namespace mxml;
+
+ElementWriter::ElementWriter(Ref<Element> root)
+{
+    elements.push_back(root);
+}
+
+void ElementWriter::beginObject(const char* name)
+{
+    Ref<Element> el(new Element(name));
+    elements.back()->appendElementChild(el);
+    elements.push_back(el);
+}
+
+void ElementWriter::beginArray(const char* name, const char* itemName)
+{
+    beginObject(name);
+    elements.back()->setArrayName(itemName);
+}
+
+void ElementWriter::end()
+{
+    if (elements.size() <= 1)
+        throw _Exception(_("ElementWriter: end() without a started element"));
+    elements.pop_back();
+}
+
+void ElementWriter::attribute(const char* name, String value, enum mxml_value_type type)
+{
+    elements.back()->setAttribute(name, value, type);
+}
+
+void ElementWriter::attribute(const char* name, int value)
+{
+    elements.back()->setAttribute(name, String::from(value), mxml_int_type);
+}
+
+void ElementWriter::textChild(const char* name, String text, enum mxml_value_type type)
+{
+    elements.back()->appendTextChild(name, text, type);
+}
+
+void ElementWriter::text(const char* textKey, String text, enum mxml_value_type type)
+{
+    elements.back()->setTextKey(textKey);
+    elements.back()->setText(text, type);
+}
+
+JSONWriter::JSONWriter()
+{
+    clear();
+}
+
+void JSONWriter::clear()
+{
+    buf.clear();
+    levels.clear();
+    levels.push_back(Level { nullptr, false, false, true, nullptr, nullptr, mxml_string_type });
+}
+
+void JSONWriter::beginChild(const char* name)
+{
+    Level& level = levels.back();
+    if (level.itemName == nullptr) {
+        beginMember(name);
+        return;
+    }
+
+    if (strcmp(level.itemName, name) != 0)
+        throw _Exception(_("JSONWriter: if an element is of arrayType, all children have to have the same name"));
+    if (!level.arrayOpen) {
+        beginMember(level.itemName);
+        buf += '[';
+        level.arrayOpen = true;
+        level.first = true;
+    }
+    if (!level.first)
+        buf += ',';
+    level.first = false;
+}
+
+void JSONWriter::beginMember(const char* name)
+{
+    Level& level = levels.back();
+    if (level.textKey != nullptr)
+        throw _Exception(_("JSONWriter: the text has to be the last part of an element"));
+    if (level.arrayOpen)
+        throw _Exception(_("JSONWriter: attributes have to be written before the children of an array"));
+    if (!level.open) {
+        buf += '{';
+        level.open = true;
+    }
+    if (!level.first)
+        buf += ',';
+    level.first = false;
+    writeString(name, strlen(name));
+    buf += ':';
+}
+
+void JSONWriter::beginObject(const char* name)
+{
+    beginChild(name);
+    // like XML2JSON, an element without attributes and children is written
+    // as its text, so the brace is only written with the first member
+    levels.push_back(Level { nullptr, true, false, false, nullptr, nullptr, mxml_string_type });
+}
+
+void JSONWriter::beginArray(const char* name, const char* itemName)
+{
+    beginChild(name);
+    buf += '{';
+    levels.push_back(Level { itemName, true, false, true, nullptr, nullptr, mxml_string_type });
+}
+
+void JSONWriter::end()
+{
+    if (levels.size() <= 1)
+        throw _Exception(_("JSONWriter: end() without a started element"));
+    Level& level = levels.back();
+    if (level.itemName != nullptr) {
+        // an empty array is written as well
+        if (!level.arrayOpen) {
+            beginMember(level.itemName);
+            buf += '[';
+        }
+        buf += ']';
+    }
+
+    if (!level.open) {
+        writeValue(level.text, level.textType);
+    } else {
+        if (level.textKey != nullptr) {
+            const char* textKey = level.textKey;
+            level.textKey = nullptr;
+            beginMember(textKey);
+            writeValue(level.text, level.textType);
+        }
+        buf += '}';
+    }
+    levels.pop_back();
+}
+
+void JSONWriter::attribute(const char* name, String value, enum mxml_value_type type)
+{
+    beginMember(name);
+    writeValue(value, type);
+}
+
+void JSONWriter::attribute(const char* name, int value)
+{
+    beginMember(name);
+    buf += std::to_string(value);
+}
+
+void JSONWriter::textChild(const char* name, String text, enum mxml_value_type type)
+{
+    beginChild(name);
+    writeValue(text, type);
+}
+
+void JSONWriter::text(const char* textKey, String text, enum mxml_value_type type)
+{
+    Level& level = levels.back();
+    if (level.itemName != nullptr || levels.size() <= 1)
+        throw _Exception(_("JSONWriter: text is not allowed here"));
+    // written by end(), it is only a member if the element has attributes
+    level.textKey = textKey;
+    level.text = text;
+    level.textType = type;
+}
+
+void JSONWriter::writeString(const char* str, size_t len)
+{
+    // escaped like XML2JSON does it
+    buf += '"';
+    const char* end = str + len;
+    while (str < end) {
+        const char* special = str;
+        while (special < end && *special != '\\' && *special != '"')
+            special++;
+        buf.append(str, special - str);
+        if (special == end)
+            break;
+        buf += '\\';
+        buf += *special;
+        str = special + 1;
+    }
+    buf += '"';
+}
+
+void JSONWriter::writeValue(String value, enum mxml_value_type type)
+{
+    switch (type) {
+    case mxml_string_type:
+        writeString(value.c_str() == nullptr ? "" : value.c_str(), value.length());
+        break;
+    case mxml_bool_type:
+        assert(value == "0" || value == "1");
+        buf += value == "0" ? "false" : "true";
+        break;
+    case mxml_null_type:
+        buf += "null";
+        break;
+    case mxml_int_type:
+        if (value != nullptr)
+            buf.append(value.c_str(), value.length());
+        break;
+    }
+}
@@ -0,0 +1,137 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    response_writer.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file response_writer.h
+
+#ifndef __MXML_RESPONSE_WRITER_H__
+#define __MXML_RESPONSE_WRITER_H__
+
+#include <string>
+#include <vector>
+
+#include "zmm/zmmf.h"
+
+#include "mxml.h"
+
+namespace mxml
+{
+
+/// \brief Writes a response as a sequence of elements.
+///
+/// The calls describe the same structure as an Element tree does, so that
+/// the JSON written by JSONWriter is what XML2JSON makes of the elements
+/// ElementWriter builds. Attributes have to be written before the child
+/// elements, an element with text has no child elements.
+class ResponseWriter : public zmm::Object
+{
+public:
+    /// \brief Starts a child element.
+    virtual void beginObject(const char *name) = 0;
+
+    /// \brief Starts a child element whose children all are named itemName,
+    /// they become a JSON array.
+    virtual void beginArray(const char *name, const char *itemName) = 0;
+
+    /// \brief Ends the element started last.
+    virtual void end() = 0;
+
+    virtual void attribute(const char *name, zmm::String value, enum mxml_value_type type = mxml_string_type) = 0;
+    virtual void attribute(const char *name, int value) = 0;
+
+    inline void boolAttribute(const char *name, bool value)
+    { attribute(name, value ? _("1") : _("0"), mxml_bool_type); }
+
+    /// \brief Adds a child element that only holds text.
+    virtual void textChild(const char *name, zmm::String text, enum mxml_value_type type = mxml_string_type) = 0;
+
+    /// \brief Sets the text of the current element.
+    /// \param textKey the name of the text in JSON
+    virtual void text(const char *textKey, zmm::String text, enum mxml_value_type type = mxml_string_type) = 0;
+};
+
+/// \brief Builds the elements below a given root element.
+class ElementWriter : public ResponseWriter
+{
+public:
+    ElementWriter(zmm::Ref<Element> root);
+
+    void beginObject(const char *name) override;
+    void beginArray(const char *name, const char *itemName) override;
+    void end() override;
+    void attribute(const char *name, zmm::String value, enum mxml_value_type type = mxml_string_type) override;
+    void attribute(const char *name, int value) override;
+    void textChild(const char *name, zmm::String text, enum mxml_value_type type = mxml_string_type) override;
+    void text(const char *textKey, zmm::String text, enum mxml_value_type type = mxml_string_type) override;
+
+protected:
+    std::vector<zmm::Ref<Element> > elements;
+};
+
+/// \brief Writes JSON straight into a buffer, without building elements.
+///
+/// The members are written as members of an enclosing object that is not
+/// part of the buffer, each of them is preceded by a comma.
+class JSONWriter : public ResponseWriter
+{
+public:
+    JSONWriter();
+
+    void beginObject(const char *name) override;
+    void beginArray(const char *name, const char *itemName) override;
+    void end() override;
+    void attribute(const char *name, zmm::String value, enum mxml_value_type type = mxml_string_type) override;
+    void attribute(const char *name, int value) override;
+    void textChild(const char *name, zmm::String text, enum mxml_value_type type = mxml_string_type) override;
+    void text(const char *textKey, zmm::String text, enum mxml_value_type type = mxml_string_type) override;
+
+    inline const std::string &getBuffer() { return buf; }
+
+    /// \brief Drops everything written so far.
+    void clear();
+
+protected:
+    struct Level
+    {
+        /// \brief nullptr unless the element was started by beginArray()
+        const char *itemName;
+        bool first;
+        bool arrayOpen;
+        /// \brief true once the opening brace was written
+        bool open;
+        const char *textKey;
+        zmm::String text;
+        enum mxml_value_type textType;
+    };
+
+    std::vector<Level> levels;
+    std::string buf;
+
+    void beginChild(const char *name);
+    void beginMember(const char *name);
+    void writeString(const char *str, size_t len);
+    void writeValue(zmm::String value, enum mxml_value_type type);
+};
+
+} // namespace
+
+#endif // __MXML_RESPONSE_WRITER_H__
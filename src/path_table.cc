@@ -0,0 +1,157 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    path_table.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file path_table.cc
+
+#include "path_table.h"
+#include "common.h"
+
+PathTable::PathTable()
+{
+    // the root is never removed
+    Node root;
+    root.parent = PATH_TABLE_NONE;
+    root.name = PATH_TABLE_NONE;
+    root.refs = 1;
+    root.value = -1;
+    nodes.push_back(root);
+}
+
+uint32_t PathTable::add(const std::string& path)
+{
+    uint32_t node = PATH_TABLE_ROOT;
+    size_t start = 0;
+    while (start < path.length()) {
+        size_t end = path.find(DIR_SEPARATOR, start);
+        if (end == std::string::npos)
+            end = path.length();
+        if (end > start)
+            node = addChild(node, path.substr(start, end - start));
+        start = end + 1;
+    }
+    nodes[node].refs++;
+    return node;
+}
+
+uint32_t PathTable::find(const std::string& path) const
+{
+    uint32_t node = PATH_TABLE_ROOT;
+    size_t start = 0;
+    while (start < path.length()) {
+        size_t end = path.find(DIR_SEPARATOR, start);
+        if (end == std::string::npos)
+            end = path.length();
+        if (end > start) {
+            auto name = nameIds.find(path.substr(start, end - start));
+            if (name == nameIds.end())
+                return PATH_TABLE_NONE;
+            auto child = children.find(childKey(node, name->second));
+            if (child == children.end())
+                return PATH_TABLE_NONE;
+            node = child->second;
+        }
+        start = end + 1;
+    }
+    return node;
+}
+
+void PathTable::remove(uint32_t node)
+{
+    while (node != PATH_TABLE_NONE && --nodes[node].refs == 0) {
+        Node& entry = nodes[node];
+        children.erase(childKey(entry.parent, entry.name));
+        if (--names[entry.name].refs == 0) {
+            nameIds.erase(names[entry.name].name);
+            names[entry.name].name.clear();
+            freeNames.push_back(entry.name);
+        }
+        freeNodes.push_back(node);
+        node = entry.parent;
+    }
+}
+
+std::string PathTable::getPath(uint32_t node) const
+{
+    std::vector<uint32_t> chain;
+    for (; node != PATH_TABLE_ROOT; node = nodes[node].parent)
+        chain.push_back(nodes[node].name);
+
+    std::string path(1, DIR_SEPARATOR);
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        path += names[*it].name;
+        path += DIR_SEPARATOR;
+    }
+    return path;
+}
+
+uint32_t PathTable::addName(const std::string& name)
+{
+    auto it = nameIds.find(name);
+    if (it != nameIds.end()) {
+        names[it->second].refs++;
+        return it->second;
+    }
+
+    uint32_t id;
+    if (freeNames.empty()) {
+        id = names.size();
+        names.push_back(Name());
+    } else {
+        id = freeNames.back();
+        freeNames.pop_back();
+    }
+    names[id].name = name;
+    names[id].refs = 1;
+    nameIds.emplace(name, id);
+    return id;
+}
+
+uint32_t PathTable::addChild(uint32_t parent, const std::string& name)
+{
+    auto it = nameIds.find(name);
+    if (it != nameIds.end()) {
+        auto child = children.find(childKey(parent, it->second));
+        if (child != children.end())
+            return child->second;
+    }
+
+    Node entry;
+    entry.parent = parent;
+    entry.name = addName(name);
+    // held by the paths below it until the caller takes its own reference
+    entry.refs = 0;
+    entry.value = -1;
+    nodes[parent].refs++;
+
+    uint32_t node;
+    if (freeNodes.empty()) {
+        node = nodes.size();
+        nodes.push_back(entry);
+    } else {
+        node = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[node] = entry;
+    }
+    children.emplace(childKey(parent, entry.name), node);
+    return node;
+}
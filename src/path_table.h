@@ -0,0 +1,92 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    path_table.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file path_table.h
+/// \brief Definition of the PathTable class.
+
+#ifndef __PATH_TABLE_H__
+#define __PATH_TABLE_H__
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define PATH_TABLE_NONE UINT32_MAX
+#define PATH_TABLE_ROOT 0
+
+/// \brief Interned absolute directory paths.
+///
+/// Every path is stored as a name below its parent path, so a tree of
+/// directories stores each name once and each directory in a few bytes.
+/// Paths are reference counted, a path also stays while paths below it
+/// are in the table. Every path can carry an int value.
+class PathTable {
+public:
+    PathTable();
+
+    /// \brief Adds a reference to the path, creating it if needed.
+    uint32_t add(const std::string& path);
+
+    /// \return the path or PATH_TABLE_NONE if it is not in the table
+    uint32_t find(const std::string& path) const;
+
+    /// \brief Drops a reference taken by add().
+    void remove(uint32_t node);
+
+    /// \brief Returns the path with a trailing separator.
+    std::string getPath(uint32_t node) const;
+
+    int getValue(uint32_t node) const { return nodes[node].value; }
+    void setValue(uint32_t node, int value) { nodes[node].value = value; }
+
+    /// \brief number of paths in the table, including the root
+    size_t size() const { return nodes.size() - freeNodes.size(); }
+
+protected:
+    struct Node {
+        uint32_t parent;
+        uint32_t name;
+        uint32_t refs;
+        int value;
+    };
+
+    struct Name {
+        std::string name;
+        uint32_t refs;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> freeNodes;
+    std::vector<Name> names;
+    std::vector<uint32_t> freeNames;
+    std::unordered_map<std::string, uint32_t> nameIds;
+    /// \brief parent and name of a path to the path
+    std::unordered_map<uint64_t, uint32_t> children;
+
+    static uint64_t childKey(uint32_t parent, uint32_t name) { return ((uint64_t)parent << 32) | name; }
+    uint32_t addName(const std::string& name);
+    uint32_t addChild(uint32_t parent, const std::string& name);
+};
+
+#endif // __PATH_TABLE_H__
@@ -33,21 +33,141 @@
 // \todo this should be solved via an observer model 
 
 #include "play_hook.h"
+#include "cds_result_cache.h"
 #include "config_manager.h"
 #include "content_manager.h"
+#include "playback_io_handler.h"
+#include "storage.h"
+
+#include <chrono>
+#include <ctime>
+#include <unordered_set>
 
 #ifdef HAVE_LASTFMLIB
     #include "lastfm_scrobbler.h"
 #endif
 
 using namespace zmm;
+using namespace std;
 
-void PlayHook::trigger(zmm::Ref<CdsObject> obj)
+thread_local std::string PlayHook::requestClient;
+
+PlayHook::PlayHook()
+    : Singleton<PlayHook, std::mutex>()
+    , queue(new PlaybackQueue())
+    , flushThread(0)
+    , shutdownFlag(false)
+{
+}
+
+void PlayHook::init()
+{
+    pthread_create(
+        &flushThread,
+        nullptr,
+        PlayHook::staticThreadProc,
+        this);
+}
+
+void PlayHook::shutdown()
 {
     log_debug("start\n");
+    unique_lock<mutex_type> lock(mutex);
+    shutdownFlag = true;
+    cond.notify_one();
+    lock.unlock();
+    if (flushThread)
+        pthread_join(flushThread, nullptr);
+    flushThread = 0;
+    log_debug("end\n");
+}
+
+void PlayHook::setRequestClient(const std::string& client)
+{
+    requestClient = client;
+}
+
+int PlayHook::getPlayStatusID(Ref<CdsObject> obj)
+{
+    if (obj->isVirtual() && obj->getRefID() > 0)
+        return obj->getRefID();
+    return obj->getID();
+}
+
+void PlayHook::trigger(zmm::Ref<CdsObject> obj)
+{
+    PlaybackEvent event;
+    event.object = obj;
+    event.itemID = getPlayStatusID(obj);
+    event.client = requestClient;
+    event.time = time(nullptr);
+    event.started = true;
+    event.position = 0;
+    queue->push(event);
+}
+
+Ref<IOHandler> PlayHook::trigger(Ref<CdsObject> obj, Ref<IOHandler> ioHandler)
+{
+    trigger(obj);
+    return Ref<IOHandler>(new PlaybackIOHandler(ioHandler, queue, getPlayStatusID(obj), requestClient));
+}
+
+void PlayHook::threadProc()
+{
+    unique_lock<mutex_type> lock(mutex);
+    while (!shutdownFlag) {
+        cond.wait_for(lock, chrono::milliseconds(PLAY_HOOK_FLUSH_INTERVAL));
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+    lock.unlock();
+    // whatever was queued while shutting down
+    flush();
+}
+
+void PlayHook::flush()
+{
+    vector<PlaybackEvent> events = queue->takeAll();
+    if (events.empty())
+        return;
+
+    vector<Ref<CdsObject>> started;
+    vector<PlayStatus> changes = queue->aggregate(events, started);
+    log_debug("storing %d play statistics from %d events\n", (int)changes.size(), (int)events.size());
+    try {
+        Ref<Storage> storage = Storage::getInstance();
+        storage->storePlayStatus(changes);
+
+        // cached replies showing the statistics of these items are outdated
+        vector<int> itemIDs;
+        unordered_set<int> seen;
+        for (auto& change : changes) {
+            if (seen.insert(change.itemID).second)
+                itemIDs.push_back(change.itemID);
+        }
+        CdsResultCache::getInstance()->invalidate(storage->getPlayStatusObjectIDs(itemIDs));
+    } catch (const Exception& e) {
+        log_error("Could not store play statistics: %s\n", e.getMessage().c_str());
+    }
+
+    unordered_set<int> marked;
+    for (auto& obj : started) {
+        // the same item may have been played by several clients
+        bool mark = marked.insert(obj->getID()).second;
+        try {
+            played(obj, mark);
+        } catch (const Exception& e) {
+            log_error("Error while marking %s as played: %s\n", obj->getTitle().c_str(), e.getMessage().c_str());
+        }
+    }
+}
+
+void PlayHook::played(Ref<CdsObject> obj, bool mark)
+{
     Ref<ConfigManager> cfg = ConfigManager::getInstance();
 
-    if (cfg->getBoolOption(CFG_SERVER_EXTOPTS_MARK_PLAYED_ITEMS_ENABLED) && !obj->getFlag(OBJECT_FLAG_PLAYED))
+    if (mark && cfg->getBoolOption(CFG_SERVER_EXTOPTS_MARK_PLAYED_ITEMS_ENABLED) && !obj->getFlag(OBJECT_FLAG_PLAYED))
     {
         Ref<Array<StringBase> > mark_list = cfg->getStringArrayOption(CFG_SERVER_EXTOPTS_MARK_PLAYED_ITEMS_CONTENT_LIST);
 
@@ -72,5 +192,15 @@ void PlayHook::trigger(zmm::Ref<CdsObject> obj)
         (RefCast(obj, CdsItem)->getMimeType().startsWith("audio")))
         LastFm::getInstance()->startedPlaying(RefCast(obj, CdsItem));
 #endif
-    log_debug("end\n");
+}
+
+void* PlayHook::staticThreadProc(void* arg)
+{
+    log_debug("starting play hook thread... thread: %d\n", pthread_self());
+    auto* inst = (PlayHook*)arg;
+    inst->threadProc();
+    Storage::getInstance()->threadCleanup();
+
+    log_debug("play hook thread shut down. thread: %d\n", pthread_self());
+    return nullptr;
 }
@@ -35,15 +35,59 @@
 #ifndef __PLAY_HOOK_H__
 #define __PLAY_HOOK_H__
 
+#include <condition_variable>
+#include <string>
+
 #include "singleton.h"
 #include "common.h"
 #include "cds_objects.h"
+#include "io_handler.h"
+#include "playback_queue.h"
+
+/// \brief play statistics are written to the storage at most this often
+#define PLAY_HOOK_FLUSH_INTERVAL 5000
 
+/// \brief Records the playback of items.
+///
+/// The request threads only queue an event, marking the item as played,
+/// scrobbling and storing the play statistics happens in a thread of
+/// its own that writes the events in batches.
 class PlayHook : public Singleton<PlayHook, std::mutex>
 {
 public:
-    void trigger(zmm::Ref<CdsObject> obj);
+    PlayHook();
     zmm::String getName() override { return _("PlayHook"); }
+    void init() override;
+    void shutdown() override;
+
+    /// \brief The client of the current request started playing obj.
+    void trigger(zmm::Ref<CdsObject> obj);
+
+    /// \brief Like trigger(obj), but also records where the client stops
+    /// reading the handler that serves obj.
+    /// \return the handler to serve the item with
+    zmm::Ref<IOHandler> trigger(zmm::Ref<CdsObject> obj, zmm::Ref<IOHandler> ioHandler);
+
+    /// \brief Remembers the client of the web request the calling thread
+    /// is serving, the SDK only tells it when asking for the file info.
+    static void setRequestClient(const std::string &client);
+
+    /// \brief The item the play statistics of obj are kept for, references
+    /// share the statistics of the original item.
+    static int getPlayStatusID(zmm::Ref<CdsObject> obj);
+
+protected:
+    static thread_local std::string requestClient;
+
+    zmm::Ref<PlaybackQueue> queue;
+    pthread_t flushThread;
+    std::condition_variable cond;
+    bool shutdownFlag;
+
+    static void *staticThreadProc(void *arg);
+    void threadProc();
+    void flush();
+    void played(zmm::Ref<CdsObject> obj, bool mark);
 };
 
 #endif//__PLAY_HOOK_H__
@@ -0,0 +1,98 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    playback_io_handler.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file playback_io_handler.cc
+
+#include <ctime>
+
+#include "playback_io_handler.h"
+
+using namespace zmm;
+
+PlaybackIOHandler::PlaybackIOHandler(Ref<IOHandler> handler, Ref<PlaybackQueue> queue,
+    int itemID, const std::string& client)
+    : IOHandler()
+    , handler(handler)
+    , queue(queue)
+    , itemID(itemID)
+    , client(client)
+    , position(0)
+{
+}
+
+void PlaybackIOHandler::open(enum UpnpOpenFileMode mode)
+{
+    handler->open(mode);
+    position = 0;
+}
+
+size_t PlaybackIOHandler::read(char* buf, size_t length)
+{
+    size_t bytes = handler->read(buf, length);
+    if (position >= 0 && bytes != (size_t)-1)
+        position += bytes;
+    return bytes;
+}
+
+size_t PlaybackIOHandler::write(char* buf, size_t length)
+{
+    return handler->write(buf, length);
+}
+
+void PlaybackIOHandler::seek(off_t offset, int whence)
+{
+    handler->seek(offset, whence);
+    if (whence == SEEK_SET)
+        position = offset;
+    else if (whence == SEEK_CUR && position >= 0)
+        position += offset;
+    else
+        position = -1;
+}
+
+void PlaybackIOHandler::close()
+{
+    handler->close();
+    if (position < 0)
+        return;
+    PlaybackEvent event;
+    event.itemID = itemID;
+    event.client = client;
+    event.time = time(nullptr);
+    event.started = false;
+    event.position = position;
+    queue->push(event);
+}
+
+int PlaybackIOHandler::getPollFd()
+{
+    return handler->getPollFd();
+}
+
+ssize_t PlaybackIOHandler::readAvailable(char* buf, size_t length)
+{
+    ssize_t bytes = handler->readAvailable(buf, length);
+    if (position >= 0 && bytes > 0)
+        position += bytes;
+    return bytes;
+}
@@ -0,0 +1,59 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    playback_io_handler.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file playback_io_handler.h
+/// \brief Definition of the PlaybackIOHandler class.
+
+#ifndef __PLAYBACK_IO_HANDLER_H__
+#define __PLAYBACK_IO_HANDLER_H__
+
+#include "io_handler.h"
+#include "playback_queue.h"
+
+/// \brief Serves an item through another IOHandler and queues the offset
+/// the client stopped reading at when the stream is closed, that is where
+/// the client can resume.
+class PlaybackIOHandler : public IOHandler
+{
+public:
+    PlaybackIOHandler(zmm::Ref<IOHandler> handler, zmm::Ref<PlaybackQueue> queue,
+        int itemID, const std::string &client);
+
+    void open(enum UpnpOpenFileMode mode) override;
+    size_t read(char *buf, size_t length) override;
+    size_t write(char *buf, size_t length) override;
+    void seek(off_t offset, int whence) override;
+    void close() override;
+    int getPollFd() override;
+    ssize_t readAvailable(char *buf, size_t length) override;
+
+protected:
+    zmm::Ref<IOHandler> handler;
+    zmm::Ref<PlaybackQueue> queue;
+    int itemID;
+    std::string client;
+    /// \brief -1 after seeking relative to the end
+    off_t position;
+};
+
+#endif // __PLAYBACK_IO_HANDLER_H__
@@ -0,0 +1,113 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    playback_queue.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file playback_queue.cc
+
+#include <algorithm>
+
+#include "playback_queue.h"
+
+using namespace zmm;
+
+PlaybackQueue::PlaybackQueue()
+    : head(nullptr)
+{
+}
+
+PlaybackQueue::~PlaybackQueue()
+{
+    Node* node = head.exchange(nullptr);
+    while (node != nullptr) {
+        Node* next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
+void PlaybackQueue::push(PlaybackEvent event)
+{
+    Node* node = new Node { std::move(event), head.load(std::memory_order_relaxed) };
+    while (!head.compare_exchange_weak(node->next, node,
+        std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+std::vector<PlaybackEvent> PlaybackQueue::takeAll()
+{
+    // the whole list is taken at once, so nodes are never popped while
+    // another thread looks at them
+    Node* node = head.exchange(nullptr, std::memory_order_acquire);
+    std::vector<PlaybackEvent> events;
+    while (node != nullptr) {
+        Node* next = node->next;
+        events.push_back(std::move(node->event));
+        delete node;
+        node = next;
+    }
+    std::reverse(events.begin(), events.end());
+    return events;
+}
+
+std::vector<PlayStatus> PlaybackQueue::aggregate(const std::vector<PlaybackEvent>& events,
+    std::vector<Ref<CdsObject>>& started)
+{
+    std::vector<PlayStatus> changes;
+    std::map<std::pair<int, std::string>, size_t> index;
+    time_t newest = 0;
+
+    for (auto& event : events) {
+        auto key = std::make_pair(event.itemID, event.client);
+        auto found = index.find(key);
+        if (found == index.end()) {
+            found = index.emplace(key, changes.size()).first;
+            changes.push_back(PlayStatus { event.itemID, event.client, 0, event.time, -1 });
+        }
+        PlayStatus& change = changes[found->second];
+        change.lastPlayed = std::max(change.lastPlayed, event.time);
+        newest = std::max(newest, event.time);
+
+        if (!event.started) {
+            change.position = event.position;
+            continue;
+        }
+
+        auto last = lastStarted.find(key);
+        if (last == lastStarted.end() || event.time - last->second >= PLAYBACK_QUEUE_REPLAY_SECONDS) {
+            change.playCount++;
+            // a new playback starts from the beginning unless the client
+            // tells where it stopped
+            change.position = 0;
+            if (event.object != nullptr)
+                started.push_back(event.object);
+        }
+        lastStarted[key] = event.time;
+    }
+
+    for (auto it = lastStarted.begin(); it != lastStarted.end();) {
+        if (newest - it->second >= PLAYBACK_QUEUE_REPLAY_SECONDS)
+            it = lastStarted.erase(it);
+        else
+            ++it;
+    }
+    return changes;
+}
@@ -0,0 +1,94 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    playback_queue.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file playback_queue.h
+/// \brief Definition of the PlaybackQueue class.
+
+#ifndef __PLAYBACK_QUEUE_H__
+#define __PLAYBACK_QUEUE_H__
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "storage.h"
+
+/// \brief a client opening the same item again within this many seconds
+/// continues the previous playback, players often open a stream a few times
+/// to probe it and to seek
+#define PLAYBACK_QUEUE_REPLAY_SECONDS 30
+
+struct PlaybackEvent
+{
+    /// \brief the played object, only set for started events
+    zmm::Ref<CdsObject> object;
+    int itemID;
+    std::string client;
+    time_t time;
+    /// \brief true when the playback started, false when the client stopped
+    /// reading at position
+    bool started;
+    off_t position;
+};
+
+/// \brief Hands playback events from the request threads to the thread
+/// that writes them to the storage.
+///
+/// push() is lock free, the request threads never wait for each other or
+/// for the writer. The writer takes all queued events at once and adds
+/// them up per item and client.
+class PlaybackQueue : public zmm::Object
+{
+public:
+    PlaybackQueue();
+    virtual ~PlaybackQueue();
+
+    /// \brief Queues an event, can be called from any thread.
+    void push(PlaybackEvent event);
+
+    /// \brief Removes all queued events.
+    /// \return the events in the order they were pushed
+    std::vector<PlaybackEvent> takeAll();
+
+    /// \brief Adds up the events per item and client.
+    ///
+    /// Only called by the writer, it remembers recent starts so that a
+    /// repeated open within PLAYBACK_QUEUE_REPLAY_SECONDS is not counted
+    /// as another playback.
+    /// \param started receives the objects of the playbacks that were counted
+    std::vector<PlayStatus> aggregate(const std::vector<PlaybackEvent> &events,
+        std::vector<zmm::Ref<CdsObject> > &started);
+
+protected:
+    struct Node
+    {
+        PlaybackEvent event;
+        Node *next;
+    };
+
+    std::atomic<Node *> head;
+    std::map<std::pair<int, std::string>, time_t> lastStarted;
+};
+
+#endif // __PLAYBACK_QUEUE_H__
@@ -34,99 +34,250 @@
 #include <cstdio>
 #include <unistd.h>
 #include <sys/types.h>
-#include <sys/stat.h>
 #include <fcntl.h>
 #include <csignal>
 #include <sys/wait.h>
+#include <poll.h>
+#include <spawn.h>
+#include <pthread.h>
 
 #include <cstring>
 #include <cerrno>
+#include <sstream>
+#include <vector>
 
-#include "config_manager.h"
+#include "common.h"
+#include "tools.h"
+
+extern char **environ;
 
 using namespace zmm;
 
 #define BUF_SIZE 256
 
-String run_simple_process(String prog, String param, String input)
+static bool open_pipe(int fds[2])
+{
+    if (pipe(fds) == -1)
+        return false;
+
+    // only the process we spawn gets its end, via dup2
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+}
+
+static void close_pipe(int fds[2])
 {
-    FILE *file;
-    int fd;
-
-    /* creating input file */
-    char temp_in[] = "mt_in_XXXXXX";
-    char temp_out[] = "mt_out_XXXXXX";
-        
-    Ref<ConfigManager> cfg = ConfigManager::getInstance();
-    String input_file = tempName(cfg->getOption(CFG_SERVER_TMPDIR), temp_in);
-    fd = open(input_file.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
-    if (fd == -1)
+    for (int i = 0; i < 2; i++)
     {
-        log_debug("Failed to open input file %s: %s\n", input_file.c_str(),
-                  strerror(errno));
-        throw _Exception(_("Failed to open input file ") + input_file +_(" ") + 
-                         strerror(errno));
+        if (fds[i] >= 0)
+            close(fds[i]);
+        fds[i] = -1;
     }
-    ssize_t ret = write(fd, input.c_str(), input.length());
-    close(fd);
-    if (ret < input.length())
+}
+
+pid_t spawn_process(char *const argv[], int *stdin_fd, int *stdout_fd)
+{
+    int in_pipe[2] = { -1, -1 };
+    int out_pipe[2] = { -1, -1 };
+
+    if (((stdin_fd != nullptr) && !open_pipe(in_pipe)) ||
+        ((stdout_fd != nullptr) && !open_pipe(out_pipe)))
     {
+        int err = errno;
+        close_pipe(in_pipe);
+        close_pipe(out_pipe);
+        throw _Exception(_("Failed to create pipe for ") + argv[0] + ": " +
+                         strerror(err));
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    if (stdin_fd != nullptr)
+        posix_spawn_file_actions_adddup2(&actions, in_pipe[0], STDIN_FILENO);
+    if (stdout_fd != nullptr)
+        posix_spawn_file_actions_adddup2(&actions, out_pipe[1], STDOUT_FILENO);
+
+    // do not pass the signal mask of the calling thread or ignored
+    // signals on to the child
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigset_t defaults;
+    sigemptyset(&defaults);
+    sigaddset(&defaults, SIGPIPE);
+    sigaddset(&defaults, SIGINT);
+    sigaddset(&defaults, SIGTERM);
+    sigaddset(&defaults, SIGHUP);
+
+    short flags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF;
+#ifdef POSIX_SPAWN_USEVFORK
+    flags |= POSIX_SPAWN_USEVFORK;
+#endif
+
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setsigmask(&attr, &mask);
+    posix_spawnattr_setsigdefault(&attr, &defaults);
+    posix_spawnattr_setflags(&attr, flags);
+
+    pid_t pid = -1;
+    int ret = posix_spawnp(&pid, argv[0], &actions, &attr, argv, environ);
 
-        log_debug("Failed to write to %s: %s\n", input.c_str(), 
-                   strerror(errno));
-        throw _Exception(_("Failed to write to ") + input + ": " + 
-                         strerror(errno));
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+
+    // the child has its own copies of these ends now
+    if (in_pipe[0] >= 0)
+    {
+        close(in_pipe[0]);
+        in_pipe[0] = -1;
     }
-    
-    /* touching output file */
-    String output_file = tempName(cfg->getOption(CFG_SERVER_TMPDIR), temp_out);
-    fd = open(output_file.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
-    if (fd == -1)
+    if (out_pipe[1] >= 0)
     {
-        log_debug("Failed to open output file %s: %s\n", output_file.c_str(),
-                  strerror(errno));
-        throw _Exception(_("Failed to open output file ")+ input_file +_(" ") + 
-                         strerror(errno));
+        close(out_pipe[1]);
+        out_pipe[1] = -1;
     }
-    close(fd);
-
-    /* executing script */
-    String command = prog + " " + param + " < " + input_file + 
-                                          " > " + output_file;
-    log_debug("running %s\n", command.c_str());
-    int sysret = system(command.c_str());
-    if (sysret == -1)
+
+    if (ret != 0)
     {
-        log_debug("Failed to execute: %s\n", command.c_str());
-        throw _Exception(_("Failed to execute: ") + command);
+        close_pipe(in_pipe);
+        close_pipe(out_pipe);
+        log_debug("Failed to launch process %s: %s\n", argv[0], strerror(ret));
+        throw _Exception(_("Failed to launch process ") + argv[0] + ": " +
+                         strerror(ret));
     }
 
-    /* reading output file */
-    file = fopen(output_file.c_str(), "r");
-    if (!file)
+    if (stdin_fd != nullptr)
+        *stdin_fd = in_pipe[1];
+    if (stdout_fd != nullptr)
+        *stdout_fd = out_pipe[0];
+
+    log_debug("Launched process %s, pid: %d\n", argv[0], pid);
+    return pid;
+}
+
+String run_simple_process(String prog, String param, String input)
+{
+    // the command used to go through the shell, keep accepting commands
+    // that come with their own arguments
+    Ref<Array<StringBase> > words = split_string(prog, ' ');
+    if (words->size() == 0)
+        throw _Exception(_("No command given"));
+
+    std::vector<char *> argv;
+    for (int i = 0; i < words->size(); i++)
+        argv.push_back(words->get(i)->data);
+    argv.push_back(const_cast<char *>(param.c_str()));
+    argv.push_back(nullptr);
+
+    // a script that exits before reading all of its input must not
+    // take the server down with SIGPIPE
+    sigset_t pipe_set;
+    sigset_t old_set;
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+
+    int in_fd = -1;
+    int out_fd = -1;
+    pid_t pid;
+    try
     {
-        log_debug("Could not open output file %s: %s\n", output_file.c_str(),
-                strerror(errno));
-        throw _Exception(_("Failed to open output file ")+output_file +_(" ") + 
-                strerror(errno));
+        pid = spawn_process(argv.data(), &in_fd, &out_fd);
+    }
+    catch (const Exception & ex)
+    {
+        pthread_sigmask(SIG_SETMASK, &old_set, nullptr);
+        throw ex;
     }
-    std::ostringstream output;
 
-    int bytesRead;
+    fcntl(in_fd, F_SETFL, O_NONBLOCK);
+    fcntl(out_fd, F_SETFL, O_NONBLOCK);
+
+    std::ostringstream output;
     char buf[BUF_SIZE];
-    while (true)
+    size_t written = 0;
+
+    if (input.length() == 0)
     {
-        bytesRead = fread(buf, 1, BUF_SIZE, file);
-        if(bytesRead > 0)
-            output << std::string(buf, bytesRead);
-        else
+        close(in_fd);
+        in_fd = -1;
+    }
+
+    // feed the input while collecting the output, the script may start
+    // writing before it has consumed everything we have to say
+    while (out_fd >= 0)
+    {
+        struct pollfd fds[2];
+        nfds_t nfds = 1;
+        fds[0].fd = out_fd;
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        if (in_fd >= 0)
+        {
+            fds[1].fd = in_fd;
+            fds[1].events = POLLOUT;
+            fds[1].revents = 0;
+            nfds++;
+        }
+
+        if (poll(fds, nfds, -1) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            log_debug("poll failed: %s\n", strerror(errno));
             break;
+        }
+
+        if ((in_fd >= 0) && (fds[1].revents != 0))
+        {
+            ssize_t ret = write(in_fd, input.c_str() + written,
+                                input.length() - written);
+            if (ret > 0)
+                written += ret;
+
+            if (((ret < 0) && (errno != EAGAIN) && (errno != EINTR)) ||
+                (written >= (size_t)input.length()))
+            {
+                close(in_fd);
+                in_fd = -1;
+            }
+        }
+
+        if (fds[0].revents != 0)
+        {
+            ssize_t bytesRead = read(out_fd, buf, BUF_SIZE);
+            if (bytesRead > 0)
+                output << std::string(buf, bytesRead);
+            else if ((bytesRead == 0) ||
+                     ((errno != EAGAIN) && (errno != EINTR)))
+            {
+                close(out_fd);
+                out_fd = -1;
+            }
+        }
     }
-    fclose(file);
 
-    /* removing input and output files */
-    unlink(input_file.c_str());
-    unlink(output_file.c_str());
+    if (in_fd >= 0)
+        close(in_fd);
+    if (out_fd >= 0)
+        close(out_fd);
+
+    int status;
+    while ((waitpid(pid, &status, 0) == -1) && (errno == EINTR));
+
+    // swallow a SIGPIPE that was raised for our write end
+    if (!sigismember(&old_set, SIGPIPE))
+    {
+        sigset_t pending;
+        sigpending(&pending);
+        if (sigismember(&pending, SIGPIPE))
+        {
+            int sig;
+            sigwait(&pipe_set, &sig);
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &old_set, nullptr);
 
     return output.str();
 }
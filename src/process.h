@@ -32,11 +32,30 @@
 #ifndef __PROCESS_H__
 #define __PROCESS_H__
 
+#include <sys/types.h>
 #include "zmm/zmmf.h"
 
 void init_process();
+
+/// \brief Runs a command, feeds it the input and returns what it wrote.
+/// \param prog the command, followed by its own arguments separated by
+/// spaces; no shell is involved, so quotes and redirections are passed on
+/// as they are
+/// \param param appended as the last argument
 zmm::String run_simple_process(zmm::String prog, zmm::String param, zmm::String input);
 
+/// \brief Launches a process via posix_spawn, without duplicating the
+/// address space of the server like fork() would.
+/// \param argv nullptr terminated argument list, argv[0] is the command
+/// which will be searched in $PATH
+/// \param stdin_fd if not nullptr, receives the write end of a pipe that is
+/// connected to the standard input of the new process
+/// \param stdout_fd if not nullptr, receives the read end of a pipe that is
+/// connected to the standard output of the new process
+/// \return process id of the launched process
+pid_t spawn_process(char *const argv[], int *stdin_fd = nullptr,
+                    int *stdout_fd = nullptr);
+
 void run_process(zmm::String prog, zmm::String param);
 
 bool is_alive(pid_t pid, int *exit_status = NULL);
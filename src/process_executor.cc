@@ -31,17 +31,16 @@
 
 #include "process_executor.h"
 #include "process.h"
-#include <pthread.h>
-#include <csignal>
+#include <unistd.h>
 
 using namespace zmm;
 
-ProcessExecutor::ProcessExecutor(String command, Ref<Array<StringBase> > arglist)
+ProcessExecutor::ProcessExecutor(String command, Ref<Array<StringBase> > arglist, int pipeFlags)
 {
 #define MAX_ARGS 255
-    const char *argv[MAX_ARGS];
+    char *argv[MAX_ARGS];
     
-    argv[0] = command.c_str();
+    argv[0] = const_cast<char *>(command.c_str());
     int apos = 0;
 
     for (int i = 0; i < arglist->size(); i++)
@@ -53,24 +52,13 @@ ProcessExecutor::ProcessExecutor(String command, Ref<Array<StringBase> > arglist
     argv[++apos] = nullptr;
 
     exit_status = 0;
+    stdin_fd = -1;
+    stdout_fd = -1;
 
-    process_id = fork();
-    
-    switch (process_id)
-    {
-        case -1:
-            throw _Exception(_("Failed to launch process ") + command);
-        
-        case 0:
-            sigset_t mask_set;
-            pthread_sigmask(SIG_SETMASK, &mask_set, nullptr);
-            log_debug("Launching process: %s\n", command.c_str());
-            execvp(command.c_str(), const_cast<char **const>(argv));
-        default:
-            break;
-    }
-
-    log_debug("Launched process %s, pid: %d\n", command.c_str(), process_id);
+    log_debug("Launching process: %s\n", command.c_str());
+    process_id = spawn_process(argv,
+            (pipeFlags & PROCESS_PIPE_STDIN) ? &stdin_fd : nullptr,
+            (pipeFlags & PROCESS_PIPE_STDOUT) ? &stdout_fd : nullptr);
 }
 
 bool ProcessExecutor::isAlive()
@@ -89,7 +77,26 @@ int ProcessExecutor::getStatus()
     return exit_status;
 }
 
+int ProcessExecutor::releaseStdin()
+{
+    int fd = stdin_fd;
+    stdin_fd = -1;
+    return fd;
+}
+
+int ProcessExecutor::releaseStdout()
+{
+    int fd = stdout_fd;
+    stdout_fd = -1;
+    return fd;
+}
+
 ProcessExecutor::~ProcessExecutor()
 {
+    if (stdin_fd >= 0)
+        close(stdin_fd);
+    if (stdout_fd >= 0)
+        close(stdout_fd);
+
     kill();
 }
@@ -34,19 +34,41 @@
 
 #include "executor.h"
 
+/// \brief connect the standard input of the process to a pipe
+#define PROCESS_PIPE_STDIN     1
+/// \brief connect the standard output of the process to a pipe
+#define PROCESS_PIPE_STDOUT    2
+
 class ProcessExecutor : public Executor
 {
 public:
+    /// \brief Launches the given command.
+    /// \param pipeFlags combination of PROCESS_PIPE_STDIN and
+    /// PROCESS_PIPE_STDOUT, the corresponding pipe ends can be taken over
+    /// via releaseStdin() and releaseStdout()
     ProcessExecutor(zmm::String command, 
-                    zmm::Ref<zmm::Array<zmm::StringBase> > arglist);
+                    zmm::Ref<zmm::Array<zmm::StringBase> > arglist,
+                    int pipeFlags = 0);
     virtual bool isAlive();
     virtual bool kill();
     virtual int getStatus();
     virtual ~ProcessExecutor();
 
+    /// \brief Hands over the write end of the pipe connected to the
+    /// standard input of the process, the caller has to close it.
+    /// \return file descriptor or -1 if there is none
+    int releaseStdin();
+
+    /// \brief Hands over the read end of the pipe connected to the
+    /// standard output of the process, the caller has to close it.
+    /// \return file descriptor or -1 if there is none
+    int releaseStdout();
+
 protected:
     pid_t process_id;
     int exit_status;
+    int stdin_fd;
+    int stdout_fd;
 };
 
 #endif // __PROCESS_EXECUTOR_H__
@@ -135,6 +135,7 @@ ProcessIOHandler::ProcessIOHandler(String filename,
                         bool ignoreSeek) : IOHandler()
 {
     this->filename = filename;
+    this->fd = -1;
     this->proclist = proclist;
     this->main_proc = main_proc;
     this->ignore_seek = ignoreSeek;
@@ -158,6 +159,34 @@ ProcessIOHandler::ProcessIOHandler(String filename,
     registerAll();
 }
 
+ProcessIOHandler::ProcessIOHandler(int fd,
+                        zmm::Ref<Executor> main_proc,
+                        zmm::Ref<zmm::Array<ProcListItem> > proclist,
+                        bool ignoreSeek) : IOHandler()
+{
+    this->fd = fd;
+    this->proclist = proclist;
+    this->main_proc = main_proc;
+    this->ignore_seek = ignoreSeek;
+
+    if (fd < 0)
+    {
+        killall();
+        throw _Exception(_("no pipe to the process"));
+    }
+
+    if ((main_proc != nullptr) && ((!main_proc->isAlive() || abort())))
+    {
+        ::close(fd);
+        this->fd = -1;
+        killall();
+        throw _Exception(_("process terminated early"));
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    registerAll();
+}
+
 void ProcessIOHandler::open(IN enum UpnpOpenFileMode mode)
 {
     if ((main_proc != nullptr) && ((!main_proc->isAlive() || abort())))
@@ -166,6 +195,10 @@ void ProcessIOHandler::open(IN enum UpnpOpenFileMode mode)
         throw _Exception(_("process terminated early"));
     }
 
+    // pipes are handed to us already open
+    if (filename == nullptr)
+        return;
+
     if (mode == UPNP_READ)
         fd = ::open(filename.c_str(), O_RDONLY | O_NONBLOCK);
     else if (mode == UPNP_WRITE)
@@ -306,6 +339,43 @@ size_t ProcessIOHandler::read(OUT char *buf, IN size_t length)
     return num_bytes;
 }
 
+int ProcessIOHandler::getPollFd()
+{
+    return fd;
+}
+
+ssize_t ProcessIOHandler::readAvailable(OUT char *buf, IN size_t length)
+{
+    ssize_t bytes_read = ::read(fd, buf, length);
+    if (bytes_read >= 0)
+        return bytes_read;
+
+    if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+    {
+        log_debug("aborting read!!!\n");
+        return -1;
+    }
+
+    // nothing to read, make sure that someone is still writing; this runs
+    // on the reactor thread, killing the processes may block and is left
+    // to close()
+    if (main_proc != nullptr)
+    {
+        bool main_ok = main_proc->isAlive();
+        if (!main_ok)
+        {
+            int exit_status = main_proc->getStatus();
+            log_debug("process exited with status %d\n", exit_status);
+            return (exit_status == EXIT_SUCCESS) ? 0 : -1;
+        }
+
+        if (abort())
+            return -1;
+    }
+
+    return IO_WOULD_BLOCK;
+}
+
 size_t ProcessIOHandler::write(IN char *buf, IN size_t length)
 {
     fd_set writeSet;
@@ -429,7 +499,10 @@ void ProcessIOHandler::close()
     bool ret;
    
 
-    log_debug("terminating process, closing %s\n", this->filename.c_str());
+    if (filename != nullptr)
+        log_debug("terminating process, closing %s\n", this->filename.c_str());
+    else
+        log_debug("terminating process, closing pipe %d\n", fd);
     unregisterAll();
 
     if (main_proc != nullptr)
@@ -441,9 +514,14 @@ void ProcessIOHandler::close()
 
     killall();
     
-    ::close(fd);
+    if (fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
     
-    unlink(filename.c_str());
+    if (filename != nullptr)
+        unlink(filename.c_str());
 
     if (!ret)
         throw _Exception(_("failed to kill process!"));
@@ -51,7 +51,7 @@ protected:
     bool abort;
 };
 
-/// \brief Allows the web server to read from a fifo.
+/// \brief Allows the web server to read from a fifo or a pipe.
 class ProcessIOHandler : public IOHandler
 {
 public:
@@ -62,6 +62,15 @@ public:
     ProcessIOHandler(zmm::String filename, zmm::Ref<Executor> main_proc,
                      zmm::Ref<zmm::Array<ProcListItem> > proclist = nullptr,
                      bool ignoreSeek = false);
+
+    /// \brief Works with an already open pipe, e.g. the one obtained from
+    /// ProcessExecutor::releaseStdout().
+    /// \param fd file descriptor, will be closed together with the handler
+    /// \param proclist associated processes that will be terminated once
+    /// they are no longer needed
+    ProcessIOHandler(int fd, zmm::Ref<Executor> main_proc,
+                     zmm::Ref<zmm::Array<ProcListItem> > proclist = nullptr,
+                     bool ignoreSeek = false);
     
     /// \brief Opens file for reading (writing is not supported)
     void open(IN enum UpnpOpenFileMode mode) override;
@@ -90,6 +99,13 @@ public:
     /// \brief Close a previously opened file and kills the kill_pid process
     void close() override;
 
+    /// \brief Returns the file descriptor of the fifo or pipe.
+    int getPollFd() override;
+
+    /// \brief Reads what is available in the fifo or pipe, if there is
+    /// nothing the state of the associated processes is checked.
+    ssize_t readAvailable(OUT char *buf, IN size_t length) override;
+
     ~ProcessIOHandler();
 
 protected:
@@ -99,7 +115,8 @@ protected:
     /// \brief Main process used for reading
     zmm::Ref<Executor> main_proc;
 
-    /// \brief name of the file or fifo to read the data from
+    /// \brief name of the file or fifo to read the data from, nullptr
+    /// if we were given an open pipe
     zmm::String filename;
 
     /// \brief file descriptor
@@ -0,0 +1,316 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    proxy_cache.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file proxy_cache.cc
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <iterator>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "config_manager.h"
+#include "proxy_cache.h"
+#include "tools.h"
+
+#define PROXY_CACHE_FILE_SUFFIX ".seg"
+
+using namespace zmm;
+using namespace std;
+
+ProxyCacheEntry::ProxyCacheEntry(String url, String path, size_t segmentSize)
+    : url(url)
+    , path(path)
+    , segmentSize(segmentSize)
+    , size(-1)
+    , bytes(0)
+    , rangeRequests(true)
+    , users(0)
+    , lastUse(0)
+{
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0)
+        throw _Exception(_("ProxyCache: could not create ") + path + ": " + mt_strerror(errno));
+}
+
+ProxyCacheEntry::~ProxyCacheEntry()
+{
+    if (fd >= 0)
+        ::close(fd);
+}
+
+size_t ProxyCacheEntry::read(char* buf, size_t length, off_t offset)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t segment = offset / segmentSize;
+    if (fd < 0 || segment >= filled.size())
+        return 0;
+    off_t end = (off_t)(segment * segmentSize + filled[segment]);
+    if (offset >= end)
+        return 0;
+
+    ssize_t ret;
+    do {
+        ret = pread(fd, buf, std::min(length, (size_t)(end - offset)), offset);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0) {
+        log_error("ProxyCache: could not read %s: %s\n", path.c_str(), mt_strerror(errno).c_str());
+        return 0;
+    }
+    return ret;
+}
+
+off_t ProxyCacheEntry::getFillOffset(off_t offset)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t segment = offset / segmentSize;
+    off_t start = (off_t)(segment * segmentSize);
+    if (segment >= filled.size())
+        return start;
+    return start + filled[segment];
+}
+
+size_t ProxyCacheEntry::store(const char* buf, size_t length, off_t offset)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd < 0)
+        return 0;
+
+    size_t added = 0;
+    off_t end = offset + length;
+    while (offset < end) {
+        size_t segment = offset / segmentSize;
+        off_t segmentStart = (off_t)(segment * segmentSize);
+        off_t pieceEnd = std::min(end, segmentStart + (off_t)segmentSize);
+        if (segment >= filled.size())
+            filled.resize(segment + 1, 0);
+
+        // only data that directly continues the filled part is kept
+        off_t filledEnd = segmentStart + filled[segment];
+        if (offset <= filledEnd && filledEnd < pieceEnd) {
+            const char* data = buf + (filledEnd - (end - length));
+            size_t count = pieceEnd - filledEnd;
+            ssize_t ret;
+            do {
+                ret = pwrite(fd, data, count, filledEnd);
+            } while (ret < 0 && errno == EINTR);
+            if (ret < 0) {
+                log_error("ProxyCache: could not write %s: %s\n", path.c_str(), mt_strerror(errno).c_str());
+                return added;
+            }
+            filled[segment] += ret;
+            added += ret;
+        }
+        offset = pieceEnd;
+    }
+    bytes += added;
+    return added;
+}
+
+off_t ProxyCacheEntry::getSize()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return size;
+}
+
+void ProxyCacheEntry::setSize(off_t size)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->size = size;
+}
+
+size_t ProxyCacheEntry::getBytes()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytes;
+}
+
+void ProxyCacheEntry::drop()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd < 0)
+        return;
+    ::close(fd);
+    fd = -1;
+    unlink(path.c_str());
+    filled.clear();
+    bytes = 0;
+}
+
+bool ProxyCacheEntry::getRangeRequests()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return rangeRequests;
+}
+
+void ProxyCacheEntry::disableRangeRequests()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    rangeRequests = false;
+}
+
+ProxyCache::ProxyCache()
+    : Singleton<ProxyCache>()
+    , maxSize(0)
+    , segmentSize(PROXY_CACHE_SEGMENT_SIZE)
+    , totalBytes(0)
+    , useCounter(0)
+    , nextFileID(0)
+{
+}
+
+void ProxyCache::init()
+{
+    Ref<ConfigManager> config = ConfigManager::getInstance();
+    String dir = config->getOption(CFG_SERVER_PROXY_CACHE_LOCATION);
+    if (!string_ok(dir))
+        dir = config->getOption(CFG_SERVER_HOME) + DIR_SEPARATOR + "proxy-cache";
+    start(dir, (size_t)config->getIntOption(CFG_SERVER_PROXY_CACHE_SIZE) * 1024 * 1024);
+}
+
+void ProxyCache::start(String location, size_t maxSize, size_t segmentSize)
+{
+    if (!check_path(location, true) && mkdir(location.c_str(), 0700) != 0)
+        throw _Exception(_("ProxyCache: could not create ") + location + ": " + mt_strerror(errno));
+    this->location = location;
+    this->maxSize = maxSize;
+    this->segmentSize = segmentSize;
+    removeFiles();
+    log_debug("proxy cache in %s, %zu bytes\n", location.c_str(), maxSize);
+}
+
+void ProxyCache::shutdown()
+{
+    AutoLock lock(mutex);
+    for (auto& entry : entries)
+        entry.second->drop();
+    entries.clear();
+    totalBytes = 0;
+}
+
+Ref<ProxyCacheEntry> ProxyCache::acquireEntry(String url, off_t size, String validator)
+{
+    std::string key = std::string(url.c_str()) + '\n' + std::to_string((long long)size) + '\n'
+        + (validator != nullptr ? validator.c_str() : "");
+    AutoLock lock(mutex);
+    Ref<ProxyCacheEntry> entry;
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        entry = it->second;
+    } else {
+        // the data changed upstream, older versions are not served again
+        for (it = entries.begin(); it != entries.end();) {
+            auto next = std::next(it);
+            if (it->second->users == 0 && it->second->getURL() == url) {
+                log_debug("%s changed upstream, dropping the cached data\n", url.c_str());
+                removeEntry(it);
+            }
+            it = next;
+        }
+
+        String path = location + DIR_SEPARATOR + String::from(nextFileID++) + PROXY_CACHE_FILE_SUFFIX;
+        entry = Ref<ProxyCacheEntry>(new ProxyCacheEntry(url, path, segmentSize));
+        entries[key] = entry;
+    }
+    entry->users++;
+    entry->lastUse = ++useCounter;
+    return entry;
+}
+
+void ProxyCache::releaseEntry(Ref<ProxyCacheEntry> entry)
+{
+    AutoLock lock(mutex);
+    entry->users--;
+    entry->lastUse = ++useCounter;
+    evict();
+}
+
+void ProxyCache::stored(size_t bytes)
+{
+    if (bytes == 0)
+        return;
+    AutoLock lock(mutex);
+    totalBytes += bytes;
+    evict();
+}
+
+size_t ProxyCache::getBytes()
+{
+    AutoLock lock(mutex);
+    return totalBytes;
+}
+
+bool ProxyCache::contains(String url)
+{
+    AutoLock lock(mutex);
+    for (auto& entry : entries) {
+        if (entry.second->getURL() == url)
+            return true;
+    }
+    return false;
+}
+
+void ProxyCache::evict()
+{
+    while (totalBytes > maxSize) {
+        auto victim = entries.end();
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->second->users > 0)
+                continue;
+            if (victim == entries.end() || it->second->lastUse < victim->second->lastUse)
+                victim = it;
+        }
+        // everything is being streamed right now
+        if (victim == entries.end())
+            return;
+
+        log_debug("evicting %s from the proxy cache\n", victim->second->getURL().c_str());
+        removeEntry(victim);
+    }
+}
+
+void ProxyCache::removeEntry(std::unordered_map<std::string, Ref<ProxyCacheEntry> >::iterator it)
+{
+    Ref<ProxyCacheEntry> entry = it->second;
+    entries.erase(it);
+    totalBytes -= std::min(entry->getBytes(), totalBytes);
+    entry->drop();
+}
+
+void ProxyCache::removeFiles()
+{
+    DIR* dir = opendir(location.c_str());
+    if (dir == nullptr)
+        return;
+    struct dirent* dent;
+    size_t suffixLength = strlen(PROXY_CACHE_FILE_SUFFIX);
+    while ((dent = readdir(dir)) != nullptr) {
+        size_t length = strlen(dent->d_name);
+        if (length > suffixLength && strcmp(dent->d_name + length - suffixLength, PROXY_CACHE_FILE_SUFFIX) == 0)
+            unlink((location + DIR_SEPARATOR + dent->d_name).c_str());
+    }
+    closedir(dir);
+}
@@ -0,0 +1,157 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    proxy_cache.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file proxy_cache.h
+/// \brief Definition of the ProxyCache and ProxyCacheEntry classes.
+
+#ifndef __PROXY_CACHE_H__
+#define __PROXY_CACHE_H__
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common.h"
+#include "singleton.h"
+
+/// \brief the cached data of a URL is tracked in segments of this size
+#define PROXY_CACHE_SEGMENT_SIZE (1024 * 1024)
+
+/// \brief Cached bytes of one proxied URL.
+///
+/// The data is kept in a sparse file. For every segment the cache knows
+/// how many bytes from the start of the segment are filled, so a client
+/// that stopped in the middle of a segment leaves a usable prefix and the
+/// next transfer continues right where the filled part ends.
+class ProxyCacheEntry : public zmm::Object
+{
+public:
+    ProxyCacheEntry(zmm::String url, zmm::String path, size_t segmentSize);
+    virtual ~ProxyCacheEntry();
+
+    /// \brief Reads cached data, does not go beyond the end of a segment.
+    /// \return number of bytes read, 0 if the data at offset is not cached
+    size_t read(char *buf, size_t length, off_t offset);
+
+    /// \brief Returns where a transfer has to start to fill the data at
+    /// offset: the end of the filled part of its segment.
+    off_t getFillOffset(off_t offset);
+
+    /// \brief Stores data fetched from upstream, only the part that extends
+    /// the filled part of a segment is kept.
+    /// \return number of bytes that were added to the cache
+    size_t store(const char *buf, size_t length, off_t offset);
+
+    /// \brief Total size of the data, -1 if not known yet.
+    off_t getSize();
+    void setSize(off_t size);
+
+    /// \brief Number of cached bytes.
+    size_t getBytes();
+
+    /// \brief Removes the file, the entry does not cache anything anymore.
+    void drop();
+
+    /// \brief Checks if upstream honours range requests, which is assumed
+    /// until a transfer that started in the middle failed.
+    bool getRangeRequests();
+    void disableRangeRequests();
+
+    inline zmm::String getURL() { return url; }
+
+protected:
+    zmm::String url;
+    zmm::String path;
+    size_t segmentSize;
+    int fd;
+    std::mutex mutex;
+    /// \brief filled bytes from the start of each segment
+    std::vector<size_t> filled;
+    off_t size;
+    size_t bytes;
+    bool rangeRequests;
+
+    // bookkeeping of the ProxyCache, protected by its mutex
+    int users;
+    uint64_t lastUse;
+
+    friend class ProxyCache;
+};
+
+/// \brief On-disk cache of the bytes of proxied external URL items.
+///
+/// Entries are evicted in least recently used order once the cached bytes
+/// exceed the configured size, entries that are being streamed are kept.
+/// The cache starts out empty every time the server starts.
+class ProxyCache : public Singleton<ProxyCache>
+{
+public:
+    ProxyCache();
+    zmm::String getName() override { return _("Proxy Cache"); }
+
+    /// \brief Starts the cache with the configured location and size.
+    void init() override;
+    void shutdown() override;
+
+    /// \brief Starts the cache, files left in location are removed.
+    /// \param maxSize cached bytes the cache tries not to exceed
+    void start(zmm::String location, size_t maxSize, size_t segmentSize = PROXY_CACHE_SEGMENT_SIZE);
+
+    /// \brief Returns the entry of the URL, creates an empty one if the URL
+    /// is not cached. Every acquireEntry() needs a releaseEntry().
+    ///
+    /// The entry is kept per version of the data upstream. When the size
+    /// or the validator changed, a new entry is started and the unused
+    /// entries of the old version are dropped.
+    /// \param size size reported by upstream, -1 if not known
+    /// \param validator ETag or Last-Modified reported by upstream
+    zmm::Ref<ProxyCacheEntry> acquireEntry(zmm::String url, off_t size = -1, zmm::String validator = nullptr);
+    void releaseEntry(zmm::Ref<ProxyCacheEntry> entry);
+
+    /// \brief Accounts bytes that were added to an entry and evicts entries
+    /// if the cache got too large.
+    void stored(size_t bytes);
+
+    /// \brief Number of cached bytes.
+    size_t getBytes();
+
+    /// \brief Checks if the URL has an entry, of any version.
+    bool contains(zmm::String url);
+
+protected:
+    zmm::String location;
+    size_t maxSize;
+    size_t segmentSize;
+    size_t totalBytes;
+    uint64_t useCounter;
+    unsigned int nextFileID;
+    std::unordered_map<std::string, zmm::Ref<ProxyCacheEntry> > entries;
+
+    void evict();
+    void removeEntry(std::unordered_map<std::string, zmm::Ref<ProxyCacheEntry> >::iterator it);
+    void removeFiles();
+};
+
+#endif // __PROXY_CACHE_H__
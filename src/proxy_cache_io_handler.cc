@@ -0,0 +1,163 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    proxy_cache_io_handler.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file proxy_cache_io_handler.cc
+
+#include <algorithm>
+#include <cstring>
+
+#include "proxy_cache_io_handler.h"
+
+using namespace zmm;
+
+ProxyCacheIOHandler::ProxyCacheIOHandler(Ref<ProxyCache> cache, String url, off_t size, String validator,
+    UpstreamFactory upstreamFactory)
+    : cache(cache)
+    , url(url)
+    , size(size)
+    , validator(validator)
+    , upstreamFactory(upstreamFactory)
+    , upstreamOffset(-1)
+    , upstreamStart(-1)
+    , position(0)
+{
+}
+
+void ProxyCacheIOHandler::open(IN enum UpnpOpenFileMode mode)
+{
+    if (mode != UPNP_READ)
+        throw _Exception(_("ProxyCacheIOHandler::open: only reading is supported"));
+    entry = cache->acquireEntry(url, size, validator);
+    if (size >= 0 && entry->getSize() < 0)
+        entry->setSize(size);
+    buffer.resize(PROXY_CACHE_READ_SIZE);
+    position = 0;
+}
+
+size_t ProxyCacheIOHandler::read(OUT char* buf, IN size_t length)
+{
+    off_t knownSize = entry->getSize();
+    if (knownSize >= 0 && position >= knownSize)
+        return 0;
+
+    size_t ret = entry->read(buf, length, position);
+    if (ret > 0) {
+        position += ret;
+        return ret;
+    }
+
+    // continue the filled part of the segment, so that it stays usable
+    off_t from = entry->getFillOffset(position);
+    if (!entry->getRangeRequests()) {
+        // a running transfer is kept unless it went past the missed data
+        from = (upstream != nullptr && upstreamOffset <= from) ? upstreamOffset : 0;
+    }
+    if (upstream == nullptr || upstreamOffset != from)
+        openUpstream(from);
+
+    while (true) {
+        ret = upstream->read(buffer.data(), buffer.size());
+        if (ret == (size_t)-1) {
+            // a server that ignores the Range header makes the transfer
+            // fail before it delivered anything
+            bool rangeFailed = upstreamStart > 0 && upstreamOffset == upstreamStart;
+            closeUpstream();
+            if (!rangeFailed)
+                return -1;
+            log_warning("%s does not support range requests, reading it from the start\n", url.c_str());
+            entry->disableRangeRequests();
+            openUpstream(0);
+            continue;
+        }
+        if (ret == 0) {
+            entry->setSize(upstreamOffset);
+            closeUpstream();
+            return 0;
+        }
+
+        cache->stored(entry->store(buffer.data(), ret, upstreamOffset));
+        off_t chunkStart = upstreamOffset;
+        upstreamOffset += ret;
+        if (upstreamOffset > position) {
+            size_t skip = position - chunkStart;
+            size_t count = std::min(length, ret - skip);
+            memcpy(buf, buffer.data() + skip, count);
+            position += count;
+            return count;
+        }
+    }
+}
+
+void ProxyCacheIOHandler::seek(IN off_t offset, IN int whence)
+{
+    off_t target;
+    if (whence == SEEK_SET) {
+        target = offset;
+    } else if (whence == SEEK_CUR) {
+        target = position + offset;
+    } else if (whence == SEEK_END) {
+        off_t knownSize = entry->getSize();
+        if (knownSize < 0)
+            throw _Exception(_("ProxyCacheIOHandler::seek: size of ") + url + " is not known");
+        target = knownSize + offset;
+    } else {
+        throw _Exception(_("ProxyCacheIOHandler::seek: invalid whence"));
+    }
+    if (target < 0)
+        throw _Exception(_("ProxyCacheIOHandler::seek: invalid offset"));
+    // the upstream transfer is moved on the next miss, if at all
+    position = target;
+}
+
+void ProxyCacheIOHandler::close()
+{
+    closeUpstream();
+    if (entry != nullptr) {
+        cache->releaseEntry(entry);
+        entry = nullptr;
+    }
+}
+
+void ProxyCacheIOHandler::openUpstream(off_t offset)
+{
+    closeUpstream();
+    log_debug("fetching %s from %lld\n", url.c_str(), (long long)offset);
+    upstream = upstreamFactory(offset);
+    upstream->open(UPNP_READ);
+    upstreamOffset = offset;
+    upstreamStart = offset;
+}
+
+void ProxyCacheIOHandler::closeUpstream()
+{
+    if (upstream == nullptr)
+        return;
+    try {
+        upstream->close();
+    } catch (const Exception& e) {
+        log_debug("closing the transfer of %s failed: %s\n", url.c_str(), e.getMessage().c_str());
+    }
+    upstream = nullptr;
+    upstreamOffset = -1;
+    upstreamStart = -1;
+}
@@ -0,0 +1,85 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    proxy_cache_io_handler.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file proxy_cache_io_handler.h
+/// \brief Definition of the ProxyCacheIOHandler class.
+
+#ifndef __PROXY_CACHE_IO_HANDLER_H__
+#define __PROXY_CACHE_IO_HANDLER_H__
+
+#include <functional>
+#include <vector>
+
+#include "common.h"
+#include "io_handler.h"
+#include "proxy_cache.h"
+
+/// \brief size of the reads from upstream
+#define PROXY_CACHE_READ_SIZE (64 * 1024)
+
+/// \brief Serves a proxied URL from the ProxyCache, data that is not cached
+/// yet is fetched from upstream and cached on the way.
+///
+/// Seeking is supported in all directions, SEEK_END once the size of the
+/// data is known. An upstream transfer is only started on a cache miss,
+/// at the end of the filled part of the segment that was missed. If
+/// upstream turns out to ignore range requests, transfers start at the
+/// beginning and the data up to the miss is only cached.
+class ProxyCacheIOHandler : public IOHandler
+{
+public:
+    /// \brief Opens a transfer of the URL that starts at offset.
+    typedef std::function<zmm::Ref<IOHandler>(off_t offset)> UpstreamFactory;
+
+    /// \param size size of the data if known from a HEAD request, -1 otherwise
+    /// \param validator ETag or Last-Modified from the HEAD request, a
+    /// cached version with another one is not served
+    ProxyCacheIOHandler(zmm::Ref<ProxyCache> cache, zmm::String url, off_t size, zmm::String validator,
+        UpstreamFactory upstreamFactory);
+
+    void open(IN enum UpnpOpenFileMode mode) override;
+    size_t read(OUT char *buf, IN size_t length) override;
+    void seek(IN off_t offset, IN int whence) override;
+    void close() override;
+
+protected:
+    zmm::Ref<ProxyCache> cache;
+    zmm::String url;
+    off_t size;
+    zmm::String validator;
+    UpstreamFactory upstreamFactory;
+    zmm::Ref<ProxyCacheEntry> entry;
+
+    zmm::Ref<IOHandler> upstream;
+    /// \brief offset of the next byte the upstream transfer delivers
+    off_t upstreamOffset;
+    /// \brief offset the upstream transfer was started at
+    off_t upstreamStart;
+    off_t position;
+    std::vector<char> buffer;
+
+    void openUpstream(off_t offset);
+    void closeUpstream();
+};
+
+#endif // __PROXY_CACHE_IO_HANDLER_H__
@@ -0,0 +1,564 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    read_ahead_io_handler.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file read_ahead_io_handler.cc
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#ifdef __linux__
+    #include <sys/vfs.h>
+#endif
+#ifdef HAVE_IO_URING
+    #include <sys/eventfd.h>
+#endif
+
+#include "config_manager.h"
+#include "file_io_handler.h"
+#include "read_ahead_io_handler.h"
+#include "tools.h"
+
+// weight of the last second in the consumption rate
+#define READ_AHEAD_RATE_WEIGHT 0.3
+// the rate is sampled after at least this many milliseconds
+#define READ_AHEAD_RATE_INTERVAL 1000
+// user data of the read on the wakeup eventfd
+#define READ_AHEAD_RING_WAKEUP 0
+
+using namespace zmm;
+using namespace std;
+
+ReadAheadPool::ReadAheadPool()
+    : Singleton<ReadAheadPool>()
+{
+    shutdownFlag = false;
+#ifdef HAVE_IO_URING
+    wakeupFd = -1;
+#endif
+}
+
+void ReadAheadPool::init()
+{
+    Ref<ConfigManager> config = ConfigManager::getInstance();
+    start(config->getIntOption(CFG_SERVER_READ_AHEAD_THREADS),
+        config->getBoolOption(CFG_SERVER_READ_AHEAD_IO_URING));
+}
+
+void ReadAheadPool::start(int threadCount, bool useIOUring)
+{
+#ifdef HAVE_IO_URING
+    if (useIOUring) {
+        try {
+            if (!IOUring::supported())
+                throw _Exception(_("the kernel does not support IORING_OP_READ"));
+            ring = Ref<IOUring>(new IOUring(READ_AHEAD_RING_ENTRIES));
+            wakeupFd = eventfd(0, EFD_CLOEXEC);
+            if (wakeupFd < 0)
+                throw _Exception(_("could not create eventfd: ") + mt_strerror(errno));
+            pthread_t thread;
+            if (pthread_create(&thread, nullptr, ReadAheadPool::staticRingThreadProc, this) != 0)
+                throw _Exception(_("could not start thread: ") + mt_strerror(errno));
+            threads.push_back(thread);
+            log_debug("read-ahead uses io_uring\n");
+            return;
+        } catch (const Exception& e) {
+            log_warning("read-ahead falls back to threads, io_uring is not available: %s\n", e.getMessage().c_str());
+            ring = nullptr;
+            if (wakeupFd >= 0)
+                ::close(wakeupFd);
+            wakeupFd = -1;
+        }
+    }
+#else
+    if (useIOUring)
+        log_warning("read-ahead falls back to threads, this version of Gerbera was compiled without io_uring support\n");
+#endif
+
+    for (int i = 0; i < threadCount; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, nullptr, ReadAheadPool::staticThreadProc, this) != 0)
+            throw _Exception(_("ReadAheadPool: could not start thread: ") + mt_strerror(errno));
+        threads.push_back(thread);
+    }
+}
+
+void ReadAheadPool::shutdown()
+{
+    log_debug("start\n");
+    unique_lock<mutex_type> lock(mutex);
+    shutdownFlag = true;
+    cond.notify_all();
+    lock.unlock();
+#ifdef HAVE_IO_URING
+    if (wakeupFd >= 0)
+        eventfd_write(wakeupFd, 1);
+#endif
+    for (pthread_t thread : threads)
+        pthread_join(thread, nullptr);
+    threads.clear();
+    // streams that still wait for a read fail instead of blocking forever
+    lock.lock();
+    deque<Ref<ReadAheadIOHandler> > pending;
+    pending.swap(queue);
+    lock.unlock();
+    for (auto& stream : pending)
+        stream->cancelFetch();
+#ifdef HAVE_IO_URING
+    ring = nullptr;
+    if (wakeupFd >= 0)
+        ::close(wakeupFd);
+    wakeupFd = -1;
+#endif
+    log_debug("end\n");
+}
+
+bool ReadAheadPool::usesIOUring()
+{
+#ifdef HAVE_IO_URING
+    return ring != nullptr;
+#else
+    return false;
+#endif
+}
+
+bool ReadAheadPool::schedule(Ref<ReadAheadIOHandler> stream)
+{
+    unique_lock<mutex_type> lock(mutex);
+    if (shutdownFlag)
+        return false;
+    queue.push_back(stream);
+#ifdef HAVE_IO_URING
+    if (ring != nullptr) {
+        lock.unlock();
+        eventfd_write(wakeupFd, 1);
+        return true;
+    }
+#endif
+    cond.notify_one();
+    return true;
+}
+
+void* ReadAheadPool::staticThreadProc(void* arg)
+{
+    auto* inst = static_cast<ReadAheadPool*>(arg);
+    inst->threadProc();
+    pthread_exit(nullptr);
+    return nullptr;
+}
+
+void ReadAheadPool::threadProc()
+{
+    unique_lock<mutex_type> lock(mutex);
+    while (!shutdownFlag) {
+        if (queue.empty()) {
+            cond.wait(lock);
+            continue;
+        }
+        Ref<ReadAheadIOHandler> stream = queue.front();
+        queue.pop_front();
+        lock.unlock();
+        stream->fetch();
+        stream = nullptr;
+        lock.lock();
+    }
+}
+
+#ifdef HAVE_IO_URING
+void* ReadAheadPool::staticRingThreadProc(void* arg)
+{
+    auto* inst = static_cast<ReadAheadPool*>(arg);
+    inst->ringThreadProc();
+    pthread_exit(nullptr);
+    return nullptr;
+}
+
+void ReadAheadPool::ringThreadProc()
+{
+    struct Pending
+    {
+        Ref<ReadAheadIOHandler> stream;
+        ReadAheadIOHandler::Fetch fetch;
+    };
+    // keyed by the address of the entry, which is also the user data
+    unordered_map<uint64_t, unique_ptr<Pending> > inflight;
+    eventfd_t wakeupValue;
+    bool wakeupArmed = false;
+    // one entry stays free for the read on the eventfd
+    size_t maxInflight = ring->getEntries() - 1;
+
+    unique_lock<mutex_type> lock(mutex, defer_lock);
+    while (true) {
+        if (!wakeupArmed)
+            wakeupArmed = ring->prepareRead(wakeupFd, &wakeupValue, sizeof(wakeupValue), 0, READ_AHEAD_RING_WAKEUP);
+
+        vector<Ref<ReadAheadIOHandler> > batch;
+        lock.lock();
+        bool stop = shutdownFlag;
+        while (!stop && !queue.empty() && inflight.size() + batch.size() < maxInflight) {
+            batch.push_back(queue.front());
+            queue.pop_front();
+        }
+        lock.unlock();
+        if (stop && inflight.empty())
+            break;
+
+        for (auto& stream : batch) {
+            unique_ptr<Pending> pending(new Pending { stream, {} });
+            if (!stream->startFetch(pending->fetch))
+                continue;
+            auto userData = (uint64_t)(uintptr_t)pending.get();
+            if (!ring->prepareRead(stream->getFd(), pending->fetch.chunk.data(), pending->fetch.chunk.size(),
+                    pending->fetch.offset, userData)) {
+                // the kernel did not take earlier entries yet, the stream
+                // must not wait for a read that was never queued
+                log_debug("io_uring submission queue is full, reading synchronously\n");
+                stream->readChunk(pending->fetch);
+                continue;
+            }
+            inflight[userData] = std::move(pending);
+        }
+
+        // submits the whole batch and waits for the first completion
+        ring->submit(1);
+        ring->reap([&inflight, &wakeupArmed](uint64_t userData, int result) {
+            if (userData == READ_AHEAD_RING_WAKEUP) {
+                wakeupArmed = false;
+                return;
+            }
+            auto it = inflight.find(userData);
+            if (it == inflight.end())
+                return;
+            unique_ptr<Pending> pending = std::move(it->second);
+            inflight.erase(it);
+            pending->stream->finishFetch(pending->fetch, result < 0 ? -1 : result, result < 0 ? -result : 0);
+        });
+    }
+}
+#endif
+
+ReadAheadIOHandler::ReadAheadIOHandler(String filename, size_t maxWindow, Ref<ReadAheadPool> pool)
+    : filename(filename)
+    , pool(pool)
+    , fd(-1)
+    , maxWindow(std::max(maxWindow, (size_t)READ_AHEAD_MIN_WINDOW))
+    , window(READ_AHEAD_MIN_WINDOW)
+    , chunkOffset(0)
+    , buffered(0)
+    , position(0)
+    , fetchOffset(0)
+    , generation(0)
+    , fetching(false)
+    , eof(false)
+    , error(0)
+    , closed(false)
+    , rateBytes(0)
+    , bytesPerSecond(0)
+{
+    rateStart.tv_sec = 0;
+    rateStart.tv_nsec = 0;
+}
+
+ReadAheadIOHandler::~ReadAheadIOHandler()
+{
+    // the pool holds a reference while it reads, so no read is in flight
+    if (fd >= 0)
+        ::close(fd);
+}
+
+Ref<IOHandler> ReadAheadIOHandler::create(String filename)
+{
+    Ref<ConfigManager> config = ConfigManager::getInstance();
+    String mode = config->getOption(CFG_SERVER_READ_AHEAD_MODE);
+    if (mode == YES || (mode == "network" && isOnNetworkMount(filename))) {
+        return Ref<IOHandler>(new ReadAheadIOHandler(filename,
+            config->getIntOption(CFG_SERVER_READ_AHEAD_MAX_WINDOW),
+            ReadAheadPool::getInstance()));
+    }
+    return Ref<IOHandler>(new FileIOHandler(filename));
+}
+
+bool ReadAheadIOHandler::isOnNetworkMount(String filename)
+{
+#ifdef __linux__
+    struct statfs fs;
+    if (statfs(filename.c_str(), &fs) != 0)
+        return false;
+    switch ((unsigned long)fs.f_type) {
+    case 0x6969: // NFS
+    case 0x517b: // SMB
+    case 0xfe534d42: // SMB2
+    case 0xff534d42: // CIFS
+    case 0x65735546: // FUSE, sshfs and friends
+    case 0x01021997: // 9P
+    case 0x00c36400: // Ceph
+    case 0x5346414f: // AFS
+    case 0x73757245: // Coda
+        return true;
+    default:
+        return false;
+    }
+#else
+    return false;
+#endif
+}
+
+void ReadAheadIOHandler::open(IN enum UpnpOpenFileMode mode)
+{
+    if (mode == UPNP_WRITE)
+        throw _Exception(_("ReadAheadIOHandler::open: Write mode not supported"));
+    if (mode != UPNP_READ)
+        throw _Exception(_("ReadAheadIOHandler::open: invalid UpnpOpenFileMode mode"));
+
+    fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw _Exception(_("ReadAheadIOHandler::open: failed to open: ") + filename.c_str());
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    std::lock_guard<std::mutex> lock(mutex);
+    getTimespecNow(&rateStart);
+    scheduleFetch();
+}
+
+size_t ReadAheadIOHandler::read(OUT char* buf, IN size_t length)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (buffered == 0) {
+        if (error != 0)
+            return -1;
+        if (eof || closed)
+            return 0;
+        scheduleFetch();
+        cond.wait(lock);
+    }
+
+    size_t copied = 0;
+    while (copied < length && !chunks.empty()) {
+        vector<char>& chunk = chunks.front();
+        size_t count = std::min(length - copied, chunk.size() - chunkOffset);
+        memcpy(buf + copied, chunk.data() + chunkOffset, count);
+        copied += count;
+        chunkOffset += count;
+        if (chunkOffset == chunk.size()) {
+            spare.push_back(std::move(chunk));
+            chunks.pop_front();
+            chunkOffset = 0;
+        }
+    }
+    buffered -= copied;
+    position += copied;
+    consumed(copied);
+    scheduleFetch();
+    return copied;
+}
+
+void ReadAheadIOHandler::seek(IN off_t offset, IN int whence)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    off_t target;
+    if (whence == SEEK_SET) {
+        target = offset;
+    } else if (whence == SEEK_CUR) {
+        target = position + offset;
+    } else if (whence == SEEK_END) {
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+            throw _Exception(_("ReadAheadIOHandler::seek: fstat failed: ") + mt_strerror(errno));
+        target = st.st_size + offset;
+    } else {
+        throw _Exception(_("ReadAheadIOHandler::seek: invalid whence"));
+    }
+    if (target < 0)
+        throw _Exception(_("ReadAheadIOHandler::seek: invalid offset"));
+
+    if (target >= position && (size_t)(target - position) < buffered) {
+        // a short skip forward stays within the data read ahead
+        size_t skip = target - position;
+        while (skip > 0) {
+            vector<char>& chunk = chunks.front();
+            size_t count = std::min(skip, chunk.size() - chunkOffset);
+            skip -= count;
+            chunkOffset += count;
+            if (chunkOffset == chunk.size()) {
+                spare.push_back(std::move(chunk));
+                chunks.pop_front();
+                chunkOffset = 0;
+            }
+        }
+        buffered -= target - position;
+        position = target;
+        return;
+    }
+
+    generation++;
+    dropChunks();
+    position = target;
+    fetchOffset = target;
+    eof = false;
+    error = 0;
+    // the rate before the seek says nothing about the rate after it
+    getTimespecNow(&rateStart);
+    rateBytes = 0;
+    scheduleFetch();
+}
+
+void ReadAheadIOHandler::close()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    closed = true;
+    generation++;
+    while (fetching)
+        cond.wait(lock);
+    dropChunks();
+    spare.clear();
+    lock.unlock();
+
+    int ret = ::close(fd);
+    fd = -1;
+    if (ret != 0)
+        throw _Exception(_("ReadAheadIOHandler::close: close failed: ") + mt_strerror(errno));
+}
+
+size_t ReadAheadIOHandler::getWindow()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return window;
+}
+
+bool ReadAheadIOHandler::startFetch(Fetch& fetch)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (closed || eof || error != 0) {
+        fetching = false;
+        cond.notify_all();
+        return false;
+    }
+    fetch.generation = generation;
+    fetch.offset = fetchOffset;
+    if (!spare.empty()) {
+        fetch.chunk = std::move(spare.back());
+        spare.pop_back();
+    }
+    fetch.chunk.resize(READ_AHEAD_CHUNK_SIZE);
+    return true;
+}
+
+void ReadAheadIOHandler::finishFetch(Fetch& fetch, ssize_t result, int errnum)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    fetching = false;
+    if (fetch.generation == generation && !closed) {
+        if (result < 0) {
+            log_error("read-ahead of %s failed: %s\n", filename.c_str(), mt_strerror(errnum).c_str());
+            error = errnum;
+        } else if (result == 0) {
+            eof = true;
+        } else {
+            fetch.chunk.resize(result);
+            chunks.push_back(std::move(fetch.chunk));
+            buffered += result;
+            fetchOffset += result;
+        }
+    } else if (fetch.chunk.capacity() > 0) {
+        spare.push_back(std::move(fetch.chunk));
+    }
+    cond.notify_all();
+    scheduleFetch();
+}
+
+void ReadAheadIOHandler::fetch()
+{
+    Fetch fetch;
+    if (startFetch(fetch))
+        readChunk(fetch);
+}
+
+void ReadAheadIOHandler::readChunk(Fetch& fetch)
+{
+    ssize_t result;
+    do {
+        result = pread(fd, fetch.chunk.data(), fetch.chunk.size(), fetch.offset);
+    } while (result < 0 && errno == EINTR);
+    finishFetch(fetch, result, result < 0 ? errno : 0);
+}
+
+void ReadAheadIOHandler::cancelFetch()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    fetching = false;
+    if (error == 0)
+        error = ECANCELED;
+    cond.notify_all();
+}
+
+void ReadAheadIOHandler::scheduleFetch()
+{
+    if (fetching || closed || eof || error != 0 || buffered >= window)
+        return;
+    fetching = true;
+    if (!pool->schedule(Ref<ReadAheadIOHandler>(this))) {
+        fetching = false;
+        error = ECANCELED;
+    }
+}
+
+void ReadAheadIOHandler::consumed(size_t length)
+{
+    rateBytes += length;
+    struct timespec now;
+    getTimespecNow(&now);
+    long millis = getDeltaMillis(&rateStart, &now);
+    if (millis < READ_AHEAD_RATE_INTERVAL)
+        return;
+
+    double rate = rateBytes * 1000.0 / millis;
+    if (bytesPerSecond == 0)
+        bytesPerSecond = rate;
+    else
+        bytesPerSecond = READ_AHEAD_RATE_WEIGHT * rate + (1 - READ_AHEAD_RATE_WEIGHT) * bytesPerSecond;
+    rateStart = now;
+    rateBytes = 0;
+
+    size_t wanted = (size_t)(bytesPerSecond * READ_AHEAD_SECONDS);
+    wanted = (wanted + READ_AHEAD_CHUNK_SIZE - 1) / READ_AHEAD_CHUNK_SIZE * READ_AHEAD_CHUNK_SIZE;
+    window = std::min(std::max(wanted, (size_t)READ_AHEAD_MIN_WINDOW), maxWindow);
+}
+
+void ReadAheadIOHandler::dropChunks()
+{
+    while (!chunks.empty()) {
+        spare.push_back(std::move(chunks.front()));
+        chunks.pop_front();
+    }
+    // a few buffers are enough to refill the window
+    if (spare.size() > 2)
+        spare.resize(2);
+    chunkOffset = 0;
+    buffered = 0;
+}
@@ -0,0 +1,193 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    read_ahead_io_handler.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file read_ahead_io_handler.h
+/// \brief Definition of the ReadAheadIOHandler and ReadAheadPool classes.
+
+#ifndef __READ_AHEAD_IO_HANDLER_H__
+#define __READ_AHEAD_IO_HANDLER_H__
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <pthread.h>
+#include <vector>
+
+#include "common.h"
+#include "io_handler.h"
+#include "mt_io_uring.h"
+#include "singleton.h"
+
+/// \brief size of one read issued by the pool
+#define READ_AHEAD_CHUNK_SIZE   (256 * 1024)
+#define READ_AHEAD_MIN_WINDOW   (2 * READ_AHEAD_CHUNK_SIZE)
+/// \brief the window holds this many seconds of the consumption rate
+#define READ_AHEAD_SECONDS      4
+/// \brief size of the submission queue, limits the reads in flight
+#define READ_AHEAD_RING_ENTRIES 256
+
+class ReadAheadIOHandler;
+
+/// \brief Threads that read ahead for all ReadAheadIOHandlers.
+///
+/// A stream has at most one read queued or in flight, so a few threads
+/// serve many streams and a slow mount cannot pile up requests. With
+/// io_uring a single thread hands the queued reads of all streams to the
+/// kernel in one system call and does not block on any of them.
+class ReadAheadPool : public Singleton<ReadAheadPool>
+{
+public:
+    ReadAheadPool();
+    zmm::String getName() override { return _("Read-ahead Pool"); }
+
+    /// \brief Starts the number of threads given in the configuration.
+    void init() override;
+    void shutdown() override;
+
+    /// \brief Starts the reading threads.
+    /// \param useIOUring issue the reads through io_uring, falls back to
+    /// threadCount threads if the kernel does not support it
+    void start(int threadCount, bool useIOUring = false);
+
+    /// \brief Checks if the reads go through io_uring.
+    bool usesIOUring();
+
+    /// \brief Queues a read for the given stream.
+    /// \return false if the pool was shut down
+    bool schedule(zmm::Ref<ReadAheadIOHandler> stream);
+
+protected:
+    std::vector<pthread_t> threads;
+    std::deque<zmm::Ref<ReadAheadIOHandler> > queue;
+    std::condition_variable cond;
+    bool shutdownFlag;
+
+    static void *staticThreadProc(void *arg);
+    void threadProc();
+
+#ifdef HAVE_IO_URING
+    zmm::Ref<IOUring> ring;
+    /// \brief eventfd that wakes up the ring thread when reads are queued
+    int wakeupFd;
+
+    static void *staticRingThreadProc(void *arg);
+    void ringThreadProc();
+#endif
+};
+
+/// \brief Reads a file ahead of the consumer.
+///
+/// The data read ahead is kept as a list of chunks. The window, the amount
+/// of data the handler tries to keep buffered, follows the rate at which
+/// the stream is consumed, so a client that plays a file at its bitrate
+/// does not make the server read the whole file into memory.
+class ReadAheadIOHandler : public IOHandler
+{
+public:
+    /// \param maxWindow upper bound of the window in bytes
+    /// \param pool threads that do the reading
+    ReadAheadIOHandler(zmm::String filename, size_t maxWindow, zmm::Ref<ReadAheadPool> pool);
+    virtual ~ReadAheadIOHandler();
+
+    /// \brief Returns a ReadAheadIOHandler if the configured read-ahead
+    /// mode applies to the file, a FileIOHandler otherwise.
+    static zmm::Ref<IOHandler> create(zmm::String filename);
+
+    /// \brief Checks if the file is on a network filesystem.
+    static bool isOnNetworkMount(zmm::String filename);
+
+    void open(IN enum UpnpOpenFileMode mode) override;
+    size_t read(OUT char *buf, IN size_t length) override;
+    void seek(IN off_t offset, IN int whence) override;
+    void close() override;
+
+    /// \brief Current window in bytes.
+    size_t getWindow();
+
+    /// \brief A read of the file, prepared by startFetch() and handed
+    /// back to finishFetch() when it completed.
+    struct Fetch
+    {
+        unsigned int generation;
+        off_t offset;
+        std::vector<char> chunk;
+    };
+
+    /// \brief Prepares the next read.
+    /// \return false if the stream does not need the read anymore
+    bool startFetch(Fetch &fetch);
+
+    /// \brief Stores the result of a read.
+    /// \param result number of bytes read, -1 on error
+    /// \param errnum errno of a failed read
+    void finishFetch(Fetch &fetch, ssize_t result, int errnum);
+
+    /// \brief Fails the queued read, the pool is shutting down.
+    void cancelFetch();
+
+    /// \brief Does the next read, called by the pool.
+    void fetch();
+
+    /// \brief Does a prepared read right away and stores its result.
+    void readChunk(Fetch &fetch);
+
+    inline int getFd() { return fd; }
+
+protected:
+    zmm::String filename;
+    zmm::Ref<ReadAheadPool> pool;
+    int fd;
+    size_t maxWindow;
+    size_t window;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<std::vector<char> > chunks;
+    /// \brief buffers of consumed chunks, reused for the next reads
+    std::vector<std::vector<char> > spare;
+    /// \brief bytes of the first chunk that were already consumed
+    size_t chunkOffset;
+    size_t buffered;
+    /// \brief offset of the reader in the file
+    off_t position;
+    /// \brief offset of the next read, position + buffered
+    off_t fetchOffset;
+    /// \brief incremented on seek and close, reads of an older generation
+    /// are dropped
+    unsigned int generation;
+    bool fetching;
+    bool eof;
+    int error;
+    bool closed;
+
+    // consumption rate
+    struct timespec rateStart;
+    size_t rateBytes;
+    double bytesPerSecond;
+
+    void scheduleFetch();
+    void consumed(size_t length);
+    void dropChunks();
+};
+
+#endif // __READ_AHEAD_IO_HANDLER_H__
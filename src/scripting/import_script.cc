@@ -53,6 +53,7 @@ ImportScript::ImportScript(Ref<Runtime> runtime) : Script(runtime, "import")
 
 void ImportScript::processCdsObject(Ref<CdsObject> obj, String scriptpath)
 {
+    AutoLock lock(runtime->getMutex());
     processed = obj;
     try 
     {
@@ -61,16 +62,15 @@ void ImportScript::processCdsObject(Ref<CdsObject> obj, String scriptpath)
         duk_push_string(ctx, scriptpath.c_str());
         duk_put_global_string(ctx, "object_script_path");
         execute();
-        duk_push_global_object(ctx);
-        duk_del_prop_string(ctx, -1, "orig");
-        duk_del_prop_string(ctx, -1, "object_script_path");
-        duk_pop(ctx);
+        // the globals stay defined for the next object, overwriting them
+        // is cheaper than deleting and adding them again
+        duk_push_undefined(ctx);
+        duk_put_global_string(ctx, "orig");
     }
     catch (const Exception & ex)
     {
-        duk_push_global_object(ctx);
-        duk_del_prop_string(ctx, -1, "orig");
-        duk_del_prop_string(ctx, -1, "object_script_path");
+        duk_push_undefined(ctx);
+        duk_put_global_string(ctx, "orig");
         processed = nullptr;
         throw ex;
     }
@@ -33,21 +33,23 @@
 #define __SCRIPTING_RUNTIME_H__
 
 #include "duktape.h"
-#include <pthread.h>
+#include <mutex>
 #include "common.h"
-#include "singleton.h"
 
 /// \brief Runtime class definition.
-class Runtime : public Singleton<Runtime, std::recursive_mutex>
+///
+/// Every runtime owns a separate duktape heap, scripts running on
+/// different runtimes can be executed in parallel.
+class Runtime : public zmm::Object
 {
 protected:
     duk_context *ctx;
+    std::recursive_mutex mutex;
 
 public:
     Runtime();
     virtual ~Runtime();
-    zmm::String getName() override { return _("Runtime"); }
-    
+
     /// \brief Returns a new (sub)context. !!! Not thread-safe !!!
     duk_context *createContext(std::string name);
     void destroyContext(std::string name);
@@ -31,6 +31,16 @@
 
 #ifdef HAVE_JS
 
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
 #include "script.h"
 #include "tools.h"
 #include "metadata_handler.h"
@@ -46,6 +56,26 @@
 
 using namespace zmm;
 
+// compiled scripts by script path: the cache key and the bytecode, shared
+// by all runtimes so that every heap of a pool does not compile again
+static std::mutex bytecodeMutex;
+static std::unordered_map<std::string, std::pair<std::string, std::string>> bytecodeCache;
+
+// properties of objects handed to the scripts which are only built on access
+#define LAZY_META           0
+#define LAZY_AUX            1
+#define LAZY_RES            2
+#define LAZY_PROPERTIES     3
+static const char *lazyPropertyNames[LAZY_PROPERTIES] = { "meta", "aux", "res" };
+
+// hidden symbols, not visible to the scripts
+#define LAZY_SERIAL         "\x82" "lazySerial"
+#define LAZY_PENDING        "\x82" "lazyPending"
+#define LAZY_OWNER          "\x82" "lazyOwner"
+// thread stash
+#define LAZY_PROTOTYPE      "lazyPrototype"
+#define LAZY_ACCESSORS      "lazyAccessors"
+
 static duk_function_list_entry js_global_functions[] =
 {
     { "print",          js_print,        DUK_VARARGS },
@@ -58,12 +88,12 @@ static duk_function_list_entry js_global_functions[] =
     { nullptr,          nullptr,         0 },
 };
 
-String Script::getProperty(String name)
+String Script::getProperty(const char *name)
 {
     String ret;
     if (!duk_is_object_coercible(ctx, -1))
         return nullptr;
-    duk_get_prop_string(ctx, -1, name.c_str());
+    duk_get_prop_string(ctx, -1, name);
     if (duk_is_null_or_undefined(ctx, -1) || !duk_to_string(ctx, -1))
     {
         duk_pop(ctx);
@@ -74,12 +104,12 @@ String Script::getProperty(String name)
     return ret;
 }
 
-int Script::getBoolProperty(String name)
+int Script::getBoolProperty(const char *name)
 {
     int ret;
     if (!duk_is_object_coercible(ctx, -1))
         return -1;
-    duk_get_prop_string(ctx, -1, name.c_str());
+    duk_get_prop_string(ctx, -1, name);
     if (duk_is_null_or_undefined(ctx, -1))
     {
         duk_pop(ctx);
@@ -90,12 +120,12 @@ int Script::getBoolProperty(String name)
     return ret;
 }
 
-int Script::getIntProperty(String name, int def)
+int Script::getIntProperty(const char *name, int def)
 {
     int ret;
     if (!duk_is_object_coercible(ctx, -1))
         return def;
-    duk_get_prop_string(ctx, -1, name.c_str());
+    duk_get_prop_string(ctx, -1, name);
     if (duk_is_null_or_undefined(ctx, -1))
     {
         duk_pop(ctx);
@@ -106,16 +136,16 @@ int Script::getIntProperty(String name, int def)
     return ret;
 }
 
-void Script::setProperty(String name, String value)
+void Script::setProperty(const char *name, String value)
 {
     duk_push_string(ctx, value.c_str());
-    duk_put_prop_string(ctx, -2, name.c_str());
+    duk_put_prop_string(ctx, -2, name);
 }
 
-void Script::setIntProperty(String name, int value)
+void Script::setIntProperty(const char *name, int value)
 {
     duk_push_int(ctx, value);
-    duk_put_prop_string(ctx, -2, name.c_str());
+    duk_put_prop_string(ctx, -2, name);
 }
 
 /* **************** */
@@ -123,6 +153,7 @@ void Script::setIntProperty(String name, int value)
 Script::Script(Ref<Runtime> runtime, std::string name) : Object(), name(name)
 {
     gc_counter = 0;
+    lazyObjectSerial = 0;
 
     this->runtime = runtime;
 
@@ -143,6 +174,8 @@ Script::Script(Ref<Runtime> runtime, std::string name) : Object(), name(name)
     duk_put_prop_string(ctx, -2, "this");
     duk_pop(ctx);
 
+    createLazyPrototype();
+
     /* initialize contstants */
     duk_push_int(ctx, OBJECT_TYPE_CONTAINER); duk_put_global_string(ctx, "OBJECT_TYPE_CONTAINER");
     duk_push_int(ctx, OBJECT_TYPE_ITEM); duk_put_global_string(ctx, "OBJECT_TYPE_ITEM");
@@ -219,6 +252,13 @@ Script::Script(Ref<Runtime> runtime, std::string name) : Object(), name(name)
 
 Script::~Script()
 {
+    // objects may outlive the script, their finalizers must not call back
+    duk_push_thread_stash(ctx, ctx);
+    duk_get_prop_string(ctx, -1, LAZY_PROTOTYPE);
+    duk_push_pointer(ctx, nullptr);
+    duk_put_prop_string(ctx, -2, LAZY_OWNER);
+    duk_pop_2(ctx);
+
     runtime->destroyContext(name);
 }
 
@@ -249,6 +289,145 @@ void Script::defineFunctions(duk_function_list_entry *functions)
     duk_pop(ctx);
 }
 
+static String getBytecodeCacheFile(String scriptPath)
+{
+    String home = ConfigManager::getInstance()->getOption(CFG_SERVER_HOME);
+    return home + DIR_SEPARATOR + _(JS_BYTECODE_CACHE_DIR) + DIR_SEPARATOR + hex_string_md5(scriptPath) + ".bc";
+}
+
+/// \brief Describes the duktape build: bytecode is only portable between
+/// builds with the same version and value representation.
+static std::string getDuktapeBuild()
+{
+    std::ostringstream build;
+    build << DUK_VERSION;
+#ifdef DUK_GIT_DESCRIBE
+    build << '-' << DUK_GIT_DESCRIBE;
+#endif
+    build << " ptr" << sizeof(void *);
+#ifdef DUK_USE_PACKED_TVAL
+    build << " packed";
+#endif
+#ifdef DUK_USE_FASTINT
+    build << " fastint";
+#endif
+#if defined(DUK_USE_DOUBLE_LE)
+    build << " double-le";
+#elif defined(DUK_USE_DOUBLE_BE)
+    build << " double-be";
+#elif defined(DUK_USE_DOUBLE_ME)
+    build << " double-me";
+#endif
+#if defined(DUK_USE_INTEGER_LE)
+    build << " int-le";
+#elif defined(DUK_USE_INTEGER_BE)
+    build << " int-be";
+#elif defined(DUK_USE_INTEGER_ME)
+    build << " int-me";
+#endif
+    return build.str();
+}
+
+/// \brief Identifies a compiled script: a changed script text, import
+/// charset or duktape build makes the cached bytecode unusable.
+static std::string getBytecodeCacheKey(String scriptPath, String scriptText)
+{
+    std::ostringstream key;
+    key << "gerbera-js " << getDuktapeBuild() << ' '
+        << ConfigManager::getInstance()->getOption(CFG_IMPORT_SCRIPTING_CHARSET).c_str() << ' '
+        << hex_string_md5(scriptText).c_str() << ' '
+        << scriptPath.c_str() << '\n';
+    return key.str();
+}
+
+/// \brief The cache files start with the key and the md5 sum of the
+/// bytecode, duktape does not check the bytecode it loads.
+static std::string getBytecodeHeader(const std::string& key, const std::string& bytecode)
+{
+    return key + hex_md5(bytecode.data(), bytecode.size()).c_str() + '\n';
+}
+
+static bool getCachedBytecode(String scriptPath, const std::string& key, std::string& bytecode)
+{
+    {
+        std::lock_guard<std::mutex> lock(bytecodeMutex);
+        auto it = bytecodeCache.find(scriptPath.c_str());
+        if (it != bytecodeCache.end() && it->second.first == key) {
+            bytecode = it->second.second;
+            return true;
+        }
+    }
+
+    String cacheFile = getBytecodeCacheFile(scriptPath);
+    FILE* f = fopen(cacheFile.c_str(), "rb");
+    if (f == nullptr)
+        return false;
+
+    std::string data;
+    char buffer[4096];
+    size_t bytesRead;
+    while ((bytesRead = fread(buffer, 1, sizeof(buffer), f)) > 0)
+        data.append(buffer, bytesRead);
+    fclose(f);
+
+    if (data.compare(0, key.size(), key) != 0) {
+        log_debug("stale bytecode cache for %s\n", scriptPath.c_str());
+        return false;
+    }
+
+    size_t headerEnd = data.find('\n', key.size());
+    if (headerEnd == std::string::npos
+        || data.compare(0, headerEnd + 1, getBytecodeHeader(key, data.substr(headerEnd + 1))) != 0) {
+        log_warning("corrupt bytecode cache %s\n", cacheFile.c_str());
+        return false;
+    }
+
+    bytecode = data.substr(headerEnd + 1);
+    std::lock_guard<std::mutex> lock(bytecodeMutex);
+    bytecodeCache[scriptPath.c_str()] = std::make_pair(key, bytecode);
+    return true;
+}
+
+static void storeBytecode(String scriptPath, const std::string& key, const std::string& bytecode)
+{
+    {
+        std::lock_guard<std::mutex> lock(bytecodeMutex);
+        bytecodeCache[scriptPath.c_str()] = std::make_pair(key, bytecode);
+    }
+
+    String cacheFile = getBytecodeCacheFile(scriptPath);
+    String cacheDir = cacheFile.substring(0, cacheFile.rindex(DIR_SEPARATOR));
+    if (mkdir(cacheDir.c_str(), 0700) != 0 && errno != EEXIST) {
+        log_warning("could not create bytecode cache directory %s: %s\n",
+            cacheDir.c_str(), mt_strerror(errno).c_str());
+        return;
+    }
+
+    // written under a temporary name, a concurrent reader must never see
+    // a partial file
+    String tmpFile = cacheFile + ".tmp";
+    FILE* f = fopen(tmpFile.c_str(), "wb");
+    if (f == nullptr) {
+        log_warning("could not write bytecode cache %s: %s\n",
+            tmpFile.c_str(), mt_strerror(errno).c_str());
+        return;
+    }
+    std::string header = getBytecodeHeader(key, bytecode);
+    bool ok = fwrite(header.data(), 1, header.size(), f) == header.size()
+        && fwrite(bytecode.data(), 1, bytecode.size(), f) == bytecode.size();
+    ok = (fclose(f) == 0) && ok;
+    if (!ok || rename(tmpFile.c_str(), cacheFile.c_str()) != 0) {
+        log_warning("could not write bytecode cache %s\n", cacheFile.c_str());
+        unlink(tmpFile.c_str());
+    }
+}
+
+static duk_ret_t load_function_unsafe(duk_context *ctx, void *udata)
+{
+    duk_load_function(ctx);
+    return 1;
+}
+
 void Script::_load(zmm::String scriptPath)
 {
     String scriptText = read_text_file(scriptPath);
@@ -266,9 +445,31 @@ void Script::_load(zmm::String scriptPath)
         throw _Exception(_("Failed to convert import script:") + e.getMessage().c_str());
     }
 
+    std::string key = getBytecodeCacheKey(scriptPath, scriptText);
+    std::string bytecode;
+    if (getCachedBytecode(scriptPath, key, bytecode))
+    {
+        void *buf = duk_push_fixed_buffer(ctx, bytecode.size());
+        memcpy(buf, bytecode.data(), bytecode.size());
+        if (duk_safe_call(ctx, load_function_unsafe, nullptr, 1, 1) == DUK_EXEC_SUCCESS)
+        {
+            log_debug("loaded %s from bytecode cache\n", scriptPath.c_str());
+            return;
+        }
+        log_warning("Invalid bytecode cache for %s: %s\n", scriptPath.c_str(), duk_safe_to_string(ctx, -1));
+        duk_pop(ctx);
+    }
+
     duk_push_string(ctx, scriptPath.c_str());
     if (duk_pcompile_lstring_filename(ctx, 0, scriptText.c_str(), scriptText.length()) != 0)
         throw _Exception(_("Scripting: failed to compile ") + scriptPath);
+
+    duk_dup(ctx, -1);
+    duk_dump_function(ctx);
+    duk_size_t length;
+    auto *data = (const char *)duk_get_buffer_data(ctx, -1, &length);
+    storeBytecode(scriptPath, key, std::string(data, length));
+    duk_pop(ctx);
 }
 
 void Script::load(zmm::String scriptPath)
@@ -315,7 +516,7 @@ Ref<CdsObject> Script::dukObject2cdsObject(zmm::Ref<CdsObject> pcd)
     else
         sc = StringConverter::i2i();
 
-    objectType = getIntProperty(_("objectType"), -1);
+    objectType = getIntProperty("objectType", -1);
     if (objectType == -1)
     {
         log_error("missing objectType property\n");
@@ -330,17 +531,17 @@ Ref<CdsObject> Script::dukObject2cdsObject(zmm::Ref<CdsObject> pcd)
     // CdsObject
     obj->setVirtual(true); // JS creates only virtual objects
 
-    i = getIntProperty(_("id"), INVALID_OBJECT_ID);
+    i = getIntProperty("id", INVALID_OBJECT_ID);
     if (i != INVALID_OBJECT_ID)
         obj->setID(i);
-    i = getIntProperty(_("refID"), INVALID_OBJECT_ID);
+    i = getIntProperty("refID", INVALID_OBJECT_ID);
     if (i != INVALID_OBJECT_ID)
         obj->setRefID(i);
-    i = getIntProperty(_("parentID"), INVALID_OBJECT_ID);
+    i = getIntProperty("parentID", INVALID_OBJECT_ID);
     if (i != INVALID_OBJECT_ID)
         obj->setParentID(i);
 
-    val = getProperty(_("title"));
+    val = getProperty("title");
     if (val != nullptr)
     {
         val = sc->convert(val);
@@ -352,7 +553,7 @@ Ref<CdsObject> Script::dukObject2cdsObject(zmm::Ref<CdsObject> pcd)
             obj->setTitle(pcd->getTitle());
     }
 
-    val = getProperty(_("upnpclass"));
+    val = getProperty("upnpclass");
     if (val != nullptr)
     {
         val = sc->convert(val);
@@ -364,40 +565,60 @@ Ref<CdsObject> Script::dukObject2cdsObject(zmm::Ref<CdsObject> pcd)
             obj->setClass(pcd->getClass());
     }
 
-    b = getBoolProperty(_("restricted"));
+    b = getBoolProperty("restricted");
     if (b >= 0)
         obj->setRestricted(b);
 
-    duk_get_prop_string(ctx, -1, "meta");
-    if (duk_is_object(ctx, -1))
+    auto setMetadata = [&](int i, String val)
+    {
+        if (i == M_TRACKNUMBER)
+        {
+            int j = val.toInt();
+            if (j > 0)
+            {
+                obj->setMetadata(MT_KEYS[i].upnp, val);
+                RefCast(obj, CdsItem)->setTrackNumber(j);
+            }
+            else
+                RefCast(obj, CdsItem)->setTrackNumber(0);
+        }
+        else
+        {
+            val = sc->convert(val);
+            obj->setMetadata(MT_KEYS[i].upnp, val);
+        }
+    };
+
+    Ref<CdsObject> lazyMeta = getLazySource(LAZY_META);
+    if (lazyMeta != nullptr)
     {
-        duk_to_object(ctx, -1);
-        /// \todo: only metadata enumerated in MT_KEYS is taken
+        // the script never looked at meta, no need to go through js
+        int trackNumber = IS_CDS_ITEM(lazyMeta->getObjectType()) ? RefCast(lazyMeta, CdsItem)->getTrackNumber() : 0;
         for (int i = 0; i < M_MAX; i++)
         {
-            val = getProperty(_(MT_KEYS[i].upnp));
+            val = lazyMeta->getMetadata(MT_KEYS[i].upnp);
+            if (i == M_TRACKNUMBER && trackNumber > 0)
+                val = String::from(trackNumber);
             if (val != nullptr)
+                setMetadata(i, val);
+        }
+    }
+    else
+    {
+        duk_get_prop_string(ctx, -1, "meta");
+        if (duk_is_object(ctx, -1))
+        {
+            duk_to_object(ctx, -1);
+            /// \todo: only metadata enumerated in MT_KEYS is taken
+            for (int i = 0; i < M_MAX; i++)
             {
-                if (i == M_TRACKNUMBER)
-                {
-                    int j = val.toInt();
-                    if (j > 0)
-                    {
-                        obj->setMetadata(MT_KEYS[i].upnp, val);
-                        RefCast(obj, CdsItem)->setTrackNumber(j);
-                    }
-                    else
-                        RefCast(obj, CdsItem)->setTrackNumber(0);
-                }
-                else
-                {
-                    val = sc->convert(val);
-                    obj->setMetadata(MT_KEYS[i].upnp, val);
-                }
+                val = getProperty(MT_KEYS[i].upnp);
+                if (val != nullptr)
+                    setMetadata(i, val);
             }
         }
+        duk_pop(ctx);
     }
-    duk_pop(ctx);
 
     // stuff that has not been exported to js
     if (pcd != nullptr)
@@ -416,7 +637,7 @@ Ref<CdsObject> Script::dukObject2cdsObject(zmm::Ref<CdsObject> pcd)
         if (pcd != nullptr)
             pcd_item = RefCast(pcd, CdsItem);
 
-        val = getProperty(_("mimetype"));
+        val = getProperty("mimetype");
         if (val != nullptr)
         {
             val = sc->convert(val);
@@ -428,7 +649,7 @@ Ref<CdsObject> Script::dukObject2cdsObject(zmm::Ref<CdsObject> pcd)
                 item->setMimeType(pcd_item->getMimeType());
         }
 
-        val = getProperty(_("serviceID"));
+        val = getProperty("serviceID");
         if (val != nullptr)
         {
             val = sc->convert(val);
@@ -437,7 +658,7 @@ Ref<CdsObject> Script::dukObject2cdsObject(zmm::Ref<CdsObject> pcd)
 
         /// \todo check what this is doing here, wasn't it already handled
         /// in the MT_KEYS loop?
-        val = getProperty(_("description"));
+        val = getProperty("description");
         if (val != nullptr)
         {
             val = sc->convert(val);
@@ -451,11 +672,11 @@ Ref<CdsObject> Script::dukObject2cdsObject(zmm::Ref<CdsObject> pcd)
         }
         if (this->whoami() == S_PLAYLIST)
         {
-            item->setTrackNumber(getIntProperty(_("playlistOrder"), 0));
+            item->setTrackNumber(getIntProperty("playlistOrder", 0));
         }
 
         // location must not be touched by character conversion!
-        val = getProperty(_("location"));
+        val = getProperty("location");
         if ((val != nullptr) && (IS_CDS_PURE_ITEM(objectType) || IS_CDS_ACTIVE_ITEM(objectType)))
             val = normalizePath(val);
 
@@ -474,7 +695,7 @@ Ref<CdsObject> Script::dukObject2cdsObject(zmm::Ref<CdsObject> pcd)
             if (pcd != nullptr)
                 pcd_aitem = RefCast(pcd, CdsActiveItem);
           /// \todo what about character conversion for action and state fields?
-            val = getProperty(_("action"));
+            val = getProperty("action");
             if (val != nullptr)
                 aitem->setAction(val);
             else
@@ -483,7 +704,7 @@ Ref<CdsObject> Script::dukObject2cdsObject(zmm::Ref<CdsObject> pcd)
                     aitem->setAction(pcd_aitem->getAction());
             }
 
-            val = getProperty(_("state"));
+            val = getProperty("state");
             if (val != nullptr)
                 aitem->setState(val);
             else
@@ -499,7 +720,7 @@ Ref<CdsObject> Script::dukObject2cdsObject(zmm::Ref<CdsObject> pcd)
 
             obj->setRestricted(true);
             Ref<CdsItemExternalURL> item = RefCast(obj, CdsItemExternalURL);
-            val = getProperty(_("protocol"));
+            val = getProperty("protocol");
             if (val != nullptr)
             {
                 val = sc->convert(val);
@@ -525,11 +746,11 @@ Ref<CdsObject> Script::dukObject2cdsObject(zmm::Ref<CdsObject> pcd)
     if (IS_CDS_CONTAINER(objectType))
     {
         Ref<CdsContainer> cont = RefCast(obj, CdsContainer);
-        i = getIntProperty(_("updateID"), -1);
+        i = getIntProperty("updateID", -1);
         if (i >= 0)
             cont->setUpdateID(i);
 
-        b = getBoolProperty(_("searchable"));
+        b = getBoolProperty("searchable");
         if (b >= 0)
             cont->setSearchable(b);
     }
@@ -537,87 +758,149 @@ Ref<CdsObject> Script::dukObject2cdsObject(zmm::Ref<CdsObject> pcd)
     return obj;
 }
 
-void Script::cdsObject2dukObject(Ref<CdsObject> obj)
+void Script::createLazyPrototype()
 {
-    String val;
-    int i;
-
+    duk_push_thread_stash(ctx, ctx);
     duk_push_object(ctx);
+    // stack: stash proto
+    duk_push_pointer(ctx, this);
+    duk_put_prop_string(ctx, -2, LAZY_OWNER);
 
-    int objectType = obj->getObjectType();
+    // inherited by all objects, drops their entry in lazyObjects
+    duk_push_c_function(ctx, js_lazyFinalizer, 2);
+    duk_set_finalizer(ctx, -2);
 
-    // CdsObject
-    setIntProperty(_("objectType"), objectType);
+    duk_put_prop_string(ctx, -2, LAZY_PROTOTYPE);
 
-    i = obj->getID();
+    // getter and setter of each lazy property, shared by all objects
+    duk_push_array(ctx);
+    for (int i = 0; i < LAZY_PROPERTIES; i++)
+    {
+        duk_push_c_function(ctx, js_lazyGetter, 0);
+        duk_set_magic(ctx, -1, i);
+        duk_put_prop_index(ctx, -2, 2 * i);
+        duk_push_c_function(ctx, js_lazySetter, 1);
+        duk_set_magic(ctx, -1, i);
+        duk_put_prop_index(ctx, -2, 2 * i + 1);
+    }
+    duk_put_prop_string(ctx, -2, LAZY_ACCESSORS);
+    duk_pop(ctx);
+}
 
-    if (i != INVALID_OBJECT_ID)
-        setIntProperty(_("id"), i);
+/// \brief Defines meta, aux and res on the object on top of the stack as
+/// own accessors, so Object.keys(), hasOwnProperty() and JSON.stringify()
+/// see them like the plain properties they become on first access.
+void Script::defineLazyProperties()
+{
+    duk_idx_t objIndex = duk_get_top_index(ctx);
+    duk_push_thread_stash(ctx, ctx);
+    duk_get_prop_string(ctx, -1, LAZY_ACCESSORS);
+    for (int i = 0; i < LAZY_PROPERTIES; i++)
+    {
+        duk_push_string(ctx, lazyPropertyNames[i]);
+        duk_get_prop_index(ctx, -2, 2 * i);
+        duk_get_prop_index(ctx, -3, 2 * i + 1);
+        duk_def_prop(ctx, objIndex, DUK_DEFPROP_HAVE_GETTER | DUK_DEFPROP_HAVE_SETTER |
+            DUK_DEFPROP_SET_ENUMERABLE | DUK_DEFPROP_SET_CONFIGURABLE);
+    }
+    duk_pop_2(ctx);
+}
 
-    i = obj->getParentID();
-    if (i != INVALID_OBJECT_ID)
-        setIntProperty(_("parentID"), i);
+Ref<CdsObject> Script::getLazySource(int property)
+{
+    int pending = getIntProperty(LAZY_PENDING, 0);
+    if (!(pending & (1 << property)))
+        return nullptr;
 
-    val = obj->getTitle();
-    if (val != nullptr)
-        setProperty(_("title"), val);
+    auto it = lazyObjects.find(getIntProperty(LAZY_SERIAL, 0));
+    if (it == lazyObjects.end())
+        return nullptr;
+    return it->second;
+}
 
-    val = obj->getClass();
-    if (val != nullptr)
-        setProperty(_("upnpclass"), val);
+/// \brief Turns the value on top of the stack into a plain property of
+/// the object below it.
+static void putLazyValue(duk_context *ctx, int property)
+{
+    // stack: this value
+    duk_push_string(ctx, lazyPropertyNames[property]);
+    duk_dup(ctx, -2);
+    duk_def_prop(ctx, -4, DUK_DEFPROP_HAVE_VALUE | DUK_DEFPROP_SET_WRITABLE |
+        DUK_DEFPROP_SET_ENUMERABLE | DUK_DEFPROP_SET_CONFIGURABLE);
+
+    duk_get_prop_string(ctx, -2, LAZY_PENDING);
+    int pending = duk_to_int(ctx, -1);
+    duk_pop(ctx);
+    duk_push_int(ctx, pending & ~(1 << property));
+    duk_put_prop_string(ctx, -3, LAZY_PENDING);
+}
 
-    val = obj->getLocation();
-    if (val != nullptr)
-        setProperty(_("location"), val);
+duk_ret_t Script::js_lazyGetter(duk_context *ctx)
+{
+    auto *self = getContextScript(ctx);
+    int property = duk_get_current_magic(ctx);
 
-    setIntProperty(_("mtime"), (int)obj->getMTime());
-    setIntProperty(_("sizeOnDisk"), (int)obj->getSizeOnDisk());
+    duk_push_this(ctx);
+    if (self->getIntProperty(LAZY_SERIAL, 0) == 0)
+    {
+        // called on an object that was not handed to the script
+        duk_push_undefined(ctx);
+        return 1;
+    }
 
-    // TODO: boolean type
-    i = obj->isRestricted();
-    setIntProperty(_("restricted"), i);
+    self->pushLazyProperty(self->getLazySource(property), property);
+    putLazyValue(ctx, property);
+    return 1;
+}
 
-    if (obj->getFlag(OBJECT_FLAG_OGG_THEORA))
-        setIntProperty(_("theora"), 1);
-    else
-        setIntProperty(_("theora"), 0);
+duk_ret_t Script::js_lazySetter(duk_context *ctx)
+{
+    auto *self = getContextScript(ctx);
+    int property = duk_get_current_magic(ctx);
 
-#ifdef ONLINE_SERVICES
-    if (obj->getFlag(OBJECT_FLAG_ONLINE_SERVICE))
-    {
-         service_type_t service = (service_type_t)(obj->getAuxData(_(ONLINE_SERVICE_AUX_ID)).toInt());
-        setIntProperty(_("onlineservice"), (int)service);
-    }
-    else
-#endif
-        setIntProperty(_("onlineservice"), 0);
+    duk_push_this(ctx);
+    if (self->getIntProperty(LAZY_SERIAL, 0) == 0)
+        return 0;
 
-    // setting metadata
-    {
-        duk_push_object(ctx);
-        // stack: js meta_js
+    duk_swap_top(ctx, -2);
+    // stack: this value
+    putLazyValue(ctx, property);
+    return 0;
+}
+
+duk_ret_t Script::js_lazyFinalizer(duk_context *ctx)
+{
+    // stack: object heapDestruct
+    duk_get_prop_string(ctx, 0, LAZY_OWNER);
+    auto *self = (Script *)duk_get_pointer(ctx, -1);
+    duk_get_prop_string(ctx, 0, LAZY_SERIAL);
+    if (self != nullptr && duk_is_number(ctx, -1))
+        self->lazyObjects.erase(duk_get_int(ctx, -1));
+    return 0;
+}
 
+void Script::pushLazyProperty(Ref<CdsObject> obj, int property)
+{
+    duk_push_object(ctx);
+    if (obj == nullptr)
+        return;
+
+    if (property == LAZY_META)
+    {
         Ref<Dictionary> meta = obj->getMetadata();
         Ref<Array<DictionaryElement> > elements = meta->getElements();
         int len = elements->size();
         for (int i = 0; i < len; i++)
         {
             Ref<DictionaryElement> el = elements->get(i);
-            setProperty(el->getKey(), el->getValue());
+            setProperty(el->getKey().c_str(), el->getValue());
         }
 
-        if (RefCast(obj, CdsItem)->getTrackNumber() > 0)
-            setProperty(MetadataHandler::getMetaFieldName(M_TRACKNUMBER), String::from(RefCast(obj, CdsItem)->getTrackNumber()));
-
-        duk_put_prop_string(ctx, -2, "meta");
-        // stack: js
+        if (IS_CDS_ITEM(obj->getObjectType()) && RefCast(obj, CdsItem)->getTrackNumber() > 0)
+            setProperty(MetadataHandler::getMetaFieldName(M_TRACKNUMBER).c_str(), String::from(RefCast(obj, CdsItem)->getTrackNumber()));
     }
-
-    // setting auxdata
+    else if (property == LAZY_AUX)
     {
-        duk_push_object(ctx);
-        // stack: js aux_js
-
         Ref<Dictionary> aux = obj->getAuxData();
 
 #ifdef HAVE_ATRAILERS
@@ -631,19 +914,11 @@ void Script::cdsObject2dukObject(Ref<CdsObject> obj)
         for (int i = 0; i < len; i++)
         {
             Ref<DictionaryElement> el = elements->get(i);
-            setProperty(el->getKey(), el->getValue());
+            setProperty(el->getKey().c_str(), el->getValue());
         }
-
-        duk_put_prop_string(ctx, -2, "aux");
-        // stack: js
     }
-
-
-    // setting resource
+    else if (property == LAZY_RES)
     {
-        duk_push_object(ctx);
-        // stack: js res_js
-
         if (obj->getResourceCount() > 0) {
             auto res = obj->getResource(0);
 
@@ -653,13 +928,80 @@ void Script::cdsObject2dukObject(Ref<CdsObject> obj)
             for (auto i = 0; i < len; i++)
             {
                 Ref<DictionaryElement> el = elements->get(i);
-                setProperty(el->getKey(), el->getValue());
+                setProperty(el->getKey().c_str(), el->getValue());
             }
         }
+    }
+}
+
+void Script::cdsObject2dukObject(Ref<CdsObject> obj)
+{
+    String val;
+    int i;
+
+    duk_push_object(ctx);
+
+    // meta, aux and res are accessors until the script reads them, the
+    // prototype only carries the finalizer
+    duk_push_thread_stash(ctx, ctx);
+    duk_get_prop_string(ctx, -1, LAZY_PROTOTYPE);
+    duk_remove(ctx, -2);
+    duk_set_prototype(ctx, -2);
+    defineLazyProperties();
+
+    if (lazyObjectSerial == INT_MAX)
+        lazyObjectSerial = 0;
+    lazyObjects[++lazyObjectSerial] = obj;
+    setIntProperty(LAZY_SERIAL, lazyObjectSerial);
+    setIntProperty(LAZY_PENDING, (1 << LAZY_PROPERTIES) - 1);
+
+    int objectType = obj->getObjectType();
+
+    // CdsObject
+    setIntProperty("objectType", objectType);
+
+    i = obj->getID();
+
+    if (i != INVALID_OBJECT_ID)
+        setIntProperty("id", i);
+
+    i = obj->getParentID();
+    if (i != INVALID_OBJECT_ID)
+        setIntProperty("parentID", i);
+
+    val = obj->getTitle();
+    if (val != nullptr)
+        setProperty("title", val);
+
+    val = obj->getClass();
+    if (val != nullptr)
+        setProperty("upnpclass", val);
+
+    val = obj->getLocation();
+    if (val != nullptr)
+        setProperty("location", val);
+
+    setIntProperty("mtime", (int)obj->getMTime());
+    setIntProperty("sizeOnDisk", (int)obj->getSizeOnDisk());
 
-        duk_put_prop_string(ctx, -2, "res");
-        // stack: js
+    // TODO: boolean type
+    i = obj->isRestricted();
+    setIntProperty("restricted", i);
+
+    if (obj->getFlag(OBJECT_FLAG_OGG_THEORA))
+        setIntProperty("theora", 1);
+    else
+        setIntProperty("theora", 0);
+
+#ifdef ONLINE_SERVICES
+    if (obj->getFlag(OBJECT_FLAG_ONLINE_SERVICE))
+    {
+         service_type_t service = (service_type_t)(obj->getAuxData(_(ONLINE_SERVICE_AUX_ID)).toInt());
+        setIntProperty("onlineservice", (int)service);
     }
+    else
+#endif
+        setIntProperty("onlineservice", 0);
 
     // CdsItem
     if (IS_CDS_ITEM(objectType))
@@ -667,21 +1009,21 @@ void Script::cdsObject2dukObject(Ref<CdsObject> obj)
         Ref<CdsItem> item = RefCast(obj, CdsItem);
         val = item->getMimeType();
         if (val != nullptr)
-            setProperty(_("mimetype"), val);
+            setProperty("mimetype", val);
 
         val = item->getServiceID();
         if (val != nullptr)
-            setProperty(_("serviceID"), val);
+            setProperty("serviceID", val);
 
         if (IS_CDS_ACTIVE_ITEM(objectType))
         {
             Ref<CdsActiveItem> aitem = RefCast(obj, CdsActiveItem);
             val = aitem->getAction();
             if (val != nullptr)
-                setProperty(_("action"), val);
+                setProperty("action", val);
             val = aitem->getState();
             if (val != nullptr)
-                setProperty(_("state"), val);
+                setProperty("state", val);
         }
     }
 
@@ -691,10 +1033,10 @@ void Script::cdsObject2dukObject(Ref<CdsObject> obj)
         Ref<CdsContainer> cont = RefCast(obj, CdsContainer);
         // TODO: boolean type, hide updateID
         i = cont->getUpdateID();
-        setIntProperty(_("updateID"), i);
+        setIntProperty("updateID", i);
 
         i = cont->isSearchable();
-        setIntProperty(_("searchable"), i);
+        setIntProperty("searchable", i);
     }
 }
 
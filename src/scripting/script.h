@@ -33,6 +33,7 @@
 #define __SCRIPTING_SCRIPT_H__
 
 #include <mutex>
+#include <unordered_map>
 #include "duktape.h"
 #include "common.h"
 #include "runtime.h"
@@ -42,6 +43,9 @@
 // perform garbage collection after script has been run for x times
 #define JS_CALL_GC_AFTER_NUM    (1000)
 
+// compiled scripts are kept in this subdirectory of the server home
+#define JS_BYTECODE_CACHE_DIR   "js-cache"
+
 typedef enum
 {
     S_IMPORT = 0,
@@ -65,12 +69,19 @@ public:
 public:
     virtual ~Script();
     
-    zmm::String getProperty(zmm::String name);
-    int getBoolProperty(zmm::String name);
-    int getIntProperty(zmm::String name, int def);
+    zmm::String getProperty(zmm::String name) { return getProperty(name.c_str()); }
+    int getBoolProperty(zmm::String name) { return getBoolProperty(name.c_str()); }
+    int getIntProperty(zmm::String name, int def) { return getIntProperty(name.c_str(), def); }
     
-    void setProperty(zmm::String name, zmm::String value);
-    void setIntProperty(zmm::String name, int value);
+    void setProperty(zmm::String name, zmm::String value) { setProperty(name.c_str(), value); }
+    void setIntProperty(zmm::String name, int value) { setIntProperty(name.c_str(), value); }
+
+    zmm::String getProperty(const char *name);
+    int getBoolProperty(const char *name);
+    int getIntProperty(const char *name, int def);
+
+    void setProperty(const char *name, zmm::String value);
+    void setIntProperty(const char *name, int value);
     
     void defineFunction(zmm::String name, duk_c_function function, uint32_t numParams);
     void defineFunctions(duk_function_list_entry *functions);
@@ -104,6 +115,18 @@ private:
     std::string name;
     void _load(zmm::String scriptPath);
     void _execute();
+
+    // meta, aux and res of objects handed to the script are only built
+    // when the script reads them, until then they are taken from here
+    std::unordered_map<int, zmm::Ref<CdsObject>> lazyObjects;
+    int lazyObjectSerial;
+    void createLazyPrototype();
+    void defineLazyProperties();
+    zmm::Ref<CdsObject> getLazySource(int property);
+    void pushLazyProperty(zmm::Ref<CdsObject> obj, int property);
+    static duk_ret_t js_lazyGetter(duk_context *ctx);
+    static duk_ret_t js_lazySetter(duk_context *ctx);
+    static duk_ret_t js_lazyFinalizer(duk_context *ctx);
     zmm::Ref<StringConverter> _p2i;
     zmm::Ref<StringConverter> _j2i;
     zmm::Ref<StringConverter> _f2i;
@@ -0,0 +1,117 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    script_pool.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file script_pool.h
+/// \brief Definition of the ScriptPool class.
+
+#ifndef __SCRIPTING_SCRIPT_POOL_H__
+#define __SCRIPTING_SCRIPT_POOL_H__
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "zmm/zmmf.h"
+#include "runtime.h"
+
+/// \brief A set of scripts of the same kind, each on its own Runtime.
+///
+/// The first script is created right away so that errors in the script
+/// show up at startup, further ones are created on demand while all
+/// others are busy, up to the given size. A borrowed script is used by one
+/// thread only.
+template <class T>
+class ScriptPool : public zmm::Object
+{
+public:
+    explicit ScriptPool(int size)
+        : size(size < 1 ? 1 : size)
+        , created(1)
+    {
+        idle.push_back(create());
+    }
+
+    /// \brief Takes a script out of the pool, blocks while all are busy.
+    zmm::Ref<T> take()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (idle.empty()) {
+            if (created < size) {
+                created++;
+                lock.unlock();
+                try {
+                    return create();
+                } catch (...) {
+                    lock.lock();
+                    created--;
+                    throw;
+                }
+            }
+            cond.wait(lock);
+        }
+        zmm::Ref<T> script = idle.back();
+        idle.pop_back();
+        return script;
+    }
+
+    void putBack(zmm::Ref<T> script)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        idle.push_back(script);
+        cond.notify_one();
+    }
+
+    /// \brief Returns the borrowed script to the pool when going out of scope.
+    class Borrowed
+    {
+    public:
+        explicit Borrowed(zmm::Ref<ScriptPool<T>> pool)
+            : pool(pool)
+            , script(pool->take())
+        {
+        }
+        ~Borrowed() { pool->putBack(script); }
+        Borrowed(const Borrowed&) = delete;
+        Borrowed& operator=(const Borrowed&) = delete;
+
+        T* operator->() { return script.getPtr(); }
+
+    protected:
+        zmm::Ref<ScriptPool<T>> pool;
+        zmm::Ref<T> script;
+    };
+
+protected:
+    int size;
+    int created;
+    std::vector<zmm::Ref<T>> idle;
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    static zmm::Ref<T> create()
+    {
+        return zmm::Ref<T>(new T(zmm::Ref<Runtime>(new Runtime())));
+    }
+};
+
+#endif // __SCRIPTING_SCRIPT_POOL_H__
@@ -32,7 +32,7 @@
 #include <sys/stat.h>
 
 #include "server.h"
-#include "file_io_handler.h"
+#include "read_ahead_io_handler.h"
 #include "serve_request_handler.h"
 
 
@@ -220,7 +220,7 @@ Ref<IOHandler> ServeRequestHandler::open(IN const char *filename,
     {
          throw _Exception(_("Not a regular file: ") + path);
     }
-    Ref<IOHandler> io_handler(new FileIOHandler(path));
+    Ref<IOHandler> io_handler = ReadAheadIOHandler::create(path);
     io_handler->open(mode);
 
     return io_handler;
@@ -42,6 +42,7 @@
 #include "server.h"
 #include "update_manager.h"
 #include "file_request_handler.h"
+#include "play_hook.h"
 #ifdef HAVE_CURL
 #include "url_request_handler.h"
 #endif
@@ -409,6 +410,9 @@ void Server::upnp_subscriptions(Ref<SubscriptionRequest> request)
 // Temp
 void Server::send_subscription_update(zmm::String updateString)
 {
+    // UPnP is not up, e.g. when importing from the command line
+    if (cmgr == nullptr)
+        return;
     cmgr->subscription_update(updateString);
 }
 
@@ -459,19 +463,25 @@ int Server::register_web_callbacks()
 {
     log_debug("Setting UpnpVirtualDir GetInfoCallback\n");
     int ret = UpnpVirtualDir_set_GetInfoCallback([](IN const char* filename, OUT UpnpFileInfo* info, const void *cookie) -> int {
+        // the SDK opens the file from the same thread right after this
+        PlayHook::setRequestClient(sockAddrToIP(UpnpFileInfo_get_CtrlPtIPAddr(info)));
+        int result = 0;
         try {
             Ref<RequestHandler> reqHandler = const_cast<Server *>(static_cast<const Server *>(cookie))->create_request_handler(filename);
             reqHandler->get_info(filename, info);
         } catch (const ServerShutdownException& se) {
-            return -1;
+            result = -1;
         } catch (const SubtitlesNotFoundException& sex) {
             log_info("%s\n", sex.getMessage().c_str());
-            return -1;
+            result = -1;
         } catch (const Exception& e) {
             log_error("%s\n", e.getMessage().c_str());
-            return -1;
+            result = -1;
         }
-        return 0;});
+        // the request ends here, the file is not going to be opened
+        if (result != 0)
+            PlayHook::setRequestClient("");
+        return result;});
     if (ret != 0) return ret;
 
     log_debug("Setting UpnpVirtualDir OpenCallback\n");
@@ -479,21 +489,23 @@ int Server::register_web_callbacks()
 
         String link = url_unescape((char*)filename);
 
+        UpnpWebFileHandle handle = nullptr;
         try {
             Ref<RequestHandler> reqHandler = const_cast<Server *>(static_cast<const Server *>(cookie))->create_request_handler(filename);
             Ref<IOHandler> ioHandler = reqHandler->open(link.c_str(), mode, nullptr);
             ioHandler->retain();
             //log_debug("%p open(%s)\n", ioHandler.getPtr(), filename);
-            return (UpnpWebFileHandle)ioHandler.getPtr();
+            handle = (UpnpWebFileHandle)ioHandler.getPtr();
         } catch (const ServerShutdownException& se) {
-            return nullptr;
         } catch (const SubtitlesNotFoundException& sex) {
             log_info("SubtitlesNotFoundException: %s\n", sex.getMessage().c_str());
-            return nullptr;
         } catch (const Exception& ex) {
             log_error("Exception: %s\n", ex.getMessage().c_str());
-            return nullptr;
         }
+        // the thread serves other requests next, they must not be
+        // attributed to this client
+        PlayHook::setRequestClient("");
+        return handle;
     });
     if (ret != UPNP_E_SUCCESS) return ret;
 
@@ -37,91 +37,73 @@
 #include "timer.h"
 #include "tools.h"
 
-#define UI_UPDATE_ID_HASH_SIZE 61
 #define MAX_UI_UPDATE_IDS 10
 
 using namespace zmm;
 using namespace mxml;
 using namespace std;
 
-Session::Session(long timeout)
+Session::Session(long timeout, Ref<UIChangeFeed> feed)
     : Dictionary_r()
+    , feed(feed)
 {
     this->timeout = timeout;
     loggedIn = false;
+    waitingForUIUpdates = false;
     sessionID = nullptr;
-    uiUpdateIDs = make_shared<unordered_set<int>>();
-    //(new DBRHash<int>(UI_UPDATE_ID_HASH_SIZE, MAX_UI_UPDATE_IDS + 5, INVALID_OBJECT_ID, INVALID_OBJECT_ID_2));
-    updateAll = false;
+    feedCursor = feed->getCursor();
     access();
 }
 
-void Session::containerChangedUI(int objectID)
+void Session::logIn()
 {
-    if (objectID == INVALID_OBJECT_ID)
-        return;
-    if (!updateAll) {
-        AutoLock lock(mutex);
-        if (!updateAll) {
-            if (uiUpdateIDs->size() >= MAX_UI_UPDATE_IDS) {
-                updateAll = true;
-                uiUpdateIDs->clear();
-            } else
-                uiUpdateIDs->insert(objectID);
-        }
-    }
-}
-
-void Session::containerChangedUI(const std::vector<int>& objectIDs)
-{
-    if (updateAll)
-        return;
-
-    size_t arSize = objectIDs.size();
     AutoLock lock(mutex);
-
-    if (updateAll)
-        return;
-
-    if (uiUpdateIDs->size() + arSize >= MAX_UI_UPDATE_IDS) {
-        updateAll = true;
-        uiUpdateIDs->clear();
-        return;
-    }
-    for (int objectId : objectIDs) {
-        uiUpdateIDs->insert(objectId);
-    }
+    // the UI loads the whole tree after logging in
+    if (!loggedIn)
+        feedCursor = feed->getCursor();
+    loggedIn = true;
 }
 
 String Session::getUIUpdateIDs()
 {
-    if (!hasUIUpdateIDs())
-        return nullptr;
     AutoLock lock(mutex);
-    if (updateAll) {
-        updateAll = false;
+    if (!loggedIn)
+        return nullptr;
+    UIChangeFeed::Changes changes = feed->collect(feedCursor, MAX_UI_UPDATE_IDS);
+    if (changes.all)
         return _("all");
-    }
-    String ret = toCSV(uiUpdateIDs);
-    if (ret != nullptr)
-        uiUpdateIDs->clear();
-    return ret;
+    if (changes.containers.empty())
+        return nullptr;
+    return _(join(changes.containers, ',').c_str());
 }
 
 bool Session::hasUIUpdateIDs()
 {
-    if (updateAll)
-        return true;
-    // AutoLock lock(mutex); only accessing an int - shouldn't be necessary
-    return (uiUpdateIDs->size() > 0);
+    AutoLock lock(mutex);
+    return loggedIn && feed->hasContainerChanges(feedCursor);
 }
 
 void Session::clearUpdateIDs()
 {
     log_debug("clearing UI updateIDs\n");
     AutoLock lock(mutex);
-    uiUpdateIDs->clear();
-    updateAll = false;
+    feedCursor = feed->getCursor();
+}
+
+UIChangeFeed::WaitResult Session::waitForUIUpdates(long timeout)
+{
+    UIChangeFeed::Cursor cursor;
+    {
+        AutoLock lock(mutex);
+        if (waitingForUIUpdates)
+            return UIChangeFeed::WAIT_BUSY;
+        waitingForUIUpdates = true;
+        cursor = feedCursor;
+    }
+    UIChangeFeed::WaitResult result = feed->wait(cursor, timeout);
+    AutoLock lock(mutex);
+    waitingForUIUpdates = false;
+    return result;
 }
 
 SessionManager::SessionManager()
@@ -130,12 +112,13 @@ SessionManager::SessionManager()
 
     accounts = configManager->getDictionaryOption(CFG_SERVER_UI_ACCOUNT_LIST);
     sessions = Ref<Array<Session>>(new Array<Session>());
+    feed = Ref<UIChangeFeed>(new UIChangeFeed());
     timerAdded = false;
 }
 
 Ref<Session> SessionManager::createSession(long timeout)
 {
-    Ref<Session> newSession(new Session(timeout));
+    Ref<Session> newSession(new Session(timeout, feed));
     AutoLock lock(mutex);
 
     int count = 0;
@@ -191,26 +174,24 @@ void SessionManager::containerChangedUI(int objectID)
 {
     if (sessions->size() <= 0)
         return;
-    AutoLock lock(mutex);
-    int sesSize = sessions->size();
-    for (int i = 0; i < sesSize; i++) {
-        Ref<Session> session = sessions->get(i);
-        if (session->isLoggedIn())
-            session->containerChangedUI(objectID);
-    }
+    feed->containerChanged(objectID);
 }
 
 void SessionManager::containerChangedUI(const std::vector<int>& objectIDs)
 {
     if (sessions->size() <= 0)
         return;
-    AutoLock lock(mutex);
-    int sesSize = sessions->size();
-    for (int i = 0; i < sesSize; i++) {
-        Ref<Session> session = sessions->get(i);
-        if (session->isLoggedIn())
-            session->containerChangedUI(objectIDs);
-    }
+    feed->containerChanged(objectIDs);
+}
+
+void SessionManager::taskChangedUI()
+{
+    feed->taskChanged();
+}
+
+void SessionManager::shutdown()
+{
+    feed->close();
 }
 
 void SessionManager::checkTimer()
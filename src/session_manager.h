@@ -39,6 +39,7 @@
 #include "singleton.h"
 #include "dictionary.h"
 #include "timer.h"
+#include "ui_change_feed.h"
 
 /// \brief One UI session.
 /// 
@@ -51,11 +52,12 @@ class Session : public Dictionary_r
 public:
     /// \brief Constructor, creates a session with a given timeout.
     /// \param timeout time in milliseconds after which the session will expire if not accessed.
+    /// \param feed the changes the UI of the session is told about
     ///
     /// The session is created with a given timeout, each access to the session updates the
     /// last_access value, if last access lies further back than the timeout - the session will
     /// be deleted (will time out)
-    Session(long timeout);
+    Session(long timeout, zmm::Ref<UIChangeFeed> feed);
     
     /// \brief Returns the time of last access to the session.
     /// \return pointer to a timespec
@@ -71,7 +73,7 @@ public:
     
     inline bool isLoggedIn() { return loggedIn; }
     
-    inline void logIn() { loggedIn = true; }
+    void logIn();
     
     inline void logOut() { loggedIn = false; }
     
@@ -85,19 +87,23 @@ public:
     bool hasUIUpdateIDs();
     
     void clearUpdateIDs();
+
+    /// \brief Blocks until a container or the current task changed since
+    /// the UI last fetched the update ids.
+    ///
+    /// Only one request of a session waits at a time, others get
+    /// UIChangeFeed::WAIT_BUSY right away.
+    /// \param timeout in milliseconds
+    UIChangeFeed::WaitResult waitForUIUpdates(long timeout);
     
 protected:
-    /// \brief Is called by SessionManager if UI update is needed
-    /// \param objectID the container that needs to be updated
-    void containerChangedUI(int objectID);
-    
-    void containerChangedUI(const std::vector<int>& objectIDs);
-    
-    /// \brief True if the ui update id hash became to big and
-    /// the UI shall update every container
-    bool updateAll;
-    
-    std::shared_ptr<std::unordered_set<int> > uiUpdateIDs;
+    zmm::Ref<UIChangeFeed> feed;
+
+    /// \brief the changes the UI was already told about
+    UIChangeFeed::Cursor feedCursor;
+
+    /// \brief true while a request of the session waits for the feed
+    bool waitingForUIUpdates;
     
     /// \brief maximum time the session can be idle (starting from last_access)
     long timeout;
@@ -119,6 +125,9 @@ class SessionManager : public Timer::Subscriber, public Singleton<SessionManager
 protected:
     /// \brief This array is holding available sessions.
     zmm::Ref<zmm::Array<Session> > sessions;
+
+    /// \brief changes for the UI of all sessions
+    zmm::Ref<UIChangeFeed> feed;
     
     zmm::Ref<Dictionary> accounts;
     
@@ -154,6 +163,11 @@ public:
     void containerChangedUI(int objectID);
     
     void containerChangedUI(const std::vector<int>& objectIDs);
+
+    /// \brief Is called when the content manager starts or finishes a task.
+    void taskChangedUI();
+
+    virtual void shutdown() override;
     
     virtual void timerNotify(zmm::Ref<Timer::Parameter> parameter) override;
 };
@@ -29,6 +29,8 @@
 
 /// \file singleton.cc
 
+#include <vector>
+
 #include "singleton.h"
 
 using namespace zmm;
@@ -75,6 +77,7 @@ void SingletonManager::shutdown(bool complete)
     log_debug("start (%d objects)\n", singletonStack->size());
     AutoLock lock(mutex);
 
+    std::vector<Ref<Singleton<Object> > > inactive;
     Ref<Singleton<Object> > object;
     while((object = singletonStack->pop()) != nullptr)
     {
@@ -82,10 +85,17 @@ void SingletonManager::shutdown(bool complete)
         object->shutdown();
         log_debug("invalidating %s... \n", object->getName().c_str());
         object->inactivateSingleton();
+        inactive.push_back(object);
     }
 
-    if (complete && instance != nullptr)
-        instance = nullptr;
+    if (complete)
+    {
+        // everything is gone, a restart creates new instances
+        for (auto &singleton : inactive)
+            singleton->reactivateSingleton();
+        if (instance != nullptr)
+            instance = nullptr;
+    }
 
     log_debug("end\n");
 }
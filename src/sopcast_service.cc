@@ -48,15 +48,13 @@ SopCastService::SopCastService()
 {
     url = Ref<URL>(new URL());
     pid = 0;
-    curl_handle = curl_easy_init();
-    if (!curl_handle)
-        throw _Exception(_("failed to initialize curl!\n"));
+    client = HTTPClient::getInstance();
+    curl_handle = client->getHandle();
 }
 
 SopCastService::~SopCastService()
 {
-    if (curl_handle)
-        curl_easy_cleanup(curl_handle);
+    client->returnHandle(curl_handle);
 }
 
 service_type_t SopCastService::getServiceType()
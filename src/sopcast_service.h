@@ -38,6 +38,7 @@
 #include "zmm/zmm.h"
 #include "mxml/mxml.h"
 #include "online_service.h"
+#include "http_client.h"
 #include "url.h"
 #include "dictionary.h"
 #include <curl/curl.h>
@@ -65,6 +66,7 @@ public:
     virtual zmm::Ref<zmm::Object> defineServiceTask(zmm::Ref<mxml::Element> xmlopt, zmm::Ref<zmm::Object> params);
 
 protected:
+    zmm::Ref<HTTPClient> client;
     // the handle *must never be used from multiple threads*
     CURL *curl_handle;
     // safeguard to ensure the above
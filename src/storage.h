@@ -32,7 +32,9 @@
 #ifndef __STORAGE_H__
 #define __STORAGE_H__
 
+#include <map>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <string>
@@ -122,6 +124,39 @@ public:
     int getRequestedCount() { return requestedCount; };
 };
 
+/// \brief What a directory looked like when it was scanned completely.
+///
+/// As long as the fingerprint stays the same no entry was added to,
+/// removed from or renamed in the directory, so the scan does not need to
+/// reconcile its entries with the database.
+struct DirectoryFingerprint
+{
+    /// \brief modification and change time in nanoseconds, a directory
+    /// can change several times within one second
+    long long mtime;
+    long long ctime;
+    ino_t inode;
+    int childCount;
+
+    bool operator==(const DirectoryFingerprint& other) const
+    {
+        return mtime == other.mtime && ctime == other.ctime
+            && inode == other.inode && childCount == other.childCount;
+    }
+};
+
+/// \brief How often and how far a client played an item.
+struct PlayStatus
+{
+    int itemID;
+    /// \brief address of the client
+    std::string client;
+    int playCount;
+    time_t lastPlayed;
+    /// \brief byte offset the client stopped reading at, -1 if unknown
+    off_t position;
+};
+
 class Storage : public Singleton<Storage, std::mutex>
 {
 public:
@@ -186,7 +221,22 @@ public:
     /// \param size number of entries in the given array
     /// \return a String for UPnP: a CSV list; for every existing object:
     ///  "id,update_id"
+    ///
+    /// Implementations may keep the new values in memory only, until
+    /// flushUpdateIDs() is called.
     virtual zmm::String incrementUpdateIDs(std::shared_ptr<std::unordered_set<int> > ids) = 0;
+
+    /// \brief writes the update ids that were incremented in memory
+    /// by incrementUpdateIDs() to the database
+    virtual void flushUpdateIDs() { }
+
+    /// \brief writes objects held back to be inserted in batches
+    /// to the database
+    virtual void flushInserts() { }
+
+    /// \brief number of statements sent to the database so far,
+    /// used by the benchmarks
+    virtual unsigned long getQueryCount() { return 0; }
     
     /* utility methods */
     virtual zmm::Ref<CdsObject> loadObject(int objectID) = 0;
@@ -220,6 +270,29 @@ public:
     /// \param withoutContainer if false: all children are returned; if true: only items are returned
     /// \return DBHash containing the objectID's - nullptr if there are none!
     virtual std::shared_ptr<std::unordered_set<int> > getObjects(int parentID, bool withoutContainer) = 0;
+
+    /// \brief Loads the fingerprint stored for the given directory container.
+    /// \return false if the directory was never scanned completely
+    virtual bool loadDirectoryFingerprint(int objectID, DirectoryFingerprint &fingerprint) = 0;
+
+    /// \brief Stores the fingerprint of a completely scanned directory container.
+    virtual void storeDirectoryFingerprint(int objectID, const DirectoryFingerprint &fingerprint) = 0;
+
+    /// \brief Adds up the playback of items since the last call.
+    ///
+    /// playCount is added to the stored count, a position of -1 keeps the
+    /// stored one.
+    virtual void storePlayStatus(const std::vector<PlayStatus> &changes) = 0;
+
+    /// \brief Loads the play status of the given items for one client.
+    /// \return status by item id, items that were never played are missing
+    virtual std::unordered_map<int, PlayStatus> loadPlayStatus(const std::vector<int> &itemIDs, const std::string &client) = 0;
+
+    /// \brief Finds the objects whose rendering shows the play status of
+    /// the given items.
+    /// \return the items, the virtual items referring to them and the
+    /// containers of all of them
+    virtual std::vector<int> getPlayStatusObjectIDs(const std::vector<int> &itemIDs) = 0;
     
     /// \brief Remove all objects found in list
     /// \param list a DBHash containing objectIDs that have to be removed
@@ -237,6 +310,17 @@ public:
     
     /* accounting methods */
     virtual int getTotalFiles() = 0;
+
+    /* statistics methods */
+
+    /// \brief Returns the number of objects per mime type.
+    virtual std::map<std::string, int> getMimeTypeCounts() = 0;
+
+    /// \brief Returns the number of objects per object type.
+    virtual std::map<int, int> getObjectTypeCounts() = 0;
+
+    /// \brief Returns the size of all files below the given directory.
+    virtual off_t getDirectoryBytes(zmm::String path) = 0;
     
     /* internal setting methods */
     virtual zmm::String getInternalSetting(zmm::String key) = 0;
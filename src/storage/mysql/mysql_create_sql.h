@@ -33,85 +33,94 @@
 
 #ifndef __MYSQL_CREATE_SQL_H__
 #define __MYSQL_CREATE_SQL_H__
-#define MS_CREATE_SQL_INFLATED_SIZE 4216
-#define MS_CREATE_SQL_DEFLATED_SIZE 1090
+#define MS_CREATE_SQL_INFLATED_SIZE 5073
+#define MS_CREATE_SQL_DEFLATED_SIZE 1219
 
 /* begin binary data: */
-const unsigned char mysql_create_sql[] = /* 1090 */
-{0x78,0x9C,0xC5,0x57,0x51,0x6F,0x9B,0x48,0x10,0x7E,0xCF,0xAF,0xD8,0x7B,0x02
-,0x57,0xDC,0x05,0xA2,0x44,0xEA,0xA9,0x8A,0x14,0x0E,0x6F,0x5B,0xAB,0x04,0x52
-,0xC0,0x77,0xEA,0xBD,0x2C,0x6B,0x58,0xC7,0x5C,0x30,0x58,0xB0,0x58,0xF5,0xBF
-,0xBF,0x59,0x30,0x06,0xCC,0xDA,0xB5,0xA5,0x53,0xEF,0x25,0xC1,0xC3,0xB7,0xDF
-,0x7E,0xCC,0xCC,0xCE,0xCE,0xDC,0xBE,0xFB,0xE5,0x5E,0x37,0x74,0x03,0xF9,0x38
-,0x40,0x4F,0xAE,0x3D,0x25,0xD6,0x67,0xD3,0x33,0xAD,0x00,0x7B,0x04,0x4C,0xC4
-,0xB2,0x67,0xD8,0x09,0x1E,0x9F,0x9E,0x64,0x66,0xF4,0xEE,0xF6,0xC3,0xCD,0xED
-,0x0F,0x18,0x3C,0xEC,0xCF,0xED,0xC0,0x1F,0x51,0xEC,0xED,0xA7,0x38,0x5C,0xDB
-,0x36,0x83,0x99,0xEB,0xC0,0x93,0xE3,0x60,0x4B,0x3C,0x0A,0x0A,0x89,0x79,0xCC
-,0xE0,0x98,0xCF,0xD8,0x47,0x15,0x5F,0xBE,0xEF,0xDE,0xE9,0xC6,0x7D,0xC7,0x3E
-,0x77,0x66,0x5F,0xE7,0x18,0x84,0x62,0xEB,0x8B,0x50,0x36,0xF8,0xAD,0xA1,0xE1
-,0x6B,0xFD,0x04,0xC9,0x47,0xD7,0xC3,0xB3,0x4F,0x0E,0xF9,0x82,0xBF,0x75,0x4C
-,0x63,0xA3,0x86,0x24,0x40,0xFD,0xC4,0x67,0xFB,0x5F,0x6D,0xF2,0xEC,0x4E,0x31
-,0x30,0xB5,0x8F,0x1A,0x3A,0x18,0x15,0xC7,0x25,0xE6,0x3C,0x70,0xC9,0x9F,0xA6
-,0x0D,0xFA,0xC0,0x0B,0x7F,0x63,0xCF,0x55,0x7A,0x5C,0xC6,0x11,0x97,0xE3,0x06
-,0xD8,0xDF,0x93,0xD5,0xCF,0x0D,0x5B,0x63,0x6E,0x44,0x58,0x1E,0x36,0x03,0x8C
-,0x02,0xF3,0x0F,0x1B,0xA3,0x70,0xCD,0x49,0x14,0x97,0x24,0x5F,0xFC,0xC3,0x22
-,0x1E,0x22,0xF5,0x06,0xA1,0x30,0x89,0x43,0x94,0x64,0x5C,0x35,0x8C,0x09,0x82
-,0x95,0xC8,0x99,0xDB,0x36,0xA2,0x15,0xCF,0x49,0x92,0x45,0x05,0x5B,0xB3,0x8C
-,0x6B,0x02,0x57,0xB0,0x25,0xE9,0x63,0x63,0xB6,0xA4,0x55,0xCA,0x6B,0x7C,0x0D
-,0xD8,0xD0,0x02,0xB0,0x44,0xCA,0xD7,0x82,0x15,0x5D,0xA9,0xB1,0x8D,0x02,0xC2
-,0x77,0x1B,0x16,0x22,0x9E,0x64,0x3B,0xB1,0xE2,0x7E,0x82,0xAA,0xAC,0x4C,0x5E
-,0x33,0x16,0x1F,0x56,0xD6,0xE8,0x6A,0x93,0x6D,0x48,0x94,0xD2,0xB2,0x0C,0xD1
-,0x96,0x16,0xD1,0x8A,0x16,0xEA,0x7B,0x5D,0x22,0x21,0x8E,0x08,0x4F,0x78,0xCA
-,0x3A,0xD8,0xDD,0xC3,0x83,0x04,0x97,0xE6,0x11,0xE5,0x49,0x9E,0x85,0x68,0x91
-,0xE6,0x8B,0x81,0x89,0xAC,0x68,0xB9,0xEA,0xBE,0xE0,0x20,0x68,0xC4,0xB1,0x66
-,0x9C,0xC6,0x94,0xD3,0x1E,0x07,0xAD,0xBE,0x1F,0x59,0x0A,0x56,0xE6,0x55,0x11
-,0xB1,0xB2,0x67,0xAB,0x36,0x00,0x62,0x97,0xF9,0x69,0x9D,0xAC,0xD9,0xDE,0x4B
-,0xED,0x17,0xDD,0xCB,0x3E,0x7C,0x99,0xD2,0xD7,0x52,0xA2,0x7A,0x4C,0x6C,0x34
-,0xC4,0xBC,0xA0,0xD1,0x1B,0xC9,0xAA,0xF5,0x82,0x15,0x67,0x62,0x5A,0xB2,0x62
-,0x9B,0x44,0x8D,0xD8,0xB3,0x2E,0x7D,0xF1,0x66,0xCF,0xA6,0xF7,0x0D,0xC1,0x29
-,0x40,0x48,0x15,0x49,0x35,0x11,0x66,0xF1,0x33,0xEC,0x52,0x8E,0xB4,0x49,0xA4
-,0xB6,0xE9,0x24,0x45,0xF5,0x32,0x49,0xED,0xA5,0x95,0x36,0x48,0x1B,0xAD,0x8B
-,0xB6,0x94,0x64,0x90,0x62,0xEA,0x60,0x69,0x87,0x3F,0x44,0xBD,0xD9,0x45,0x00
-,0x87,0x89,0xA0,0xF5,0xF6,0x97,0x6E,0x33,0x74,0xA4,0x3A,0x74,0xAC,0x74,0x45
-,0xDF,0xA7,0x6A,0xDF,0xC3,0x35,0x1A,0x2A,0x9F,0x1F,0x78,0xE6,0x0C,0xEA,0xEF
-,0xF0,0xB8,0x92,0x64,0xB1,0x7C,0x23,0x46,0xD8,0x16,0x9C,0x9A,0xB7,0xF3,0x23
-,0xF2,0xF0,0x47,0xEC,0x61,0xC7,0x82,0xDA,0x38,0x3A,0xE7,0x75,0x3C,0x10,0x14
-,0xD3,0x29,0xB6,0x31,0x94,0x03,0xCB,0xF4,0x2D,0x73,0x8A,0x85,0x65,0xFE,0x32
-,0x35,0x3B,0xCB,0x05,0x0A,0xEE,0x8E,0x15,0xF4,0x1C,0xF4,0xDF,0x88,0xB8,0x99
-,0x20,0xEC,0x7C,0x9A,0x39,0xF8,0xF1,0x79,0x37,0xF3,0xCD,0x67,0x24,0xAE,0x16
-,0x28,0x7C,0x8F,0xA2,0xE6,0x7F,0xB8,0x99,0x39,0x3E,0xF6,0x02,0x04,0xFA,0xDC
-,0xD1,0x26,0x75,0xE9,0xF4,0x91,0xFA,0xAB,0xA1,0xD5,0x99,0x09,0xFF,0xF5,0xE6
-,0xE9,0xFC,0x9F,0x3D,0xE8,0xF7,0xCE,0x34,0xB9,0x6C,0x23,0xFD,0xB0,0x8F,0xA1
-,0x29,0xCD,0xCB,0xDF,0xA2,0x3C,0xE3,0x34,0xC9,0x58,0xA1,0x68,0x8A,0x97,0xE7
-,0x5C,0xB9,0x72,0xDF,0xBD,0x37,0x8E,0xB7,0x14,0xA5,0x5F,0xF8,0xF0,0x11,0x8A
-,0x03,0xFA,0xEB,0x33,0xF8,0x79,0xFF,0xD3,0x50,0x2E,0xD3,0x6A,0xB4,0x7B,0xCA
-,0xA5,0xBE,0x58,0x68,0x9A,0x14,0x60,0xCD,0x8B,0xDD,0xB5,0x92,0xA5,0xD7,0x0C
-,0x8D,0x78,0xB2,0x85,0xCC,0xE6,0x6C,0x7D,0xE6,0xAE,0x69,0x2A,0x67,0xD4,0x94
-,0xE3,0x41,0x8D,0x19,0x20,0x4A,0x0E,0x45,0xF3,0x0C,0xE0,0x44,0x01,0x92,0x24
-,0x73,0x4F,0xD6,0x89,0x33,0xF5,0xD3,0x52,0x79,0xE4,0x36,0x70,0x0E,0x2B,0x32
-,0x9A,0x42,0x91,0xE0,0x70,0x2D,0xBE,0xEE,0xFD,0xF6,0xC6,0x76,0xC3,0x0B,0x60
-,0xE0,0x9A,0x2D,0x4D,0xAB,0x2B,0x5C,0x23,0xC8,0x26,0x57,0x9E,0xB1,0xB1,0xAE
-,0x36,0xA9,0x94,0x78,0x41,0xB6,0xAC,0x28,0x21,0x7C,0x90,0x43,0x0F,0x8A,0x2C
-,0x19,0x44,0x37,0x51,0x46,0x34,0xBB,0xB2,0xE3,0x00,0x77,0x9F,0xEF,0x38,0x04
-,0x27,0x49,0xD9,0x96,0xA5,0x21,0x62,0x50,0x72,0x55,0x65,0x41,0xCB,0x24,0x02
-,0x1D,0xCB,0x2A,0x4D,0x95,0xE3,0x0C,0x12,0xE8,0x75,0x1E,0xB3,0x16,0xCC,0xE1
-,0x72,0x8D,0x01,0x9C,0x64,0x39,0x4F,0x96,0xBB,0x63,0x3C,0x1C,0x85,0x0A,0xBE
-,0x6B,0x7B,0x49,0x87,0xB2,0x4A,0xE2,0x98,0x65,0x17,0x00,0x6B,0x47,0x42,0xC0
-,0x2E,0xE9,0x30,0xA0,0xE1,0xE1,0x42,0x70,0xB2,0x4C,0x18,0xB8,0x61,0x91,0xBC
-,0x8A,0x35,0x77,0xFA,0xB9,0x35,0x1B,0x11,0x8A,0x92,0xD7,0x77,0xD9,0x39,0x31
-,0xA3,0x4E,0x43,0xD2,0x12,0x6D,0x28,0x5F,0x41,0x00,0xFA,0xBD,0x0B,0xCF,0xAB
-,0x68,0x25,0xC4,0x5C,0xC6,0xDD,0x34,0x1B,0xFD,0xFC,0x0B,0x9B,0x5B,0xAF,0x3D
-,0x9E,0x4D,0x2F,0xDE,0xBC,0xE9,0x25,0x0A,0x69,0x43,0xAF,0xB6,0x49,0x20,0x3B
-,0xCC,0x07,0xB4,0xFC,0x14,0xB7,0x2B,0xFF,0x9F,0x93,0xDC,0xB5,0x87,0x57,0xE5
-,0x7C,0x53,0x95,0x4E,0x95,0xC9,0x4D,0x91,0x43,0x80,0xF9,0x8E,0x64,0x74,0x7D
-,0xEE,0xC4,0x77,0xC0,0x7D,0x6D,0xE0,0xEC,0x3B,0x3F,0x59,0x13,0x8E,0x62,0xD2
-,0x04,0x63,0x2F,0x9F,0x1C,0x04,0xA9,0x07,0x6D,0xB2,0x58,0x74,0xF8,0x78,0xF9
-,0x36,0x2E,0xA8,0xED,0xCA,0x9F,0x12,0x8B,0xC1,0xE0,0xD5,0xCD,0x5C,0xFD,0x09
-,0x6C,0x3C,0xF4,0xC9,0xE6,0x3D,0xF9,0x1C,0x38,0x5E,0x7B,0x34,0x70,0x8E,0x66
-,0xD0,0xF1,0x38,0x28,0x1F,0xC3,0x4F,0x0D,0xE8,0x3F,0x5A,0x7F,0x18,0xC2,0x4F
-,0xCE,0xE7,0x12,0x06,0xE9,0x08,0x7E,0x6A,0x38,0x1F,0x0F,0xA1,0xBD,0xF9,0x73
-,0x30,0x8E,0xD6,0xC8,0x7F,0x01,0x8E,0xC3,0xF9,0x67};
-/* end binary data. size = 1090 bytes */
+const unsigned char mysql_create_sql[] = /* 1219 */
+{0x78,0xDA,0xCD,0x58,0x5D,0x6F,0xA3,0x38,0x14,0x7D,0xEF,0xAF,0xF0,0x3E,0x41
+,0x46,0xEC,0x36,0x54,0x1D,0xA9,0xAB,0x51,0xA5,0xB2,0x89,0x67,0x26,0x1A,0x42
+,0x3A,0x40,0x76,0x35,0xFB,0xE2,0x38,0x60,0x1A,0x6F,0x09,0x44,0x60,0xA2,0xC9
+,0xFE,0xFA,0xB5,0xF9,0x08,0x5F,0x86,0xA6,0xA3,0xD5,0x76,0x5F,0x5A,0x72,0x39
+,0xBE,0x3E,0xDC,0x7B,0x7D,0xAE,0x75,0xAF,0xDF,0xFD,0x74,0x3B,0xD5,0xA7,0x3A
+,0x70,0xA0,0x0B,0x1E,0x56,0xE6,0x1C,0xCD,0x3E,0x1B,0xB6,0x31,0x73,0xA1,0x8D
+,0xB8,0x09,0xCD,0xCC,0x05,0xB4,0xDC,0xFB,0x87,0x07,0x99,0x19,0xBC,0xBB,0xFE
+,0x70,0x75,0xFD,0x82,0x07,0x1B,0x3A,0x6B,0xD3,0x75,0x7A,0x2E,0x4A,0xFB,0x90
+,0x8F,0x95,0x69,0x1A,0xEE,0x62,0x65,0xF1,0x27,0xCB,0x82,0x33,0xF1,0x28,0x5C
+,0x48,0xCC,0x7D,0x0F,0x96,0xB1,0x84,0x0E,0xC8,0x58,0x70,0x57,0xBF,0x9B,0xEA
+,0xB7,0xB5,0xF7,0xB5,0xB5,0xF8,0xBA,0x86,0x9C,0x28,0x9C,0x7D,0x11,0xCC,0x5A
+,0xBF,0x35,0xD0,0x7E,0x3D,0x1D,0x70,0xF2,0x71,0x65,0xC3,0xC5,0x27,0x0B,0x7D
+,0x81,0xDF,0x6A,0x4F,0x7D,0xA3,0x06,0x24,0xC0,0xE9,0xC0,0x67,0x3B,0x5F,0x4D
+,0xB4,0x5C,0xCD,0x21,0xF7,0x54,0x3D,0x6A,0xE0,0x6C,0x54,0xAC,0x15,0x32,0xD6
+,0xEE,0x0A,0xFD,0x6E,0x98,0x9C,0x1F,0x8F,0xC2,0x9F,0xD0,0x5E,0x29,0x0D,0x5F
+,0x7A,0xC7,0x97,0xB5,0x72,0xA1,0x53,0x3A,0xCB,0x9F,0x0B,0x6F,0x85,0xB9,0x20
+,0x31,0xB3,0xA1,0xE1,0x42,0xE0,0x1A,0xBF,0x99,0x10,0x6C,0xF6,0x0C,0x79,0x7E
+,0x8A,0xE2,0xED,0x5F,0xC4,0x63,0x1B,0xA0,0x5E,0x01,0xB0,0xA1,0xFE,0x06,0xD0
+,0x88,0xA9,0xBA,0x3E,0x01,0x7C,0x25,0xB0,0xD6,0xA6,0x09,0x70,0xC6,0x62,0x44
+,0x23,0x2F,0x21,0x7B,0x12,0x31,0x4D,0xE0,0x12,0x12,0xA0,0x26,0xD6,0x27,0x01
+,0xCE,0x42,0x96,0xE3,0x73,0xC0,0x01,0x27,0x1C,0x8B,0xA4,0xFE,0x2A,0xB0,0x32
+,0x55,0x72,0x6C,0xC1,0x00,0xB1,0xD3,0x81,0x6C,0x00,0xA3,0xD1,0x49,0xAC,0xB8
+,0x9D,0x80,0x2C,0x4A,0xE9,0x53,0x44,0xFC,0xF3,0xCA,0x1C,0x9D,0x1D,0xA2,0x03
+,0xF2,0x42,0x9C,0xA6,0x1B,0x70,0xC4,0x89,0xB7,0xC3,0x89,0x7A,0x37,0x95,0x50
+,0xF0,0x3D,0xC4,0x28,0x0B,0x49,0x0D,0xBB,0x79,0xFF,0x5E,0x82,0x0B,0x63,0x0F
+,0x33,0x1A,0x47,0x1B,0xB0,0x0D,0xE3,0x6D,0xCB,0x84,0x76,0x38,0xDD,0xD5,0x5F
+,0x70,0x26,0xD4,0xF3,0xB1,0x27,0x0C,0xFB,0x98,0xE1,0x86,0x0F,0x9C,0x7D,0xEF
+,0x58,0x12,0x92,0xC6,0x59,0xE2,0x91,0xB4,0x61,0xCB,0x0E,0x1C,0x44,0x2E,0x8B
+,0xD3,0x9E,0xEE,0x49,0x19,0xA5,0xEA,0x8B,0x6E,0x65,0x1F,0x1E,0x84,0xF8,0x29
+,0x95,0xB0,0xEE,0x3B,0xD6,0x0B,0xC7,0x2C,0xC1,0xDE,0x33,0x8A,0xB2,0xFD,0x96
+,0x24,0x23,0x39,0x4D,0x49,0x72,0xA4,0x5E,0x41,0x76,0x3C,0xA4,0x01,0x0D,0x09
+,0x4A,0xE9,0xDF,0x9C,0xE9,0x96,0x3E,0x09,0x87,0x37,0x12,0xA2,0x8F,0xF6,0x62
+,0x69,0xD8,0xDF,0x00,0x3F,0x2C,0x00,0xA8,0xA2,0xF6,0x26,0xC2,0x2C,0x7E,0x6E
+,0xEA,0xCA,0x44,0x55,0xAD,0xA9,0x55,0xD5,0x49,0x51,0x8D,0x82,0x53,0x1B,0xD5
+,0xA7,0xB5,0xAA,0x4B,0xAB,0x8B,0x42,0xEA,0xA4,0x55,0x89,0x6A,0x6B,0x69,0x8D
+,0x3F,0x17,0x47,0xB1,0x8B,0x00,0xB6,0xEB,0x45,0x6B,0xEC,0x2F,0xDD,0xA6,0x1D
+,0x6F,0xB5,0x1D,0x7F,0xE9,0x8A,0x66,0xE8,0xD5,0x66,0x22,0x72,0x34,0x17,0x48
+,0xC7,0xB5,0x8D,0x05,0x97,0xE9,0xF6,0xA9,0x46,0x74,0x1B,0x3C,0x23,0x7D,0x53
+,0xE9,0x52,0xEE,0xB7,0x8E,0x23,0xB0,0xE1,0x47,0x68,0x43,0x6B,0xC6,0x25,0xB4
+,0x27,0x07,0x79,0x3E,0x00,0xD7,0xDC,0x39,0x34,0x21,0x57,0x8D,0x99,0xE1,0xCC
+,0x8C,0x39,0x14,0x96,0xF5,0xE3,0xDC,0xA8,0x2D,0x17,0x30,0xB8,0xE9,0x32,0x68
+,0x04,0xE8,0xDF,0x21,0x71,0x35,0x01,0xD0,0xFA,0xB4,0xB0,0xE0,0xFD,0xF2,0xB4
+,0x70,0x8C,0x25,0x10,0x1D,0x88,0xEB,0xE3,0xBD,0x68,0x0D,0x1F,0xAE,0x16,0x96
+,0x03,0x6D,0x17,0x70,0x7E,0xAB,0xDE,0x26,0xB9,0xC2,0x3A,0x40,0xFD,0x59,0xD7
+,0xF2,0xCA,0xE4,0xFF,0xA7,0xC5,0xD3,0xF8,0x9F,0x12,0xF4,0x6B,0xC7,0x3E,0xB9
+,0x6C,0xB7,0xE9,0x79,0x33,0x5D,0x53,0x8A,0x97,0xBF,0x78,0x71,0xC4,0x30,0x8D
+,0x48,0xA2,0x68,0x8A,0x1D,0xC7,0x4C,0xF9,0x91,0xCD,0xCB,0xB8,0x74,0xF7,0x15
+,0xBD,0x42,0x44,0xF3,0x9E,0xAB,0x09,0xF8,0xE3,0x33,0x8F,0x78,0xF9,0x53,0x57
+,0x2E,0x23,0xAC,0x57,0x1B,0xCB,0xF9,0x3E,0xCE,0xC0,0x9C,0x26,0xDC,0x1A,0x27
+,0xA7,0x1F,0xE2,0x2D,0x6D,0x4E,0xD8,0x63,0xF4,0xC8,0x0B,0x9D,0x91,0xFD,0x48
+,0x87,0x2A,0xF4,0xD6,0x2B,0x44,0xBC,0xA5,0x4C,0x2D,0x44,0xCA,0xB8,0xD4,0x8E
+,0x00,0x06,0xF4,0x48,0x52,0xDB,0x0D,0x5A,0x03,0x47,0xEC,0x3F,0xAB,0xEC,0x5E
+,0xD8,0x78,0x70,0x48,0x12,0xE1,0x90,0x6B,0x06,0xE3,0xCD,0xF4,0xA9,0x8C,0xDB
+,0x33,0x39,0xB5,0xDB,0x46,0x2B,0x34,0x47,0x1C,0x66,0xAF,0x08,0x8D,0x70,0x36
+,0x79,0xE5,0x91,0xEB,0xF3,0xAA,0x2A,0x4B,0xF1,0xB7,0xE8,0x48,0x92,0x94,0xA7
+,0x8F,0x17,0xD2,0x9D,0x22,0x2B,0x06,0x71,0x07,0x49,0x3D,0x1C,0xBD,0xF2,0x9E
+,0xC2,0xC3,0x3D,0x7E,0x4F,0x11,0x3E,0x51,0x48,0x8E,0x24,0xDC,0x00,0xC2,0x15
+,0x58,0x55,0xB6,0x38,0xA5,0x1E,0xE7,0x11,0x64,0x61,0xA8,0x74,0x2B,0x48,0xA0
+,0xF7,0xB1,0x4F,0x2A,0x30,0xE3,0x2D,0xD9,0xE7,0x60,0x1A,0xC5,0x8C,0x06,0xA7
+,0x2E,0x9E,0x9F,0x87,0x8C,0x7F,0xD7,0xF1,0x92,0x7B,0xCD,0x8E,0xFA,0x3E,0x89
+,0x2E,0x00,0xE6,0x81,0xE4,0x09,0xBB,0xE4,0x5E,0xC2,0xAF,0x49,0x4C,0x10,0xA6
+,0x01,0x25,0x7E,0xAB,0x19,0x0F,0xAF,0x39,0x88,0x54,0xA4,0x2C,0x6F,0x6D,0x63
+,0x64,0x7A,0xF7,0x13,0xC9,0x45,0xEA,0x80,0xD9,0x8E,0x27,0xA0,0x79,0xE3,0x61
+,0x71,0xE6,0xED,0x04,0x99,0xCB,0x7C,0x17,0x57,0x94,0x66,0xFD,0x6D,0x8A,0x26
+,0x58,0x1D,0xCF,0xE2,0x06,0x5F,0xBC,0x69,0x14,0x0A,0xAA,0x52,0xAF,0x56,0x45
+,0x20,0x3B,0xCC,0x67,0xB4,0xFC,0x14,0x57,0x2B,0xDF,0xE6,0x24,0xD7,0x97,0xCA
+,0x57,0xD5,0x7C,0xA1,0x4A,0x43,0x32,0x79,0x48,0x62,0x9E,0x60,0x76,0x42,0x11
+,0xDE,0x8F,0x9D,0xF8,0x1A,0x58,0x6A,0x03,0x23,0xDF,0xD9,0xA0,0x26,0x74,0x72
+,0x52,0x24,0xA3,0xA4,0x8F,0xCE,0x84,0xD4,0x33,0x37,0x59,0x2E,0x6A,0xBC,0x1F
+,0x3C,0xF7,0x05,0xB5,0x5A,0xF9,0x36,0xB9,0xF0,0x69,0x82,0x02,0xAE,0x5A,0x24
+,0x39,0x24,0x34,0x62,0x2F,0x35,0xA3,0xBD,0x10,0x86,0xD6,0x79,0x6B,0xBD,0xF6
+,0xC6,0x5F,0x73,0x35,0xF1,0x89,0xFC,0xB4,0xB6,0xDD,0xEC,0x68,0xE8,0x23,0x2F
+,0xCE,0x04,0x21,0x19,0x8F,0x66,0x8A,0x06,0x1B,0x5A,0xE7,0xD3,0x06,0xC2,0xFF
+,0x66,0x91,0x3F,0x84,0xF8,0x84,0x44,0xEB,0xCE,0xD2,0x2A,0xEA,0xA3,0x05,0xEE
+,0x85,0x34,0x97,0xAE,0x91,0xCA,0x16,0x1E,0x07,0xA2,0xD6,0x17,0x35,0xA1,0xA0
+,0x62,0x45,0x47,0x3F,0x5B,0x1E,0x0B,0x50,0x9C,0xD2,0x52,0xFE,0xFA,0xB0,0xAE
+,0xDF,0x4E,0x66,0xCA,0x2F,0xD2,0x2A,0xF6,0xB2,0x3C,0x35,0x02,0xF1,0x7F,0x38
+,0x22,0xAD,0x89,0x46,0x3D,0xCC,0x68,0x8E,0x36,0xFA,0xD3,0x14,0xD9,0x20,0x45
+,0x3E,0x60,0xE9,0xAF,0xED,0x4C,0x72,0x7A,0xC3,0x9D,0xFE,0x9C,0x45,0x3E,0xDF
+,0x1A,0x9A,0x7C,0xBD,0xB4,0xFE,0x3C,0xDD,0x1A,0x1C,0x7C,0x49,0x3C,0x48,0x67
+,0x5B,0x43,0x53,0xAF,0xFE,0x74,0xA7,0x31,0xD8,0x69,0xCD,0x79,0x72,0xE4,0x3F
+,0xEB,0x1F,0xFC,0xF6};
+/* end binary data. size = 1219 bytes */
 
 #endif // __MYSQL_CREATE_SQL_H__
 
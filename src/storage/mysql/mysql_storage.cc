@@ -71,6 +71,31 @@
   CONSTRAINT `mt_metadata_idfk1` FOREIGN KEY (`item_id`) REFERENCES `mt_cds_object` (`id`) ON DELETE CASCADE ON UPDATE CASCADE \
 ) ENGINE=MyISAM CHARSET=utf8"
 #define MYSQL_UPDATE_4_5_2 "UPDATE `mt_internal_setting` SET `value`='5' WHERE `key`='db_version' AND `value`='4'"
+
+#define MYSQL_UPDATE_5_6_1 "CREATE TABLE `mt_dir_fingerprint` ( \
+  `id` int(11) NOT NULL, \
+  `mtime` bigint(20) NOT NULL, \
+  `ctime` bigint(20) NOT NULL, \
+  `inode` bigint(20) unsigned NOT NULL, \
+  `child_count` int(11) NOT NULL, \
+  PRIMARY KEY (`id`), \
+  CONSTRAINT `mt_dir_fingerprint_idfk1` FOREIGN KEY (`id`) REFERENCES `mt_cds_object` (`id`) ON DELETE CASCADE ON UPDATE CASCADE \
+) ENGINE=MyISAM CHARSET=utf8"
+#define MYSQL_UPDATE_5_6_2 "UPDATE `mt_internal_setting` SET `value`='6' WHERE `key`='db_version' AND `value`='5'"
+
+#define MYSQL_UPDATE_6_7_1 "CREATE TABLE `mt_play_status` ( \
+  `item_id` int(11) NOT NULL, \
+  `client` varchar(255) NOT NULL, \
+  `play_count` int(11) NOT NULL default '0', \
+  `last_played` bigint(20) NOT NULL, \
+  `last_position` bigint(20) NOT NULL default '0', \
+  PRIMARY KEY (`item_id`,`client`), \
+  CONSTRAINT `mt_play_status_idfk1` FOREIGN KEY (`item_id`) REFERENCES `mt_cds_object` (`id`) ON DELETE CASCADE ON UPDATE CASCADE \
+) ENGINE=MyISAM CHARSET=utf8"
+#define MYSQL_UPDATE_6_7_2 "UPDATE `mt_internal_setting` SET `value`='7' WHERE `key`='db_version' AND `value`='6'"
+
+#define MYSQL_UPDATE_7_8_1 "ALTER TABLE `mt_cds_object` ADD `file_size` bigint(20) default NULL"
+#define MYSQL_UPDATE_7_8_2 "UPDATE `mt_internal_setting` SET `value`='8' WHERE `key`='db_version' AND `value`='7'"
   
 
 using namespace zmm;
@@ -269,9 +294,33 @@ void MysqlStorage::init()
         dbVersion = _("5");
     }
 
+    if (dbVersion == "5") {
+        log_info("Doing an automatic database upgrade from database version 5 to version 6...\n");
+        _exec(MYSQL_UPDATE_5_6_1);
+        _exec(MYSQL_UPDATE_5_6_2);
+        log_info("database upgrade successful.\n");
+        dbVersion = _("6");
+    }
+
+    if (dbVersion == "6") {
+        log_info("Doing an automatic database upgrade from database version 6 to version 7...\n");
+        _exec(MYSQL_UPDATE_6_7_1);
+        _exec(MYSQL_UPDATE_6_7_2);
+        log_info("database upgrade successful.\n");
+        dbVersion = _("7");
+    }
+
+    if (dbVersion == "7") {
+        log_info("Doing an automatic database upgrade from database version 7 to version 8...\n");
+        _exec(MYSQL_UPDATE_7_8_1);
+        _exec(MYSQL_UPDATE_7_8_2);
+        log_info("database upgrade successful.\n");
+        dbVersion = _("8");
+    }
+
     /* --- --- ---*/
 
-    if (!string_ok(dbVersion) || dbVersion != "5")
+    if (!string_ok(dbVersion) || dbVersion != "8")
         throw _Exception(_("The database seems to be from a newer version (database version ") + dbVersion + ")!");
 
     lock.unlock();
@@ -315,6 +364,7 @@ Ref<SQLResult> MysqlStorage::select(const char* query, int length)
 
     int res;
 
+    queryCount++;
     checkMysqlThreadInit();
     AutoLock lock(mysqlMutex);
     res = mysql_real_query(&db, query, length);
@@ -341,6 +391,7 @@ int MysqlStorage::exec(const char* query, int length, bool getLastInsertId)
 
     int res;
 
+    queryCount++;
     checkMysqlThreadInit();
     AutoLock lock(mysqlMutex);
     res = mysql_real_query(&db, query, length);
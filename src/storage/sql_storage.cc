@@ -32,6 +32,7 @@
 #include "sql_storage.h"
 #include "config_manager.h"
 #include "filesystem.h"
+#include "metadata_handler.h"
 #include "string_converter.h"
 #include "tools.h"
 #include "update_manager.h"
@@ -50,7 +51,12 @@ using namespace std;
 
 #define SQL_NULL "NULL"
 
-#define RESOURCE_SEP '|'
+/// \brief internal setting holding the encoding of resources and auxdata
+#define RESOURCE_ENCODING_SETTING "resource_encoding"
+
+/// \brief internal setting telling that the file_size column is filled
+#define FILE_SIZE_SETTING "file_size"
+
 
 enum {
     _id = 0,
@@ -76,7 +82,8 @@ enum {
     _ref_resources,
     _ref_mime_type,
     _ref_service_id,
-    _as_persistent
+    _as_persistent,
+    _file_size
 };
 
 /* table quote */
@@ -115,7 +122,8 @@ enum {
     SEL_EQ_SP_RFQ_DT_BQ "resources" \
     SEL_EQ_SP_RFQ_DT_BQ "mime_type" \
     SEL_EQ_SP_RFQ_DT_BQ "service_id" << QTE \
-    << ',' << TQD("as","persistent")
+    << ',' << TQD("as","persistent") \
+    << ',' << TQD('f',"file_size")
 
 #define SQL_QUERY_FOR_STRINGBUFFER "SELECT " << SELECT_DATA_FOR_STRINGBUFFER << \
     " FROM " << TQ(CDS_OBJECT_TABLE) << ' ' << TQ('f') << " LEFT JOIN " \
@@ -165,6 +173,7 @@ SQLStorage::SQLStorage()
     table_quote_end = '\0';
     lastID = INVALID_OBJECT_ID;
     lastMetadataID = INVALID_OBJECT_ID;
+    queryCount = 0;
 }
 
 void SQLStorage::init()
@@ -216,13 +225,18 @@ void SQLStorage::init()
 
 void SQLStorage::dbReady()
 {
+    migrateResourceEncoding();
+    migrateFileSizes();
     loadLastID();
     loadLastMetadataID();
+    loadVirtualPaths();
+    loadStatistics();
 }
 
 void SQLStorage::shutdown()
 {
     flushInsertBuffer();
+    flushUpdateIDs();
     shutdownDriver();
 }
 
@@ -325,20 +339,12 @@ Ref<Array<SQLStorage::AddUpdateTable>> SQLStorage::_addUpdateObject(Ref<CdsObjec
         cdsObjectSql->put(_("auxdata"), _(SQL_NULL));
     Ref<Dictionary> dict = obj->getAuxData();
     if (dict->size() > 0 && (!hasReference || !refObj->getAuxData()->equals(obj->getAuxData()))) {
-        cdsObjectSql->put(_("auxdata"), quote(obj->getAuxData()->encode()));
+        cdsObjectSql->put(_("auxdata"), quote(obj->getAuxData()->encodeCompact()));
     }
 
     if (!hasReference || (!obj->getFlag(OBJECT_FLAG_USE_RESOURCE_REF) && !refObj->resourcesEqual(obj))) {
-        // encode resources
-        std::ostringstream resBuf;
-        for (int i = 0; i < obj->getResourceCount(); i++) {
-            if (i > 0)
-                resBuf << RESOURCE_SEP;
-            resBuf << obj->getResource(i)->encode();
-        }
-        String resStr = resBuf.str();
-        if (string_ok(resStr))
-            cdsObjectSql->put(_("resources"), quote(resStr));
+        if (obj->getResourceCount() > 0)
+            cdsObjectSql->put(_("resources"), quote(CdsResource::encodeCompact(obj->getResources())));
         else
             cdsObjectSql->put(_("resources"), _(SQL_NULL));
     } else if (isUpdate)
@@ -401,6 +407,12 @@ Ref<Array<SQLStorage::AddUpdateTable>> SQLStorage::_addUpdateObject(Ref<CdsObjec
         }
 
         cdsObjectSql->put(_("mime_type"), quote(item->getMimeType()));
+
+        off_t fileSize = getCountedFileSize(obj);
+        if (fileSize > 0)
+            cdsObjectSql->put(_("file_size"), quote((long long)fileSize));
+        else if (isUpdate)
+            cdsObjectSql->put(_("file_size"), _(SQL_NULL));
     }
     if (IS_CDS_ACTIVE_ITEM(objectType)) {
         Ref<Dictionary> cdsActiveItemSql(new Dictionary());
@@ -468,6 +480,17 @@ void SQLStorage::addObject(Ref<CdsObject> obj, int* changedContainer)
         else
             addToInsertBuffer(qb->str());
     }
+    // the directory has a new entry, its next scan has to reconcile it
+    if (!obj->isVirtual()) {
+        std::ostringstream qb;
+        qb << "DELETE FROM " << TQ(DIR_FINGERPRINT_TABLE)
+           << " WHERE " << TQ("id") << '=' << obj->getParentID();
+        if (!doInsertBuffering())
+            exec(qb);
+        else
+            addToInsertBuffer(qb.str());
+    }
+    countObject(obj, 1);
 
     /* add to cache */
     if (cacheOn()) {
@@ -498,6 +521,9 @@ void SQLStorage::updateObject(zmm::Ref<CdsObject> obj, int* changedContainer)
         data = _addUpdateObject(obj, true, changedContainer);
         if (data == nullptr)
             return;
+        // not loaded by a browse or loadObject(), the row still holds what was counted
+        if (IS_CDS_ITEM(obj->getObjectType()) && !obj->isCounted())
+            loadCounted(obj);
     }
     for (int i = 0; i < data->size(); i++) {
         Ref<AddUpdateTable> addUpdateTable = data->get(i);
@@ -514,6 +540,12 @@ void SQLStorage::updateObject(zmm::Ref<CdsObject> obj, int* changedContainer)
         log_debug("upd_query: %s\n", qb->str().c_str());
         exec(*qb);
     }
+    if (IS_CDS_ITEM(obj->getObjectType())) {
+        uncountObject(obj);
+        countObject(obj, 1);
+    }
+    if (IS_CDS_CONTAINER(obj->getObjectType()) && obj->isVirtual() && string_ok(obj->getLocation()))
+        rememberVirtualContainer(obj->getID(), obj->getLocation().c_str());
     /* add to cache */
     addObjectToCache(obj);
     /* ------------ */
@@ -708,9 +740,10 @@ Ref<Array<CdsObject>> SQLStorage::browse(Ref<BrowseParam> param)
     res = select(qb);
 
     Ref<Array<CdsObject>> arr(new Array<CdsObject>());
+    ResultPage page;
 
     while ((row = res->nextRow()) != nullptr) {
-        Ref<CdsObject> obj = createObjectFromRow(row);
+        Ref<CdsObject> obj = createObjectFromRow(row, page);
         arr->append(obj);
         row = nullptr;
     }
@@ -718,6 +751,10 @@ Ref<Array<CdsObject>> SQLStorage::browse(Ref<BrowseParam> param)
     row = nullptr;
     res = nullptr;
 
+    loadMetadata(page);
+    for (auto& entry : page.entries)
+        addObjectToCache(entry.object);
+
     // update childCount fields
     for (int i = 0; i < arr->size(); i++) {
         Ref<CdsObject> obj = arr->get(i);
@@ -761,15 +798,18 @@ zmm::Ref<zmm::Array<CdsObject>> SQLStorage::search(zmm::Ref<SearchParam> param,
     sqlResult = select(retrievalSQL);
 
     zmm::Ref<zmm::Array<CdsObject>> arr(new Array<CdsObject>()); 
+    ResultPage page;
     zmm::Ref<SQLRow> sqlRow;
     while ((sqlRow = sqlResult->nextRow()) != nullptr) {
-        Ref<CdsObject> obj = createObjectFromSearchRow(sqlRow);
+        Ref<CdsObject> obj = createObjectFromSearchRow(sqlRow, page);
         arr->append(obj);
         sqlRow = nullptr;
     }
     sqlRow = nullptr;
     sqlResult = nullptr;
 
+    loadMetadata(page);
+
     return arr;
 }
 
@@ -825,24 +865,11 @@ int SQLStorage::getChildCount(int contId, bool containers, bool items, bool hide
 
 Ref<Array<StringBase>> SQLStorage::getMimeTypes()
 {
-    flushInsertBuffer();
-
     Ref<Array<StringBase>> arr(new Array<StringBase>());
 
-    std::ostringstream qb;
-    qb << "SELECT DISTINCT " << TQ("mime_type")
-        << " FROM " << TQ(CDS_OBJECT_TABLE)
-        << " WHERE " << TQ("mime_type") << " IS NOT NULL ORDER BY "
-        << TQ("mime_type");
-    Ref<SQLResult> res = select(qb);
-    if (res == nullptr)
-        throw _Exception(_("db error"));
-
-    Ref<SQLRow> row;
-
-    while ((row = res->nextRow()) != nullptr) {
-        arr->append(String(row->col(0)));
-    }
+    AutoLock lock(statisticsMutex);
+    for (const auto& mimeType : mimeTypeCounts)
+        arr->append(String(mimeType.first.c_str()));
 
     return arr;
 }
@@ -988,6 +1015,11 @@ int SQLStorage::createContainer(int parentID, String name, String path, bool isV
 
     exec(qb);
 
+    {
+        AutoLock lock(statisticsMutex);
+        countObject(OBJECT_TYPE_CONTAINER, nullptr, dbLocation, 0, 1);
+    }
+
     if (itemMetadata != nullptr) {
         Ref<Array<DictionaryElement>> metadataElements = itemMetadata->getElements();
         for (int i = 0; i < metadataElements->size(); i++) {
@@ -1027,6 +1059,9 @@ int SQLStorage::createContainer(int parentID, String name, String path, bool isV
     }
     /* ------------ */
 
+    if (isVirtual)
+        rememberVirtualContainer(newID, path.c_str());
+
     return newID;
 
     //return exec(qb, true);
@@ -1059,39 +1094,85 @@ String SQLStorage::buildContainerPath(int parentID, String title)
 }
 
 void SQLStorage::addContainerChain(String path, String lastClass, int lastRefID, int* containerID, int* updateID, Ref<Dictionary> lastMetadata)
+{
+    // layout scripts may run in parallel, they must not create a chain twice
+    AutoLock lock(containerChainMutex);
+    _addContainerChain(path, lastClass, lastRefID, containerID, updateID, lastMetadata);
+}
+
+void SQLStorage::_addContainerChain(String path, String lastClass, int lastRefID, int* containerID, int* updateID, Ref<Dictionary> lastMetadata)
 {
     path = path.reduce(VIRTUAL_CONTAINER_SEPARATOR);
     if (path == VIRTUAL_CONTAINER_SEPARATOR) {
         *containerID = CDS_ID_ROOT;
         return;
     }
-    std::ostringstream qb;
-    String dbLocation = addLocationPrefix(LOC_VIRT_PREFIX, path);
-    qb << "SELECT " << TQ("id") << " FROM " << TQ(CDS_OBJECT_TABLE)
-        << " WHERE " << TQ("location_hash") << '=' << quote(stringHash(dbLocation))
-        << " AND " << TQ("location") << '=' << quote(dbLocation)
-        << " LIMIT 1";
 
-    Ref<SQLResult> res = select(qb);
-    if (res != nullptr) {
-        Ref<SQLRow> row = res->nextRow();
-        if (row != nullptr) {
-            if (containerID != nullptr)
-                *containerID = row->col(0).toInt();
-            return;
-        }
+    int existingID = findVirtualContainer(path.c_str());
+    if (existingID != INVALID_OBJECT_ID) {
+        if (containerID != nullptr)
+            *containerID = existingID;
+        return;
     }
 
     int parentContainerID;
     String newpath, container;
     stripAndUnescapeVirtualContainerFromPath(path, newpath, container);
 
-    addContainerChain(newpath, nullptr, INVALID_OBJECT_ID, &parentContainerID, updateID, nullptr);
+    _addContainerChain(newpath, nullptr, INVALID_OBJECT_ID, &parentContainerID, updateID, nullptr);
     if (updateID != nullptr && *updateID == INVALID_OBJECT_ID)
         *updateID = parentContainerID;
     *containerID = createContainer(parentContainerID, container, path, true, lastClass, lastRefID, lastMetadata);
 }
 
+void SQLStorage::loadVirtualPaths()
+{
+    std::ostringstream qb;
+    qb << "SELECT " << TQ("id") << ',' << TQ("location")
+       << " FROM " << TQ(CDS_OBJECT_TABLE)
+       << " WHERE " << TQ("object_type") << '=' << quote(OBJECT_TYPE_CONTAINER);
+    Ref<SQLResult> res = select(qb);
+    if (res == nullptr)
+        throw _Exception(_("could not load virtual containers"));
+
+    AutoLock lock(virtualPathMutex);
+    virtualPaths.clear();
+    virtualPathIDs.clear();
+    Ref<SQLRow> row;
+    while ((row = res->nextRow()) != nullptr) {
+        char prefix;
+        String path = stripLocationPrefix(&prefix, row->col(1));
+        if (prefix != LOC_VIRT_PREFIX || !string_ok(path))
+            continue;
+        int objectID = row->col(0).toInt();
+        virtualPaths[path.c_str()] = objectID;
+        virtualPathIDs[objectID] = path.c_str();
+    }
+    log_debug("loaded %d virtual container paths\n", (int)virtualPaths.size());
+}
+
+int SQLStorage::findVirtualContainer(const std::string& path)
+{
+    AutoLock lock(virtualPathMutex);
+    auto it = virtualPaths.find(path);
+    if (it == virtualPaths.end())
+        return INVALID_OBJECT_ID;
+    return it->second;
+}
+
+void SQLStorage::rememberVirtualContainer(int objectID, const std::string& path)
+{
+    AutoLock lock(virtualPathMutex);
+    auto it = virtualPathIDs.find(objectID);
+    if (it != virtualPathIDs.end()) {
+        if (it->second == path)
+            return;
+        virtualPaths.erase(it->second);
+    }
+    virtualPaths[path] = objectID;
+    virtualPathIDs[objectID] = path;
+}
+
 String SQLStorage::addLocationPrefix(char prefix, String path)
 {
     return String(prefix) + path;
@@ -1115,6 +1196,15 @@ String SQLStorage::stripLocationPrefix(String path)
 }
 
 Ref<CdsObject> SQLStorage::createObjectFromRow(Ref<SQLRow> row)
+{
+    ResultPage page;
+    Ref<CdsObject> obj = createObjectFromRow(row, page);
+    loadMetadata(page);
+    addObjectToCache(obj);
+    return obj;
+}
+
+Ref<CdsObject> SQLStorage::createObjectFromRow(Ref<SQLRow> row, ResultPage& page)
 {
     int objectType = row->col(_object_type).toInt();
     Ref<CdsObject> obj = CdsObject::createObject(objectType);
@@ -1125,41 +1215,20 @@ Ref<CdsObject> SQLStorage::createObjectFromRow(Ref<SQLRow> row)
 
     obj->setParentID(row->col(_parent_id).toInt());
     obj->setTitle(row->col(_dc_title));
-    obj->setClass(fallbackString(row->col(_upnp_class), row->col(_ref_upnp_class)));
+    obj->setClass(fallbackString(page.strings.get(row->col_c_str(_upnp_class)),
+        page.strings.get(row->col_c_str(_ref_upnp_class))));
     obj->setFlags(row->col(_flags).toUInt());
 
-    Ref<Dictionary> meta = retrieveMetadataForObject(obj->getID());
-    if (meta != nullptr && meta->size())
-        obj->setMetadata(meta);
-    else {
-        meta = retrieveMetadataForObject(obj->getRefID());
-        if (meta != nullptr && meta->size())
-            obj->setMetadata(meta);
-    }
-    if (meta == nullptr || meta->size() == 0) {
-        // fallback to metadata that might be in mt_cds_object, which
-        // will be useful if retrieving for schema upgrade
-        String metadataStr = row->col(_metadata);
-        meta->decode(metadataStr);
-        obj->setMetadata(meta);
-    }
-
-    String auxdataStr = fallbackString(row->col(_auxdata), row->col(_ref_auxdata));
-    Ref<Dictionary> aux(new Dictionary());
-    aux->decode(auxdataStr);
-    obj->setAuxData(aux);
+    // the metadata of the whole page is loaded by loadMetadata()
+    const char* metadataStr = row->col_c_str(_metadata);
+    page.entries.push_back(ResultPage::Entry { obj,
+        metadataStr != nullptr && *metadataStr ? String(metadataStr) : nullptr,
+        true });
 
+    // resources and auxdata are decoded when they are used
     String resources_str = fallbackString(row->col(_resources), row->col(_ref_resources));
-    bool resource_zero_ok = false;
-    if (string_ok(resources_str)) {
-        Ref<Array<StringBase>> resources = split_string(resources_str,
-            RESOURCE_SEP);
-        for (int i = 0; i < resources->size(); i++) {
-            if (i == 0)
-                resource_zero_ok = true;
-            obj->addResource(CdsResource::decode(resources->get(i)));
-        }
-    }
+    bool resource_zero_ok = string_ok(resources_str);
+    obj->setEncodedResources(resources_str, fallbackString(row->col(_auxdata), row->col(_ref_auxdata)));
 
     if ((obj->getRefID() && IS_CDS_PURE_ITEM(objectType)) || (IS_CDS_ITEM(objectType) && !IS_CDS_PURE_ITEM(objectType)))
         obj->setVirtual(true);
@@ -1170,7 +1239,7 @@ Ref<CdsObject> SQLStorage::createObjectFromRow(Ref<SQLRow> row)
 
     if (IS_CDS_CONTAINER(objectType)) {
         Ref<CdsContainer> cont = RefCast(obj, CdsContainer);
-        cont->setUpdateID(row->col(_update_id).toInt());
+        cont->setUpdateID(getCurrentUpdateID(obj->getID(), row->col(_update_id).toInt()));
         char locationPrefix;
         cont->setLocation(stripLocationPrefix(&locationPrefix, row->col(_location)));
         if (locationPrefix == LOC_VIRT_PREFIX)
@@ -1192,7 +1261,8 @@ Ref<CdsObject> SQLStorage::createObjectFromRow(Ref<SQLRow> row)
             throw _Exception(_("tried to create object without at least one resource"));
 
         Ref<CdsItem> item = RefCast(obj, CdsItem);
-        item->setMimeType(fallbackString(row->col(_mime_type), row->col(_ref_mime_type)));
+        item->setMimeType(fallbackString(page.strings.get(row->col_c_str(_mime_type)),
+            page.strings.get(row->col_c_str(_ref_mime_type))));
         if (IS_CDS_PURE_ITEM(objectType)) {
             if (!obj->isVirtual())
                 item->setLocation(stripLocationPrefix(row->col(_location)));
@@ -1210,6 +1280,7 @@ Ref<CdsObject> SQLStorage::createObjectFromRow(Ref<SQLRow> row)
         else
             item->setServiceID(row->col(_service_id));
 
+        item->setCounted(row->col(_mime_type), row->col(_location), row->col(_file_size).toOFF_T());
         matched_types++;
     }
 
@@ -1235,11 +1306,10 @@ Ref<CdsObject> SQLStorage::createObjectFromRow(Ref<SQLRow> row)
         throw _StorageException(nullptr, _("unknown object type: ") + objectType);
     }
 
-    addObjectToCache(obj);
     return obj;
 }
 
-Ref<CdsObject> SQLStorage::createObjectFromSearchRow(Ref<SQLRow> row)
+Ref<CdsObject> SQLStorage::createObjectFromSearchRow(Ref<SQLRow> row, ResultPage& page)
 {
     int objectType = row->col(_object_type).toInt();
     Ref<CdsObject> obj = CdsObject::createObject(objectType);
@@ -1250,29 +1320,19 @@ Ref<CdsObject> SQLStorage::createObjectFromSearchRow(Ref<SQLRow> row)
 
     obj->setParentID(row->col(SearchCol::parent_id).toInt());
     obj->setTitle(row->col(SearchCol::dc_title));
-    obj->setClass(row->col(SearchCol::upnp_class));
-
-    Ref<Dictionary> meta = retrieveMetadataForObject(obj->getID());
-    if (meta != nullptr)
-        obj->setMetadata(meta);
+    obj->setClass(page.strings.get(row->col_c_str(SearchCol::upnp_class)));
+    page.entries.push_back(ResultPage::Entry { obj, nullptr, false });
 
     String resources_str = row->col(SearchCol::resources);
-    bool resource_zero_ok = false;
-    if (string_ok(resources_str)) {
-        Ref<Array<StringBase>> resources = split_string(resources_str, RESOURCE_SEP);
-        for (int i = 0; i < resources->size(); i++) {
-            if (i == 0)
-                resource_zero_ok = true;
-            obj->addResource(CdsResource::decode(resources->get(i)));
-        }
-    }
+    bool resource_zero_ok = string_ok(resources_str);
+    obj->setEncodedResources(resources_str, nullptr);
 
     if (IS_CDS_ITEM(objectType)) {
         if (!resource_zero_ok)
             throw _Exception(_("tried to create object without at least one resource"));
 
         Ref<CdsItem> item = RefCast(obj, CdsItem);
-        item->setMimeType(row->col(SearchCol::mime_type));
+        item->setMimeType(page.strings.get(row->col_c_str(SearchCol::mime_type)));
         if (IS_CDS_PURE_ITEM(objectType)) {
             item->setLocation(stripLocationPrefix(row->col(SearchCol::location)));
         } else { // URLs and active items
@@ -1287,6 +1347,77 @@ Ref<CdsObject> SQLStorage::createObjectFromSearchRow(Ref<SQLRow> row)
     return obj;
 }
 
+void SQLStorage::loadMetadata(ResultPage& page)
+{
+    // the metadata rows of an object go straight into its dictionary, the
+    // ones of referenced objects are only needed if an object has none
+    std::unordered_map<int, std::vector<Ref<Dictionary>>> targets;
+    std::unordered_map<int, Ref<Dictionary>> refMetadata;
+    std::vector<int> ids;
+    for (auto& entry : page.entries) {
+        Ref<CdsObject> obj = entry.object;
+        auto& target = targets[obj->getID()];
+        if (target.empty())
+            ids.push_back(obj->getID());
+        target.push_back(obj->getMetadata());
+        if (entry.useReference && obj->getRefID() > 0
+            && refMetadata.emplace(obj->getRefID(), nullptr).second
+            && targets.find(obj->getRefID()) == targets.end())
+            ids.push_back(obj->getRefID());
+    }
+
+    for (size_t start = 0; start < ids.size(); start += METADATA_LOAD_BATCH) {
+        size_t end = std::min(ids.size(), start + METADATA_LOAD_BATCH);
+        std::ostringstream qb;
+        qb << SELECT_METADATA
+            << " FROM " << TQ(METADATA_TABLE)
+            << " WHERE " << TQ("item_id")
+            << " IN (" << join(std::vector<int>(ids.begin() + start, ids.begin() + end), ',') << ')';
+        Ref<SQLResult> res = select(qb);
+        if (res == nullptr)
+            continue;
+
+        Ref<SQLRow> row;
+        while ((row = res->nextRow()) != nullptr) {
+            int itemID = row->col(m_item_id).toInt();
+            String name = page.strings.get(row->col_c_str(m_property_name));
+            String value = page.strings.get(row->col_c_str(m_property_value));
+
+            auto target = targets.find(itemID);
+            if (target != targets.end()) {
+                for (auto& meta : target->second)
+                    meta->put(name, value);
+            }
+            auto ref = refMetadata.find(itemID);
+            if (ref != refMetadata.end()) {
+                if (ref->second == nullptr)
+                    ref->second = Ref<Dictionary>(new Dictionary());
+                ref->second->put(name, value);
+            }
+        }
+    }
+
+    for (auto& entry : page.entries) {
+        Ref<CdsObject> obj = entry.object;
+        Ref<Dictionary> meta = obj->getMetadata();
+        if (meta->size())
+            continue;
+        if (entry.useReference && obj->getRefID() > 0) {
+            Ref<Dictionary> ref = refMetadata[obj->getRefID()];
+            if (ref != nullptr) {
+                // objects must not share a dictionary
+                meta->merge(ref);
+                continue;
+            }
+        }
+        if (entry.rowMetadata != nullptr) {
+            // fallback to metadata that might be in mt_cds_object, which
+            // will be useful if retrieving for schema upgrade
+            meta->decode(entry.rowMetadata);
+        }
+    }
+}
+
 Ref<Dictionary> SQLStorage::retrieveMetadataForObject(int objectId)
 {
     std::ostringstream qb;
@@ -1308,64 +1439,360 @@ Ref<Dictionary> SQLStorage::retrieveMetadataForObject(int objectId)
 }
 
 
+/// \brief size attribute of the first of the encoded resources
+static off_t getResourceSize(String resources)
+{
+    if (!string_ok(resources))
+        return 0;
+    try {
+        Ref<Array<CdsResource>> resourceList = CdsResource::decodeCompact(resources);
+        if (resourceList->size() == 0)
+            return 0;
+        String size = resourceList->get(0)->getAttribute(MetadataHandler::getResAttrName(R_SIZE));
+        if (string_ok(size))
+            return size.toOFF_T();
+    } catch (const Exception& e) {
+        log_debug("could not parse resources: %s\n", e.getMessage().c_str());
+    }
+    return 0;
+}
+
 int SQLStorage::getTotalFiles()
 {
-    flushInsertBuffer();
+    AutoLock lock(statisticsMutex);
+    int total = 0;
+    for (const auto& objectType : objectTypeCounts) {
+        if (IS_CDS_ITEM(objectType.first))
+            total += objectType.second;
+    }
+    return total;
+}
+
+std::map<std::string, int> SQLStorage::getMimeTypeCounts()
+{
+    AutoLock lock(statisticsMutex);
+    return mimeTypeCounts;
+}
+
+std::map<int, int> SQLStorage::getObjectTypeCounts()
+{
+    AutoLock lock(statisticsMutex);
+    return objectTypeCounts;
+}
 
-    std::ostringstream query;
-    query << "SELECT COUNT(*) FROM " << TQ(CDS_OBJECT_TABLE) << " WHERE "
-           << TQ("object_type") << " != " << quote(OBJECT_TYPE_CONTAINER);
-    //<< " AND is_virtual = 0";
-    Ref<SQLResult> res = select(query);
+off_t SQLStorage::getDirectoryBytes(String path)
+{
+    std::string dir = path.c_str();
+    while (dir.length() > 1 && dir[dir.length() - 1] == DIR_SEPARATOR)
+        dir.erase(dir.length() - 1);
+
+    AutoLock lock(statisticsMutex);
+    auto it = directoryBytes.find(dir);
+    if (it == directoryBytes.end())
+        return 0;
+    return it->second;
+}
+
+void SQLStorage::loadStatistics()
+{
+    std::ostringstream qb;
+    qb << "SELECT " << TQ("object_type") << ',' << TQ("mime_type") << ",COUNT(*)"
+       << " FROM " << TQ(CDS_OBJECT_TABLE)
+       << " WHERE " << TQ("id") << "<>" << CDS_ID_BLACKHOLE
+       << " GROUP BY " << TQ("object_type") << ',' << TQ("mime_type");
+    Ref<SQLResult> res = select(qb);
+    if (res == nullptr)
+        throw _Exception(_("could not load object statistics"));
+
+    // files always live in the container of their directory
+    std::ostringstream fb;
+    fb << "SELECT " << TQD('p', "id") << ',' << TQD('p', "location") << ",SUM(" << TQD('f', "file_size") << ')'
+       << " FROM " << TQ(CDS_OBJECT_TABLE) << ' ' << TQ('f')
+       << " JOIN " << TQ(CDS_OBJECT_TABLE) << ' ' << TQ('p')
+       << " ON " << TQD('p', "id") << '=' << TQD('f', "parent_id")
+       << " WHERE " << TQD('f', "file_size") << " IS NOT NULL"
+       << " GROUP BY " << TQD('p', "id") << ',' << TQD('p', "location");
+    Ref<SQLResult> dirs = select(fb);
+    if (dirs == nullptr)
+        throw _Exception(_("could not load file statistics"));
+
+    AutoLock lock(statisticsMutex);
+    mimeTypeCounts.clear();
+    objectTypeCounts.clear();
+    directoryBytes.clear();
     Ref<SQLRow> row;
-    if (res != nullptr && (row = res->nextRow()) != nullptr) {
-        return row->col(0).toInt();
+    while ((row = res->nextRow()) != nullptr)
+        countObjects(row->col(0).toInt(), row->col(1), row->col(2).toInt());
+    while ((row = dirs->nextRow()) != nullptr)
+        countDirectoryBytes(row->col(0).toInt(), row->col(1), row->col(2).toOFF_T());
+    log_debug("loaded statistics for %d mime types and %d directories\n",
+        (int)mimeTypeCounts.size(), (int)directoryBytes.size());
+}
+
+off_t SQLStorage::getCountedFileSize(Ref<CdsObject> obj)
+{
+    if (!IS_CDS_PURE_ITEM(obj->getObjectType()) || obj->isVirtual() || obj->getResourceCount() == 0)
+        return 0;
+    String size = obj->getResource(0)->getAttribute(MetadataHandler::getResAttrName(R_SIZE));
+    return string_ok(size) ? size.toOFF_T() : 0;
+}
+
+void SQLStorage::countObject(Ref<CdsObject> obj, int delta)
+{
+    int objectType = obj->getObjectType();
+    String mimeType;
+    String dbLocation;
+    off_t size = getCountedFileSize(obj);
+    if (IS_CDS_ITEM(objectType))
+        mimeType = RefCast(obj, CdsItem)->getMimeType();
+    if (size > 0)
+        dbLocation = addLocationPrefix(LOC_FILE_PREFIX, obj->getLocation());
+
+    {
+        AutoLock lock(statisticsMutex);
+        countObject(objectType, mimeType, dbLocation, size, delta);
     }
-    return 0;
+    if (delta > 0)
+        obj->setCounted(mimeType, dbLocation, size);
+}
+
+void SQLStorage::loadCounted(Ref<CdsObject> obj)
+{
+    std::ostringstream qb;
+    qb << "SELECT " << TQ("mime_type") << ',' << TQ("location") << ',' << TQ("file_size")
+       << " FROM " << TQ(CDS_OBJECT_TABLE)
+       << " WHERE " << TQ("id") << '=' << quote(obj->getID());
+    Ref<SQLResult> res = select(qb);
+    Ref<SQLRow> row;
+    if (res != nullptr && (row = res->nextRow()) != nullptr)
+        obj->setCounted(row->col(0), row->col(1), row->col(2).toOFF_T());
+}
+
+void SQLStorage::uncountObject(Ref<CdsObject> obj)
+{
+    if (!obj->isCounted())
+        return;
+    AutoLock lock(statisticsMutex);
+    countObject(obj->getObjectType(), obj->getCountedMimeType(), obj->getCountedLocation(), obj->getCountedFileSize(), -1);
+}
+
+void SQLStorage::uncountObjects(const std::string& objectIDs)
+{
+    std::ostringstream qb;
+    qb << "SELECT " << TQ("object_type") << ',' << TQ("mime_type") << ",COUNT(*)"
+       << " FROM " << TQ(CDS_OBJECT_TABLE)
+       << " WHERE " << TQ("id") << " IN (" << objectIDs << ')'
+       << " GROUP BY " << TQ("object_type") << ',' << TQ("mime_type");
+    Ref<SQLResult> res = select(qb);
+    if (res == nullptr)
+        return;
+
+    std::ostringstream fb;
+    fb << "SELECT " << TQD('p', "id") << ',' << TQD('p', "location") << ",SUM(" << TQD('f', "file_size") << ')'
+       << " FROM " << TQ(CDS_OBJECT_TABLE) << ' ' << TQ('f')
+       << " JOIN " << TQ(CDS_OBJECT_TABLE) << ' ' << TQ('p')
+       << " ON " << TQD('p', "id") << '=' << TQD('f', "parent_id")
+       << " WHERE " << TQD('f', "id") << " IN (" << objectIDs << ')'
+       << " AND " << TQD('f', "file_size") << " IS NOT NULL"
+       << " GROUP BY " << TQD('p', "id") << ',' << TQD('p', "location");
+    Ref<SQLResult> dirs = select(fb);
+    if (dirs == nullptr)
+        return;
+
+    AutoLock lock(statisticsMutex);
+    Ref<SQLRow> row;
+    while ((row = res->nextRow()) != nullptr)
+        countObjects(row->col(0).toInt(), row->col(1), -row->col(2).toInt());
+    while ((row = dirs->nextRow()) != nullptr)
+        countDirectoryBytes(row->col(0).toInt(), row->col(1), -row->col(2).toOFF_T());
+}
+
+void SQLStorage::countObject(int objectType, String mimeType, String dbLocation, off_t size, int delta)
+{
+    countObjects(objectType, mimeType, delta);
+
+    char prefix;
+    String location = stripLocationPrefix(&prefix, dbLocation);
+    if (!IS_CDS_PURE_ITEM(objectType) || prefix != LOC_FILE_PREFIX || size <= 0)
+        return;
+    std::string path = location.c_str();
+    size_t pos = path.rfind(DIR_SEPARATOR);
+    if (pos != std::string::npos)
+        addDirectoryBytes((pos == 0) ? std::string(1, DIR_SEPARATOR) : path.substr(0, pos), delta * size);
+}
+
+void SQLStorage::countObjects(int objectType, String mimeType, int delta)
+{
+    auto type = objectTypeCounts.find(objectType);
+    if (type == objectTypeCounts.end())
+        type = objectTypeCounts.emplace(objectType, 0).first;
+    type->second += delta;
+    if (type->second <= 0)
+        objectTypeCounts.erase(type);
+
+    if (string_ok(mimeType)) {
+        auto mime = mimeTypeCounts.find(mimeType.c_str());
+        if (mime == mimeTypeCounts.end())
+            mime = mimeTypeCounts.emplace(mimeType.c_str(), 0).first;
+        mime->second += delta;
+        if (mime->second <= 0)
+            mimeTypeCounts.erase(mime);
+    }
+}
+
+void SQLStorage::countDirectoryBytes(int containerID, String dbLocation, off_t bytes)
+{
+    if (containerID == CDS_ID_FS_ROOT) {
+        addDirectoryBytes(std::string(1, DIR_SEPARATOR), bytes);
+        return;
+    }
+    char prefix;
+    String location = stripLocationPrefix(&prefix, dbLocation);
+    if (prefix == LOC_DIR_PREFIX && string_ok(location))
+        addDirectoryBytes(location.c_str(), bytes);
+}
+
+void SQLStorage::addDirectoryBytes(std::string dir, off_t bytes)
+{
+    // every directory up to the root holds the sum of all files below it
+    while (true) {
+        auto it = directoryBytes.find(dir);
+        if (it == directoryBytes.end())
+            it = directoryBytes.emplace(dir, 0).first;
+        it->second += bytes;
+        if (it->second <= 0)
+            directoryBytes.erase(it);
+
+        size_t pos = dir.rfind(DIR_SEPARATOR);
+        if (pos == std::string::npos || dir.length() == 1)
+            break;
+        dir = (pos == 0) ? std::string(1, DIR_SEPARATOR) : dir.substr(0, pos);
+    }
+}
+
+int SQLStorage::getCurrentUpdateID(int objectID, int storedUpdateID)
+{
+    AutoLock lock(updateIDMutex);
+    auto it = updateIDs.find(objectID);
+    if (it == updateIDs.end())
+        return storedUpdateID;
+    return it->second;
 }
 
 String SQLStorage::incrementUpdateIDs(shared_ptr<unordered_set<int>> ids)
 {
     if (ids->empty())
         return nullptr;
-    std::ostringstream inBuf;
 
-    bool first = true;
+    unique_lock<std::mutex> lock(updateIDMutex);
+
+    // only containers we have never seen need a trip to the database
+    std::vector<int> unknown;
     for (const auto& id : *ids) {
-        if (first) {
-            inBuf << "IN (" << id;
-            first = false;
-        } else {
-            inBuf << ',' << id;
-        }
+        if (updateIDs.find(id) == updateIDs.end())
+            unknown.push_back(id);
     }
-    inBuf << ')';
 
-    std::ostringstream bufUpdate;
-    bufUpdate << "UPDATE " << TQ(CDS_OBJECT_TABLE) << " SET " << TQ("update_id")
-            << '=' << TQ("update_id") << " + 1 WHERE " << TQ("id") << ' ';
-    bufUpdate << inBuf.str();
-    exec(bufUpdate);
+    if (!unknown.empty()) {
+        lock.unlock();
+        std::ostringstream bufSelect;
+        bufSelect << "SELECT " << TQ("id") << ',' << TQ("update_id") << " FROM "
+                << TQ(CDS_OBJECT_TABLE) << " WHERE " << TQ("id")
+                << " IN (" << join(unknown, ',') << ')';
+        Ref<SQLResult> res = select(bufSelect);
+        if (res == nullptr)
+            throw _Exception(_("Error while fetching update ids"));
+        std::vector<std::pair<int, int>> loaded;
+        Ref<SQLRow> row;
+        while ((row = res->nextRow()) != nullptr)
+            loaded.emplace_back(row->col(0).toInt(), row->col(1).toInt());
+        lock.lock();
+        // don't overwrite values which were incremented in the meantime
+        for (const auto& entry : loaded)
+            updateIDs.emplace(entry.first, entry.second);
+    }
 
-    std::ostringstream bufSelect;
-    bufSelect << "SELECT " << TQ("id") << ',' << TQ("update_id") << " FROM "
-            << TQ(CDS_OBJECT_TABLE) << " WHERE " << TQ("id") << ' ';
-    bufSelect << inBuf.str();
-    Ref<SQLResult> res = select(bufSelect);
-    if (res == nullptr)
-        throw _Exception(_("Error while fetching update ids"));
-    Ref<SQLRow> row;
     std::list<std::string> rows;
-    while ((row = res->nextRow()) != nullptr) {
+    for (const auto& id : *ids) {
+        auto it = updateIDs.find(id);
+        if (it == updateIDs.end())
+            continue; // object does not exist (anymore)
+        it->second++;
+        dirtyUpdateIDs.insert(id);
+
         std::ostringstream s;
-        s << row->col(0) << ',' << row->col(1);
+        s << id << ',' << it->second;
         rows.emplace_back(s.str());
     }
+    lock.unlock();
+
+    if (cacheOn() && !rows.empty()) {
+        AutoLock cacheLock(cache->getMutex());
+        for (const auto& id : *ids) {
+            Ref<CacheObject> cObj = cache->getObject(id);
+            if (cObj == nullptr || !cObj->knowsObject())
+                continue;
+            Ref<CdsObject> obj = cObj->getObject();
+            if (IS_CDS_CONTAINER(obj->getObjectType()))
+                RefCast(obj, CdsContainer)->setUpdateID(getCurrentUpdateID(id, 0));
+        }
+    }
+
     if (rows.empty())
         return nullptr;
     return join(rows, ",");
 }
 
+void SQLStorage::flushUpdateIDs()
+{
+    std::unordered_set<int> flushing;
+    std::vector<std::pair<int, int>> dirty;
+    {
+        AutoLock lock(updateIDMutex);
+        if (dirtyUpdateIDs.empty())
+            return;
+        flushing.swap(dirtyUpdateIDs);
+        dirty.reserve(flushing.size());
+        for (const auto& id : flushing) {
+            auto it = updateIDs.find(id);
+            if (it != updateIDs.end())
+                dirty.emplace_back(id, it->second);
+        }
+    }
+
+    log_debug("persisting %d update ids\n", (int)dirty.size());
+
+    // one statement per batch instead of one per container
+    for (size_t start = 0; start < dirty.size(); start += UPDATE_ID_FLUSH_BATCH) {
+        size_t end = std::min(dirty.size(), start + UPDATE_ID_FLUSH_BATCH);
+        std::ostringstream bufCase;
+        std::ostringstream bufIn;
+        for (size_t i = start; i < end; i++) {
+            bufCase << " WHEN " << dirty[i].first << " THEN " << dirty[i].second;
+            if (i > start)
+                bufIn << ',';
+            bufIn << dirty[i].first;
+        }
+
+        std::ostringstream bufUpdate;
+        bufUpdate << "UPDATE " << TQ(CDS_OBJECT_TABLE) << " SET " << TQ("update_id")
+                << " = CASE " << TQ("id") << bufCase.str() << " END WHERE "
+                << TQ("id") << " IN (" << bufIn.str() << ')';
+        try {
+            exec(bufUpdate);
+        } catch (const Exception& e) {
+            // the ids of this and the following batches are written by the
+            // next flush, unless their objects were removed in the meantime
+            AutoLock lock(updateIDMutex);
+            for (size_t i = start; i < dirty.size(); i++) {
+                if (updateIDs.find(dirty[i].first) != updateIDs.end())
+                    dirtyUpdateIDs.insert(dirty[i].first);
+            }
+            throw;
+        }
+    }
+}
+
 // id is the parent_id for cover media to find, and if set, trackArtBase is the case-folded
 // name of the track to try as artwork; we rely on LIKE being case-insensitive
 
@@ -1503,6 +1930,155 @@ shared_ptr<unordered_set<int>> SQLStorage::getObjects(int parentID, bool without
     return ret;
 }
 
+bool SQLStorage::loadDirectoryFingerprint(int objectID, DirectoryFingerprint& fingerprint)
+{
+    std::ostringstream q;
+    q << "SELECT " << TQ("mtime") << ',' << TQ("ctime") << ','
+      << TQ("inode") << ',' << TQ("child_count")
+      << " FROM " << TQ(DIR_FINGERPRINT_TABLE)
+      << " WHERE " << TQ("id") << '=' << quote(objectID);
+    Ref<SQLResult> res = select(q);
+    if (res == nullptr)
+        return false;
+    Ref<SQLRow> row = res->nextRow();
+    if (row == nullptr)
+        return false;
+
+    fingerprint.mtime = strtoll(row->col_c_str(0), nullptr, 10);
+    fingerprint.ctime = strtoll(row->col_c_str(1), nullptr, 10);
+    fingerprint.inode = (ino_t)strtoull(row->col_c_str(2), nullptr, 10);
+    fingerprint.childCount = row->col(3).toInt();
+    return true;
+}
+
+void SQLStorage::storeDirectoryFingerprint(int objectID, const DirectoryFingerprint& fingerprint)
+{
+    // the adds of the scan drop the fingerprint of their directory
+    flushInsertBuffer();
+
+    std::ostringstream q;
+    q << "REPLACE INTO " << TQ(DIR_FINGERPRINT_TABLE)
+      << " (" << TQ("id") << ',' << TQ("mtime") << ',' << TQ("ctime") << ','
+      << TQ("inode") << ',' << TQ("child_count") << ") VALUES ("
+      << objectID << ',' << fingerprint.mtime << ','
+      << fingerprint.ctime << ','
+      << (unsigned long long)fingerprint.inode << ','
+      << fingerprint.childCount << ')';
+    exec(q);
+}
+
+void SQLStorage::storePlayStatus(const std::vector<PlayStatus>& changes)
+{
+    for (size_t start = 0; start < changes.size(); start += PLAY_STATUS_FLUSH_BATCH) {
+        size_t end = std::min(changes.size(), start + PLAY_STATUS_FLUSH_BATCH);
+
+        // the counts are added up here, the statements are plain SQL that
+        // both sqlite and mysql understand
+        std::ostringstream bufIn;
+        for (size_t i = start; i < end; i++) {
+            if (i > start)
+                bufIn << ',';
+            bufIn << changes[i].itemID;
+        }
+        std::map<std::pair<int, std::string>, std::pair<int, long long>> stored;
+        std::ostringstream q;
+        q << "SELECT " << TQ("item_id") << ',' << TQ("client") << ','
+          << TQ("play_count") << ',' << TQ("last_position")
+          << " FROM " << TQ(PLAY_STATUS_TABLE)
+          << " WHERE " << TQ("item_id") << " IN (" << bufIn.str() << ')';
+        Ref<SQLResult> res = select(q);
+        Ref<SQLRow> row;
+        while (res != nullptr && (row = res->nextRow()) != nullptr) {
+            stored[std::make_pair(row->col(0).toInt(), std::string(row->col_c_str(1)))]
+                = std::make_pair(row->col(2).toInt(), strtoll(row->col_c_str(3), nullptr, 10));
+        }
+
+        std::ostringstream bufReplace;
+        bufReplace << "REPLACE INTO " << TQ(PLAY_STATUS_TABLE)
+                   << " (" << TQ("item_id") << ',' << TQ("client") << ','
+                   << TQ("play_count") << ',' << TQ("last_played") << ','
+                   << TQ("last_position") << ") VALUES ";
+        for (size_t i = start; i < end; i++) {
+            const PlayStatus& change = changes[i];
+            int playCount = change.playCount;
+            long long position = change.position;
+            auto it = stored.find(std::make_pair(change.itemID, change.client));
+            if (it != stored.end()) {
+                playCount += it->second.first;
+                if (position < 0)
+                    position = it->second.second;
+            }
+            if (position < 0)
+                position = 0;
+
+            if (i > start)
+                bufReplace << ',';
+            bufReplace << '(' << change.itemID << ',' << quote(String(change.client.c_str())) << ','
+                       << playCount << ',' << (long long)change.lastPlayed << ',' << position << ')';
+        }
+        exec(bufReplace);
+    }
+}
+
+std::unordered_map<int, PlayStatus> SQLStorage::loadPlayStatus(const std::vector<int>& itemIDs, const std::string& client)
+{
+    std::unordered_map<int, PlayStatus> status;
+    if (itemIDs.empty())
+        return status;
+
+    std::ostringstream q;
+    q << "SELECT " << TQ("item_id") << ',' << TQ("play_count") << ','
+      << TQ("last_played") << ',' << TQ("last_position")
+      << " FROM " << TQ(PLAY_STATUS_TABLE)
+      << " WHERE " << TQ("client") << '=' << quote(String(client.c_str()))
+      << " AND " << TQ("item_id") << " IN (" << join(itemIDs, ',') << ')';
+    Ref<SQLResult> res = select(q);
+    if (res == nullptr)
+        return status;
+
+    Ref<SQLRow> row;
+    while ((row = res->nextRow()) != nullptr) {
+        PlayStatus entry;
+        entry.itemID = row->col(0).toInt();
+        entry.client = client;
+        entry.playCount = row->col(1).toInt();
+        entry.lastPlayed = (time_t)strtoll(row->col_c_str(2), nullptr, 10);
+        entry.position = (off_t)strtoll(row->col_c_str(3), nullptr, 10);
+        status[entry.itemID] = entry;
+    }
+    return status;
+}
+
+std::vector<int> SQLStorage::getPlayStatusObjectIDs(const std::vector<int>& itemIDs)
+{
+    std::vector<int> objectIDs;
+    if (itemIDs.empty())
+        return objectIDs;
+
+    flushInsertBuffer();
+
+    std::string in = join(itemIDs, ',');
+    std::ostringstream q;
+    q << "SELECT " << TQ("id") << ',' << TQ("parent_id")
+      << " FROM " << TQ(CDS_OBJECT_TABLE)
+      << " WHERE " << TQ("id") << " IN (" << in << ')'
+      << " OR " << TQ("ref_id") << " IN (" << in << ')';
+    Ref<SQLResult> res = select(q);
+    if (res == nullptr)
+        return objectIDs;
+
+    std::unordered_set<int> found;
+    Ref<SQLRow> row;
+    while ((row = res->nextRow()) != nullptr) {
+        for (int col = 0; col < 2; col++) {
+            int objectID = row->col(col).toInt();
+            if (found.insert(objectID).second)
+                objectIDs.push_back(objectID);
+        }
+    }
+    return objectIDs;
+}
+
 Ref<Storage::ChangedContainers> SQLStorage::removeObjects(shared_ptr<unordered_set<int>> list, bool all)
 {
     flushInsertBuffer();
@@ -1585,17 +2161,52 @@ void SQLStorage::_removeObjects(const std::vector<int32_t> &objectIDs) {
         }
     }
 
+    uncountObjects(objectIdsStr);
+
     std::ostringstream qActiveItem;
     qActiveItem << "DELETE FROM " << TQ(CDS_ACTIVE_ITEM_TABLE)
                 << " WHERE " << TQ("id")
                 << " IN (" << objectIdsStr << ')';
     exec(qActiveItem);
 
+    // the directories lose an entry, their next scan has to reconcile them
+    std::ostringstream qFingerprint;
+    qFingerprint << "DELETE FROM " << TQ(DIR_FINGERPRINT_TABLE)
+                 << " WHERE " << TQ("id")
+                 << " IN (" << objectIdsStr << ')'
+                 << " OR " << TQ("id") << " IN (SELECT " << TQ("parent_id")
+                 << " FROM " << TQ(CDS_OBJECT_TABLE)
+                 << " WHERE " << TQ("id") << " IN (" << objectIdsStr << "))";
+    exec(qFingerprint);
+
+    std::ostringstream qPlayStatus;
+    qPlayStatus << "DELETE FROM " << TQ(PLAY_STATUS_TABLE)
+                << " WHERE " << TQ("item_id")
+                << " IN (" << objectIdsStr << ')';
+    exec(qPlayStatus);
+
     std::ostringstream qObject;
     qObject << "DELETE FROM " << TQ(CDS_OBJECT_TABLE)
             << " WHERE " << TQ("id")
             << " IN (" << objectIdsStr << ')';
     exec(qObject);
+
+    {
+        AutoLock lock(updateIDMutex);
+        for (const auto& id : objectIDs) {
+            updateIDs.erase(id);
+            dirtyUpdateIDs.erase(id);
+        }
+    }
+
+    AutoLock lock(virtualPathMutex);
+    for (const auto& id : objectIDs) {
+        auto it = virtualPathIDs.find(id);
+        if (it == virtualPathIDs.end())
+            continue;
+        virtualPaths.erase(it->second);
+        virtualPathIDs.erase(it);
+    }
 }
 
 Ref<Storage::ChangedContainers> SQLStorage::removeObject(int objectID, bool all)
@@ -2441,11 +3052,13 @@ void SQLStorage::addObjectToCache(Ref<CdsObject> object, bool dontLock)
     }
 }
 
-void SQLStorage::addToInsertBuffer(const std::string &query)
+void SQLStorage::addToInsertBuffer(const std::string &query, bool dontLock)
 {
     assert(doInsertBuffering());
 
-    AutoLock lock(mutex);
+    unique_lock<decltype(mutex)> lock(mutex, std::defer_lock);
+    if (!dontLock)
+        lock.lock();
     _addToInsertBuffer(query);
 
     insertBufferEmpty = false;
@@ -2668,6 +3281,101 @@ void SQLStorage::doMetadataMigration()
     log_info("Migrated metadata - object count: %d\n", objectsUpdated);
 }
 
+void SQLStorage::migrateResourceEncoding()
+{
+    if (getInternalSetting(_(RESOURCE_ENCODING_SETTING)) == COMPACT_ENCODING_PREFIX)
+        return;
+
+    std::ostringstream qb;
+    qb << "SELECT " << TQ("id") << ',' << TQ("resources") << ',' << TQ("auxdata")
+       << " FROM " << TQ(CDS_OBJECT_TABLE)
+       << " WHERE (" << TQ("resources") << " IS NOT NULL AND " << TQ("resources") << " NOT LIKE '!%')"
+       << " OR (" << TQ("auxdata") << " IS NOT NULL AND " << TQ("auxdata") << " NOT LIKE '!%')";
+    Ref<SQLResult> res = select(qb);
+    if (res == nullptr)
+        throw _Exception(_("could not load resources to convert"));
+
+    log_info("Converting resources and auxdata to the compact encoding...\n");
+    int converted = 0;
+    Ref<SQLRow> row;
+    while ((row = res->nextRow()) != nullptr) {
+        String resources = row->col(1);
+        String auxdata = row->col(2);
+        try {
+            if (string_ok(resources)) {
+                Ref<Array<CdsResource>> resourceList = CdsResource::decodeCompact(resources);
+                resources = (resourceList->size() > 0) ? quote(CdsResource::encodeCompact(resourceList)) : _(SQL_NULL);
+            } else
+                resources = _(SQL_NULL);
+
+            Ref<Dictionary> aux(new Dictionary());
+            aux->decodeCompact(auxdata);
+            auxdata = (aux->size() > 0) ? quote(aux->encodeCompact()) : _(SQL_NULL);
+        } catch (const Exception& e) {
+            // such an object could not be loaded before either
+            log_warning("Could not convert resources of object %s: %s\n", row->col(0).c_str(), e.getMessage().c_str());
+            continue;
+        }
+
+        std::ostringstream ub;
+        ub << "UPDATE " << TQ(CDS_OBJECT_TABLE)
+           << " SET " << TQ("resources") << '=' << resources
+           << ',' << TQ("auxdata") << '=' << auxdata
+           << " WHERE " << TQ("id") << '=' << row->col(0).toInt();
+        // runs from init(), the singleton mutex is already held
+        if (!doInsertBuffering())
+            exec(ub);
+        else
+            addToInsertBuffer(ub.str(), true);
+        converted++;
+    }
+    flushInsertBuffer(true);
+
+    storeInternalSetting(_(RESOURCE_ENCODING_SETTING), _(COMPACT_ENCODING_PREFIX));
+    log_info("Converted resources and auxdata of %d objects\n", converted);
+}
+
+void SQLStorage::migrateFileSizes()
+{
+    if (getInternalSetting(_(FILE_SIZE_SETTING)) == "1")
+        return;
+
+    std::ostringstream qb;
+    qb << "SELECT " << TQ("id") << ',' << TQ("resources")
+       << " FROM " << TQ(CDS_OBJECT_TABLE)
+       << " WHERE " << TQ("object_type") << '=' << quote(OBJECT_TYPE_ITEM)
+       << " AND " << TQ("ref_id") << " IS NULL"
+       << " AND " << TQ("resources") << " IS NOT NULL"
+       << " AND " << TQ("file_size") << " IS NULL";
+    Ref<SQLResult> res = select(qb);
+    if (res == nullptr)
+        throw _Exception(_("could not load resources to read the file sizes"));
+
+    log_info("Storing the file sizes for the statistics...\n");
+    int stored = 0;
+    Ref<SQLRow> row;
+    while ((row = res->nextRow()) != nullptr) {
+        off_t size = getResourceSize(row->col(1));
+        if (size <= 0)
+            continue;
+
+        std::ostringstream ub;
+        ub << "UPDATE " << TQ(CDS_OBJECT_TABLE)
+           << " SET " << TQ("file_size") << '=' << quote((long long)size)
+           << " WHERE " << TQ("id") << '=' << row->col(0).toInt();
+        // runs from init(), the singleton mutex is already held
+        if (!doInsertBuffering())
+            exec(ub);
+        else
+            addToInsertBuffer(ub.str(), true);
+        stored++;
+    }
+    flushInsertBuffer(true);
+
+    storeInternalSetting(_(FILE_SIZE_SETTING), _("1"));
+    log_info("Stored the file sizes of %d objects\n", stored);
+}
+
 void SQLStorage::migrateMetadata(Ref<CdsObject> object)
 {
     if (object == nullptr)
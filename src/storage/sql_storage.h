@@ -38,6 +38,10 @@
 #include "storage.h"
 #include "storage_cache.h"
 
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <unordered_map>
 #include <unordered_set>
 #include <mutex>
 #include <sstream>
@@ -50,6 +54,14 @@
 #define INTERNAL_SETTINGS_TABLE     "mt_internal_setting"
 #define AUTOSCAN_TABLE              "mt_autoscan"
 #define METADATA_TABLE              "mt_metadata"
+#define DIR_FINGERPRINT_TABLE       "mt_dir_fingerprint"
+#define PLAY_STATUS_TABLE           "mt_play_status"
+
+// containers per UPDATE statement when persisting update ids
+#define UPDATE_ID_FLUSH_BATCH       100
+#define PLAY_STATUS_FLUSH_BATCH     100
+// object ids per SELECT when loading the metadata of a result page
+#define METADATA_LOAD_BATCH         1000
 
 class SQLResult;
 class SQLEmitter;
@@ -74,6 +86,48 @@ public:
     virtual unsigned long long getNumRows() = 0;
 };
 
+/// \brief Hands out a single String per distinct value.
+///
+/// Used while building a result page: the objects of a page mostly have the
+/// same class, mime type and metadata keys, with the pool they share one
+/// String instead of each holding its own copy.
+class SQLStringPool
+{
+public:
+    zmm::String get(const char *str)
+    {
+        if (str == nullptr)
+            return nullptr;
+        auto found = strings.find(str);
+        if (found != strings.end())
+            return found->second;
+        zmm::String pooled(str);
+        strings.emplace(pooled.c_str(), pooled);
+        return pooled;
+    }
+
+    size_t size() { return strings.size(); }
+
+protected:
+    struct Hash
+    {
+        size_t operator()(const char *str) const
+        {
+            size_t hash = 5381;
+            while (*str)
+                hash = hash * 33 + (unsigned char)*str++;
+            return hash;
+        }
+    };
+    struct Equal
+    {
+        bool operator()(const char *a, const char *b) const { return strcmp(a, b) == 0; }
+    };
+
+    /// \brief the keys point into the pooled Strings
+    std::unordered_map<const char *, zmm::String, Hash, Equal> strings;
+};
+
 class SQLStorage : protected Storage
 {
 public:
@@ -112,6 +166,11 @@ public:
     //virtual zmm::Ref<zmm::Array<CdsObject> > selectObjects(zmm::Ref<SelectParam> param);
     
     virtual std::shared_ptr<std::unordered_set<int> > getObjects(int parentID, bool withoutContainer) override;
+    virtual bool loadDirectoryFingerprint(int objectID, DirectoryFingerprint &fingerprint) override;
+    virtual void storeDirectoryFingerprint(int objectID, const DirectoryFingerprint &fingerprint) override;
+    virtual void storePlayStatus(const std::vector<PlayStatus> &changes) override;
+    virtual std::unordered_map<int, PlayStatus> loadPlayStatus(const std::vector<int> &itemIDs, const std::string &client) override;
+    virtual std::vector<int> getPlayStatusObjectIDs(const std::vector<int> &itemIDs) override;
     
     virtual zmm::Ref<ChangedContainers> removeObject(int objectID, bool all) override;
     virtual zmm::Ref<ChangedContainers> removeObjects(std::shared_ptr<std::unordered_set<int> > list, bool all = false) override;
@@ -123,6 +182,11 @@ public:
     
     /* accounting methods */
     virtual int getTotalFiles() override;
+
+    /* statistics methods */
+    virtual std::map<std::string, int> getMimeTypeCounts() override;
+    virtual std::map<int, int> getObjectTypeCounts() override;
+    virtual off_t getDirectoryBytes(zmm::String path) override;
     
     virtual zmm::Ref<zmm::Array<CdsObject> > browse(zmm::Ref<BrowseParam> param) override;
     // virtual _and_ override for consistency!
@@ -134,6 +198,9 @@ public:
     virtual zmm::Ref<CdsObject> findObjectByPath(zmm::String fullpath) override;
     virtual int findObjectIDByPath(zmm::String fullpath) override;
     virtual zmm::String incrementUpdateIDs(std::shared_ptr<std::unordered_set<int> > ids) override;
+    virtual void flushUpdateIDs() override;
+    virtual void flushInserts() override { flushInsertBuffer(); }
+    virtual unsigned long getQueryCount() override { return queryCount; }
 
     virtual zmm::String buildContainerPath(int parentID, zmm::String title) override;
     virtual void addContainerChain(zmm::String path, zmm::String lastClass, int lastRefID, int *containerID, int *updateID, zmm::Ref<Dictionary> lastMetadata) override;
@@ -171,9 +238,20 @@ protected:
 
     void doMetadataMigration() override;
     void migrateMetadata(zmm::Ref<CdsObject> object);
+
+    /// \brief Rewrites resources and auxdata stored in the old url based
+    /// encoding in the compact encoding, once per database.
+    void migrateResourceEncoding();
+
+    /// \brief Fills the file_size column from the resources, once per
+    /// database.
+    void migrateFileSizes();
     
     char table_quote_begin;
     char table_quote_end;
+
+    /// \brief to be incremented by the drivers in select() and exec()
+    std::atomic<unsigned long> queryCount;
     
 private:
     zmm::String sql_query;
@@ -181,14 +259,36 @@ private:
     /* helper for createObjectFromRow() */
     zmm::String getRealLocation(int parentID, zmm::String location);
     
+    /// \brief objects of a result set whose metadata is loaded at once
+    /// after all rows were read
+    struct ResultPage
+    {
+        struct Entry
+        {
+            zmm::Ref<CdsObject> object;
+            /// \brief metadata column of mt_cds_object, used if the
+            /// metadata table has nothing for the object
+            zmm::String rowMetadata;
+            /// \brief fall back to the metadata of the referenced object
+            bool useReference;
+        };
+        std::vector<Entry> entries;
+        SQLStringPool strings;
+    };
+
     zmm::Ref<CdsObject> createObjectFromRow(zmm::Ref<SQLRow> row);
-    zmm::Ref<CdsObject> createObjectFromSearchRow(zmm::Ref<SQLRow> row);
+    zmm::Ref<CdsObject> createObjectFromRow(zmm::Ref<SQLRow> row, ResultPage &page);
+    zmm::Ref<CdsObject> createObjectFromSearchRow(zmm::Ref<SQLRow> row, ResultPage &page);
+    void loadMetadata(ResultPage &page);
     zmm::Ref<Dictionary> retrieveMetadataForObject(int objectId);
     
     /* helper for findObjectByPath and findObjectIDByPath */ 
     zmm::Ref<CdsObject> _findObjectByPath(zmm::String fullpath);
     
     int _ensurePathExistence(zmm::String path, int *changedContainer);
+
+    std::mutex containerChainMutex;
+    void _addContainerChain(zmm::String path, zmm::String lastClass, int lastRefID, int *containerID, int *updateID, zmm::Ref<Dictionary> lastMetadata);
     
     /* helper class and helper function for addObject and updateObject */
     class AddUpdateTable : public Object
@@ -262,13 +362,54 @@ private:
     std::shared_ptr<SQLEmitter> sqlEmitter;
 
     std::mutex nextIDMutex;
+
+    /// \brief update ids of all containers which were changed since startup,
+    /// these are ahead of the database until flushUpdateIDs() is called
+    std::unordered_map<int, int> updateIDs;
+    std::unordered_set<int> dirtyUpdateIDs;
+    std::mutex updateIDMutex;
+    int getCurrentUpdateID(int objectID, int storedUpdateID);
+
+    /// \brief ids of all virtual containers by path, loaded in dbReady()
+    /// and kept up to date by createContainer(), updateObject() and
+    /// _removeObjects(), so addContainerChain() needs no lookups
+    std::unordered_map<std::string, int> virtualPaths;
+    std::unordered_map<int, std::string> virtualPathIDs;
+    std::mutex virtualPathMutex;
+    void loadVirtualPaths();
+    int findVirtualContainer(const std::string &path);
+    void rememberVirtualContainer(int objectID, const std::string &path);
+
+    /// \brief object counts by mime type and by object type and the size
+    /// of the files below each directory, loaded in dbReady() and kept up to
+    /// date by every add, update and remove, so that getMimeTypes() and
+    /// getTotalFiles() need no queries
+    std::map<std::string, int> mimeTypeCounts;
+    std::map<int, int> objectTypeCounts;
+    std::unordered_map<std::string, off_t> directoryBytes;
+    std::mutex statisticsMutex;
+    void loadStatistics();
+    /// \brief size of the file counted below its directory, stored in the
+    /// file_size column so the statistics can be summed up in SQL
+    off_t getCountedFileSize(zmm::Ref<CdsObject> obj);
+    void countObject(zmm::Ref<CdsObject> obj, int delta);
+    /// \brief reads what an object that was not loaded from the database was counted with
+    void loadCounted(zmm::Ref<CdsObject> obj);
+    /// \brief takes out what the object was counted with when it was loaded
+    void uncountObject(zmm::Ref<CdsObject> obj);
+    void uncountObjects(const std::string &objectIDs);
+    /// \brief caller has to hold statisticsMutex
+    void countObject(int objectType, zmm::String mimeType, zmm::String dbLocation, off_t size, int delta);
+    void countObjects(int objectType, zmm::String mimeType, int delta);
+    void countDirectoryBytes(int containerID, zmm::String dbLocation, off_t bytes);
+    void addDirectoryBytes(std::string dir, off_t bytes);
     
     zmm::Ref<StorageCache> cache;
     inline bool cacheOn() { return cache != nullptr; }
     void addObjectToCache(zmm::Ref<CdsObject> object, bool dontLock = false);
     
     inline bool doInsertBuffering() { return insertBufferOn; }
-    void addToInsertBuffer(const std::string &query);
+    void addToInsertBuffer(const std::string &query, bool dontLock = false);
     void flushInsertBuffer(bool dontLock = false);
     
     /* insert buffer functions to be overridden by implementing classes */
@@ -64,6 +64,33 @@
   ON DELETE CASCADE ON UPDATE CASCADE )"
 #define SQLITE3_UPDATE_3_4_2 "CREATE INDEX mt_metadata_item_id ON mt_metadata(item_id)"
 #define SQLITE3_UPDATE_3_4_3 "UPDATE \"mt_internal_setting\" SET \"value\"='4' WHERE \"key\"='db_version' AND \"value\"='3'"
+
+// updates 4->5
+#define SQLITE3_UPDATE_4_5_1 "CREATE TABLE \"mt_dir_fingerprint\" ( \
+  \"id\" integer primary key, \
+  \"mtime\" integer NOT NULL, \
+  \"ctime\" integer NOT NULL, \
+  \"inode\" integer NOT NULL, \
+  \"child_count\" integer NOT NULL, \
+  CONSTRAINT \"mt_dir_fingerprint_idfk1\" FOREIGN KEY (\"id\") REFERENCES \"mt_cds_object\" (\"id\") \
+  ON DELETE CASCADE ON UPDATE CASCADE )"
+#define SQLITE3_UPDATE_4_5_2 "UPDATE \"mt_internal_setting\" SET \"value\"='5' WHERE \"key\"='db_version' AND \"value\"='4'"
+
+// updates 5->6
+#define SQLITE3_UPDATE_5_6_1 "CREATE TABLE \"mt_play_status\" ( \
+  \"item_id\" integer NOT NULL, \
+  \"client\" varchar(255) NOT NULL, \
+  \"play_count\" integer NOT NULL default '0', \
+  \"last_played\" integer NOT NULL, \
+  \"last_position\" integer NOT NULL default '0', \
+  PRIMARY KEY (\"item_id\", \"client\"), \
+  CONSTRAINT \"mt_play_status_idfk1\" FOREIGN KEY (\"item_id\") REFERENCES \"mt_cds_object\" (\"id\") \
+  ON DELETE CASCADE ON UPDATE CASCADE )"
+#define SQLITE3_UPDATE_5_6_2 "UPDATE \"mt_internal_setting\" SET \"value\"='6' WHERE \"key\"='db_version' AND \"value\"='5'"
+
+// updates 6->7
+#define SQLITE3_UPDATE_6_7_1 "ALTER TABLE \"mt_cds_object\" ADD \"file_size\" bigint default NULL"
+#define SQLITE3_UPDATE_6_7_2 "UPDATE \"mt_internal_setting\" SET \"value\"='7' WHERE \"key\"='db_version' AND \"value\"='6'"
   
 #define SL3_INITITAL_QUEUE_SIZE 20
 
@@ -204,9 +231,33 @@ void Sqlite3Storage::init()
         dbVersion = _("4");
     }
 
+    if (dbVersion == "4") {
+        log_info("Doing an automatic database upgrade from database version 4 to version 5...\n");
+        _exec(SQLITE3_UPDATE_4_5_1);
+        _exec(SQLITE3_UPDATE_4_5_2);
+        log_info("database upgrade successful.\n");
+        dbVersion = _("5");
+    }
+
+    if (dbVersion == "5") {
+        log_info("Doing an automatic database upgrade from database version 5 to version 6...\n");
+        _exec(SQLITE3_UPDATE_5_6_1);
+        _exec(SQLITE3_UPDATE_5_6_2);
+        log_info("database upgrade successful.\n");
+        dbVersion = _("6");
+    }
+
+    if (dbVersion == "6") {
+        log_info("Doing an automatic database upgrade from database version 6 to version 7...\n");
+        _exec(SQLITE3_UPDATE_6_7_1);
+        _exec(SQLITE3_UPDATE_6_7_2);
+        log_info("database upgrade successful.\n");
+        dbVersion = _("7");
+    }
+
     /* --- --- ---*/
 
-    if (!string_ok(dbVersion) || dbVersion != "4")
+    if (!string_ok(dbVersion) || dbVersion != "7")
         throw _Exception(_("The database seems to be from a newer version!"));
 
     // add timer for backups
@@ -247,6 +298,7 @@ Ref<SQLResult> Sqlite3Storage::select(const char* query, int length)
 {
     //fprintf(stdout, "%s\n",query);
     //fflush(stdout);
+    queryCount++;
     Ref<SLSelectTask> ptask(new SLSelectTask(query));
     addTask(RefCast(ptask, SLTask));
     ptask->waitForTask();
@@ -257,6 +309,7 @@ int Sqlite3Storage::exec(const char* query, int length, bool getLastInsertId)
 {
     //fprintf(stdout, "%s\n",query);
     //fflush(stdout);
+    queryCount++;
     Ref<SLExecTask> ptask(new SLExecTask(query, getLastInsertId));
     addTask(RefCast(ptask, SLTask));
     ptask->waitForTask();
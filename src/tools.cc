@@ -1213,6 +1213,25 @@ String ipToInterface(String ip) {
     return nullptr;
 }
 
+std::string sockAddrToIP(const struct sockaddr_storage *address)
+{
+    if (address == nullptr)
+        return "";
+
+    char host[NI_MAXHOST];
+    int family = address->ss_family;
+    if (family != AF_INET && family != AF_INET6)
+        return "";
+    int s = getnameinfo((const struct sockaddr *)address,
+            (family == AF_INET) ? sizeof(struct sockaddr_in) : sizeof(struct sockaddr_in6),
+            host, NI_MAXHOST, NULL, 0, NI_NUMERICHOST);
+    if (s != 0) {
+        log_debug("getnameinfo() failed: %s\n", gai_strerror(s));
+        return "";
+    }
+    return host;
+}
+
 bool validateYesNo(String value)
 {
     if ((value != "yes") && (value != "no"))
@@ -1330,52 +1349,6 @@ String tempName(String leadPath, char *tmpl)
     return nullptr;
 }
 
-bool isTheora(String ogg_filename)
-{
-    FILE *f;
-    char buffer[7];
-    f = fopen(ogg_filename.c_str(), "rb");
-
-    if (!f)
-    {
-        throw _Exception(_("Error opening ") + ogg_filename + _(" : ") + 
-                    mt_strerror(errno));
-    }
-    
-    if (fread(buffer, 1, 4, f) != 4)
-    {
-        fclose(f);
-        throw _Exception(_("Error reading ") + ogg_filename);
-    }
-
-    if (memcmp(buffer, "OggS", 4) != 0)
-    {
-        fclose(f);
-        return false;
-    }
-
-    if (fseek(f, 28, SEEK_SET) != 0)
-    {
-        fclose(f);
-        throw _Exception(_("Incomplete file ") + ogg_filename);
-    }
-
-    if (fread(buffer, 1, 7, f) != 7)
-    {
-        fclose(f);
-        throw _Exception(_("Error reading ") + ogg_filename);
-    }
-
-    if (memcmp(buffer, "\x80theora", 7) != 0)
-    {
-        fclose(f);
-        return false;
-    }
-
-    fclose(f);
-    return true;
-}
-
 String get_last_path(String location)
 {
     String path;
@@ -1498,57 +1471,6 @@ String getDLNAtransferHeader(String mimeType, String header)
 }
 #endif
 
-#ifndef HAVE_FFMPEG
-String getAVIFourCC(zmm::String avi_filename)
-{
-#define FCC_OFFSET  0xbc
-    char *buffer;
-    FILE *f = fopen(avi_filename.c_str(), "rb");
-    if (!f)
-        throw _Exception(_("could not open file ") + avi_filename + " : " +
-                          mt_strerror(errno));
-
-    buffer = (char *)MALLOC(FCC_OFFSET+6);
-    if (buffer == nullptr)
-    {
-        fclose(f);
-        throw _Exception(_("Out of memory when allocating buffer for file ") +
-                          avi_filename);
-    }
-
-    size_t rb = fread(buffer, 1, FCC_OFFSET+4, f);
-    fclose(f);
-    if (rb != FCC_OFFSET+4)
-    {
-        free(buffer);
-        throw _Exception(_("could not read header of ") + avi_filename +  
-                          " : " + mt_strerror(errno));
-    }
-
-    buffer[FCC_OFFSET+5] = '\0';
-
-    if (strncmp(buffer, "RIFF", 4) != 0)
-    {
-        free(buffer);
-        return nullptr;
-    }
-
-    if (strncmp(buffer+8, "AVI ", 4) != 0)
-    {
-        free(buffer);
-        return nullptr;
-    }
-
-    String fourcc = String(buffer+FCC_OFFSET, 4);
-    free(buffer);
-
-    if (string_ok(fourcc))
-        return fourcc;
-    else
-        return nullptr;
-}
-#endif
-
 #ifdef TOMBDEBUG
 
 void profiling_thread_check(struct profiling_t *data)
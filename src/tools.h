@@ -35,6 +35,7 @@
 #include <unordered_set>
 #include <sstream>
 
+#include <sys/socket.h>
 #include <sys/time.h>
 
 #include "common.h"
@@ -300,6 +301,10 @@ zmm::String interfaceToIP(zmm::String interface);
 /// \return Interface name or nullptr if IP was not found.
 zmm::String ipToInterface(zmm::String interface);
 
+/// \brief Renders the address of a client as numeric IP address.
+/// \return IP address or an empty string if the address is not an IP one.
+std::string sockAddrToIP(const struct sockaddr_storage *address);
+
 
 /// \brief Returns true if the given string is eitehr "yes" or "no", otherwise
 /// returns false.
@@ -325,9 +330,6 @@ zmm::Ref<zmm::Array<zmm::StringBase> > parseCommandLine(zmm::String line,
 /// open a regular file.
 zmm::String tempName(zmm::String leadPath, char *tmpl);
 
-/// \brief Determines if the particular ogg file contains a video (theora)
-bool isTheora(zmm::String ogg_filename);
-
 /// \brief Gets an absolute filename as a parameter and returns the last parent
 ///
 /// "/some/path/to/file.txt" -> "to"
@@ -343,14 +345,6 @@ zmm::String getDLNAprofileString(zmm::String contentType);
 zmm::String getDLNAcontentHeader(zmm::String contentType, zmm::String header);
 #endif
 
-#ifndef HAVE_FFMPEG
-/// \brief Fallback code to retrieve the used fourcc from an AVI file.
-///
-/// This code is based on offsets, so we will use it only if ffmpeg is not
-/// available.
-zmm::String getAVIFourCC(zmm::String avi_filename);
-#endif
-
 #ifdef TOMBDEBUG
 
 struct profiling_t
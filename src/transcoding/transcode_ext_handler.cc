@@ -60,6 +60,12 @@
     #include "curl_io_handler.h"
 #endif
 
+/// \brief substituted for %in if we proxy online content to the transcoder
+#define TRANSCODE_PIPE_STDIN    "/dev/stdin"
+/// \brief substituted for %out, the standard output of the transcoder is
+/// connected to the pipe we are reading from
+#define TRANSCODE_PIPE_STDOUT   "/dev/stdout"
+
 using namespace zmm;
 
 TranscodeExternalHandler::TranscodeExternalHandler() : TranscodeHandler()
@@ -75,7 +81,6 @@ Ref<IOHandler> TranscodeExternalHandler::open(Ref<TranscodingProfile> profile,
 //    bool is_srt = false;
 
     log_debug("start transcoding file: %s\n", location.c_str());
-    char fifo_template[]="mt_transcode_XXXXXX";
 
     if (profile == nullptr)
         throw _Exception(_("Transcoding of file ") + location +
@@ -122,13 +127,12 @@ Ref<IOHandler> TranscodeExternalHandler::open(Ref<TranscodingProfile> profile,
 
     Ref<ConfigManager> cfg = ConfigManager::getInstance();
    
-    String fifo_name = normalizePath(tempName(cfg->getOption(CFG_SERVER_TMPDIR),
-                                     fifo_template));
     String arguments;
     String temp;
     String command;
     Ref<Array<StringBase> > arglist;
     Ref<Array<ProcListItem> > proc_list = nullptr;
+    bool proxyURL = false;
 
 #ifdef SOPCAST
     service_type_t service = OS_None;
@@ -161,36 +165,9 @@ Ref<IOHandler> TranscodeExternalHandler::open(Ref<TranscodingProfile> profile,
         if (isURL && (!profile->acceptURL()))
         {
 #ifdef HAVE_CURL
-            String url = location;
-            strcpy(fifo_template, "mt_transcode_XXXXXX");
-            location = normalizePath(tempName(cfg->getOption(CFG_SERVER_TMPDIR), fifo_template));
-            log_debug("creating reader fifo: %s\n", location.c_str());
-            if (mkfifo(location.c_str(), O_RDWR) == -1)
-            {
-                log_error("Failed to create fifo for the remote content "
-                          "reading thread: %s\n", strerror(errno));
-                throw _Exception(_("Could not create reader fifo!\n"));
-            }
-
-            try
-            {
-                chmod(location.c_str(), S_IWUSR | S_IRUSR);
-
-                Ref<IOHandler> c_ioh(new CurlIOHandler(url, nullptr, 
-                   cfg->getIntOption(CFG_EXTERNAL_TRANSCODING_CURL_BUFFER_SIZE),
-                   cfg->getIntOption(CFG_EXTERNAL_TRANSCODING_CURL_FILL_SIZE)));
-
-                Ref<IOHandler> p_ioh(new ProcessIOHandler(location, nullptr));
-                Ref<Executor> ch(new IOHandlerChainer(c_ioh, p_ioh, 16384));
-                proc_list = Ref<Array<ProcListItem> >(new Array<ProcListItem>(1));
-                Ref<ProcListItem> pr_item(new ProcListItem(ch));
-                proc_list->append(pr_item);
-            }
-            catch (const Exception & ex)
-            {
-                unlink(location.c_str());
-                throw ex;
-            }
+            // we fetch the content ourselves and feed it to the
+            // standard input of the transcoder
+            proxyURL = true;
 #else
             throw _Exception(_("MediaTomb was compiled without libcurl support,"
                                "data proxying is not available"));
@@ -225,26 +202,38 @@ Ref<IOHandler> TranscodeExternalHandler::open(Ref<TranscodingProfile> profile,
         throw _Exception(_("Transcoder ") + profile->getCommand() + 
                 " is not executable: " + strerror(err));
 
-    log_debug("creating fifo: %s\n", fifo_name.c_str());
-    if (mkfifo(fifo_name.c_str(), O_RDWR) == -1) 
+    // the transcoder writes into a pipe that is connected to its
+    // standard output, %out refers to that
+    String url = location;
+    int pipeFlags = PROCESS_PIPE_STDOUT;
+    if (proxyURL)
     {
-        log_error("Failed to create fifo for the transcoding process!: %s\n", strerror(errno));
-        throw _Exception(_("Could not create fifo!\n"));
+        location = _(TRANSCODE_PIPE_STDIN);
+        pipeFlags |= PROCESS_PIPE_STDIN;
     }
-        
-    chmod(fifo_name.c_str(), S_IWUSR | S_IRUSR);
-   
-    arglist = parseCommandLine(profile->getArguments(), location, fifo_name, range);
+
+    arglist = parseCommandLine(profile->getArguments(), location, _(TRANSCODE_PIPE_STDOUT), range);
 
     log_debug("Command: %s\n", profile->getCommand().c_str());
     log_debug("Arguments: %s\n", profile->getArguments().c_str());
-    Ref<TranscodingProcessExecutor> main_proc(new TranscodingProcessExecutor(profile->getCommand(), arglist));
-    main_proc->removeFile(fifo_name);
-    if (isURL && (!profile->acceptURL()))
+    Ref<TranscodingProcessExecutor> main_proc(new TranscodingProcessExecutor(profile->getCommand(), arglist, pipeFlags));
+
+#ifdef HAVE_CURL
+    if (proxyURL)
     {
-        main_proc->removeFile(location);
+        Ref<IOHandler> c_ioh(new CurlIOHandler(url, nullptr, 
+           cfg->getIntOption(CFG_EXTERNAL_TRANSCODING_CURL_BUFFER_SIZE),
+           cfg->getIntOption(CFG_EXTERNAL_TRANSCODING_CURL_FILL_SIZE)));
+
+        Ref<IOHandler> p_ioh(new ProcessIOHandler(main_proc->releaseStdin(), nullptr));
+        Ref<Executor> ch(new IOHandlerChainer(c_ioh, p_ioh, 16384));
+        proc_list = Ref<Array<ProcListItem> >(new Array<ProcListItem>(1));
+        Ref<ProcListItem> pr_item(new ProcListItem(ch));
+        proc_list->append(pr_item);
     }
-    Ref<IOHandler> io_handler(new BufferedIOHandler(Ref<IOHandler> (new ProcessIOHandler(fifo_name, RefCast(main_proc, Executor), proc_list)), profile->getBufferSize(), profile->getBufferChunkSize(), profile->getBufferInitialFillSize()));
+#endif
+
+    Ref<IOHandler> io_handler(new BufferedIOHandler(Ref<IOHandler> (new ProcessIOHandler(main_proc->releaseStdout(), RefCast(main_proc, Executor), proc_list)), profile->getBufferSize(), profile->getBufferChunkSize(), profile->getBufferInitialFillSize()));
 
     io_handler->open(UPNP_READ);
     PlayHook::getInstance()->trigger(obj);
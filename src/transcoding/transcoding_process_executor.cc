@@ -34,7 +34,7 @@
 
 using namespace zmm;
 
-TranscodingProcessExecutor::TranscodingProcessExecutor(String command, Ref<Array<StringBase> > arglist) : ProcessExecutor(command, arglist)
+TranscodingProcessExecutor::TranscodingProcessExecutor(String command, Ref<Array<StringBase> > arglist, int pipeFlags) : ProcessExecutor(command, arglist, pipeFlags)
 {
 };
 
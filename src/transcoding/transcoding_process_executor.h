@@ -38,7 +38,8 @@ class TranscodingProcessExecutor : public ProcessExecutor
 {
 public:
     TranscodingProcessExecutor(zmm::String command,
-                               zmm::Ref<zmm::Array<zmm::StringBase> > arglist);
+                               zmm::Ref<zmm::Array<zmm::StringBase> > arglist,
+                               int pipeFlags = 0);
     /// \brief This function adds a filename to a list, files in that list
     /// will be removed once the class is destroyed.
     void removeFile(zmm::String filename);
@@ -0,0 +1,148 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    ui_change_feed.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file ui_change_feed.cc
+
+#include <chrono>
+
+#include "common.h"
+#include "ui_change_feed.h"
+
+using namespace zmm;
+
+UIChangeFeed::UIChangeFeed(size_t capacity, size_t maxWaiters)
+    : ring(capacity)
+    , next(0)
+    , taskVersion(0)
+    , waiters(0)
+    , maxWaiters(maxWaiters)
+    , closed(false)
+{
+}
+
+UIChangeFeed::Cursor UIChangeFeed::getCursor()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return Cursor { next, taskVersion };
+}
+
+void UIChangeFeed::containerChanged(int objectID)
+{
+    if (objectID == INVALID_OBJECT_ID)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // an import changes the same container many times in a row
+        if (next > 0 && ring[(next - 1) % ring.size()] == objectID)
+            return;
+        ring[next % ring.size()] = objectID;
+        next++;
+    }
+    cond.notify_all();
+}
+
+void UIChangeFeed::containerChanged(const std::vector<int>& objectIDs)
+{
+    bool changed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int objectID : objectIDs) {
+            if (objectID == INVALID_OBJECT_ID)
+                continue;
+            if (next > 0 && ring[(next - 1) % ring.size()] == objectID)
+                continue;
+            ring[next % ring.size()] = objectID;
+            next++;
+            changed = true;
+        }
+    }
+    if (changed)
+        cond.notify_all();
+}
+
+void UIChangeFeed::taskChanged()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        taskVersion++;
+    }
+    cond.notify_all();
+}
+
+bool UIChangeFeed::hasContainerChanges(const Cursor& cursor)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return next != cursor.position;
+}
+
+bool UIChangeFeed::hasChanges(const Cursor& cursor)
+{
+    return next != cursor.position || taskVersion != cursor.taskVersion;
+}
+
+UIChangeFeed::Changes UIChangeFeed::collect(Cursor& cursor, size_t maxIDs)
+{
+    Changes changes;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    changes.task = taskVersion != cursor.taskVersion;
+    changes.all = next - cursor.position > ring.size();
+    for (uint64_t i = cursor.position; !changes.all && i < next; i++) {
+        changes.containers.insert(ring[i % ring.size()]);
+        if (changes.containers.size() > maxIDs)
+            changes.all = true;
+    }
+    if (changes.all)
+        changes.containers.clear();
+
+    cursor.position = next;
+    cursor.taskVersion = taskVersion;
+    return changes;
+}
+
+UIChangeFeed::WaitResult UIChangeFeed::wait(const Cursor& cursor, long timeout)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (closed)
+        return WAIT_TIMEOUT;
+    if (hasChanges(cursor))
+        return WAIT_CHANGED;
+    if (waiters >= maxWaiters)
+        return WAIT_BUSY;
+
+    waiters++;
+    cond.wait_for(lock, std::chrono::milliseconds(timeout), [this, &cursor]() {
+        return closed || hasChanges(cursor);
+    });
+    waiters--;
+    return (!closed && hasChanges(cursor)) ? WAIT_CHANGED : WAIT_TIMEOUT;
+}
+
+void UIChangeFeed::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+    }
+    cond.notify_all();
+}
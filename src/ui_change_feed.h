@@ -0,0 +1,124 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    ui_change_feed.h - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file ui_change_feed.h
+/// \brief Definition of the UIChangeFeed class.
+
+#ifndef __UI_CHANGE_FEED_H__
+#define __UI_CHANGE_FEED_H__
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "zmm/zmmf.h"
+
+/// \brief number of container changes the feed keeps, a reader that falls
+/// further behind has to reload the whole tree
+#define UI_CHANGE_FEED_CAPACITY 1024
+
+/// \brief number of readers that may wait at the same time, each of them
+/// holds a thread of the web server
+#define UI_CHANGE_FEED_MAX_WAITERS 4
+
+/// \brief Broadcasts container changes and task changes to the web UI
+/// sessions.
+///
+/// All sessions read the same ring, each through its own Cursor. Writing a
+/// change costs the same no matter how many sessions are logged in, and
+/// a session only looks at the changes when its UI asks for them.
+class UIChangeFeed : public zmm::Object
+{
+public:
+    /// \brief Position of a reader in the feed.
+    struct Cursor
+    {
+        uint64_t position;
+        uint64_t taskVersion;
+    };
+
+    /// \brief Changes a reader has not seen yet.
+    struct Changes
+    {
+        /// \brief true if the reader has to reload every container
+        bool all;
+        std::unordered_set<int> containers;
+        bool task;
+    };
+
+    /// \brief How a wait() ended.
+    enum WaitResult
+    {
+        WAIT_CHANGED,
+        /// \brief also returned after close()
+        WAIT_TIMEOUT,
+        /// \brief too many readers were waiting already, the reader did
+        /// not wait
+        WAIT_BUSY
+    };
+
+    UIChangeFeed(size_t capacity = UI_CHANGE_FEED_CAPACITY, size_t maxWaiters = UI_CHANGE_FEED_MAX_WAITERS);
+
+    /// \brief Returns a cursor that only sees later changes.
+    Cursor getCursor();
+
+    void containerChanged(int objectID);
+    void containerChanged(const std::vector<int> &objectIDs);
+
+    /// \brief Is called when a task starts or finishes.
+    void taskChanged();
+
+    /// \brief Checks for container changes after the cursor.
+    bool hasContainerChanges(const Cursor &cursor);
+
+    /// \brief Returns the changes after the cursor and moves it to the end
+    /// of the feed.
+    /// \param maxIDs more changed containers than this are reported as all
+    Changes collect(Cursor &cursor, size_t maxIDs);
+
+    /// \brief Blocks until there are changes after the cursor, unless
+    /// maxWaiters readers are waiting already.
+    /// \param timeout in milliseconds
+    WaitResult wait(const Cursor &cursor, long timeout);
+
+    /// \brief Wakes up all waiting readers, is called on shutdown.
+    void close();
+
+protected:
+    bool hasChanges(const Cursor &cursor);
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<int> ring;
+    /// \brief sequence number of the next change, the change with sequence
+    /// number n is at ring[n % ring.size()]
+    uint64_t next;
+    uint64_t taskVersion;
+    size_t waiters;
+    size_t maxWaiters;
+    bool closed;
+};
+
+#endif // __UI_CHANGE_FEED_H__
@@ -31,6 +31,7 @@
 
 #include "update_manager.h"
 
+#include "cds_result_cache.h"
 #include "server.h"
 #include "singleton.h"
 #include "storage.h"
@@ -44,6 +45,9 @@
 #define SPEC_INTERVAL 2000
 #define MIN_SLEEP 1
 
+// update ids are written to the database at most this often
+#define PERSIST_INTERVAL 30000
+
 #define MAX_OBJECT_IDS 1000
 #define MAX_OBJECT_IDS_OVERLOAD 30
 #define OBJECT_ID_HASH_CAPACITY 3109
@@ -95,6 +99,9 @@ void UpdateManager::shutdown()
 
 void UpdateManager::containersChanged(const std::vector<int>& objectIDs, int flushPolicy)
 {
+    // cached replies are outdated right away, not only after the flush
+    CdsResultCache::getInstance()->invalidate(objectIDs);
+
     unique_lock<mutex_type> lock(mutex);
     // signalling thread if it could have been idle, because
     // there were no unprocessed updates
@@ -135,6 +142,7 @@ void UpdateManager::containerChanged(int objectID, int flushPolicy)
 {
     if (objectID == INVALID_OBJECT_ID)
         return;
+    CdsResultCache::getInstance()->invalidate(objectID);
     AutoLock lock(mutex);
     if (objectID != lastContainerChanged || flushPolicy > this->flushPolicy) {
         // signalling thread if it could have been idle, because
@@ -171,6 +179,9 @@ void UpdateManager::threadProc()
 {
     struct timespec lastUpdate;
     getTimespecNow(&lastUpdate);
+    struct timespec lastPersist;
+    getTimespecNow(&lastPersist);
+    bool persistPending = false;
 
     unique_lock<mutex_type> lock(mutex);
     //cond.notify_one();
@@ -209,16 +220,21 @@ void UpdateManager::threadProc()
                 flushPolicy = FLUSH_SPEC;
                 String updateString;
 
+                // take the ids and let others queue new changes while the
+                // storage is busy
+                auto ids = objectIDHash;
+                objectIDHash = make_shared<unordered_set<int>>();
+                lock.unlock();
+
                 try {
-                    updateString = Storage::getInstance()->incrementUpdateIDs(objectIDHash);
-                    objectIDHash->clear(); // hash_data_array will be invalid after clear()
+                    updateString = Storage::getInstance()->incrementUpdateIDs(ids);
+                    persistPending = true;
                 } catch (const Exception& e) {
                     e.printStackTrace();
                     log_error("Fatal error when sending updates: %s\n", e.getMessage().c_str());
                     log_error("Forcing MediaTomb shutdown.\n");
                     kill(0, SIGINT);
                 }
-                lock.unlock(); // we don't need to hold the lock during the sending of the updates
                 if (string_ok(updateString)) {
                     try {
                         log_debug("updates sent: \"%s\"\n", updateString.c_str());
@@ -232,8 +248,26 @@ void UpdateManager::threadProc()
                 } else {
                     log_debug("NOT sending updates (string empty or invalid).\n");
                 }
+                if (persistPending && getDeltaMillis(&lastPersist) >= PERSIST_INTERVAL) {
+                    persistUpdateIDs();
+                    persistPending = false;
+                    getTimespecNow(&lastPersist);
+                }
                 lock.lock();
             }
+        } else if (persistPending) {
+            // write the update ids once things calmed down
+            long sleepMillis = PERSIST_INTERVAL - getDeltaMillis(&lastPersist);
+            if (sleepMillis < MIN_SLEEP
+                || cond.wait_for(lock, chrono::milliseconds(sleepMillis)) == cv_status::timeout) {
+                if (!haveUpdates() && !shutdownFlag) {
+                    lock.unlock();
+                    persistUpdateIDs();
+                    persistPending = false;
+                    getTimespecNow(&lastPersist);
+                    lock.lock();
+                }
+            }
         } else {
             //nothing to do
             cond.wait(lock);
@@ -241,6 +275,15 @@ void UpdateManager::threadProc()
     }
 }
 
+void UpdateManager::persistUpdateIDs()
+{
+    try {
+        Storage::getInstance()->flushUpdateIDs();
+    } catch (const Exception& e) {
+        log_error("Error while storing update ids: %s\n", e.getMessage().c_str());
+    }
+}
+
 void* UpdateManager::staticThreadProc(void* arg)
 {
     log_debug("starting update thread... thread: %d\n", pthread_self());
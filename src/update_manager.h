@@ -68,6 +68,7 @@ protected:
 
     static void *staticThreadProc(void *arg);
     void threadProc();
+    void persistUpdateIDs();
 
     inline bool haveUpdates() { return (objectIDHash->size() > 0); }
 };
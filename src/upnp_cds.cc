@@ -30,7 +30,9 @@
 /// \file upnp_cds.cc
 
 #include "upnp_cds.h"
+#include "cds_result_cache.h"
 #include "config_manager.h"
+#include "play_hook.h"
 #include "server.h"
 #include "storage.h"
 #include "search_handler.h"
@@ -52,6 +54,48 @@ ContentDirectoryService::~ContentDirectoryService()
 {
 }
 
+static std::string toStdString(String value)
+{
+    if (value == nullptr)
+        return std::string();
+    return std::string(value.c_str(), value.length());
+}
+
+/// \brief Loads the play statistics of the client for the items among objects.
+static std::unordered_map<int, PlayStatus> loadPlayStatus(Ref<Array<CdsObject>> objects, const std::string &client)
+{
+    std::vector<int> itemIDs;
+    for (int i = 0; i < objects->size(); i++) {
+        Ref<CdsObject> obj = objects->get(i);
+        if (IS_CDS_ITEM(obj->getObjectType()))
+            itemIDs.push_back(PlayHook::getPlayStatusID(obj));
+    }
+    return Storage::getInstance()->loadPlayStatus(itemIDs, client);
+}
+
+static void renderPlayStatus(Ref<Element> didlObject, Ref<CdsObject> obj,
+    const std::unordered_map<int, PlayStatus> &playStatus)
+{
+    if (!IS_CDS_ITEM(obj->getObjectType()))
+        return;
+    auto status = playStatus.find(PlayHook::getPlayStatusID(obj));
+    if (status != playStatus.end())
+        UpnpXML_DIDLRenderPlayStatus(didlObject, obj, status->second);
+}
+
+void ContentDirectoryService::sendCachedResult(Ref<ActionRequest> request, const CdsCachedResult &result)
+{
+    Ref<Element> response;
+    response = UpnpXML_CreateResponse(request->getActionName(), _(DESC_CDS_SERVICE_TYPE));
+
+    response->appendTextChild(_("Result"), String(result.didl.c_str(), result.didl.length()));
+    response->appendTextChild(_("NumberReturned"), String::from(result.numberReturned));
+    response->appendTextChild(_("TotalMatches"), String::from(result.totalMatches));
+    response->appendTextChild(_("UpdateID"), String::from(systemUpdateID));
+
+    request->setResponse(response);
+}
+
 void ContentDirectoryService::upnp_action_Browse(Ref<ActionRequest> request)
 {
     log_debug("start\n");
@@ -62,10 +106,12 @@ void ContentDirectoryService::upnp_action_Browse(Ref<ActionRequest> request)
     String objID = req->getChildText(_("ObjectID"));
     int objectID;
     String BrowseFlag = req->getChildText(_("BrowseFlag"));
-    //String Filter; // not yet supported
+    // not yet supported, but part of the cache key
+    String Filter = req->getChildText(_("Filter"));
     String StartingIndex = req->getChildText(_("StartingIndex"));
     String RequestedCount = req->getChildText(_("RequestedCount"));
-    // String SortCriteria; // not yet supported
+    // not yet supported, but part of the cache key
+    String SortCriteria = req->getChildText(_("SortCriteria"));
 
     log_debug("Browse received parameters: ObjectID [%s] BrowseFlag [%s] StartingIndex [%s] RequestedCount [%s]\n",
               objID.c_str(), BrowseFlag.c_str(), StartingIndex.c_str(), RequestedCount.c_str());
@@ -83,6 +129,19 @@ void ContentDirectoryService::upnp_action_Browse(Ref<ActionRequest> request)
         throw UpnpException(UPNP_SOAP_E_INVALID_ARGS,
             _("invalid browse flag: ") + BrowseFlag);
 
+    Ref<CdsResultCache> cache = CdsResultCache::getInstance();
+    std::string cacheKey = "Browse\n" + toStdString(objID) + '\n' + toStdString(BrowseFlag)
+        + '\n' + toStdString(StartingIndex) + '\n' + toStdString(RequestedCount)
+        + '\n' + toStdString(SortCriteria) + '\n' + toStdString(Filter)
+        + '\n' + request->getClient();
+    CdsCachedResult cached;
+    if (cache->get(cacheKey, cached)) {
+        log_debug("Browse served from cache\n");
+        sendCachedResult(request, cached);
+        return;
+    }
+    unsigned long cacheGeneration = cache->getGeneration();
+
     Ref<CdsObject> parent = storage->loadObject(objectID);
     if ((parent->getClass() == UPNP_DEFAULT_CLASS_MUSIC_ALBUM) || (parent->getClass() == UPNP_DEFAULT_CLASS_PLAYLIST_CONTAINER))
         flag |= BROWSE_TRACK_SORT;
@@ -120,8 +179,15 @@ void ContentDirectoryService::upnp_action_Browse(Ref<ActionRequest> request)
     }
 #endif
 
+    // the reply shows the child counts of contained containers, so it is
+    // outdated as soon as one of them changes, too
+    std::vector<int> dependsOn { objectID, parent->getParentID() };
+    auto playStatus = loadPlayStatus(arr, request->getClient());
+
     for (int i = 0; i < arr->size(); i++) {
         Ref<CdsObject> obj = arr->get(i);
+        if (IS_CDS_CONTAINER(obj->getObjectType()))
+            dependsOn.push_back(obj->getID());
         if (cfg->getBoolOption(CFG_SERVER_EXTOPTS_MARK_PLAYED_ITEMS_ENABLED) && obj->getFlag(OBJECT_FLAG_PLAYED)) {
             String title = obj->getTitle();
             if (cfg->getBoolOption(CFG_SERVER_EXTOPTS_MARK_PLAYED_ITEMS_STRING_MODE_PREPEND))
@@ -133,19 +199,18 @@ void ContentDirectoryService::upnp_action_Browse(Ref<ActionRequest> request)
         }
 
         Ref<Element> didl_object = UpnpXML_DIDLRenderObject(obj, false, stringLimit);
+        renderPlayStatus(didl_object, obj, playStatus);
 
         didl_lite->appendElementChild(didl_object);
     }
 
-    Ref<Element> response;
-    response = UpnpXML_CreateResponse(request->getActionName(), _(DESC_CDS_SERVICE_TYPE));
-
-    response->appendTextChild(_("Result"), didl_lite->print());
-    response->appendTextChild(_("NumberReturned"), String::from(arr->size()));
-    response->appendTextChild(_("TotalMatches"), String::from(param->getTotalMatches()));
-    response->appendTextChild(_("UpdateID"), String::from(systemUpdateID));
+    CdsCachedResult result;
+    result.didl = toStdString(didl_lite->print());
+    result.numberReturned = arr->size();
+    result.totalMatches = param->getTotalMatches();
+    cache->put(cacheKey, result, dependsOn, false, cacheGeneration);
 
-    request->setResponse(response);
+    sendCachedResult(request, result);
     log_debug("end\n");
 }
 
@@ -157,9 +222,23 @@ void ContentDirectoryService::upnp_action_Search(Ref<ActionRequest> request) {
     std::string searchCriteria(req->getChildText(_("SearchCriteria")).c_str());
     std::string startingIndex(req->getChildText(_("StartingIndex")).c_str());
     std::string requestedCount(req->getChildText(_("RequestedCount")).c_str());
+    std::string filter = toStdString(req->getChildText(_("Filter")));
+    std::string sortCriteria = toStdString(req->getChildText(_("SortCriteria")));
     log_debug("Search received parameters: ContainerID [%s] SearchCriteria [%s] StartingIndex [%s] RequestedCount [%s]\n",
               containerID.c_str(), searchCriteria.c_str(), startingIndex.c_str(), requestedCount.c_str());
 
+    Ref<CdsResultCache> cache = CdsResultCache::getInstance();
+    std::string cacheKey = "Search\n" + containerID + '\n' + searchCriteria + '\n' + startingIndex
+        + '\n' + requestedCount + '\n' + sortCriteria + '\n' + filter
+        + '\n' + request->getClient();
+    CdsCachedResult cached;
+    if (cache->get(cacheKey, cached)) {
+        log_debug("Search served from cache\n");
+        sendCachedResult(request, cached);
+        return;
+    }
+    unsigned long cacheGeneration = cache->getGeneration();
+
    Ref<Element> didl_lite(new Element(_("DIDL-Lite")));
     didl_lite->setAttribute(_(XML_NAMESPACE_ATTR),
         _(XML_DIDL_LITE_NAMESPACE));
@@ -190,6 +269,7 @@ void ContentDirectoryService::upnp_action_Search(Ref<ActionRequest> request) {
         throw UpnpException(UPNP_E_NO_SUCH_ID, _("no such object"));
     }
 
+    auto playStatus = loadPlayStatus(results, request->getClient());
     for (int i = 0; i < results->size(); i++) {
         Ref<CdsObject> cdsObject = results->get(i);
         if (cfg->getBoolOption(CFG_SERVER_EXTOPTS_MARK_PLAYED_ITEMS_ENABLED) && cdsObject->getFlag(OBJECT_FLAG_PLAYED)) {
@@ -203,18 +283,18 @@ void ContentDirectoryService::upnp_action_Search(Ref<ActionRequest> request) {
         }
 
         Ref<Element> didl_object = UpnpXML_DIDLRenderObject(cdsObject, false, stringLimit);
+        renderPlayStatus(didl_object, cdsObject, playStatus);
         didl_lite->appendElementChild(didl_object);
     }
 
-    Ref<Element> response;
-    response = UpnpXML_CreateResponse(request->getActionName(), _(DESC_CDS_SERVICE_TYPE));
-
-    response->appendTextChild(_("Result"), didl_lite->print());
-    response->appendTextChild(_("NumberReturned"), String::from(results->size()));
-    response->appendTextChild(_("TotalMatches"), String::from(numMatches));
-    response->appendTextChild(_("UpdateID"), String::from(systemUpdateID));
+    // a search covers a whole subtree, any change may affect it
+    CdsCachedResult result;
+    result.didl = toStdString(didl_lite->print());
+    result.numberReturned = results->size();
+    result.totalMatches = numMatches;
+    cache->put(cacheKey, result, std::vector<int>(), true, cacheGeneration);
 
-    request->setResponse(response);
+    sendCachedResult(request, result);
     log_debug("end\n");
 }
 
@@ -33,6 +33,7 @@
 #define __UPNP_CDS_H__
 
 #include "action_request.h"
+#include "cds_result_cache.h"
 #include "common.h"
 #include "singleton.h"
 #include "subscription_request.h"
@@ -89,6 +90,9 @@ protected:
     /// GetSystemUpdateID(ui4 Id)
     void upnp_action_GetSystemUpdateID(zmm::Ref<ActionRequest> request);
 
+    /// \brief Sends a Browse or Search reply with the current systemUpdateID.
+    void sendCachedResult(zmm::Ref<ActionRequest> request, const CdsCachedResult &result);
+
     UpnpDevice_Handle deviceHandle;
 
 public:
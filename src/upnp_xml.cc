@@ -262,6 +262,32 @@ Ref<Element> UpnpXML_DIDLRenderObject(Ref<CdsObject> obj, bool renderActions, in
     return result;
 }
 
+void UpnpXML_DIDLRenderPlayStatus(Ref<Element> didlObject, Ref<CdsObject> obj, const PlayStatus &status)
+{
+    didlObject->appendTextChild(_("upnp:playbackCount"), String::from(status.playCount));
+
+    struct tm lastPlayed;
+    char buf[32];
+    if (localtime_r(&status.lastPlayed, &lastPlayed) != nullptr
+        && strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &lastPlayed) > 0)
+        didlObject->appendTextChild(_("upnp:lastPlaybackTime"), buf);
+
+    if (status.position <= 0 || obj->getResourceCount() == 0)
+        return;
+
+    Ref<CdsResource> res = obj->getResource(0);
+    String duration = res->getAttribute(MetadataHandler::getResAttrName(R_DURATION));
+    String size = res->getAttribute(MetadataHandler::getResAttrName(R_SIZE));
+    if (!string_ok(duration) || !string_ok(size))
+        return;
+    long long bytes = strtoll(size.c_str(), nullptr, 10);
+    if (bytes <= 0 || status.position >= bytes)
+        return;
+
+    long long seconds = (long long)HMSToSeconds(duration) * status.position / bytes;
+    didlObject->appendTextChild(_("upnp:lastPlaybackPosition"), secondsToHMS((int)seconds));
+}
+
 void UpnpXML_DIDLUpdateObject(Ref<CdsObject> obj, String text)
 {
     Ref<Parser> parser(new Parser());
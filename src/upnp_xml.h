@@ -35,6 +35,7 @@
 #include "common.h"
 #include "mxml/mxml.h"
 #include "cds_objects.h"
+#include "storage.h"
 
 /// \brief Renders XML for the action response header.
 /// \param actionName Name of the action.
@@ -58,6 +59,15 @@ zmm::Ref<mxml::Element> UpnpXML_CreateResponse(zmm::String actionName, zmm::Stri
 /// providing the XML representation of an active item to a trigger/toggle script.
 zmm::Ref<mxml::Element> UpnpXML_DIDLRenderObject(zmm::Ref<CdsObject> obj, bool renderActions = false, int stringLimit = -1);
 
+/// \brief Adds the play statistics of the requesting client to a rendered item.
+/// \param didlObject the rendered item
+/// \param obj the item
+/// \param status how often and how far the client played the item
+///
+/// The resume position is stored as byte offset, it is rendered as time
+/// if the item tells its size and duration.
+void UpnpXML_DIDLRenderPlayStatus(zmm::Ref<mxml::Element> didlObject, zmm::Ref<CdsObject> obj, const PlayStatus &status);
+
 /// \todo change the text string to element, parsing should be done outside
 void UpnpXML_DIDLUpdateObject(zmm::Ref<CdsObject> obj, zmm::String text);
 
@@ -37,8 +37,10 @@
 #include "url.h"
 #include "tools.h"
 #include "config_manager.h"
+#include "http_client.h"
 
 #include <sstream>
+#include <strings.h>
 
 using namespace zmm;
 
@@ -49,18 +51,18 @@ std::string URL::download(String URL, long *HTTP_retcode,
     CURLcode res;
     bool cleanup = false;
     char error_buffer[CURL_ERROR_SIZE] = {'\0'};
+    Ref<HTTPClient> client = HTTPClient::getInstance();
 
     if (curl_handle == nullptr)
     {
-        curl_handle = curl_easy_init();
+        curl_handle = client->getHandle();
         cleanup = true;
-        if (curl_handle == nullptr)
-            throw _Exception(_("Invalid curl handle!\n"));
     }
 
     std::ostringstream buffer;
 
     curl_easy_reset(curl_handle);
+    client->prepareHandle(curl_handle);
     
     if (verbose)
     {
@@ -101,12 +103,16 @@ std::string URL::download(String URL, long *HTTP_retcode,
         curl_easy_setopt(curl_handle, CURLOPT_MAXREDIRS, -1);
     }
 
-    res = curl_easy_perform(curl_handle);
+    {
+        HTTPClient::HostSlot slot(client, URL);
+        res = curl_easy_perform(curl_handle);
+    }
+    client->recordTransfer(curl_handle, res);
     if (res != CURLE_OK)
     {
         log_error("%s\n", error_buffer);
         if (cleanup)
-            curl_easy_cleanup(curl_handle);
+            client->returnHandle(curl_handle);
         throw _Exception(error_buffer);
     }
 
@@ -115,12 +121,12 @@ std::string URL::download(String URL, long *HTTP_retcode,
     {
         log_error("%s\n", error_buffer);
         if (cleanup)
-            curl_easy_cleanup(curl_handle);
+            client->returnHandle(curl_handle);
         throw _Exception(error_buffer);
     }
 
     if (cleanup)
-        curl_easy_cleanup(curl_handle);
+        client->returnHandle(curl_handle);
 
     return buffer.str();
 }
@@ -136,20 +142,19 @@ Ref<URL::Stat> URL::getInfo(String URL, CURL *curl_handle)
     char error_buffer[CURL_ERROR_SIZE] = {'\0'};
     String mt;
     String used_url;
+    Ref<HTTPClient> client = HTTPClient::getInstance();
 
     if (curl_handle == nullptr)
     {
-        curl_handle = curl_easy_init();
+        curl_handle = client->getHandle();
         cleanup = true;
-        if (curl_handle == nullptr)
-            throw _Exception(_("Invalid curl handle!\n"));
     }
 
-    download(URL, &retcode, curl_handle, true, true, true);
+    std::string headers = download(URL, &retcode, curl_handle, true, true, true);
     if (retcode != 200)
     {
         if (cleanup)
-            curl_easy_cleanup(curl_handle);
+            client->returnHandle(curl_handle);
         throw _Exception(_("Error retrieving information from ") +
                           URL + _(" HTTP return code: ") + 
                           String::from(retcode));
@@ -164,7 +169,7 @@ Ref<URL::Stat> URL::getInfo(String URL, CURL *curl_handle)
     catch (const Exception & ex)
     {
         if (cleanup)
-            curl_easy_cleanup(curl_handle);
+            client->returnHandle(curl_handle);
 
         throw ex;
     }
@@ -187,7 +192,7 @@ Ref<URL::Stat> URL::getInfo(String URL, CURL *curl_handle)
     catch (const Exception & ex)
     {
         if (cleanup)
-            curl_easy_cleanup(curl_handle);
+            client->returnHandle(curl_handle);
 
         throw ex;
     }
@@ -204,7 +209,7 @@ Ref<URL::Stat> URL::getInfo(String URL, CURL *curl_handle)
     {
         log_error("%s\n", error_buffer);
         if (cleanup)
-            curl_easy_cleanup(curl_handle);
+            client->returnHandle(curl_handle);
         throw _Exception(error_buffer);
     }
  
@@ -213,7 +218,7 @@ Ref<URL::Stat> URL::getInfo(String URL, CURL *curl_handle)
     {
         log_error("%s\n", error_buffer);
         if (cleanup)
-            curl_easy_cleanup(curl_handle);
+            client->returnHandle(curl_handle);
         throw _Exception(error_buffer);
     }
 
@@ -229,7 +234,7 @@ Ref<URL::Stat> URL::getInfo(String URL, CURL *curl_handle)
     {
         log_error("%s\n", error_buffer);
         if (cleanup)
-            curl_easy_cleanup(curl_handle);
+            client->returnHandle(curl_handle);
         throw _Exception(error_buffer);
     }
 
@@ -238,14 +243,60 @@ Ref<URL::Stat> URL::getInfo(String URL, CURL *curl_handle)
     else
         used_url = c_url;
 
-    Ref<Stat> st(new Stat(used_url, (off_t)cl, mt));
+    bool acceptsRanges;
+    String validator;
+    parseHeaders(headers, &acceptsRanges, &validator);
+
+    Ref<Stat> st(new Stat(used_url, (off_t)cl, mt, acceptsRanges, validator));
 
     if (cleanup)
-        curl_easy_cleanup(curl_handle);
+        client->returnHandle(curl_handle);
 
     return st;
 }
 
+void URL::parseHeaders(const std::string &headers, bool *acceptsRanges, String *validator)
+{
+    std::string etag;
+    std::string lastModified;
+    *acceptsRanges = false;
+
+    std::istringstream lines(headers);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (strncasecmp(line.c_str(), "HTTP/", 5) == 0)
+        {
+            // a new response, the headers of a redirect do not count
+            etag.clear();
+            lastModified.clear();
+            *acceptsRanges = false;
+            continue;
+        }
+
+        size_t colon = line.find(':');
+        if (colon == std::string::npos)
+            continue;
+        std::string name = line.substr(0, colon);
+        String value = trim_string(String(line.substr(colon + 1).c_str()));
+        if (strcasecmp(name.c_str(), "Accept-Ranges") == 0)
+            *acceptsRanges = strcasecmp(value.c_str(), "bytes") == 0;
+        else if (strcasecmp(name.c_str(), "ETag") == 0)
+            etag = value.c_str();
+        else if (strcasecmp(name.c_str(), "Last-Modified") == 0)
+            lastModified = value.c_str();
+    }
+
+    // a weak ETag still changes with the content
+    if (!etag.empty())
+        *validator = String(etag.c_str());
+    else if (!lastModified.empty())
+        *validator = String(lastModified.c_str());
+    else
+        *validator = nullptr;
+}
 
 size_t URL::dl(void *buf, size_t size, size_t nmemb, void *data)
 {
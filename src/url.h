@@ -54,19 +54,28 @@ public:
         ///
         /// \param size size of the media in bytes
         /// \param mimetype mime type of the media
-        Stat(zmm::String url, off_t size, zmm::String mimetype)
+        /// \param acceptsRanges the server announced byte range support
+        /// \param validator ETag or Last-Modified of the media, nullptr if
+        /// the server sent neither
+        Stat(zmm::String url, off_t size, zmm::String mimetype,
+            bool acceptsRanges = false, zmm::String validator = nullptr)
         {
             this->url = url; this->size = size; this->mimetype = mimetype; 
+            this->acceptsRanges = acceptsRanges; this->validator = validator;
         }
 
         zmm::String getURL()        { return url; }
         off_t getSize()             { return size; }
         zmm::String getMimeType()   { return mimetype; }
+        bool getAcceptsRanges()     { return acceptsRanges; }
+        zmm::String getValidator()  { return validator; }
     
     protected:
         zmm::String url;
         off_t size;
         zmm::String mimetype;
+        bool acceptsRanges;
+        zmm::String validator;
     };
 
     /// \brief downloads either the content or the headers to the buffer.
@@ -93,6 +102,10 @@ protected:
     /// \brief This function is installed as a callback for libcurl, when
     /// we download data from a remote site.
     static size_t dl(void *buf, size_t size, size_t nmemb, void *data);
+
+    /// \brief Reads the range support and the validator from the headers
+    /// of the last response in headers, redirects come before it.
+    static void parseHeaders(const std::string &headers, bool *acceptsRanges, zmm::String *validator);
 };
 
 #endif//__URL_H__
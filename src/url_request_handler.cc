@@ -42,6 +42,7 @@
 #include "url_request_handler.h"
 #include "cds_objects.h"
 #include "play_hook.h"
+#include "proxy_cache_io_handler.h"
 
 #ifdef ONLINE_SERVICES
     #include "online_service_helper.h"
@@ -227,6 +228,9 @@ Ref<IOHandler> URLRequestHandler::open(IN const char *filename,
     //info->is_directory = 0;
     //info->http_header = NULL;
 
+    off_t size = -1;
+    bool acceptsRanges = false;
+    String validator;
     tr_profile = dict->get(_(URL_PARAM_TRANSCODE_PROFILE_NAME));
 
     if (string_ok(tr_profile))
@@ -249,6 +253,9 @@ Ref<IOHandler> URLRequestHandler::open(IN const char *filename,
         {
             st = u->getInfo(url);
            // info->file_length = st->getSize();
+            size = st->getSize();
+            acceptsRanges = st->getAcceptsRanges();
+            validator = st->getValidator();
             header = _("Accept-Ranges: bytes");
             log_debug("URL used for request: %s\n", st->getURL().c_str());
         }
@@ -267,7 +274,19 @@ Ref<IOHandler> URLRequestHandler::open(IN const char *filename,
     */
 
     ///\todo make curl io handler configurable for url request handler
-    Ref<IOHandler> io_handler(new CurlIOHandler(url, nullptr, 1024*1024, 0));
+    Ref<IOHandler> io_handler;
+    // live streams and servers without byte ranges are passed through,
+    // their data could neither be bounded nor filled in later
+    if (item->getFlag(OBJECT_FLAG_PROXY_URL) && size >= 0 && acceptsRanges &&
+        ConfigManager::getInstance()->getBoolOption(CFG_SERVER_PROXY_CACHE_ENABLED))
+    {
+        io_handler = Ref<IOHandler>(new ProxyCacheIOHandler(ProxyCache::getInstance(), url, size, validator,
+            [url](off_t offset) {
+                return Ref<IOHandler>(new CurlIOHandler(url, nullptr, 1024*1024, 0, offset));
+            }));
+    }
+    else
+        io_handler = Ref<IOHandler>(new CurlIOHandler(url, nullptr, 1024*1024, 0));
 
     io_handler->open(mode);
     
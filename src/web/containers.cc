@@ -51,33 +51,28 @@ void web::containers::process()
         throw _Exception(_("web::containers: no parent_id given"));
     
     Ref<Storage> storage = Storage::getInstance();
-
-        
-    Ref<Element> containers (new Element(_("containers")));
-    containers->setArrayName(_("container"));
-    containers->setAttribute(_("parent_id"), String::from(parentID), mxml_int_type);
-    containers->setAttribute(_("type"), _("database"));
-
-    if (string_ok(param(_("select_it"))))
-        containers->setAttribute(_("select_it"), param(_("select_it")));
-    root->appendElementChild(containers);
     
     Ref<BrowseParam> param(new BrowseParam(parentID, BROWSE_DIRECT_CHILDREN | BROWSE_CONTAINERS));
     Ref<Array<CdsObject> > arr;
     arr = storage->browse(param);
+
+    writer->beginArray("containers", "container");
+    writer->attribute("parent_id", parentID);
+    writer->attribute("type", _("database"));
+
+    if (string_ok(this->param(_("select_it"))))
+        writer->attribute("select_it", this->param(_("select_it")));
     
     for (int i = 0; i < arr->size(); i++)
     {
         Ref<CdsObject> obj = arr->get(i);
-        //if (IS_CDS_CONTAINER(obj->getObjectType()))
-        //{
         Ref<CdsContainer> cont = RefCast(obj, CdsContainer);
-        Ref<Element> ce(new Element(_("container")));
-        ce->setAttribute(_("id"), String::from(cont->getID()), mxml_int_type);
+        writer->beginObject("container");
+        writer->attribute("id", cont->getID());
         int childCount = cont->getChildCount();
-        ce->setAttribute(_("child_count"), String::from(childCount), mxml_int_type);
+        writer->attribute("child_count", childCount);
         int autoscanType = cont->getAutoscanType();
-        ce->setAttribute(_("autoscan_type"), mapAutoscanType(autoscanType));
+        writer->attribute("autoscan_type", mapAutoscanType(autoscanType));
         
         String autoscanMode = _("none");
         if (autoscanType > 0)
@@ -92,10 +87,9 @@ void web::containers::process()
             }
 #endif
         }
-        ce->setAttribute(_("autoscan_mode"), autoscanMode);
-        ce->setTextKey(_("title"));
-        ce->setText(cont->getTitle());
-        containers->appendElementChild(ce);
-        //}
+        writer->attribute("autoscan_mode", autoscanMode);
+        writer->text("title", cont->getTitle());
+        writer->end();
     }
+    writer->end();
 }
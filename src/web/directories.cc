@@ -54,25 +54,23 @@ void web::directories::process()
     else
         path = hex_decode_string(parentID);
     
-    Ref<Element> containers (new Element(_("containers")));
-    containers->setArrayName(_("container"));
-    containers->setAttribute(_("parent_id"), parentID);
-    if (string_ok(param(_("select_it"))))
-        containers->setAttribute(_("select_it"), param(_("select_it")));
-    containers->setAttribute(_("type"), _("filesystem"));
-    root->appendElementChild(containers);
-    
     Ref<Filesystem> fs(new Filesystem());
     
     Ref<Array<FsObject> > arr;
     arr = fs->readDirectory(path, FS_MASK_DIRECTORIES,
                                                       FS_MASK_DIRECTORIES);
     
+    writer->beginArray("containers", "container");
+    writer->attribute("parent_id", parentID);
+    if (string_ok(param(_("select_it"))))
+        writer->attribute("select_it", param(_("select_it")));
+    writer->attribute("type", _("filesystem"));
+    
+    Ref<StringConverter> f2i = StringConverter::f2i();
     for (int i = 0; i < arr->size(); i++)
     {
         Ref<FsObject> obj = arr->get(i);
 
-        Ref<Element> ce(new Element(_("container")));
         String filename = obj->filename;
         String filepath;
         if (path.c_str()[path.length() - 1] == '/')
@@ -80,17 +78,13 @@ void web::directories::process()
         else
             filepath = path + '/' + filename;
         
+        writer->beginObject("container");
         /// \todo replace hex_encode with base64_encode?
         String id = hex_encode(filepath.c_str(), filepath.length());
-        ce->setAttribute(_("id"), id);
-        if (obj->hasContent)
-            ce->setAttribute(_("child_count"), String::from(1), mxml_int_type);
-        else
-            ce->setAttribute(_("child_count"), String::from(0), mxml_int_type);
-
-        Ref<StringConverter> f2i = StringConverter::f2i();
-        ce->setTextKey(_("title"));
-        ce->setText(f2i->convert(filename));
-        containers->appendElementChild(ce);
+        writer->attribute("id", id);
+        writer->attribute("child_count", obj->hasContent ? 1 : 0);
+        writer->text("title", f2i->convert(filename));
+        writer->end();
     }
+    writer->end();
 }
@@ -0,0 +1,62 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    events.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file events.cc
+
+#include <algorithm>
+
+#include "pages.h"
+#include "config_manager.h"
+#include "content_manager.h"
+
+/// \brief longest time in seconds a request waits for changes
+#define UI_EVENTS_MAX_WAIT 30
+
+using namespace zmm;
+using namespace mxml;
+
+void web::events::process()
+{
+    check_request();
+
+    int wait = intParam(_("timeout"), UI_EVENTS_MAX_WAIT);
+    if (wait < 0 || wait > UI_EVENTS_MAX_WAIT)
+        wait = UI_EVENTS_MAX_WAIT;
+
+    int pollInterval = ConfigManager::getInstance()->getIntOption(CFG_SERVER_UI_POLL_INTERVAL);
+    // while a task runs, its progress is sent every poll interval
+    if (ContentManager::getInstance()->getCurrentTask() != nullptr)
+        wait = std::min(wait, pollInterval);
+
+    UIChangeFeed::WaitResult result = session->waitForUIUpdates(wait * 1000L);
+    session->access();
+
+    // the UI asks again after this many seconds instead of right away
+    if (result == UIChangeFeed::WAIT_BUSY)
+        writer->attribute("retry", pollInterval);
+
+    writer->beginObject("update_ids");
+    if (!addUpdateIDs(writer, session))
+        writer->boolAttribute("updates", false);
+    writer->end();
+}
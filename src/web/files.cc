@@ -54,29 +54,26 @@ void web::files::process()
     else
         path = hex_decode_string(parentID);
     
-    Ref<Element> files(new Element(_("files")));
-    files->setArrayName(_("file"));
-    files->setAttribute(_("parent_id"), parentID);
-    files->setAttribute(_("location"), path);
-    root->appendElementChild(files);
-    
     Ref<Filesystem> fs(new Filesystem());
     Ref<Array<FsObject> > arr;
     arr = fs->readDirectory(path, FS_MASK_FILES);
     
+    writer->beginArray("files", "file");
+    writer->attribute("parent_id", parentID);
+    writer->attribute("location", path);
+    
+    Ref<StringConverter> f2i = StringConverter::f2i();
     for (int i = 0; i < arr->size(); i++)
     {
         Ref<FsObject> obj = arr->get(i);
         
-        Ref<Element> fe(new Element(_("file")));
         String filename = obj->filename;
         String filepath = path + _("/") + filename;
         String id = hex_encode(filepath.c_str(), filepath.length());
-        fe->setAttribute(_("id"), id);
-        
-        Ref<StringConverter> f2i = StringConverter::f2i();
-        fe->setTextKey(_("filename"));
-        fe->setText(f2i->convert(filename));
-        files->appendElementChild(fe);
+        writer->beginObject("file");
+        writer->attribute("id", id);
+        writer->text("filename", f2i->convert(filename));
+        writer->end();
     }
+    writer->end();
 }
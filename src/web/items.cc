@@ -55,10 +55,6 @@ void web::items::process()
         throw _Exception(_("illegal count parameter"));
     
     Ref<Storage> storage = Storage::getInstance();
-    Ref<Element> items (new Element(_("items")));
-    items->setArrayName(_("item"));
-    items->setAttribute(_("parent_id"), String::from(parentID), mxml_int_type);
-    root->appendElementChild(items);
     Ref<CdsObject> obj;
     obj = storage->loadObject(parentID);
     Ref<BrowseParam> param(new BrowseParam(parentID, BROWSE_DIRECT_CHILDREN | BROWSE_ITEMS));
@@ -71,14 +67,16 @@ void web::items::process()
     Ref<Array<CdsObject> > arr;
     arr = storage->browse(param);
     
+    writer->beginArray("items", "item");
+    writer->attribute("parent_id", parentID);
     String location = obj->getVirtualPath(); 
     if (string_ok(location))
-        items->setAttribute(_("location"), location);
-    items->setAttribute(_("virtual"), (obj->isVirtual() ? _("1") : _("0")), mxml_bool_type);
+        writer->attribute("location", location);
+    writer->boolAttribute("virtual", obj->isVirtual());
     
-    items->setAttribute(_("start"), String::from(start), mxml_int_type);
-    //items->setAttribute(_("returned"), String::from(arr->size()));
-    items->setAttribute(_("total_matches"), String::from(param->getTotalMatches()), mxml_int_type);
+    writer->attribute("start", start);
+    //writer->attribute("returned", arr->size());
+    writer->attribute("total_matches", param->getTotalMatches());
     
     int protectContainer = 0;
     int protectItems = 0;
@@ -115,25 +113,21 @@ void web::items::process()
         }
     }
 #endif
-    items->setAttribute(_("autoscan_mode"), autoscanMode);
-    items->setAttribute(_("autoscan_type"), mapAutoscanType(autoscanType));
-    items->setAttribute(_("protect_container"), String::from(protectContainer), mxml_bool_type);
-    items->setAttribute(_("protect_items"), String::from(protectItems), mxml_bool_type);
+    writer->attribute("autoscan_mode", autoscanMode);
+    writer->attribute("autoscan_type", mapAutoscanType(autoscanType));
+    writer->boolAttribute("protect_container", protectContainer);
+    writer->boolAttribute("protect_items", protectItems);
 
     for (int i = 0; i < arr->size(); i++)
     {
         Ref<CdsObject> obj = arr->get(i);
-        //if (IS_CDS_ITEM(obj->getObjectType()))
-        //{
-        Ref<Element> item (new Element(_("item")));
-        item->setAttribute(_("id"), String::from(obj->getID()), mxml_int_type);
-        item->appendTextChild(_("title"), obj->getTitle());
+        writer->beginObject("item");
+        writer->attribute("id", obj->getID());
+        writer->textChild("title", obj->getTitle());
         /// \todo clean this up, should have more generic options for online
         /// services
-            item->appendTextChild(_("res"), CdsResourceManager::getFirstResource(RefCast(obj, CdsItem)));
-        //item->appendTextChild(_("virtual"), obj->isVirtual() ? _("1") : _("0"), mxml_bool_type);
-        items->appendElementChild(item);
-        //}
+        writer->textChild("res", CdsResourceManager::getFirstResource(RefCast(obj, CdsItem)));
+        writer->end();
     }
-    
+    writer->end();
 }
@@ -160,6 +160,20 @@ public:
     virtual void process();
 };
 
+/// \brief library statistics
+class statistics : public WebRequestHandler
+{
+public:
+    virtual void process();
+};
+
+/// \brief waits for container and task changes and returns them
+class events : public WebRequestHandler
+{
+public:
+    virtual void process();
+};
+
 } // namespace
 
 /// \brief Chooses and creates the appropriate handler for processing the request.
@@ -0,0 +1,111 @@
+/*GRB*
+
+Gerbera - https://gerbera.io/
+
+    statistics.cc - this file is part of Gerbera.
+
+    Copyright (C) 2016-2018 Gerbera Contributors
+
+    Gerbera is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 2
+    as published by the Free Software Foundation.
+
+    Gerbera is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+    $Id$
+*/
+
+/// \file statistics.cc
+
+#include "pages.h"
+#include "config_manager.h"
+#include "content_manager.h"
+#include "http_client.h"
+#include "storage.h"
+
+using namespace zmm;
+using namespace mxml;
+
+void web::statistics::process()
+{
+    check_request();
+    Ref<Storage> storage = Storage::getInstance();
+
+    Ref<Element> statisticsEl(new Element(_("statistics")));
+    statisticsEl->setAttribute(_("total_files"), String::from(storage->getTotalFiles()), mxml_int_type);
+
+    Ref<Element> objectTypesEl(new Element(_("object_types")));
+    objectTypesEl->setArrayName(_("object_type"));
+    for (const auto& objectType : storage->getObjectTypeCounts()) {
+        // the invisible parent of the root has no type
+        if (objectType.first == 0)
+            continue;
+        Ref<Element> objectTypeEl(new Element(_("object_type")));
+        objectTypeEl->setAttribute(_("count"), String::from(objectType.second), mxml_int_type);
+        objectTypeEl->setTextKey(_("type"));
+        objectTypeEl->setText(CdsObject::mapObjectType(objectType.first));
+        objectTypesEl->appendElementChild(objectTypeEl);
+    }
+    statisticsEl->appendElementChild(objectTypesEl);
+
+    Ref<Element> mimeTypesEl(new Element(_("mime_types")));
+    mimeTypesEl->setArrayName(_("mime_type"));
+    for (const auto& mimeType : storage->getMimeTypeCounts()) {
+        Ref<Element> mimeTypeEl(new Element(_("mime_type")));
+        mimeTypeEl->setAttribute(_("count"), String::from(mimeType.second), mxml_int_type);
+        mimeTypeEl->setTextKey(_("type"));
+        mimeTypeEl->setText(String(mimeType.first.c_str()));
+        mimeTypesEl->appendElementChild(mimeTypeEl);
+    }
+    statisticsEl->appendElementChild(mimeTypesEl);
+
+    Ref<Element> autoscansEl(new Element(_("autoscans")));
+    autoscansEl->setArrayName(_("autoscan"));
+    Ref<Array<AutoscanDirectory>> autoscanList = ContentManager::getInstance()->getAutoscanDirectories();
+    for (int i = 0; i < autoscanList->size(); i++) {
+        Ref<AutoscanDirectory> autoscanDir = autoscanList->get(i);
+        Ref<Element> autoscanEl(new Element(_("autoscan")));
+        autoscanEl->setAttribute(_("objectID"), String::from(autoscanDir->getObjectID()), mxml_int_type);
+        autoscanEl->appendTextChild(_("location"), autoscanDir->getLocation());
+        autoscanEl->appendTextChild(_("bytes"), String::from(storage->getDirectoryBytes(autoscanDir->getLocation())), mxml_int_type);
+        autoscansEl->appendElementChild(autoscanEl);
+    }
+    statisticsEl->appendElementChild(autoscansEl);
+
+#ifdef HAVE_INOTIFY
+    if (ConfigManager::getInstance()->getBoolOption(CFG_IMPORT_AUTOSCAN_USE_INOTIFY)) {
+        InotifyEventStatistics inotify = ContentManager::getInstance()->getInotifyEventStatistics();
+        Ref<Element> inotifyEl(new Element(_("inotify")));
+        inotifyEl->setAttribute(_("received"), String::from(inotify.received), mxml_int_type);
+        inotifyEl->setAttribute(_("collapsed"), String::from(inotify.collapsed), mxml_int_type);
+        inotifyEl->setAttribute(_("cancelled"), String::from(inotify.cancelled), mxml_int_type);
+        inotifyEl->setAttribute(_("emitted"), String::from(inotify.emitted), mxml_int_type);
+        inotifyEl->setAttribute(_("batches"), String::from(inotify.batches), mxml_int_type);
+        inotifyEl->setAttribute(_("pending"), String::from(inotify.pending), mxml_int_type);
+        inotifyEl->setAttribute(_("max_pending"), String::from(inotify.maxPending), mxml_int_type);
+        statisticsEl->appendElementChild(inotifyEl);
+    }
+#endif
+
+#ifdef HAVE_CURL
+    HTTPClientStatistics http = HTTPClient::getInstance()->getStatistics();
+    Ref<Element> httpEl(new Element(_("http")));
+    httpEl->setAttribute(_("requests"), String::from(http.requests), mxml_int_type);
+    httpEl->setAttribute(_("failed"), String::from(http.failed), mxml_int_type);
+    httpEl->setAttribute(_("connects"), String::from(http.connects), mxml_int_type);
+    httpEl->setAttribute(_("dns_us"), String::from(http.dnsTime), mxml_int_type);
+    httpEl->setAttribute(_("connect_us"), String::from(http.connectTime), mxml_int_type);
+    httpEl->setAttribute(_("tls_us"), String::from(http.tlsTime), mxml_int_type);
+    httpEl->setAttribute(_("total_us"), String::from(http.totalTime), mxml_int_type);
+    httpEl->setAttribute(_("bytes"), String::from(http.bytes), mxml_int_type);
+    statisticsEl->appendElementChild(httpEl);
+#endif
+
+    root->appendElementChild(statisticsEl); // inherited from WebRequestHandler
+}
@@ -46,17 +46,14 @@ void web::tasks::process()
     
     if (action == "list")
     {
-        Ref<Element> tasksEl (new Element(_("tasks")));
-        tasksEl->setArrayName(_("task"));
-        root->appendElementChild(tasksEl); // inherited from WebRequestHandler
+        writer->beginArray("tasks", "task");
         Ref<Array<GenericTask> > taskList = cm->getTasklist();
-        if (taskList == nullptr)
-            return;
-        int count = taskList->size();
+        int count = taskList == nullptr ? 0 : taskList->size();
         for (int i = 0; i < count; i++)
         {
-            appendTask(tasksEl, taskList->get(i));
+            appendTask(writer, taskList->get(i));
         }
+        writer->end();
     }
     else if (action == "cancel")
     {
@@ -123,10 +123,19 @@ Ref<IOHandler> WebRequestHandler::open(IN enum UpnpOpenFileMode mode)
 {
     root = Ref<Element>(new Element(_("root")));
 
+    String returnType = param(_("return_type"));
+    bool returnXML = string_ok(returnType) && returnType == "xml";
+    Ref<JSONWriter> json;
+    if (returnXML)
+        writer = Ref<ResponseWriter>(new ElementWriter(root));
+    else {
+        json = Ref<JSONWriter>(new JSONWriter());
+        writer = RefCast(json, ResponseWriter);
+    }
+
     String error = nullptr;
     int error_code = 0;
 
-    String output;
     // processing page, creating output
     try {
         if (!ConfigManager::getInstance()->getBoolOption(CFG_SERVER_UI_ENABLED)) {
@@ -138,7 +147,7 @@ Ref<IOHandler> WebRequestHandler::open(IN enum UpnpOpenFileMode mode)
 
             if (checkRequestCalled) {
                 // add current task
-                appendTask(root, ContentManager::getInstance()->getCurrentTask());
+                appendTask(writer, ContentManager::getInstance()->getCurrentTask());
 
                 handleUpdateIDs();
             }
@@ -167,18 +176,21 @@ Ref<IOHandler> WebRequestHandler::open(IN enum UpnpOpenFileMode mode)
         root->setAttribute(_("success"), _("1"), mxml_bool_type);
     } else {
         root->setAttribute(_("success"), _("0"), mxml_bool_type);
-        Ref<Element> errorEl(new Element(_("error")));
-        errorEl->setTextKey(_("text"));
-        errorEl->setText(error);
+
+        // the elements a failed request had started are incomplete
+        if (json != nullptr)
+            json->clear();
 
         if (error_code == 0)
             error_code = 899;
-        errorEl->setAttribute(_("code"), String::from(error_code));
-        root->appendElementChild(errorEl);
+        writer->beginObject("error");
+        writer->attribute("code", String::from(error_code));
+        writer->text("text", error);
+        writer->end();
     }
 
-    String returnType = param(_("return_type"));
-    if (string_ok(returnType) && returnType == "xml") {
+    Ref<IOHandler> io_handler;
+    if (returnXML) {
 #ifdef TOMBDEBUG
         try {
             // make sure we can generate JSON w/o exceptions
@@ -188,33 +200,25 @@ Ref<IOHandler> WebRequestHandler::open(IN enum UpnpOpenFileMode mode)
             e.printStackTrace();
         }
 #endif
-        output = renderXMLHeader() + root->print();
+        io_handler = Ref<IOHandler>(new MemIOHandler(renderXMLHeader() + root->print()));
     } else {
+        std::string output;
         try {
-            output = XML2JSON::getJSON(root);
+            // the root element holds the success attribute and the elements
+            // of pages that do not use the writer, the writer adds its members
+            String rootJSON = XML2JSON::getJSON(root);
+            output.reserve(rootJSON.length() + json->getBuffer().length());
+            output.append(rootJSON.c_str(), rootJSON.length() - 1);
+            output.append(json->getBuffer());
+            output += '}';
         } catch (const Exception e) {
             e.printStackTrace();
         }
+        io_handler = Ref<IOHandler>(new MemIOHandler(output.data(), output.length()));
     }
 
-    /*
-    try
-    {
-        printf("%s\n", output.c_str());
-        String json = XML2JSON::getJSON(root);
-        printf("%s\n",json.c_str());
-    }
-    catch (const Exception e)
-    {
-        e.printStackTrace();
-    }
-    */
-
-    //root = nullptr;
-
-    Ref<MemIOHandler> io_handler(new MemIOHandler(output));
     io_handler->open(mode);
-    return RefCast(io_handler, IOHandler);
+    return io_handler;
 }
 
 Ref<IOHandler> WebRequestHandler::open(IN const char* filename,
@@ -238,37 +242,37 @@ void WebRequestHandler::handleUpdateIDs()
 
     String updates = param(_("updates"));
     if (string_ok(updates)) {
-        Ref<Element> updateIDs(new Element(_("update_ids")));
-        root->appendElementChild(updateIDs);
+        writer->beginObject("update_ids");
         if (updates == "check") {
-            updateIDs->setAttribute(_("pending"), session->hasUIUpdateIDs() ? _("1") : _("0"), mxml_bool_type);
+            writer->boolAttribute("pending", session->hasUIUpdateIDs());
         } else if (updates == "get") {
-            addUpdateIDs(updateIDs, session);
+            addUpdateIDs(writer, session);
         }
+        writer->end();
     }
 }
 
-void WebRequestHandler::addUpdateIDs(Ref<Element> updateIDsEl, Ref<Session> session)
+bool WebRequestHandler::addUpdateIDs(Ref<ResponseWriter> writer, Ref<Session> session)
 {
     String updateIDs = session->getUIUpdateIDs();
-    if (string_ok(updateIDs)) {
-        log_debug("UI: sending update ids: %s\n", updateIDs.c_str());
-        updateIDsEl->setTextKey(_("ids"));
-        updateIDsEl->setText(updateIDs);
-        updateIDsEl->setAttribute(_("updates"), _("1"), mxml_bool_type);
-    }
+    if (!string_ok(updateIDs))
+        return false;
+
+    log_debug("UI: sending update ids: %s\n", updateIDs.c_str());
+    writer->attribute("updates", _("1"), mxml_bool_type);
+    writer->text("ids", updateIDs);
+    return true;
 }
 
-void WebRequestHandler::appendTask(Ref<Element> el, Ref<GenericTask> task)
+void WebRequestHandler::appendTask(Ref<ResponseWriter> writer, Ref<GenericTask> task)
 {
-    if (task == nullptr || el == nullptr)
+    if (task == nullptr || writer == nullptr)
         return;
-    Ref<Element> taskEl(new Element(_("task")));
-    taskEl->setAttribute(_("id"), String::from(task->getID()), mxml_int_type);
-    taskEl->setAttribute(_("cancellable"), task->isCancellable() ? _("1") : _("0"), mxml_bool_type);
-    taskEl->setTextKey(_("text"));
-    taskEl->setText(task->getDescription());
-    el->appendElementChild(taskEl);
+    writer->beginObject("task");
+    writer->attribute("id", String::from(task->getID()), mxml_int_type);
+    writer->boolAttribute("cancellable", task->isCancellable());
+    writer->text("text", task->getDescription());
+    writer->end();
 }
 
 String WebRequestHandler::mapAutoscanType(int type)
@@ -69,6 +69,13 @@ protected:
     
     /// \brief This is the root xml element to be populated by process() method.
     zmm::Ref<mxml::Element> root;
+
+    /// \brief Writes the response of the process() method without building
+    /// elements first, JSON goes straight into the output buffer.
+    ///
+    /// The elements of the root element are written before the ones
+    /// of the writer.
+    zmm::Ref<mxml::ResponseWriter> writer;
     
     /// \brief The current session, used for this request; will be filled by
     /// check_request()
@@ -100,20 +107,21 @@ protected:
     /// \todo Genych, chto tut proishodit, ya tolkom che to ne wrubaus?? 
     zmm::Ref<IOHandler> open(IN enum UpnpOpenFileMode mode);
     
-    /// \brief add the ui update ids from the given session as xml tags to the given root element
-    /// \param root the xml element to add the elements to
+    /// \brief add the ui update ids from the given session to the current element
+    /// \param writer the writer of the element to add the ids to
     /// \param session the session from which the ui update ids should be taken
-    void addUpdateIDs(zmm::Ref<mxml::Element> root, zmm::Ref<Session> session);
+    /// \return true if there were update ids
+    bool addUpdateIDs(zmm::Ref<mxml::ResponseWriter> writer, zmm::Ref<Session> session);
     
     /// \brief check if ui update ids should be added to the response and add
     /// them in that case.
     /// must only be called after check_request
     void handleUpdateIDs();
     
-    /// \brief add the content manager task to the given xml element as xml elements
-    /// \param el the xml element to add the elements to
-    /// \param task the task to add to the given xml element
-    void appendTask(zmm::Ref<mxml::Element> el, zmm::Ref<GenericTask> task);
+    /// \brief add the content manager task as child of the current element
+    /// \param writer the writer of the element to add the task to
+    /// \param task the task to add
+    void appendTask(zmm::Ref<mxml::ResponseWriter> writer, zmm::Ref<GenericTask> task);
     
     /// \brief check if accounts are enabled in the config
     /// \return true if accounts are enabled, false if not
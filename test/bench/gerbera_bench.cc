@@ -0,0 +1,605 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  gerbera_bench.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+
+/// \file gerbera_bench.cc
+/// \brief Load test for the storage and ContentDirectory hot paths.
+///
+/// Builds a synthetic library in a fresh SQLite database and reports
+/// latency percentiles, issued queries and allocations per operation as
+/// JSON, so results can be compared between commits. The streaming part
+/// reads one file through many concurrent streams with each file I/O
+/// handler and reports read latencies and CPU time.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include <ixml.h>
+#include <upnp.h>
+
+#include "action_request.h"
+#include "autoscan.h"
+#include "cds_objects.h"
+#include "cds_result_cache.h"
+#include "config/config_generator.h"
+#include "config_manager.h"
+#include "content_manager.h"
+#include "file_io_handler.h"
+#include "metadata_handler.h"
+#include "read_ahead_io_handler.h"
+#include "storage.h"
+#include "tools.h"
+#include "upnp_cds.h"
+
+#ifndef GIT_COMMIT_HASH
+#define GIT_COMMIT_HASH ""
+#endif
+
+using namespace zmm;
+
+static std::atomic<unsigned long> allocationCount(0);
+
+void *operator new(size_t size)
+{
+    allocationCount++;
+    void *ptr = malloc(size ? size : 1);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+
+struct BenchOptions
+{
+    int items = 10000;
+    int perContainer = 100;
+    int iterations = 200;
+    int files = 1000;
+    int rescans = 10;
+    int streams = 32;
+    int streamSize = 16;
+    unsigned int seed = 42;
+    std::string workDir;
+    std::string jsonFile;
+};
+
+struct Measurement
+{
+    std::string name;
+    std::vector<long> micros;
+    unsigned long queries = 0;
+    unsigned long allocations = 0;
+    long cpuMicros = 0;
+};
+
+static std::vector<Measurement> results;
+
+static long cpuMicros()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000L
+        + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+template <typename Op>
+static void measure(const std::string &name, int iterations, Op op)
+{
+    Ref<Storage> storage = Storage::getInstance();
+    Measurement m;
+    m.name = name;
+    m.micros.reserve(iterations);
+
+    unsigned long queries = storage->getQueryCount();
+    unsigned long allocations = allocationCount;
+    long cpu = cpuMicros();
+    for (int i = 0; i < iterations; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        op(i);
+        m.micros.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+    m.queries = storage->getQueryCount() - queries;
+    m.allocations = allocationCount - allocations;
+    m.cpuMicros = cpuMicros() - cpu;
+    results.push_back(m);
+}
+
+static long percentile(std::vector<long> &sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    size_t index = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static void writeResults(std::ostream &out, const BenchOptions &opts)
+{
+    out << "{\n";
+    out << "  \"commit\": \"" << GIT_COMMIT_HASH << "\",\n";
+    out << "  \"items\": " << opts.items << ",\n";
+    out << "  \"per_container\": " << opts.perContainer << ",\n";
+    out << "  \"files\": " << opts.files << ",\n";
+    out << "  \"streams\": " << opts.streams << ",\n";
+    out << "  \"seed\": " << opts.seed << ",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        Measurement &m = results[i];
+        std::vector<long> sorted(m.micros);
+        std::sort(sorted.begin(), sorted.end());
+        long total = 0;
+        for (long v : sorted)
+            total += v;
+        double ops = sorted.empty() ? 1 : sorted.size();
+
+        out << (i > 0 ? "," : "") << "\n    {";
+        out << "\"name\": \"" << m.name << "\", ";
+        out << "\"ops\": " << sorted.size() << ", ";
+        out << "\"mean_us\": " << (long)(total / ops) << ", ";
+        out << "\"p50_us\": " << percentile(sorted, 0.50) << ", ";
+        out << "\"p90_us\": " << percentile(sorted, 0.90) << ", ";
+        out << "\"p99_us\": " << percentile(sorted, 0.99) << ", ";
+        out << "\"max_us\": " << (sorted.empty() ? 0 : sorted.back()) << ", ";
+        out << "\"queries_per_op\": " << m.queries / ops << ", ";
+        out << "\"allocs_per_op\": " << m.allocations / ops << ", ";
+        out << "\"cpu_us_per_op\": " << m.cpuMicros / ops << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void makeDir(const std::string &path)
+{
+    if (mkdir(path.c_str(), 0777) < 0 && errno != EEXIST)
+        throw std::runtime_error("could not create " + path);
+}
+
+static void touch(const std::string &path, const std::string &content = std::string())
+{
+    std::ofstream file(path);
+    file << content;
+}
+
+/// \brief Creates a config with a fresh SQLite database below workDir.
+static void setupConfig(const BenchOptions &opts)
+{
+    makeDir(opts.workDir);
+    makeDir(opts.workDir + DIR_SEPARATOR + "web");
+    std::string jsDir = opts.workDir + DIR_SEPARATOR + "js";
+    makeDir(jsDir);
+    touch(jsDir + DIR_SEPARATOR + DEFAULT_COMMON_SCRIPT);
+    touch(jsDir + DIR_SEPARATOR + DEFAULT_IMPORT_SCRIPT);
+    touch(jsDir + DIR_SEPARATOR + DEFAULT_PLAYLISTS_SCRIPT);
+
+    std::string configDir = opts.workDir + DIR_SEPARATOR + ".config";
+    makeDir(configDir);
+    unlink((configDir + DIR_SEPARATOR + DEFAULT_SQLITE3_DB_FILENAME).c_str());
+
+    ConfigGenerator generator;
+    std::string configFile = configDir + DIR_SEPARATOR + "config.xml";
+    touch(configFile, generator.generate(opts.workDir, ".config", opts.workDir, ""));
+
+    ConfigManager::setStaticArgs(_(configFile.c_str()), _(opts.workDir.c_str()),
+        _(".config"), _(opts.workDir.c_str()), _(""));
+    ConfigManager::getInstance();
+}
+
+/// \brief Adds items/perContainer albums directly through the storage,
+/// every addObject() is one sample.
+static std::vector<int> buildLibrary(const BenchOptions &opts, std::vector<int> &itemIDs)
+{
+    Ref<Storage> storage = Storage::getInstance();
+    std::vector<int> containerIDs;
+    String mimeType = _("audio/mpeg");
+    String protocolInfo = renderProtocolInfo(mimeType);
+
+    measure("storage_add_object", opts.items, [&](int i) {
+        int album = i / opts.perContainer;
+        int artist = album / 10;
+
+        std::ostringstream location;
+        location << "/bench/Artist " << artist << "/Album " << album << "/Track " << i << ".mp3";
+
+        Ref<CdsItem> item(new CdsItem());
+        item->setLocation(_(location.str().c_str()));
+        item->setMimeType(mimeType);
+        item->setClass(_(UPNP_DEFAULT_CLASS_MUSIC_TRACK));
+        item->setTitle(_("Track ") + i);
+        item->setMetadata(MetadataHandler::getMetaFieldName(M_TITLE), _("Track ") + i);
+        item->setMetadata(MetadataHandler::getMetaFieldName(M_ARTIST), _("Artist ") + artist);
+        item->setMetadata(MetadataHandler::getMetaFieldName(M_ALBUM), _("Album ") + album);
+        item->setMetadata(MetadataHandler::getMetaFieldName(M_GENRE), _("Genre ") + (artist % 20));
+        item->setTrackNumber(i % opts.perContainer + 1);
+
+        Ref<CdsResource> resource(new CdsResource(CH_DEFAULT));
+        resource->addAttribute(MetadataHandler::getResAttrName(R_PROTOCOLINFO), protocolInfo);
+        resource->addAttribute(MetadataHandler::getResAttrName(R_SIZE), _("4000000"));
+        item->addResource(resource);
+
+        int changedContainer = INVALID_OBJECT_ID;
+        storage->addObject(RefCast(item, CdsObject), &changedContainer);
+        itemIDs.push_back(item->getID());
+        if (i % opts.perContainer == 0)
+            containerIDs.push_back(item->getParentID());
+    });
+
+    return containerIDs;
+}
+
+static void benchStorage(const BenchOptions &opts, std::vector<int> &containerIDs, std::vector<int> &itemIDs)
+{
+    Ref<Storage> storage = Storage::getInstance();
+    std::mt19937 random(opts.seed);
+    std::uniform_int_distribution<size_t> pickContainer(0, containerIDs.size() - 1);
+
+    measure("storage_browse_children", opts.iterations, [&](int) {
+        Ref<BrowseParam> param(new BrowseParam(containerIDs[pickContainer(random)],
+            BROWSE_DIRECT_CHILDREN | BROWSE_ITEMS | BROWSE_CONTAINERS | BROWSE_EXACT_CHILDCOUNT | BROWSE_TRACK_SORT));
+        param->setRange(0, 50);
+        storage->browse(param);
+    });
+
+    measure("storage_browse_metadata", opts.iterations, [&](int) {
+        Ref<BrowseParam> param(new BrowseParam(containerIDs[pickContainer(random)],
+            BROWSE_ITEMS | BROWSE_CONTAINERS | BROWSE_EXACT_CHILDCOUNT));
+        storage->browse(param);
+    });
+
+    int artists = std::max(1, opts.items / opts.perContainer / 10);
+    std::uniform_int_distribution<int> pickArtist(0, artists - 1);
+    measure("storage_search", opts.iterations, [&](int) {
+        std::ostringstream criteria;
+        criteria << "upnp:class derivedfrom \"object.item.audioItem\" and upnp:artist = \"Artist "
+                 << pickArtist(random) << "\"";
+        Ref<SearchParam> param(new SearchParam("0", criteria.str(), 0, 50));
+        int numMatches = 0;
+        storage->search(param, &numMatches);
+    });
+
+    std::shuffle(itemIDs.begin(), itemIDs.end(), random);
+    int removals = std::min(opts.iterations, (int)itemIDs.size());
+    measure("storage_remove_object", removals, [&](int i) {
+        storage->removeObject(itemIDs[i], false);
+    });
+    itemIDs.erase(itemIDs.begin(), itemIDs.begin() + removals);
+}
+
+static Ref<ActionRequest> createBrowseRequest(int objectID, const char *browseFlag, UpnpActionRequest *upnpRequest)
+{
+    std::ostringstream xml;
+    xml << "<u:Browse xmlns:u=\"" << DESC_CDS_SERVICE_TYPE << "\">"
+        << "<ObjectID>" << objectID << "</ObjectID>"
+        << "<BrowseFlag>" << browseFlag << "</BrowseFlag>"
+        << "<Filter>*</Filter>"
+        << "<StartingIndex>0</StartingIndex>"
+        << "<RequestedCount>50</RequestedCount>"
+        << "<SortCriteria></SortCriteria>"
+        << "</u:Browse>";
+
+    IXML_Document *doc = nullptr;
+    if (ixmlParseBufferEx(xml.str().c_str(), &doc) != IXML_SUCCESS)
+        throw std::runtime_error("could not build Browse request");
+    UpnpActionRequest_strcpy_ActionName(upnpRequest, "Browse");
+    UpnpActionRequest_strcpy_ServiceID(upnpRequest, DESC_CDS_SERVICE_ID);
+    UpnpActionRequest_strcpy_DevUDN(upnpRequest,
+        ConfigManager::getInstance()->getOption(CFG_SERVER_UDN).c_str());
+    UpnpActionRequest_set_ActionRequest(upnpRequest, doc);
+
+    Ref<ActionRequest> request(new ActionRequest(upnpRequest));
+
+    UpnpActionRequest_set_ActionRequest(upnpRequest, nullptr);
+    ixmlDocument_free(doc);
+    return request;
+}
+
+static void benchUpnpBrowse(const BenchOptions &opts, std::vector<int> &containerIDs)
+{
+    ContentDirectoryService cds(0);
+    Ref<CdsResultCache> cache = CdsResultCache::getInstance();
+    UpnpActionRequest *upnpRequest = UpnpActionRequest_new();
+    std::mt19937 random(opts.seed);
+    std::uniform_int_distribution<size_t> pickContainer(0, containerIDs.size() - 1);
+
+    // the request parsing is not part of the measurement
+    std::vector<Ref<ActionRequest>> requests;
+    auto prepare = [&]() {
+        requests.clear();
+        for (int i = 0; i < opts.iterations; i++)
+            requests.push_back(createBrowseRequest(containerIDs[pickContainer(random)],
+                "BrowseDirectChildren", upnpRequest));
+    };
+
+    prepare();
+    measure("cds_browse_uncached", opts.iterations, [&](int i) {
+        cache->clear();
+        cds.process_action_request(requests[i]);
+    });
+
+    // same requests again, served from the result cache where enabled
+    measure("cds_browse_repeated", opts.iterations, [&](int i) {
+        cds.process_action_request(requests[i]);
+    });
+
+    UpnpActionRequest_delete(upnpRequest);
+}
+
+static void waitForTasks(Ref<ContentManager> cm)
+{
+    while (cm->getTasklist() != nullptr)
+        usleep(500);
+}
+
+static void benchImport(const BenchOptions &opts)
+{
+    if (opts.files <= 0)
+        return;
+
+    Ref<ContentManager> cm = ContentManager::getInstance();
+    std::string mediaDir = opts.workDir + DIR_SEPARATOR + "media";
+    makeDir(mediaDir);
+
+    int dirs = (opts.files + opts.perContainer - 1) / opts.perContainer;
+    for (int d = 0; d < dirs; d++)
+    {
+        std::string dir = mediaDir + DIR_SEPARATOR + "dir" + std::to_string(d);
+        makeDir(dir);
+        for (int f = d * opts.perContainer; f < std::min(opts.files, (d + 1) * opts.perContainer); f++)
+            touch(dir + DIR_SEPARATOR + "file" + std::to_string(f) + ".mp3", "ID3");
+    }
+
+    // one sample per directory, the import is synchronous
+    measure("import_directory", dirs, [&](int d) {
+        std::string dir = mediaDir + DIR_SEPARATOR + "dir" + std::to_string(d);
+        cm->addFile(_(dir.c_str()), true, false);
+    });
+
+    int objectID = Storage::getInstance()->findObjectIDByPath(_(mediaDir.c_str()) + DIR_SEPARATOR);
+    if (objectID == INVALID_OBJECT_ID || opts.rescans <= 0)
+        return;
+
+    Ref<AutoscanDirectory> adir(new AutoscanDirectory(_(mediaDir.c_str()), ScanMode::Timed,
+        ScanLevel::Full, true, false, INVALID_SCAN_ID, 24 * 60 * 60));
+    adir->setObjectID(objectID);
+    cm->setAutoscanDirectory(adir);
+    waitForTasks(cm);
+
+    // nothing changed on disk, this is what periodic rescans cost
+    measure("rescan_unchanged", opts.rescans, [&](int) {
+        cm->rescanDirectory(objectID, adir->getScanID(), ScanMode::Timed);
+        waitForTasks(cm);
+    });
+}
+
+#define STREAM_READ_SIZE (64 * 1024)
+
+/// \brief Reads the file through opts.streams concurrent streams, every
+/// read of every stream is one sample.
+static void measureStreams(const std::string &name, const BenchOptions &opts,
+    const std::string &file, std::function<Ref<IOHandler>()> createHandler)
+{
+    Measurement m;
+    m.name = name;
+    std::mutex resultMutex;
+    bool failed = false;
+
+    unsigned long allocations = allocationCount;
+    long cpu = cpuMicros();
+    std::vector<std::thread> threads;
+    for (int s = 0; s < opts.streams; s++)
+    {
+        threads.emplace_back([&, s]() {
+            std::vector<long> micros;
+            std::vector<char> buf(STREAM_READ_SIZE);
+            Ref<IOHandler> handler = createHandler();
+            handler->open(UPNP_READ);
+            // the streams start at different positions, like clients do
+            handler->seek((off_t)s * STREAM_READ_SIZE % (opts.streamSize * 1024 * 1024), SEEK_SET);
+            size_t ret;
+            do
+            {
+                auto start = std::chrono::steady_clock::now();
+                ret = handler->read(buf.data(), buf.size());
+                micros.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+            } while (ret > 0 && ret != (size_t)-1);
+            handler->close();
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            failed = failed || ret == (size_t)-1;
+            m.micros.insert(m.micros.end(), micros.begin(), micros.end());
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    if (failed)
+        throw _Exception(_("reading ") + file.c_str() + " failed in " + name.c_str());
+
+    m.allocations = allocationCount - allocations;
+    m.cpuMicros = cpuMicros() - cpu;
+    results.push_back(m);
+}
+
+static void benchStreaming(const BenchOptions &opts)
+{
+    if (opts.streams <= 0 || opts.streamSize <= 0)
+        return;
+
+    std::string file = opts.workDir + DIR_SEPARATOR + "stream.bin";
+    {
+        std::ofstream out(file, std::ios::binary);
+        std::vector<char> block(1024 * 1024);
+        std::mt19937 random(opts.seed);
+        for (int i = 0; i < opts.streamSize; i++)
+        {
+            for (auto &c : block)
+                c = (char)random();
+            out.write(block.data(), block.size());
+        }
+    }
+    String filename = _(file.c_str());
+    int threads = ConfigManager::getInstance()->getIntOption(CFG_SERVER_READ_AHEAD_THREADS);
+
+    measureStreams("stream_file", opts, file, [&]() {
+        return Ref<IOHandler>(new FileIOHandler(filename));
+    });
+
+    Ref<ReadAheadPool> pool(new ReadAheadPool());
+    pool->start(threads);
+    measureStreams("stream_read_ahead_threads", opts, file, [&]() {
+        return Ref<IOHandler>(new ReadAheadIOHandler(filename, DEFAULT_READ_AHEAD_MAX_WINDOW, pool));
+    });
+    pool->shutdown();
+
+    pool = Ref<ReadAheadPool>(new ReadAheadPool());
+    pool->start(threads, true);
+    if (pool->usesIOUring())
+    {
+        measureStreams("stream_read_ahead_io_uring", opts, file, [&]() {
+            return Ref<IOHandler>(new ReadAheadIOHandler(filename, DEFAULT_READ_AHEAD_MAX_WINDOW, pool));
+        });
+    }
+    pool->shutdown();
+}
+
+static void usage(const char *name)
+{
+    std::cerr << "usage: " << name << " [options]\n"
+              << "  --items N          synthetic items added through the storage (10000)\n"
+              << "  --per-container N  items per container (100)\n"
+              << "  --iterations N     samples per browse/search/remove benchmark (200)\n"
+              << "  --files N          files imported through the content manager (1000)\n"
+              << "  --rescans N        rescans of the imported files (10)\n"
+              << "  --streams N        concurrent streams reading one file (32)\n"
+              << "  --stream-size N    size of the streamed file in MiB (16)\n"
+              << "  --seed N           random seed (42)\n"
+              << "  --workdir DIR      directory for config, database and files\n"
+              << "  --json FILE        write the results to FILE instead of stdout\n";
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions opts;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--help")
+        {
+            usage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+        if (i + 1 >= argc)
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        std::string value = argv[++i];
+        if (arg == "--items")
+            opts.items = std::stoi(value);
+        else if (arg == "--per-container")
+            opts.perContainer = std::stoi(value);
+        else if (arg == "--iterations")
+            opts.iterations = std::stoi(value);
+        else if (arg == "--files")
+            opts.files = std::stoi(value);
+        else if (arg == "--rescans")
+            opts.rescans = std::stoi(value);
+        else if (arg == "--streams")
+            opts.streams = std::stoi(value);
+        else if (arg == "--stream-size")
+            opts.streamSize = std::stoi(value);
+        else if (arg == "--seed")
+            opts.seed = std::stoul(value);
+        else if (arg == "--workdir")
+            opts.workDir = value;
+        else if (arg == "--json")
+            opts.jsonFile = value;
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (opts.items < 1 || opts.perContainer < 1 || opts.iterations < 1)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opts.workDir.empty())
+    {
+        char tmpl[] = "/tmp/gerbera-bench-XXXXXX";
+        if (mkdtemp(tmpl) == nullptr)
+        {
+            perror("mkdtemp");
+            return EXIT_FAILURE;
+        }
+        opts.workDir = tmpl;
+    }
+
+    Ref<SingletonManager> singletonManager = SingletonManager::getInstance();
+    try
+    {
+        setupConfig(opts);
+
+        std::vector<int> itemIDs;
+        std::vector<int> containerIDs = buildLibrary(opts, itemIDs);
+        benchStorage(opts, containerIDs, itemIDs);
+        benchUpnpBrowse(opts, containerIDs);
+        benchImport(opts);
+        benchStreaming(opts);
+    }
+    catch (const Exception &e)
+    {
+        std::cerr << "benchmark failed: " << e.getMessage().c_str() << std::endl;
+        singletonManager->shutdown(true);
+        return EXIT_FAILURE;
+    }
+
+    singletonManager->shutdown(true);
+
+    if (opts.jsonFile.empty())
+        writeResults(std::cout, opts);
+    else
+    {
+        std::ofstream out(opts.jsonFile);
+        writeResults(out, opts);
+    }
+    return EXIT_SUCCESS;
+}
@@ -53,3 +53,32 @@ TEST_F(DictionaryTest, PutWithExistingKeyReplacesValue)
     EXPECT_EQ(3, dictionary2.size());
     EXPECT_EQ(dictionary2.get(String("keyTwo")), String("replacementValue"));
 }
+
+TEST_F(DictionaryTest, CompactEncodingRoundTrip)
+{
+    dictionary1.put(String("plain"), String("value"));
+    dictionary1.put(String("a=b&c"), String("12:34;5|~%20"));
+    dictionary1.put(String("empty"), String(""));
+
+    String encoded = dictionary1.encodeCompact();
+    EXPECT_TRUE(encoded.startsWith(_(COMPACT_ENCODING_PREFIX)));
+
+    Ref<Dictionary> decoded(new Dictionary());
+    decoded->decodeCompact(encoded);
+    EXPECT_EQ(3, decoded->size());
+    EXPECT_TRUE(decoded->equals(dictionary1.clone()));
+    EXPECT_EQ(decoded->get(String("a=b&c")), String("12:34;5|~%20"));
+}
+
+TEST_F(DictionaryTest, CompactDecodingReadsUrlEncoding)
+{
+    Ref<Dictionary> decoded(new Dictionary());
+    decoded->decodeCompact(dictionary2.encode());
+    EXPECT_TRUE(decoded->equals(dictionary2.clone()));
+}
+
+TEST_F(DictionaryTest, CompactDecodingRejectsTruncatedData)
+{
+    String encoded = dictionary2.encodeCompact();
+    EXPECT_THROW(dictionary1.decodeCompact(encoded.substring(0, encoded.length() - 3)), Exception);
+}
@@ -0,0 +1,119 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_directory_walker.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#include <fstream>
+#include <ftw.h>
+#include <map>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "directory_walker.h"
+
+using namespace zmm;
+
+class DirectoryWalkerTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    char dirTemplate[] = "/tmp/gerbera-walker-XXXXXX";
+    ASSERT_NE(mkdtemp(dirTemplate), nullptr);
+    root = dirTemplate;
+
+    // 1 + 3 + 3 * 4 directories, each with two files
+    createDirectory(root);
+    for (int i = 0; i < 3; i++) {
+      std::string dir = root + "/dir" + std::to_string(i);
+      createDirectory(dir);
+      for (int j = 0; j < 4; j++)
+        createDirectory(dir + "/sub" + std::to_string(j));
+    }
+    mkdir((root + "/.hidden").c_str(), 0700);
+  }
+
+  virtual void TearDown() {
+    nftw(root.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+  }
+
+  static int removeEntry(const char *path, const struct stat *sb, int flag, struct FTW *ftwbuf) {
+    return remove(path);
+  }
+
+  void createDirectory(const std::string &dir) {
+    mkdir(dir.c_str(), 0700);
+    std::ofstream(dir + "/a.mp3") << "12345";
+    std::ofstream(dir + "/b.jpg") << "1";
+  }
+
+  std::string root;
+};
+
+TEST_F(DirectoryWalkerTest, ListsDirectoryWithTypesAndStatsRequestedEntries) {
+  DirectoryWalker walker(false, FS_MASK_FILES);
+  std::vector<DirectoryEntry> entries;
+  walker.readDirectory(root, entries);
+
+  std::map<std::string, DirectoryEntry> byName;
+  for (auto &entry : entries)
+    byName[entry.name] = entry;
+
+  ASSERT_EQ(byName.size(), 5u);
+  EXPECT_EQ(byName.count(".hidden"), 0u);
+  EXPECT_TRUE(byName["a.mp3"].isRegular());
+  EXPECT_TRUE(byName["a.mp3"].statValid);
+  EXPECT_EQ(byName["a.mp3"].statbuf.st_size, 5);
+  EXPECT_TRUE(byName["dir0"].isDirectory());
+}
+
+TEST_F(DirectoryWalkerTest, ThrowsForMissingDirectory) {
+  DirectoryWalker walker(false, 0);
+  EXPECT_ANY_THROW(walker.walk(root + "/missing", [](const std::string &, std::vector<DirectoryEntry> &) { return true; }));
+}
+
+TEST_F(DirectoryWalkerTest, VisitsEveryDirectoryOnce) {
+  DirectoryWalker walker(true, FS_MASK_FILES);
+  std::map<std::string, int> visits;
+  int files = 0;
+  walker.walk(root, [&](const std::string &path, std::vector<DirectoryEntry> &entries) {
+    visits[path]++;
+    for (auto &entry : entries) {
+      if (entry.isRegular())
+        files++;
+    }
+    return true;
+  });
+
+  EXPECT_EQ(visits.size(), 17u);
+  for (auto &visit : visits)
+    EXPECT_EQ(visit.second, 1) << visit.first;
+  EXPECT_EQ(visits.count(root + "/.hidden"), 1u);
+  EXPECT_EQ(visits.count(root + "/dir2/sub3"), 1u);
+  EXPECT_EQ(files, 32);
+}
+
+TEST_F(DirectoryWalkerTest, StopsWhenVisitorReturnsFalse) {
+  DirectoryWalker walker(false, 0);
+  int visits = 0;
+  walker.walk(root, [&](const std::string &, std::vector<DirectoryEntry> &) {
+    visits++;
+    return false;
+  });
+  EXPECT_EQ(visits, 1);
+}
@@ -0,0 +1,109 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_file_probe.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "file_probe.h"
+
+using namespace zmm;
+
+class FileProbeTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    char fileTemplate[] = "/tmp/gerbera-probe-XXXXXX";
+    int fd = mkstemp(fileTemplate);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    filename = fileTemplate;
+  }
+
+  virtual void TearDown() {
+    unlink(filename.c_str());
+  }
+
+  void writeFile(const std::string& content) {
+    std::ofstream out(filename, std::ios::binary);
+    out << content;
+  }
+
+  std::string filename;
+};
+
+TEST_F(FileProbeTest, ReadsAnyRangeOfTheFile) {
+  std::string content;
+  for (int i = 0; content.length() < 3 * FILE_PROBE_HEAD_SIZE; i++)
+    content += std::to_string(i) + ',';
+  writeFile(content);
+
+  Ref<FileProbe> probe(new FileProbe(filename.c_str()));
+  ASSERT_EQ(probe->getSize(), (off_t)content.length());
+  ASSERT_EQ(probe->getHeadLength(), (size_t)FILE_PROBE_HEAD_SIZE);
+  EXPECT_EQ(memcmp(probe->getHead(), content.data(), FILE_PROBE_HEAD_SIZE), 0);
+
+  // head, across the end of the head, middle, tail and past the end
+  off_t offsets[] = { 10, FILE_PROBE_HEAD_SIZE - 5, FILE_PROBE_HEAD_SIZE + 1000,
+    (off_t)content.length() - 100, (off_t)content.length() - 4 };
+  for (off_t offset : offsets) {
+    char buffer[64];
+    size_t expected = std::min(sizeof(buffer), content.length() - offset);
+    ASSERT_EQ(probe->read(offset, buffer, sizeof(buffer)), expected);
+    EXPECT_EQ(std::string(buffer, expected), content.substr(offset, expected));
+  }
+
+  char buffer[8];
+  EXPECT_EQ(probe->read(content.length(), buffer, sizeof(buffer)), 0u);
+
+  const char* mapped = probe->map();
+  ASSERT_NE(mapped, nullptr);
+  EXPECT_EQ(std::string(mapped, content.length()), content);
+}
+
+TEST_F(FileProbeTest, ReadsShortFileFromTheHead) {
+  writeFile("short file");
+
+  Ref<FileProbe> probe(new FileProbe(filename.c_str()));
+  char buffer[32];
+  ASSERT_EQ(probe->read(6, buffer, sizeof(buffer)), 4u);
+  EXPECT_EQ(std::string(buffer, 4), "file");
+  EXPECT_EQ(probe->read(20, buffer, sizeof(buffer)), 0u);
+}
+
+TEST_F(FileProbeTest, DetectsTheoraAndFourCC) {
+  std::string ogg = "OggS" + std::string(24, '\0') + "\x80theora" + std::string(100, '\0');
+  writeFile(ogg);
+  EXPECT_TRUE(Ref<FileProbe>(new FileProbe(filename.c_str()))->isTheora());
+
+  ogg.replace(28, 7, "\x01vorbis");
+  writeFile(ogg);
+  EXPECT_FALSE(Ref<FileProbe>(new FileProbe(filename.c_str()))->isTheora());
+
+  std::string avi = "RIFF" + std::string(4, '\0') + "AVI " + std::string(0xbc - 12, '\0') + "XVID" + std::string(100, '\0');
+  writeFile(avi);
+  EXPECT_EQ(std::string(Ref<FileProbe>(new FileProbe(filename.c_str()))->getAVIFourCC().c_str()), "XVID");
+}
+
+TEST_F(FileProbeTest, ThrowsForMissingFile) {
+  EXPECT_THROW(FileProbe(_("/tmp/gerbera-probe-does-not-exist")), Exception);
+}
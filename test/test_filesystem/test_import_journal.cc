@@ -0,0 +1,112 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_import_journal.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#include <fstream>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "import_journal.h"
+
+using namespace zmm;
+
+class ImportJournalTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    char fileTemplate[] = "/tmp/gerbera-journal-XXXXXX";
+    int fd = mkstemp(fileTemplate);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    filename = fileTemplate;
+  }
+
+  virtual void TearDown() {
+    unlink(filename.c_str());
+    unlink((filename + ".tmp").c_str());
+  }
+
+  std::string filename;
+};
+
+TEST_F(ImportJournalTest, ResumesUnfinishedImportWithCheckpointedDirectories) {
+  {
+    Ref<ImportJournal> journal(new ImportJournal(filename));
+    EXPECT_TRUE(journal->getUnfinished().empty());
+
+    int id = journal->begin("/media/music", "/media", false);
+    EXPECT_FALSE(journal->isResumed(id));
+    journal->directoryDone(id, "/media/music/a");
+    journal->directoryDone(id, "/media/music/odd\tname\nwith\\escapes");
+    journal->checkpoint();
+    // never checkpointed, lost with the "crash"
+    journal->directoryDone(id, "/media/music/b");
+  }
+
+  Ref<ImportJournal> journal(new ImportJournal(filename));
+  auto unfinished = journal->getUnfinished();
+  ASSERT_EQ(unfinished.size(), 1u);
+  EXPECT_EQ(unfinished[0].path, "/media/music");
+  EXPECT_EQ(unfinished[0].rootpath, "/media");
+  EXPECT_FALSE(unfinished[0].hidden);
+
+  int id = journal->begin("/media/music", "/media", false);
+  EXPECT_EQ(id, unfinished[0].id);
+  EXPECT_TRUE(journal->isResumed(id));
+  EXPECT_TRUE(journal->isDone(id, "/media/music/a"));
+  EXPECT_TRUE(journal->isDone(id, "/media/music/odd\tname\nwith\\escapes"));
+  EXPECT_FALSE(journal->isDone(id, "/media/music/b"));
+}
+
+TEST_F(ImportJournalTest, ForgetsFinishedImports) {
+  {
+    Ref<ImportJournal> journal(new ImportJournal(filename));
+    int finished = journal->begin("/media/video", "", true);
+    int running = journal->begin("/media/photos", "", true);
+    journal->directoryDone(finished, "/media/video/a");
+    journal->checkpoint();
+    journal->end(finished);
+    journal->directoryDone(running, "/media/photos/2018");
+    journal->checkpoint();
+  }
+  {
+    Ref<ImportJournal> journal(new ImportJournal(filename));
+    auto unfinished = journal->getUnfinished();
+    ASSERT_EQ(unfinished.size(), 1u);
+    EXPECT_EQ(unfinished[0].path, "/media/photos");
+    EXPECT_TRUE(unfinished[0].hidden);
+    journal->end(unfinished[0].id);
+  }
+
+  Ref<ImportJournal> journal(new ImportJournal(filename));
+  EXPECT_TRUE(journal->getUnfinished().empty());
+  std::ifstream in(filename);
+  EXPECT_EQ(in.peek(), std::ifstream::traits_type::eof());
+}
+
+TEST_F(ImportJournalTest, CheckpointIsDueAfterManyDirectories) {
+  Ref<ImportJournal> journal(new ImportJournal(filename));
+  int id = journal->begin("/media", "", false);
+  EXPECT_FALSE(journal->checkpointDue());
+  for (int i = 0; i < IMPORT_JOURNAL_CHECKPOINT_DIRECTORIES; i++)
+    journal->directoryDone(id, "/media/" + std::to_string(i));
+  EXPECT_TRUE(journal->checkpointDue());
+  journal->checkpoint();
+  EXPECT_FALSE(journal->checkpointDue());
+}
@@ -0,0 +1,111 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_inotify_event_aggregator.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#include "gtest/gtest.h"
+#include "inotify_event_aggregator.h"
+
+using namespace zmm;
+using namespace std::chrono;
+
+class InotifyEventAggregatorTest : public ::testing::Test {
+ public:
+  InotifyEventAggregatorTest() : aggregator(100), start(InotifyEventAggregator::Clock::now()) {}
+
+  InotifyEventAggregator::Clock::time_point at(int ms) {
+    return start + milliseconds(ms);
+  }
+
+  std::vector<InotifyWorkItem> takeDue(int ms) {
+    std::vector<InotifyWorkItem> items;
+    aggregator.takeDue(items, at(ms));
+    return items;
+  }
+
+  InotifyEventAggregator aggregator;
+  InotifyEventAggregator::Clock::time_point start;
+};
+
+TEST_F(InotifyEventAggregatorTest, WaitsForTheWindowAfterTheLastEvent) {
+  aggregator.record("/media/a.mp3", InotifyAction::Add, true, nullptr, at(0));
+  aggregator.record("/media/a.mp3", InotifyAction::Update, false, nullptr, at(80));
+
+  EXPECT_TRUE(takeDue(150).empty());
+  EXPECT_EQ(aggregator.getTimeout(at(150)), 30);
+
+  auto items = takeDue(180);
+  ASSERT_EQ(items.size(), 1u);
+  EXPECT_EQ(items[0].path, "/media/a.mp3");
+  // the file was new, there is nothing to remove first
+  EXPECT_EQ(items[0].action, InotifyAction::Add);
+  EXPECT_EQ(aggregator.getTimeout(at(180)), -1);
+}
+
+TEST_F(InotifyEventAggregatorTest, DropsFilesThatCameAndWent) {
+  aggregator.record("/media/tmp.part", InotifyAction::Add, true, nullptr, at(0));
+  aggregator.record("/media/tmp.part", InotifyAction::Update, false, nullptr, at(10));
+  aggregator.record("/media/tmp.part", InotifyAction::Remove, false, nullptr, at(20));
+
+  EXPECT_TRUE(takeDue(1000).empty());
+  InotifyEventStatistics statistics = aggregator.getStatistics();
+  EXPECT_EQ(statistics.received, 3);
+  EXPECT_EQ(statistics.collapsed, 2);
+  EXPECT_EQ(statistics.cancelled, 1);
+  EXPECT_EQ(statistics.pending, 0);
+}
+
+TEST_F(InotifyEventAggregatorTest, ReplacedFileBecomesUpdate) {
+  aggregator.record("/media/a.mp3", InotifyAction::Remove, false, nullptr, at(0));
+  aggregator.record("/media/a.mp3", InotifyAction::Add, false, nullptr, at(10));
+
+  auto items = takeDue(200);
+  ASSERT_EQ(items.size(), 1u);
+  EXPECT_EQ(items[0].action, InotifyAction::Update);
+}
+
+TEST_F(InotifyEventAggregatorTest, HandsOutRemovalsFirst) {
+  aggregator.record("/media/a.mp3", InotifyAction::Add, true, nullptr, at(0));
+  aggregator.record("/media/b.mp3", InotifyAction::Update, false, nullptr, at(1));
+  aggregator.record("/media/c.mp3", InotifyAction::Remove, false, nullptr, at(2));
+
+  auto items = takeDue(200);
+  ASSERT_EQ(items.size(), 3u);
+  EXPECT_EQ(items[0].path, "/media/c.mp3");
+  EXPECT_EQ(aggregator.getStatistics().batches, 1);
+  EXPECT_EQ(aggregator.getStatistics().maxPending, 3);
+}
+
+TEST_F(InotifyEventAggregatorTest, BusyFileIsHandedOutAfterMaximumDelay) {
+  for (int ms = 0; ms < 2000; ms += 50)
+    aggregator.record("/media/growing.ts", InotifyAction::Update, false, nullptr, at(ms));
+
+  auto items = takeDue(100 * INOTIFY_DEBOUNCE_MAX_DELAY_FACTOR);
+  ASSERT_EQ(items.size(), 1u);
+}
+
+TEST_F(InotifyEventAggregatorTest, DiscardsPendingWorkBelowDirectory) {
+  aggregator.record("/media/dir/a.mp3", InotifyAction::Add, true, nullptr, at(0));
+  aggregator.record("/media/other.mp3", InotifyAction::Add, true, nullptr, at(0));
+  aggregator.discardBelow("/media/dir/");
+
+  auto items = takeDue(200);
+  ASSERT_EQ(items.size(), 1u);
+  EXPECT_EQ(items[0].path, "/media/other.mp3");
+}
@@ -0,0 +1,74 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_path_table.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#include "gtest/gtest.h"
+#include "path_table.h"
+
+TEST(PathTableTest, InternsPathsBelowTheirParents) {
+  PathTable table;
+  uint32_t music = table.add("/media/music/");
+  uint32_t video = table.add("/media/video");
+
+  EXPECT_EQ(table.getPath(music), "/media/music/");
+  EXPECT_EQ(table.getPath(video), "/media/video/");
+  EXPECT_EQ(table.getPath(PATH_TABLE_ROOT), "/");
+  // root, media, music and video
+  EXPECT_EQ(table.size(), 4u);
+
+  EXPECT_EQ(table.add("/media//music"), music);
+  EXPECT_EQ(table.find("/media/music"), music);
+  EXPECT_EQ(table.find("/media/photos"), PATH_TABLE_NONE);
+  EXPECT_NE(table.find("/media"), PATH_TABLE_NONE);
+}
+
+TEST(PathTableTest, KeepsValues) {
+  PathTable table;
+  uint32_t node = table.add("/media/music");
+  EXPECT_EQ(table.getValue(node), -1);
+  table.setValue(node, 42);
+  EXPECT_EQ(table.getValue(table.find("/media/music/")), 42);
+}
+
+TEST(PathTableTest, RemovesPathsWithoutReferences) {
+  PathTable table;
+  uint32_t parent = table.add("/media");
+  uint32_t child = table.add("/media/music/rock");
+  uint32_t twice = table.add("/media/music/rock");
+  EXPECT_EQ(child, twice);
+
+  table.remove(child);
+  EXPECT_EQ(table.find("/media/music/rock"), child);
+
+  table.remove(twice);
+  EXPECT_EQ(table.find("/media/music/rock"), PATH_TABLE_NONE);
+  EXPECT_EQ(table.find("/media/music"), PATH_TABLE_NONE);
+  EXPECT_EQ(table.find("/media"), parent);
+  EXPECT_EQ(table.size(), 2u);
+
+  // freed entries are reused
+  uint32_t other = table.add("/media/video");
+  EXPECT_EQ(table.getPath(other), "/media/video/");
+  EXPECT_EQ(table.size(), 3u);
+
+  table.remove(parent);
+  table.remove(other);
+  EXPECT_EQ(table.size(), 1u);
+}
@@ -0,0 +1,124 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_cds_result_cache.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#include "gtest/gtest.h"
+#include "cds_result_cache.h"
+
+using namespace zmm;
+
+// The singleton reads its capacity from the configuration.
+class TestCdsResultCache : public CdsResultCache {
+ public:
+  explicit TestCdsResultCache(size_t capacity) {
+    this->capacity = capacity;
+  }
+};
+
+class CdsResultCacheTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    cache = Ref<CdsResultCache>(new TestCdsResultCache(3));
+  }
+
+  void put(const std::string &key, std::vector<int> dependsOn, bool anyChange = false) {
+    put(key, dependsOn, anyChange, cache->getGeneration());
+  }
+
+  void put(const std::string &key, std::vector<int> dependsOn, bool anyChange, unsigned long generation) {
+    CdsCachedResult result;
+    result.didl = "<DIDL-Lite>" + key + "</DIDL-Lite>";
+    result.numberReturned = 1;
+    result.totalMatches = 7;
+    cache->put(key, result, dependsOn, anyChange, generation);
+  }
+
+  bool cached(const std::string &key) {
+    CdsCachedResult result;
+    return cache->get(key, result);
+  }
+
+  Ref<CdsResultCache> cache;
+};
+
+TEST_F(CdsResultCacheTest, ReturnsAStoredReply) {
+  put("Browse\n1", { 1, 0 });
+
+  CdsCachedResult result;
+  ASSERT_TRUE(cache->get("Browse\n1", result));
+  EXPECT_EQ(result.didl, "<DIDL-Lite>Browse\n1</DIDL-Lite>");
+  EXPECT_EQ(result.numberReturned, 1);
+  EXPECT_EQ(result.totalMatches, 7);
+  EXPECT_FALSE(cached("Browse\n2"));
+}
+
+TEST_F(CdsResultCacheTest, DropsOnlyRepliesOfAChangedContainer) {
+  put("Browse\n1", { 1, 0 });
+  put("Browse\n2", { 2, 0 });
+  put("Search\n0", {}, true);
+
+  cache->invalidate(1);
+  EXPECT_FALSE(cached("Browse\n1"));
+  EXPECT_TRUE(cached("Browse\n2"));
+  EXPECT_FALSE(cached("Search\n0"));
+
+  cache->invalidate(0);
+  EXPECT_FALSE(cached("Browse\n2"));
+  EXPECT_EQ(cache->size(), 0u);
+}
+
+TEST_F(CdsResultCacheTest, DoesNotStoreAReplyThatRacedWithAChange) {
+  unsigned long generation = cache->getGeneration();
+  cache->invalidate(1);
+
+  // rendered before the change of its container
+  put("Browse\n1", { 1, 0 }, false, generation);
+  EXPECT_FALSE(cached("Browse\n1"));
+
+  // another container changing does not matter
+  put("Browse\n2", { 2, 0 }, false, generation);
+  EXPECT_TRUE(cached("Browse\n2"));
+
+  put("Search\n0", {}, true, generation);
+  EXPECT_FALSE(cached("Search\n0"));
+
+  generation = cache->getGeneration();
+  cache->clear();
+  put("Browse\n2", { 2, 0 }, false, generation);
+  EXPECT_FALSE(cached("Browse\n2"));
+}
+
+TEST_F(CdsResultCacheTest, EvictsTheLeastRecentlyUsedReply) {
+  put("a", { 1 });
+  put("b", { 2 });
+  put("c", { 3 });
+  EXPECT_TRUE(cached("a"));
+
+  put("d", { 4 });
+  EXPECT_EQ(cache->size(), 3u);
+  EXPECT_TRUE(cached("a"));
+  EXPECT_FALSE(cached("b"));
+  EXPECT_TRUE(cached("c"));
+  EXPECT_TRUE(cached("d"));
+
+  // the evicted entry is gone from the dependencies as well
+  cache->invalidate(2);
+  EXPECT_EQ(cache->size(), 3u);
+}
@@ -0,0 +1,183 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_http_client.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#ifdef HAVE_CURL
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <mutex>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "http_client.h"
+
+using namespace zmm;
+
+// Answers every request on a connection with a short body and keeps the
+// connection open, counts the connections it accepted.
+class KeepAliveServer {
+ public:
+  KeepAliveServer() : accepted(0) {
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(listenFd, (struct sockaddr*)&addr, sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(listenFd, (struct sockaddr*)&addr, &len);
+    port = ntohs(addr.sin_port);
+    listen(listenFd, 8);
+    thread = std::thread([this]() { serve(); });
+  }
+
+  ~KeepAliveServer() {
+    ::shutdown(listenFd, SHUT_RDWR);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      // the client keeps its connections open
+      for (int fd : fds)
+        ::shutdown(fd, SHUT_RDWR);
+    }
+    thread.join();
+    close(listenFd);
+  }
+
+  std::string url(const char* path) {
+    return "http://127.0.0.1:" + std::to_string(port) + path;
+  }
+
+  std::atomic<int> accepted;
+
+ protected:
+  int listenFd;
+  int port;
+  std::thread thread;
+  std::mutex mutex;
+  std::vector<int> fds;
+
+  void serve() {
+    std::vector<std::thread> connections;
+    int fd;
+    while ((fd = accept(listenFd, nullptr, nullptr)) >= 0) {
+      accepted++;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        fds.push_back(fd);
+      }
+      connections.emplace_back([fd]() {
+        char buf[4096];
+        std::string request;
+        ssize_t ret;
+        while ((ret = read(fd, buf, sizeof(buf))) > 0) {
+          request.append(buf, ret);
+          size_t end;
+          while ((end = request.find("\r\n\r\n")) != std::string::npos) {
+            request.erase(0, end + 4);
+            const char reply[] = "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello";
+            write(fd, reply, sizeof(reply) - 1);
+          }
+        }
+        close(fd);
+      });
+    }
+    for (auto& connection : connections)
+      connection.join();
+  }
+};
+
+static size_t collect(void* buf, size_t size, size_t nmemb, void* data) {
+  ((std::string*)data)->append((char*)buf, size * nmemb);
+  return size * nmemb;
+}
+
+class HTTPClientTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    client = Ref<HTTPClient>(new HTTPClient());
+    client->start(2);
+  }
+
+  virtual void TearDown() {
+    client->shutdown();
+  }
+
+  std::string fetch(CURL* handle, std::string url) {
+    std::string body;
+    curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, collect);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &body);
+    CURLcode res = curl_easy_perform(handle);
+    client->recordTransfer(handle, res);
+    return body;
+  }
+
+  Ref<HTTPClient> client;
+};
+
+TEST_F(HTTPClientTest, ReusesTheConnectionAcrossHandles) {
+  KeepAliveServer server;
+  CURL* first = client->getHandle();
+  CURL* second = client->getHandle();
+  EXPECT_EQ(fetch(first, server.url("/a")), "hello");
+  EXPECT_EQ(fetch(second, server.url("/b")), "hello");
+  client->returnHandle(first);
+  client->returnHandle(second);
+
+  HTTPClientStatistics statistics = client->getStatistics();
+  EXPECT_EQ(statistics.requests, 2);
+  EXPECT_EQ(statistics.failed, 0);
+  EXPECT_EQ(statistics.connects, 1);
+  EXPECT_EQ(statistics.bytes, 10);
+  EXPECT_EQ(server.accepted, 1);
+}
+
+TEST_F(HTTPClientTest, LimitsFetchesPerHost) {
+  std::atomic<int> running(0);
+  std::atomic<int> maxRunning(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 6; i++) {
+    threads.emplace_back([&]() {
+      HTTPClient::HostSlot slot(client, _("http://Example.com:8080/feed.xml"));
+      int now = ++running;
+      int seen = maxRunning;
+      while (now > seen && !maxRunning.compare_exchange_weak(seen, now))
+        ;
+      usleep(10000);
+      running--;
+    });
+  }
+  // another host is not held up
+  HTTPClient::HostSlot other(client, _("http://example.org/"));
+  for (auto& thread : threads)
+    thread.join();
+  EXPECT_EQ(maxRunning, 2);
+}
+
+TEST_F(HTTPClientTest, ExtractsTheHost) {
+  EXPECT_EQ(HTTPClient::getHost(_("http://Example.com/a/b?c")), "example.com");
+  EXPECT_EQ(HTTPClient::getHost(_("https://user:pw@example.com:8443")), "example.com:8443");
+  EXPECT_EQ(HTTPClient::getHost(_("example.com?x")), "example.com");
+}
+
+#endif // HAVE_CURL
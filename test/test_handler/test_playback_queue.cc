@@ -0,0 +1,112 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_playback_queue.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "playback_queue.h"
+
+using namespace zmm;
+
+static PlaybackEvent started(int itemID, const std::string& client, time_t time) {
+  PlaybackEvent event;
+  event.itemID = itemID;
+  event.client = client;
+  event.time = time;
+  event.started = true;
+  event.position = 0;
+  return event;
+}
+
+static PlaybackEvent stopped(int itemID, const std::string& client, time_t time, off_t position) {
+  PlaybackEvent event = started(itemID, client, time);
+  event.started = false;
+  event.position = position;
+  return event;
+}
+
+TEST(PlaybackQueueTest, TakesEventsFromAllThreadsInPushOrder) {
+  Ref<PlaybackQueue> queue(new PlaybackQueue());
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([queue, t]() {
+      for (int i = 0; i < 1000; i++)
+        queue->push(started(t, "client", i));
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  auto events = queue->takeAll();
+  ASSERT_EQ(events.size(), 4000u);
+  std::vector<time_t> last(4, -1);
+  for (auto& event : events) {
+    EXPECT_GT(event.time, last[event.itemID]);
+    last[event.itemID] = event.time;
+  }
+  EXPECT_TRUE(queue->takeAll().empty());
+}
+
+TEST(PlaybackQueueTest, CountsRepeatedOpensByOneClientOnce) {
+  Ref<PlaybackQueue> queue(new PlaybackQueue());
+  queue->push(started(7, "192.168.1.2", 100));
+  queue->push(stopped(7, "192.168.1.2", 101, 4096));
+  queue->push(started(7, "192.168.1.2", 110));
+  queue->push(stopped(7, "192.168.1.2", 180, 1048576));
+  queue->push(started(7, "192.168.1.3", 120));
+
+  std::vector<Ref<CdsObject>> counted;
+  auto changes = queue->aggregate(queue->takeAll(), counted);
+  ASSERT_EQ(changes.size(), 2u);
+
+  EXPECT_EQ(changes[0].itemID, 7);
+  EXPECT_EQ(changes[0].client, "192.168.1.2");
+  EXPECT_EQ(changes[0].playCount, 1);
+  EXPECT_EQ(changes[0].lastPlayed, 180);
+  EXPECT_EQ(changes[0].position, 1048576);
+
+  EXPECT_EQ(changes[1].client, "192.168.1.3");
+  EXPECT_EQ(changes[1].playCount, 1);
+  EXPECT_EQ(changes[1].position, 0);
+}
+
+TEST(PlaybackQueueTest, CountsAgainAfterTheReplayWindow) {
+  Ref<PlaybackQueue> queue(new PlaybackQueue());
+  std::vector<Ref<CdsObject>> counted;
+
+  queue->push(started(3, "client", 1000));
+  auto changes = queue->aggregate(queue->takeAll(), counted);
+  ASSERT_EQ(changes.size(), 1u);
+  EXPECT_EQ(changes[0].playCount, 1);
+
+  // a later batch still knows about the recent start
+  queue->push(started(3, "client", 1000 + PLAYBACK_QUEUE_REPLAY_SECONDS - 1));
+  changes = queue->aggregate(queue->takeAll(), counted);
+  ASSERT_EQ(changes.size(), 1u);
+  EXPECT_EQ(changes[0].playCount, 0);
+  EXPECT_EQ(changes[0].position, -1);
+
+  queue->push(started(3, "client", 1000 + 3 * PLAYBACK_QUEUE_REPLAY_SECONDS));
+  changes = queue->aggregate(queue->takeAll(), counted);
+  ASSERT_EQ(changes.size(), 1u);
+  EXPECT_EQ(changes[0].playCount, 1);
+  EXPECT_EQ(changes[0].position, 0);
+}
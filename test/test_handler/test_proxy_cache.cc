@@ -0,0 +1,229 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_proxy_cache.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "proxy_cache_io_handler.h"
+
+using namespace zmm;
+
+#define TEST_SEGMENT_SIZE 10000
+#define TEST_PIECE_SIZE 1000
+
+// Stands in for the transfer from the remote server, serves a string
+// starting at the requested offset like a range request would, in pieces
+// like they arrive from the network. Without range support a transfer
+// that does not start at 0 fails, like curl does when the server ignores
+// the Range header.
+class UpstreamIOHandler : public IOHandler {
+ public:
+  UpstreamIOHandler(const std::string& data, off_t offset, bool ranges = true)
+      : data(data), offset(offset), ranges(ranges) {}
+
+  void open(IN enum UpnpOpenFileMode mode) override {}
+  size_t read(OUT char* buf, IN size_t length) override {
+    if (!ranges && offset > 0)
+      return -1;
+    ranges = true;
+    if (offset >= (off_t)data.size())
+      return 0;
+    size_t count = std::min(std::min(length, (size_t)TEST_PIECE_SIZE), data.size() - offset);
+    memcpy(buf, data.data() + offset, count);
+    offset += count;
+    return count;
+  }
+  void close() override {}
+
+  const std::string& data;
+  off_t offset;
+  bool ranges;
+};
+
+class ProxyCacheTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    char name[] = "/tmp/gerbera_proxy_cache_XXXXXX";
+    ASSERT_NE(mkdtemp(name), nullptr);
+    location = name;
+    content.resize(TEST_SEGMENT_SIZE * 5 / 2);
+    for (size_t i = 0; i < content.size(); i++)
+      content[i] = (char)(i * 7 + i / 251);
+
+    cache = Ref<ProxyCache>(new ProxyCache());
+    cache->start(String(location.c_str()), 1024 * 1024, TEST_SEGMENT_SIZE);
+  }
+
+  virtual void TearDown() {
+    cache->shutdown();
+    rmdir(location.c_str());
+  }
+
+  Ref<IOHandler> open(String url, off_t size = -1, String validator = nullptr) {
+    Ref<IOHandler> handler(new ProxyCacheIOHandler(cache, url, size, validator, [this](off_t offset) {
+      fetches.push_back(offset);
+      return Ref<IOHandler>(new UpstreamIOHandler(content, offset, rangeSupport));
+    }));
+    handler->open(UPNP_READ);
+    return handler;
+  }
+
+  std::string readAll(Ref<IOHandler> handler, size_t blockSize) {
+    std::string data;
+    std::vector<char> buf(blockSize);
+    size_t ret;
+    while ((ret = handler->read(buf.data(), buf.size())) > 0) {
+      if (ret == (size_t)-1)
+        break;
+      data.append(buf.data(), ret);
+    }
+    return data;
+  }
+
+  std::string location;
+  std::string content;
+  Ref<ProxyCache> cache;
+  std::vector<off_t> fetches;
+  bool rangeSupport = true;
+};
+
+TEST_F(ProxyCacheTest, ServesAReplayFromTheCache) {
+  Ref<IOHandler> handler = open(_("http://example.com/a.mp3"));
+  EXPECT_EQ(readAll(handler, 3000), content);
+  handler->close();
+  EXPECT_EQ(fetches, std::vector<off_t>({ 0 }));
+  EXPECT_EQ(cache->getBytes(), content.size());
+
+  handler = open(_("http://example.com/a.mp3"));
+  EXPECT_EQ(readAll(handler, 4096), content);
+  handler->close();
+  EXPECT_EQ(fetches.size(), 1u);
+}
+
+TEST_F(ProxyCacheTest, FetchesARangeFromTheStartOfItsSegment) {
+  Ref<IOHandler> handler = open(_("http://example.com/a.mp3"), content.size());
+  handler->seek(-1000, SEEK_END);
+  EXPECT_EQ(readAll(handler, 3000), content.substr(content.size() - 1000));
+  handler->close();
+  EXPECT_EQ(fetches, std::vector<off_t>({ 2 * TEST_SEGMENT_SIZE }));
+
+  // the first segments were not cached, the last one is
+  handler = open(_("http://example.com/a.mp3"));
+  EXPECT_EQ(readAll(handler, 3000), content);
+  handler->close();
+  EXPECT_EQ(fetches, std::vector<off_t>({ 2 * TEST_SEGMENT_SIZE, 0 }));
+}
+
+TEST_F(ProxyCacheTest, ContinuesAPartialFill) {
+  char buf[TEST_PIECE_SIZE];
+  Ref<IOHandler> handler = open(_("http://example.com/a.mp3"));
+  ASSERT_EQ(handler->read(buf, sizeof(buf)), sizeof(buf));
+  handler->close();
+
+  handler = open(_("http://example.com/a.mp3"));
+  handler->seek(4000, SEEK_SET);
+  ASSERT_EQ(handler->read(buf, sizeof(buf)), sizeof(buf));
+  EXPECT_EQ(std::string(buf, sizeof(buf)), content.substr(4000, sizeof(buf)));
+
+  // data before the fill offset comes from the cache
+  handler->seek(0, SEEK_SET);
+  ASSERT_EQ(handler->read(buf, sizeof(buf)), sizeof(buf));
+  EXPECT_EQ(std::string(buf, sizeof(buf)), content.substr(0, sizeof(buf)));
+  handler->close();
+  EXPECT_EQ(fetches, std::vector<off_t>({ 0, TEST_PIECE_SIZE }));
+}
+
+TEST_F(ProxyCacheTest, EvictsTheLeastRecentlyUsedURL) {
+  cache->shutdown();
+  cache = Ref<ProxyCache>(new ProxyCache());
+  cache->start(String(location.c_str()), content.size() * 2, TEST_SEGMENT_SIZE);
+
+  Ref<IOHandler> handler;
+  const char* urls[] = { "http://example.com/a", "http://example.com/b", "http://example.com/a", "http://example.com/c" };
+  for (const char* url : urls) {
+    handler = open(_(url));
+    EXPECT_EQ(readAll(handler, 8192), content);
+    handler->close();
+  }
+
+  EXPECT_TRUE(cache->contains(_("http://example.com/a")));
+  EXPECT_FALSE(cache->contains(_("http://example.com/b")));
+  EXPECT_TRUE(cache->contains(_("http://example.com/c")));
+  EXPECT_LE(cache->getBytes(), content.size() * 2);
+  EXPECT_EQ(fetches.size(), 3u);
+}
+
+TEST_F(ProxyCacheTest, KeepsAURLThatIsStreamed) {
+  cache->shutdown();
+  cache = Ref<ProxyCache>(new ProxyCache());
+  cache->start(String(location.c_str()), content.size(), TEST_SEGMENT_SIZE);
+
+  Ref<IOHandler> first = open(_("http://example.com/a"));
+  EXPECT_EQ(readAll(first, 8192), content);
+  Ref<IOHandler> second = open(_("http://example.com/b"));
+  EXPECT_EQ(readAll(second, 8192), content);
+  EXPECT_TRUE(cache->contains(_("http://example.com/a")));
+  first->close();
+  second->close();
+  EXPECT_FALSE(cache->contains(_("http://example.com/a")));
+  EXPECT_TRUE(cache->contains(_("http://example.com/b")));
+}
+
+TEST_F(ProxyCacheTest, ReadsFromTheStartWithoutRangeSupport) {
+  rangeSupport = false;
+  char buf[TEST_PIECE_SIZE];
+  Ref<IOHandler> handler = open(_("http://example.com/a.mp3"), content.size());
+  handler->seek(TEST_SEGMENT_SIZE * 3 / 2, SEEK_SET);
+  ASSERT_EQ(handler->read(buf, sizeof(buf)), sizeof(buf));
+  EXPECT_EQ(std::string(buf, sizeof(buf)), content.substr(TEST_SEGMENT_SIZE * 3 / 2, sizeof(buf)));
+
+  // the running transfer has not passed the next miss yet
+  handler->seek(-1000, SEEK_END);
+  EXPECT_EQ(readAll(handler, 3000), content.substr(content.size() - 1000));
+  handler->close();
+  EXPECT_EQ(fetches, std::vector<off_t>({ TEST_SEGMENT_SIZE, 0 }));
+
+  // the data up to the misses was cached on the way
+  handler = open(_("http://example.com/a.mp3"), content.size());
+  EXPECT_EQ(readAll(handler, 4096), content);
+  handler->close();
+  EXPECT_EQ(fetches.size(), 2u);
+}
+
+TEST_F(ProxyCacheTest, DropsTheDataOfAChangedURL) {
+  Ref<IOHandler> handler = open(_("http://example.com/a.mp3"), content.size(), _("\"v1\""));
+  EXPECT_EQ(readAll(handler, 8192), content);
+  handler->close();
+
+  handler = open(_("http://example.com/a.mp3"), content.size(), _("\"v1\""));
+  EXPECT_EQ(readAll(handler, 8192), content);
+  handler->close();
+  EXPECT_EQ(fetches.size(), 1u);
+
+  handler = open(_("http://example.com/a.mp3"), content.size(), _("\"v2\""));
+  EXPECT_EQ(readAll(handler, 8192), content);
+  handler->close();
+  EXPECT_EQ(fetches.size(), 2u);
+  EXPECT_EQ(cache->getBytes(), content.size());
+}
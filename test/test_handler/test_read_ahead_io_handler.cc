@@ -0,0 +1,147 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_read_ahead_io_handler.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#include <cstdio>
+#include <thread>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "read_ahead_io_handler.h"
+
+using namespace zmm;
+
+class ReadAheadIOHandlerTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    char name[] = "/tmp/gerbera_read_ahead_XXXXXX";
+    int fd = mkstemp(name);
+    ASSERT_GE(fd, 0);
+    filename = name;
+    // three and a half chunks, every byte tells its offset
+    content.resize(READ_AHEAD_CHUNK_SIZE * 7 / 2);
+    for (size_t i = 0; i < content.size(); i++)
+      content[i] = (char)(i * 7 + i / 251);
+    ASSERT_EQ(write(fd, content.data(), content.size()), (ssize_t)content.size());
+    close(fd);
+
+    pool = Ref<ReadAheadPool>(new ReadAheadPool());
+    pool->start(2);
+  }
+
+  virtual void TearDown() {
+    pool->shutdown();
+    unlink(filename.c_str());
+  }
+
+  Ref<ReadAheadIOHandler> open() {
+    Ref<ReadAheadIOHandler> handler(new ReadAheadIOHandler(String(filename.c_str()), READ_AHEAD_MIN_WINDOW, pool));
+    handler->open(UPNP_READ);
+    return handler;
+  }
+
+  std::string readAll(Ref<ReadAheadIOHandler> handler, size_t blockSize) {
+    std::string data;
+    std::vector<char> buf(blockSize);
+    size_t ret;
+    while ((ret = handler->read(buf.data(), buf.size())) > 0) {
+      if (ret == (size_t)-1)
+        break;
+      data.append(buf.data(), ret);
+    }
+    return data;
+  }
+
+  std::string filename;
+  std::string content;
+  Ref<ReadAheadPool> pool;
+};
+
+TEST_F(ReadAheadIOHandlerTest, ReadsTheWholeFile) {
+  Ref<ReadAheadIOHandler> handler = open();
+  EXPECT_EQ(readAll(handler, 10000), content);
+  handler->close();
+}
+
+TEST_F(ReadAheadIOHandlerTest, SeeksWithinAndBeyondTheWindow) {
+  Ref<ReadAheadIOHandler> handler = open();
+  char buf[100];
+  ASSERT_EQ(handler->read(buf, sizeof(buf)), sizeof(buf));
+
+  // forward within the data read ahead
+  handler->seek(1000, SEEK_SET);
+  ASSERT_EQ(handler->read(buf, sizeof(buf)), sizeof(buf));
+  EXPECT_EQ(std::string(buf, sizeof(buf)), content.substr(1000, sizeof(buf)));
+
+  // backwards, the data read ahead is dropped
+  handler->seek(-600, SEEK_CUR);
+  ASSERT_EQ(handler->read(buf, sizeof(buf)), sizeof(buf));
+  EXPECT_EQ(std::string(buf, sizeof(buf)), content.substr(500, sizeof(buf)));
+
+  handler->seek(-READ_AHEAD_CHUNK_SIZE, SEEK_END);
+  EXPECT_EQ(readAll(handler, 4096), content.substr(content.size() - READ_AHEAD_CHUNK_SIZE));
+  handler->close();
+}
+
+TEST_F(ReadAheadIOHandlerTest, ClosesWhileReadingAhead) {
+  for (int i = 0; i < 20; i++) {
+    Ref<ReadAheadIOHandler> handler = open();
+    handler->seek(i * 4096, SEEK_SET);
+    handler->close();
+  }
+}
+
+TEST_F(ReadAheadIOHandlerTest, FailsReadsAfterThePoolWasShutDown) {
+  Ref<ReadAheadIOHandler> handler = open();
+  char buf[100];
+  ASSERT_EQ(handler->read(buf, sizeof(buf)), sizeof(buf));
+  pool->shutdown();
+  handler->seek(0, SEEK_END);
+  handler->seek(0, SEEK_SET);
+  EXPECT_EQ(handler->read(buf, sizeof(buf)), (size_t)-1);
+  handler->close();
+}
+
+TEST_F(ReadAheadIOHandlerTest, ReadsManyStreamsThroughIOUring) {
+  pool->shutdown();
+  pool = Ref<ReadAheadPool>(new ReadAheadPool());
+  pool->start(2, true);
+#ifdef HAVE_IO_URING
+  if (!pool->usesIOUring())
+    return; // the kernel lacks io_uring, the threads were tested above
+#else
+  ASSERT_FALSE(pool->usesIOUring());
+#endif
+
+  std::vector<std::thread> threads;
+  std::vector<std::string> results(16);
+  for (size_t i = 0; i < results.size(); i++) {
+    threads.emplace_back([this, i, &results]() {
+      Ref<ReadAheadIOHandler> handler = open();
+      handler->seek(i * 1000, SEEK_SET);
+      results[i] = readAll(handler, 16384);
+      handler->close();
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  for (size_t i = 0; i < results.size(); i++)
+    EXPECT_EQ(results[i], content.substr(i * 1000));
+}
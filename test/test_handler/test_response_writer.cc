@@ -0,0 +1,93 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_response_writer.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#include <functional>
+
+#include "gtest/gtest.h"
+#include "mxml/mxml.h"
+
+using namespace zmm;
+using namespace mxml;
+
+// writes the same response through both writers, the JSON has to match
+// what XML2JSON makes of the elements
+static void expectSameJSON(std::function<void(Ref<ResponseWriter>)> write) {
+  Ref<Element> root(new Element(_("root")));
+  root->setAttribute(_("success"), _("1"), mxml_bool_type);
+  write(Ref<ResponseWriter>(new ElementWriter(root)));
+  String expected = XML2JSON::getJSON(root);
+
+  Ref<JSONWriter> json(new JSONWriter());
+  write(RefCast(json, ResponseWriter));
+  std::string actual = "{\"success\":true" + json->getBuffer() + "}";
+
+  EXPECT_EQ(actual, std::string(expected.c_str()));
+}
+
+TEST(ResponseWriterTest, WritesArraysLikeXML2JSON) {
+  expectSameJSON([](Ref<ResponseWriter> writer) {
+    writer->beginArray("items", "item");
+    writer->attribute("parent_id", 12);
+    writer->attribute("location", _("/Music/\"Best\" of\\"));
+    writer->boolAttribute("virtual", true);
+    for (int i = 0; i < 3; i++) {
+      writer->beginObject("item");
+      writer->attribute("id", i);
+      writer->textChild("title", _("Track ") + i);
+      writer->textChild("res", nullptr);
+      writer->end();
+    }
+    writer->end();
+
+    writer->beginArray("tasks", "task");
+    writer->end();
+  });
+}
+
+TEST(ResponseWriterTest, WritesTextLikeXML2JSON) {
+  expectSameJSON([](Ref<ResponseWriter> writer) {
+    writer->beginObject("task");
+    writer->attribute("id", _("3"), mxml_int_type);
+    writer->boolAttribute("cancellable", false);
+    writer->text("text", _("Importing: /media"));
+    writer->end();
+
+    // without attributes the element is written as its text
+    writer->beginObject("update_ids");
+    writer->end();
+    writer->beginObject("config");
+    writer->text("value", _("42"), mxml_int_type);
+    writer->end();
+
+    writer->beginObject("error");
+    writer->attribute("code", _("800"));
+    writer->text("text", _("Error: \"x\""));
+    writer->end();
+  });
+}
+
+TEST(ResponseWriterTest, RejectsAttributesAfterArrayItems) {
+  Ref<JSONWriter> json(new JSONWriter());
+  json->beginArray("files", "file");
+  json->textChild("file", _("a"));
+  EXPECT_THROW(json->attribute("location", _("/")), Exception);
+  EXPECT_THROW(json->textChild("dir", _("b")), Exception);
+}
@@ -0,0 +1,115 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_ui_change_feed.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "session_manager.h"
+#include "ui_change_feed.h"
+
+using namespace zmm;
+
+TEST(UIChangeFeedTest, EveryReaderSeesTheChangesAfterItsCursor) {
+  Ref<UIChangeFeed> feed(new UIChangeFeed());
+  UIChangeFeed::Cursor first = feed->getCursor();
+  feed->containerChanged(5);
+  UIChangeFeed::Cursor second = feed->getCursor();
+  feed->containerChanged(std::vector<int> { 5, 5, 7, 5 });
+
+  auto changes = feed->collect(first, 10);
+  EXPECT_FALSE(changes.all);
+  EXPECT_EQ(changes.containers, (std::unordered_set<int> { 5, 7 }));
+
+  changes = feed->collect(second, 10);
+  EXPECT_EQ(changes.containers, (std::unordered_set<int> { 5, 7 }));
+
+  EXPECT_FALSE(feed->hasContainerChanges(first));
+  EXPECT_TRUE(feed->collect(first, 10).containers.empty());
+}
+
+TEST(UIChangeFeedTest, ReportsAllWhenAReaderFallsBehind) {
+  Ref<UIChangeFeed> feed(new UIChangeFeed(8));
+  UIChangeFeed::Cursor behind = feed->getCursor();
+  UIChangeFeed::Cursor many = feed->getCursor();
+  for (int i = 0; i < 9; i++)
+    feed->containerChanged(i);
+
+  EXPECT_TRUE(feed->collect(behind, 100).all);
+
+  feed->containerChanged(100);
+  UIChangeFeed::Cursor current = feed->getCursor();
+  feed->containerChanged(std::vector<int> { 1, 2, 3 });
+  EXPECT_TRUE(feed->collect(current, 2).all);
+  EXPECT_TRUE(feed->collect(many, 100).all);
+}
+
+TEST(UIChangeFeedTest, WakesUpWaitingReaders) {
+  Ref<UIChangeFeed> feed(new UIChangeFeed());
+  UIChangeFeed::Cursor cursor = feed->getCursor();
+  EXPECT_EQ(feed->wait(cursor, 10), UIChangeFeed::WAIT_TIMEOUT);
+
+  std::thread writer([feed]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    feed->taskChanged();
+  });
+  EXPECT_EQ(feed->wait(cursor, 10000), UIChangeFeed::WAIT_CHANGED);
+  writer.join();
+
+  auto changes = feed->collect(cursor, 10);
+  EXPECT_TRUE(changes.task);
+  EXPECT_TRUE(changes.containers.empty());
+
+  feed->close();
+  EXPECT_EQ(feed->wait(cursor, 10000), UIChangeFeed::WAIT_TIMEOUT);
+}
+
+TEST(UIChangeFeedTest, LetsOnlyMaxWaitersWait) {
+  Ref<UIChangeFeed> feed(new UIChangeFeed(8, 1));
+  UIChangeFeed::Cursor cursor = feed->getCursor();
+
+  std::thread waiter([feed, cursor]() {
+    EXPECT_EQ(feed->wait(cursor, 10000), UIChangeFeed::WAIT_CHANGED);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(feed->wait(cursor, 10000), UIChangeFeed::WAIT_BUSY);
+
+  feed->containerChanged(5);
+  waiter.join();
+  // changes are handed out without waiting
+  EXPECT_EQ(feed->wait(cursor, 10000), UIChangeFeed::WAIT_CHANGED);
+}
+
+TEST(UIChangeFeedTest, LetsOneRequestOfASessionWait) {
+  Ref<UIChangeFeed> feed(new UIChangeFeed());
+  Ref<Session> session(new Session(60, feed));
+  Ref<Session> other(new Session(60, feed));
+
+  std::thread waiter([session]() {
+    EXPECT_EQ(session->waitForUIUpdates(10000), UIChangeFeed::WAIT_CHANGED);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(session->waitForUIUpdates(10000), UIChangeFeed::WAIT_BUSY);
+  EXPECT_EQ(other->waitForUIUpdates(10), UIChangeFeed::WAIT_TIMEOUT);
+
+  feed->taskChanged();
+  waiter.join();
+  EXPECT_EQ(session->waitForUIUpdates(10000), UIChangeFeed::WAIT_CHANGED);
+}
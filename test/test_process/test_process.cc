@@ -0,0 +1,127 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_process.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#include <chrono>
+#include <iostream>
+#include <poll.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "process.h"
+#include "process_executor.h"
+#include "tools.h"
+
+using namespace zmm;
+
+static std::string readAll(int fd)
+{
+    std::string result;
+    char buf[256];
+    ssize_t bytesRead;
+    while ((bytesRead = read(fd, buf, sizeof(buf))) > 0)
+        result.append(buf, bytesRead);
+    return result;
+}
+
+// reap the process, otherwise the executor tries to kill it on destruction
+static void waitForExit(Ref<ProcessExecutor> proc)
+{
+    while (proc->isAlive())
+        usleep(1000);
+}
+
+TEST(ProcessTest, SpawnedProcessWritesIntoStdoutPipe) {
+  Ref<Array<StringBase> > arglist(new Array<StringBase>());
+  arglist->append(_("-c"));
+  arglist->append(_("printf gerbera"));
+
+  Ref<ProcessExecutor> proc(new ProcessExecutor(_("sh"), arglist, PROCESS_PIPE_STDOUT));
+  int fd = proc->releaseStdout();
+  ASSERT_GE(fd, 0);
+
+  EXPECT_EQ(readAll(fd), "gerbera");
+  close(fd);
+  waitForExit(proc);
+  EXPECT_EQ(proc->getStatus(), 0);
+  EXPECT_EQ(proc->releaseStdout(), -1);
+}
+
+TEST(ProcessTest, UnknownCommandThrows) {
+  Ref<Array<StringBase> > arglist(new Array<StringBase>());
+  EXPECT_THROW(new ProcessExecutor(_("gerbera-no-such-command"), arglist, PROCESS_PIPE_STDOUT), Exception);
+}
+
+TEST(ProcessTest, RunSimpleProcessFeedsInputAndCollectsOutput) {
+  String output = run_simple_process(_("sh"), _("-s"), _("printf hello"));
+  EXPECT_STREQ(output.c_str(), "hello");
+}
+
+TEST(ProcessTest, RunSimpleProcessPassesTheArgumentsOfTheCommand) {
+  // the action of an active item may come with its own arguments
+  String output = run_simple_process(_("printf  %s-%s-%s a b"), _("run"), _(""));
+  EXPECT_STREQ(output.c_str(), "a-b-run");
+}
+
+TEST(ProcessTest, RunSimpleProcessSurvivesUnreadInput) {
+  String input = _("exit 0\n") + std::string(1024 * 1024, '#');
+  String output = run_simple_process(_("sh"), _("-s"), input);
+  EXPECT_EQ(output.length(), 0);
+}
+
+// Measures how long it takes from launching a transcoder until the first
+// byte of the stream arrives, this is what the player is waiting for.
+TEST(ProcessTest, TranscoderTimeToFirstByte) {
+  const int runs = 20;
+  long total = 0;
+  long worst = 0;
+
+  for (int i = 0; i < runs; i++)
+  {
+    Ref<Array<StringBase> > arglist = parseCommandLine(_("if=%in of=%out bs=4096 count=64"),
+                                                      _("/dev/zero"), _("/dev/stdout"), nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    Ref<ProcessExecutor> proc(new ProcessExecutor(_("dd"), arglist, PROCESS_PIPE_STDOUT));
+    int fd = proc->releaseStdout();
+    ASSERT_GE(fd, 0);
+
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    ASSERT_EQ(poll(&pfd, 1, 10000), 1);
+    char byte;
+    ASSERT_EQ(read(fd, &byte, 1), 1);
+    long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - start).count();
+
+    total += elapsed;
+    if (elapsed > worst)
+      worst = elapsed;
+
+    EXPECT_EQ(readAll(fd).length(), (size_t)(4096 * 64 - 1));
+    close(fd);
+    waitForExit(proc);
+  }
+
+  RecordProperty("ttfb_avg_us", (int)(total / runs));
+  RecordProperty("ttfb_max_us", (int)worst);
+  std::cout << "time to first byte: avg " << (total / runs) << "us, max " << worst << "us" << std::endl;
+}
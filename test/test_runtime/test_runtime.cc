@@ -21,6 +21,7 @@
 */
 #include "test_runtime.h"
 #include "scripting/runtime.h"
+#include "scripting/script_pool.h"
 
 TEST_F(RuntimeTest, CheckTestCodeLinksAgainstDependencies)
 {
@@ -28,3 +29,30 @@ TEST_F(RuntimeTest, CheckTestCodeLinksAgainstDependencies)
     duk_context* ctx = runtime->createContext("testCtx");
     EXPECT_NE(ctx, nullptr);
 }
+
+class PooledScript : public zmm::Object
+{
+public:
+    explicit PooledScript(zmm::Ref<Runtime> runtime)
+        : runtime(runtime)
+    {
+    }
+    zmm::Ref<Runtime> runtime;
+};
+
+TEST_F(RuntimeTest, ScriptPoolHandsOutScriptsOnSeparateRuntimes)
+{
+    zmm::Ref<ScriptPool<PooledScript>> pool(new ScriptPool<PooledScript>(2));
+
+    zmm::Ref<PooledScript> first = pool->take();
+    zmm::Ref<PooledScript> second = pool->take();
+    EXPECT_NE(first.getPtr(), second.getPtr());
+    EXPECT_NE(first->runtime.getPtr(), second->runtime.getPtr());
+
+    pool->putBack(first);
+    {
+        ScriptPool<PooledScript>::Borrowed borrowed(pool);
+        EXPECT_EQ(borrowed->runtime.getPtr(), first->runtime.getPtr());
+    }
+    EXPECT_EQ(pool->take().getPtr(), first.getPtr());
+}
@@ -0,0 +1,92 @@
+#ifdef HAVE_JS
+#ifndef GERBERA_IMPORTSCRIPTFIXTURE_H
+#define GERBERA_IMPORTSCRIPTFIXTURE_H
+
+#include "gtest/gtest.h"
+#include <duktape.h>
+#include <fstream>
+#include <ftw.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cds_objects.h>
+#include <config_manager.h>
+#include <config/config_generator.h>
+#include <scripting/import_script.h>
+#include <singleton.h>
+
+// Runs a real ImportScript with the import script a test writes, in a
+// temporary server home. Hands back what the script passed to
+// addCdsObject() as the container chain.
+class ImportScriptFixture : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    char dirTemplate[] = "/tmp/gerbera-import-script-XXXXXX";
+    ASSERT_NE(mkdtemp(dirTemplate), nullptr);
+    workDir = dirTemplate;
+
+    mkdir((workDir + "/web").c_str(), 0700);
+    mkdir((workDir + "/js").c_str(), 0700);
+    mkdir((workDir + "/.config").c_str(), 0700);
+    for (const char *script : { DEFAULT_COMMON_SCRIPT, DEFAULT_PLAYLISTS_SCRIPT })
+      std::ofstream(workDir + "/js/" + script);
+    importScript = workDir + "/js/" + DEFAULT_IMPORT_SCRIPT;
+
+    ConfigGenerator generator;
+    std::string configFile = workDir + "/.config/config.xml";
+    std::ofstream(configFile) << generator.generate(workDir, ".config", workDir, "");
+
+    ConfigManager::setStaticArgs(zmm::String(configFile.c_str()), zmm::String(workDir.c_str()),
+        _(".config"), zmm::String(workDir.c_str()), _(""));
+    ConfigManager::getInstance();
+  }
+
+  virtual void TearDown() {
+    SingletonManager::getInstance()->shutdown(true);
+    nftw(workDir.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+  }
+
+  static int removeEntry(const char *path, const struct stat *sb, int flag, struct FTW *ftwbuf) {
+    return remove(path);
+  }
+
+  void writeImportScript(const std::string &text) {
+    std::ofstream(importScript) << text;
+  }
+
+  static zmm::Ref<CdsObject> createItem() {
+    zmm::Ref<CdsItem> item(new CdsItem());
+    item->setID(100);
+    item->setParentID(1);
+    item->setTitle(_("Track"));
+    item->setMimeType(_("audio/mpeg"));
+    item->setLocation(_("/media/track.mp3"));
+    return RefCast(item, CdsObject);
+  }
+
+  // loads the import script and runs it on the object
+  std::string run(zmm::Ref<CdsObject> obj = createItem()) {
+    zmm::Ref<ImportScript> script(new ImportScript(zmm::Ref<Runtime>(new Runtime())));
+    script->defineFunction(_("addCdsObject"), addCdsObject, 3);
+    addedChain().clear();
+    script->processCdsObject(obj, _("/media"));
+    return addedChain();
+  }
+
+  static duk_ret_t addCdsObject(duk_context *ctx) {
+    addedChain() = duk_to_string(ctx, 1);
+    return 0;
+  }
+
+  static std::string &addedChain() {
+    static std::string chain;
+    return chain;
+  }
+
+  std::string workDir;
+  std::string importScript;
+};
+
+#endif //GERBERA_IMPORTSCRIPTFIXTURE_H
+#endif //HAVE_JS
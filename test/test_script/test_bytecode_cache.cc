@@ -0,0 +1,31 @@
+#ifdef HAVE_JS
+
+#include "gtest/gtest.h"
+#include <sys/stat.h>
+#include <utime.h>
+
+#include "mock/import_script_fixture.h"
+
+class BytecodeCacheTest : public ImportScriptFixture {
+};
+
+TEST_F(BytecodeCacheTest, CompilesAnEditedScriptWithTheSameSizeAndTime) {
+  writeImportScript("addCdsObject(orig, '/aaaa');\n");
+  struct stat st;
+  ASSERT_EQ(stat(importScript.c_str(), &st), 0);
+  EXPECT_EQ(run(), "/aaaa");
+  // loaded from the cache
+  EXPECT_EQ(run(), "/aaaa");
+
+  writeImportScript("addCdsObject(orig, '/bbbb');\n");
+  struct utimbuf times = { st.st_atime, st.st_mtime };
+  ASSERT_EQ(utime(importScript.c_str(), &times), 0);
+  struct stat edited;
+  ASSERT_EQ(stat(importScript.c_str(), &edited), 0);
+  ASSERT_EQ(edited.st_size, st.st_size);
+  ASSERT_EQ(edited.st_mtime, st.st_mtime);
+
+  EXPECT_EQ(run(), "/bbbb");
+}
+
+#endif //HAVE_JS
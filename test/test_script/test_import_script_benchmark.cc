@@ -0,0 +1,177 @@
+#ifdef HAVE_JS
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdlib>
+#include <duktape.h>
+#include <fstream>
+#include <ftw.h>
+#include <iostream>
+#include <map>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cds_objects.h>
+#include <config_manager.h>
+#include <config/config_generator.h>
+#include <metadata_handler.h>
+#include <scripting/import_script.h>
+#include <singleton.h>
+
+using namespace zmm;
+using namespace std;
+
+// Measures how many objects per second make it through the real
+// ImportScript with import.js, including the conversion of every object
+// to javascript and back. Only the storage is left out.
+class ImportScriptBenchmark : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    char dirTemplate[] = "/tmp/gerbera-script-benchmark-XXXXXX";
+    ASSERT_NE(mkdtemp(dirTemplate), nullptr);
+    workDir = dirTemplate;
+
+    mkdir((workDir + "/web").c_str(), 0700);
+    mkdir((workDir + "/.config").c_str(), 0700);
+    ASSERT_EQ(symlink(SCRIPTS_DIR "/js", (workDir + "/js").c_str()), 0);
+
+    ConfigGenerator generator;
+    string configFile = workDir + "/.config/config.xml";
+    ofstream(configFile) << generator.generate(workDir, ".config", workDir, "");
+
+    ConfigManager::setStaticArgs(String(configFile.c_str()), String(workDir.c_str()),
+        _(".config"), String(workDir.c_str()), _(""));
+    ConfigManager::getInstance();
+  }
+
+  virtual void TearDown() {
+    addedObjects.clear();
+    SingletonManager::getInstance()->shutdown(true);
+    nftw(workDir.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+  }
+
+  static int removeEntry(const char *path, const struct stat *sb, int flag, struct FTW *ftwbuf) {
+    return remove(path);
+  }
+
+  static Ref<CdsObject> createItem(int i) {
+    Ref<CdsItem> item(new CdsItem());
+    item->setID(i + 100);
+    item->setParentID(1);
+    item->setTitle(_("Track ") + i);
+
+    Ref<CdsResource> resource(new CdsResource(CH_DEFAULT));
+    switch (i % 3) {
+    case 0:
+      item->setMimeType(_("video/mpeg"));
+      item->setLocation(_("/media/video/clip") + i + ".mpg");
+      break;
+    case 1:
+      item->setMimeType(_("image/jpeg"));
+      item->setLocation(_("/media/photos/image") + i + ".jpg");
+      item->setMetadata(MetadataHandler::getMetaFieldName(M_DATE), _("2018-06-01"));
+      break;
+    default:
+      item->setMimeType(_("audio/mpeg"));
+      item->setLocation(_("/media/music/track") + i + ".mp3");
+      item->setMetadata(MetadataHandler::getMetaFieldName(M_TITLE), _("Track ") + i);
+      item->setMetadata(MetadataHandler::getMetaFieldName(M_ARTIST), _("Artist ") + (i % 50));
+      item->setMetadata(MetadataHandler::getMetaFieldName(M_ALBUM), _("Album ") + (i % 200));
+      item->setMetadata(MetadataHandler::getMetaFieldName(M_GENRE), _("Genre ") + (i % 10));
+      item->setMetadata(MetadataHandler::getMetaFieldName(M_DATE), _("2018-01-01"));
+      item->setTrackNumber(i % 12 + 1);
+      resource->addAttribute(MetadataHandler::getResAttrName(R_NRAUDIOCHANNELS), _("2"));
+      break;
+    }
+    resource->addAttribute(MetadataHandler::getResAttrName(R_SIZE), String::from(1000000 + i));
+    item->addResource(resource);
+    item->setAuxData(_("aux"), _("value"));
+    return RefCast(item, CdsObject);
+  }
+
+  // every metadata, aux data and resource attribute of the item must have
+  // made it to the object the script added
+  static void expectSameData(Ref<CdsObject> item, Ref<CdsObject> added) {
+    auto meta = item->getMetadata()->getElements();
+    for (int i = 0; i < meta->size(); i++)
+      EXPECT_EQ(added->getMetadata(meta->get(i)->getKey()), meta->get(i)->getValue())
+          << item->getLocation().c_str() << ": " << meta->get(i)->getKey().c_str();
+
+    auto aux = item->getAuxData()->getElements();
+    for (int i = 0; i < aux->size(); i++)
+      EXPECT_EQ(added->getAuxData(aux->get(i)->getKey()), aux->get(i)->getValue())
+          << item->getLocation().c_str() << ": " << aux->get(i)->getKey().c_str();
+
+    ASSERT_GT(added->getResourceCount(), 0) << item->getLocation().c_str();
+    auto res = item->getResource(0)->getAttributes()->getElements();
+    for (int i = 0; i < res->size(); i++)
+      EXPECT_EQ(added->getResource(0)->getAttribute(res->get(i)->getKey()), res->get(i)->getValue())
+          << item->getLocation().c_str() << ": " << res->get(i)->getKey().c_str();
+
+    EXPECT_EQ(RefCast(added, CdsItem)->getTrackNumber(), RefCast(item, CdsItem)->getTrackNumber());
+  }
+
+  // the last object added for each location
+  static map<string, Ref<CdsObject>> addedObjects;
+  static int addedCount;
+
+  string workDir;
+};
+
+map<string, Ref<CdsObject>> ImportScriptBenchmark::addedObjects;
+int ImportScriptBenchmark::addedCount = 0;
+
+// Stands in for the real addCdsObject(), converts the original and the
+// added object back like it does, but does not touch the storage.
+static duk_ret_t addCdsObject(duk_context *ctx) {
+  auto *self = Script::getContextScript(ctx);
+
+  duk_get_global_string(ctx, "orig");
+  Ref<CdsObject> orig = self->dukObject2cdsObject(self->getProcessedObject());
+  duk_pop(ctx);
+
+  duk_dup(ctx, 0);
+  Ref<CdsObject> obj = self->dukObject2cdsObject(orig);
+  duk_pop(ctx);
+
+  if (obj != nullptr) {
+    ImportScriptBenchmark::addedObjects[obj->getLocation().c_str()] = obj;
+    ImportScriptBenchmark::addedCount++;
+  }
+  return 0;
+}
+
+TEST_F(ImportScriptBenchmark, ProcessesObjectsThroughImportScript) {
+  int count = 3000;
+  const char *env = getenv("GERBERA_SCRIPT_BENCHMARK_OBJECTS");
+  if (env != nullptr && atoi(env) > 0)
+    count = atoi(env);
+
+  Ref<ImportScript> script(new ImportScript(Ref<Runtime>(new Runtime())));
+  script->defineFunction(_("addCdsObject"), addCdsObject, 3);
+
+  vector<Ref<CdsObject>> items;
+  for (int i = 0; i < count; i++)
+    items.push_back(createItem(i));
+
+  addedCount = 0;
+  auto start = chrono::steady_clock::now();
+  for (auto &item : items)
+    script->processCdsObject(item, _("/media"));
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+  double perSecond = count / elapsed.count();
+  cout << "[ BENCHMARK] " << count << " objects, " << addedCount
+       << " virtual objects in " << elapsed.count() << " s: "
+       << (long)perSecond << " objects/s" << endl;
+  RecordProperty("ObjectsPerSecond", (int)perSecond);
+
+  EXPECT_GT(addedCount, count);
+  for (auto &item : items) {
+    auto added = addedObjects.find(item->getLocation().c_str());
+    ASSERT_NE(added, addedObjects.end()) << item->getLocation().c_str();
+    expectSameData(item, added->second);
+  }
+}
+
+#endif //HAVE_JS
@@ -0,0 +1,52 @@
+#ifdef HAVE_JS
+
+#include "gtest/gtest.h"
+
+#include <metadata_handler.h>
+
+#include "mock/import_script_fixture.h"
+
+using namespace zmm;
+
+// meta, aux and res are only built when the script reads them, but must
+// look like the plain properties they were before.
+class LazyPropertiesTest : public ImportScriptFixture {
+ public:
+  static Ref<CdsObject> createItemWithData() {
+    Ref<CdsObject> item = createItem();
+    item->setMetadata(MetadataHandler::getMetaFieldName(M_TITLE), _("Title"));
+    item->setAuxData(_("aux"), _("value"));
+    Ref<CdsResource> resource(new CdsResource(CH_DEFAULT));
+    resource->addAttribute(MetadataHandler::getResAttrName(R_SIZE), _("1000"));
+    item->addResource(resource);
+    return item;
+  }
+};
+
+TEST_F(LazyPropertiesTest, AreOwnEnumerableProperties) {
+  writeImportScript(
+      "var names = ['meta', 'aux', 'res'];\n"
+      "var keys = Object.keys(orig).filter(function (k) { return names.indexOf(k) >= 0 || k.indexOf('lazy') >= 0; });\n"
+      "var own = names.filter(function (k) { return orig.hasOwnProperty(k); });\n"
+      "addCdsObject(orig, keys.join(',') + ';' + own.join(','));\n");
+
+  EXPECT_EQ(run(createItemWithData()), "meta,aux,res;meta,aux,res");
+}
+
+TEST_F(LazyPropertiesTest, AreSerializedWithTheObject) {
+  writeImportScript(
+      "var copy = JSON.parse(JSON.stringify(orig));\n"
+      "addCdsObject(orig, [copy.meta[M_TITLE], copy.aux['aux'], copy.res[R_SIZE]].join(','));\n");
+
+  EXPECT_EQ(run(createItemWithData()), "Title,value,1000");
+}
+
+TEST_F(LazyPropertiesTest, CanBeReplacedBeforeTheyAreRead) {
+  writeImportScript(
+      "orig.meta = { replaced: true };\n"
+      "addCdsObject(orig, String(orig.meta.replaced) + ',' + orig.hasOwnProperty('meta') + ',' + orig.aux['aux']);\n");
+
+  EXPECT_EQ(run(createItemWithData()), "true,true,value");
+}
+
+#endif //HAVE_JS
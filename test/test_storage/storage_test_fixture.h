@@ -0,0 +1,126 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  storage_test_fixture.h - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#ifndef __STORAGE_TEST_FIXTURE_H__
+#define __STORAGE_TEST_FIXTURE_H__
+
+#include <fstream>
+#include <ftw.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "cds_objects.h"
+#include "config_manager.h"
+#include "config/config_generator.h"
+#include "metadata_handler.h"
+#include "storage.h"
+#include "storage/sql_storage.h"
+
+// Starts the server singletons on a fresh SQLite database in a temporary
+// home and tears them down again after every test.
+class StorageTestFixture : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    char dirTemplate[] = "/tmp/gerbera-storage-XXXXXX";
+    ASSERT_NE(mkdtemp(dirTemplate), nullptr);
+    home = dirTemplate;
+
+    mkdir((home + "/web").c_str(), 0700);
+    mkdir((home + "/js").c_str(), 0700);
+    mkdir((home + "/.config").c_str(), 0700);
+    for (const char *script : { DEFAULT_COMMON_SCRIPT, DEFAULT_IMPORT_SCRIPT, DEFAULT_PLAYLISTS_SCRIPT })
+      std::ofstream(home + "/js/" + script);
+
+    ConfigGenerator generator;
+    configFile = home + "/.config/config.xml";
+    std::ofstream(configFile) << generator.generate(home, ".config", home, "");
+    start();
+  }
+
+  void start() {
+    // the configuration forgets its arguments when it is shut down
+    ConfigManager::setStaticArgs(zmm::String(configFile.c_str()), zmm::String(home.c_str()),
+        _(".config"), zmm::String(home.c_str()), _(""));
+    storage = Storage::getInstance();
+  }
+
+  virtual void TearDown() {
+    storage = nullptr;
+    SingletonManager::getInstance()->shutdown(true);
+    nftw(home.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+  }
+
+  static int removeEntry(const char *path, const struct stat *sb, int flag, struct FTW *ftwbuf) {
+    return remove(path);
+  }
+
+  // the database is opened in exclusive locking mode, look at and tamper
+  // with the tables through the connection of the storage
+  SQLStorage *sqlStorage() {
+    return (SQLStorage *)storage.getPtr();
+  }
+
+  void execSQL(const std::string &sql) {
+    sqlStorage()->exec(sql.c_str(), sql.length());
+  }
+
+  int selectInt(const std::string &sql) {
+    zmm::Ref<SQLResult> res = sqlStorage()->select(sql);
+    zmm::Ref<SQLRow> row = res->nextRow();
+    return (row != nullptr) ? row->col(0).toInt() : -1;
+  }
+
+  // stops and starts the singletons on the same database
+  void restart() {
+    storage = nullptr;
+    SingletonManager::getInstance()->shutdown(true);
+    start();
+  }
+
+  zmm::Ref<CdsItem> addItem(const std::string &location, const std::string &title,
+      off_t size = 0, const std::string &mimeType = "audio/mpeg") {
+    zmm::Ref<CdsItem> item(new CdsItem());
+    item->setLocation(zmm::String(location.c_str()));
+    item->setMimeType(zmm::String(mimeType.c_str()));
+    item->setClass(_(UPNP_DEFAULT_CLASS_MUSIC_TRACK));
+    item->setTitle(zmm::String(title.c_str()));
+    item->setMetadata(MetadataHandler::getMetaFieldName(M_TITLE), zmm::String(title.c_str()));
+    zmm::Ref<CdsResource> resource(new CdsResource(CH_DEFAULT));
+    resource->addAttribute(MetadataHandler::getResAttrName(R_PROTOCOLINFO), renderProtocolInfo(zmm::String(mimeType.c_str())));
+    if (size > 0)
+      resource->addAttribute(MetadataHandler::getResAttrName(R_SIZE), zmm::String::from((long long)size));
+    item->addResource(resource);
+
+    int changedContainer = INVALID_OBJECT_ID;
+    storage->addObject(RefCast(item, CdsObject), &changedContainer);
+    storage->flushInserts();
+    return item;
+  }
+
+  std::string home;
+  std::string configFile;
+  zmm::Ref<Storage> storage;
+};
+
+#endif // __STORAGE_TEST_FIXTURE_H__
@@ -0,0 +1,144 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_browse.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#ifdef HAVE_SQLITE3
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "storage_test_fixture.h"
+
+using namespace zmm;
+
+// more objects than one metadata query loads
+#define ITEM_COUNT (METADATA_LOAD_BATCH + 10)
+
+class BrowseTest : public StorageTestFixture {
+ public:
+  static std::string titleOf(int i) {
+    char title[16];
+    snprintf(title, sizeof(title), "t%05d", i);
+    return title;
+  }
+
+  // pure items in /music and a virtual item for each of them in /Virtual,
+  // whose metadata only exists on the item it refers to
+  void addItems() {
+    int updateID = INVALID_OBJECT_ID;
+    storage->addContainerChain(_("/Virtual"), _(UPNP_DEFAULT_CLASS_CONTAINER), INVALID_OBJECT_ID,
+        &virtualID, &updateID, nullptr);
+
+    for (int i = 0; i < ITEM_COUNT; i++) {
+      Ref<CdsItem> item = addItem("/music/" + titleOf(i) + ".mp3", titleOf(i));
+      musicID = item->getParentID();
+
+      Ref<CdsObject> virt(new CdsItem());
+      storage->loadObject(item->getID())->copyTo(virt);
+      virt->setID(INVALID_OBJECT_ID);
+      virt->setParentID(virtualID);
+      virt->setRefID(item->getID());
+      virt->setVirtual(true);
+      int changedContainer = INVALID_OBJECT_ID;
+      storage->addObject(virt, &changedContainer);
+    }
+    storage->flushInserts();
+  }
+
+  Ref<Array<CdsObject>> browse(int containerID, int startingIndex, int requestedCount) {
+    Ref<BrowseParam> param(new BrowseParam(containerID, BROWSE_DIRECT_CHILDREN | BROWSE_ITEMS));
+    param->setRange(startingIndex, requestedCount);
+    return storage->browse(param);
+  }
+
+  std::string titleMetadata(Ref<CdsObject> obj) {
+    String title = obj->getMetadata(MetadataHandler::getMetaFieldName(M_TITLE));
+    return (title != nullptr) ? title.c_str() : "";
+  }
+
+  int musicID = INVALID_OBJECT_ID;
+  int virtualID = INVALID_OBJECT_ID;
+};
+
+TEST_F(BrowseTest, LoadsTheMetadataOfAPageInBatches) {
+  addItems();
+
+  Ref<Array<CdsObject>> items = browse(musicID, 0, 0);
+  ASSERT_EQ(items->size(), ITEM_COUNT);
+  for (int i = 0; i < items->size(); i++)
+    EXPECT_EQ(titleMetadata(items->get(i)), titleOf(i));
+}
+
+TEST_F(BrowseTest, FallsBackToTheMetadataOfTheReferencedItems) {
+  addItems();
+  EXPECT_EQ(selectInt("SELECT COUNT(*) FROM mt_metadata m JOIN mt_cds_object o ON o.id = m.item_id "
+                      "WHERE o.parent_id = " + std::to_string(virtualID)),
+      0);
+
+  Ref<Array<CdsObject>> items = browse(virtualID, 0, 0);
+  ASSERT_EQ(items->size(), ITEM_COUNT);
+  for (int i = 0; i < items->size(); i++) {
+    Ref<CdsObject> obj = items->get(i);
+    EXPECT_TRUE(obj->isVirtual());
+    EXPECT_EQ(titleMetadata(obj), titleOf(i));
+  }
+
+  // a page that starts in the second batch of references
+  items = browse(virtualID, METADATA_LOAD_BATCH - 5, 10);
+  ASSERT_EQ(items->size(), 10);
+  for (int i = 0; i < items->size(); i++)
+    EXPECT_EQ(titleMetadata(items->get(i)), titleOf(METADATA_LOAD_BATCH - 5 + i));
+}
+
+TEST_F(BrowseTest, PrefersTheMetadataOfTheVirtualItem) {
+  addItems();
+
+  Ref<Array<CdsObject>> items = browse(virtualID, 0, 1);
+  ASSERT_EQ(items->size(), 1);
+  Ref<CdsObject> renamed = items->get(0);
+  renamed->setMetadata(MetadataHandler::getMetaFieldName(M_TITLE), _("renamed"));
+  int changedContainer = INVALID_OBJECT_ID;
+  storage->updateObject(renamed, &changedContainer);
+
+  items = browse(virtualID, 0, 2);
+  ASSERT_EQ(items->size(), 2);
+  EXPECT_EQ(titleMetadata(items->get(0)), "renamed");
+  EXPECT_EQ(titleMetadata(items->get(1)), titleOf(1));
+  // the referenced item keeps its own
+  EXPECT_EQ(titleMetadata(browse(musicID, 0, 1)->get(0)), titleOf(0));
+}
+
+TEST_F(BrowseTest, FindsTheObjectsShowingThePlayStatus) {
+  addItems();
+  Ref<Array<CdsObject>> items = browse(musicID, 0, 2);
+  Ref<Array<CdsObject>> virtualItems = browse(virtualID, 0, 1);
+  ASSERT_EQ(virtualItems->get(0)->getRefID(), items->get(0)->getID());
+
+  std::vector<int> objectIDs = storage->getPlayStatusObjectIDs({ items->get(0)->getID() });
+  std::sort(objectIDs.begin(), objectIDs.end());
+  std::vector<int> expected { musicID, virtualID, items->get(0)->getID(), virtualItems->get(0)->getID() };
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(objectIDs, expected);
+
+  EXPECT_TRUE(storage->getPlayStatusObjectIDs({}).empty());
+}
+
+#endif // HAVE_SQLITE3
@@ -0,0 +1,89 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_import_resume.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#ifdef HAVE_SQLITE3
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include "storage_test_fixture.h"
+#include "content_manager.h"
+#include "import_journal.h"
+
+using namespace zmm;
+
+class ImportResumeTest : public StorageTestFixture {
+ public:
+  virtual void SetUp() {
+    StorageTestFixture::SetUp();
+    media = home + "/media";
+    mkdir(media.c_str(), 0700);
+    mkdir((media + "/done").c_str(), 0700);
+    for (const char *name : { "a.mp3", "b.mp3", "done/c.mp3" })
+      std::ofstream(media + "/" + name) << "ID3";
+  }
+
+  virtual void TearDown() {
+    cm = nullptr;
+    StorageTestFixture::TearDown();
+  }
+
+  static bool eventually(std::function<bool()> condition) {
+    for (int i = 0; i < 200; i++) {
+      if (condition())
+        return true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(25));
+    }
+    return false;
+  }
+
+  int objectID(const std::string &path) {
+    return storage->findObjectIDByPath(String(path.c_str()));
+  }
+
+  int references(int objectID) {
+    return selectInt("SELECT COUNT(*) FROM mt_cds_object WHERE ref_id = " + std::to_string(objectID));
+  }
+
+  std::string media;
+  Ref<ContentManager> cm;
+};
+
+TEST_F(ImportResumeTest, RunsTheLayoutOnItemsOfTheInterruptedDirectory) {
+  // the server stopped after a.mp3 and c.mp3 were added, before the
+  // layout saw a.mp3; the directory of c.mp3 was done
+  int itemA = addItem(media + "/a.mp3", "a")->getID();
+  int itemC = addItem(media + "/done/c.mp3", "c")->getID();
+  String serverHome = ConfigManager::getInstance()->getOption(CFG_SERVER_HOME);
+  std::ofstream(std::string(serverHome.c_str()) + DIR_SEPARATOR + IMPORT_JOURNAL_FILE)
+      << "B 1 0 " << media << "\t\n"
+      << "D 1 " << media << "/done\n";
+
+  cm = ContentManager::getInstance();
+  ASSERT_TRUE(eventually([&]() { return objectID(media + "/b.mp3") > 0 && cm->getCurrentTask() == nullptr; }));
+
+  EXPECT_GT(references(itemA), 0);
+  EXPECT_EQ(references(itemA), references(objectID(media + "/b.mp3")));
+  EXPECT_EQ(references(itemC), 0);
+}
+
+#endif // HAVE_SQLITE3
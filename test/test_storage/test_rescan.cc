@@ -0,0 +1,121 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_rescan.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#ifdef HAVE_SQLITE3
+
+#include <chrono>
+#include <functional>
+#include <iterator>
+#include <thread>
+
+#include "storage_test_fixture.h"
+#include "autoscan.h"
+#include "content_manager.h"
+
+using namespace zmm;
+
+class RescanTest : public StorageTestFixture {
+ public:
+  virtual void SetUp() {
+    StorageTestFixture::SetUp();
+    media = home + "/media";
+    mkdir(media.c_str(), 0700);
+    for (const char *name : { "a.mp3", "b.mp3" })
+      std::ofstream(media + "/" + name) << "ID3";
+    cm = ContentManager::getInstance();
+  }
+
+  virtual void TearDown() {
+    cm = nullptr;
+    StorageTestFixture::TearDown();
+  }
+
+  // the scans run on the task thread of the content manager
+  static bool eventually(std::function<bool()> condition) {
+    for (int i = 0; i < 200; i++) {
+      if (condition())
+        return true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(25));
+    }
+    return false;
+  }
+
+  // as the web UI adds it, the first scan starts right away
+  Ref<AutoscanDirectory> addAutoscan(int dirID) {
+    Ref<AutoscanDirectory> adir(new AutoscanDirectory(nullptr, ScanMode::Timed, ScanLevel::Basic,
+        true, false, INVALID_SCAN_ID, 3600));
+    adir->setObjectID(dirID);
+    cm->setAutoscanDirectory(adir);
+    return adir;
+  }
+
+  int objectID(const std::string &path) {
+    return storage->findObjectIDByPath(_(path.c_str()));
+  }
+
+  bool hasFingerprint(int containerID) {
+    DirectoryFingerprint fingerprint;
+    return storage->loadDirectoryFingerprint(containerID, fingerprint);
+  }
+
+  std::string media;
+  Ref<ContentManager> cm;
+};
+
+TEST_F(RescanTest, ImportsAnItemRemovedInTheUIAgain) {
+  int dirID = cm->ensurePathExistence(_(media.c_str()));
+  Ref<AutoscanDirectory> adir = addAutoscan(dirID);
+  ASSERT_TRUE(eventually([&]() { return hasFingerprint(dirID); }));
+  int itemID = objectID(media + "/a.mp3");
+  ASSERT_GT(itemID, 0);
+  ASSERT_GT(objectID(media + "/b.mp3"), 0);
+
+  // the directory itself does not change
+  cm->removeObject(itemID, false);
+  EXPECT_LT(objectID(media + "/a.mp3"), 0);
+  EXPECT_FALSE(hasFingerprint(dirID));
+
+  cm->rescanDirectory(dirID, adir->getScanID(), ScanMode::Timed);
+  EXPECT_TRUE(eventually([&]() { return objectID(media + "/a.mp3") > 0; }));
+  EXPECT_TRUE(eventually([&]() { return hasFingerprint(dirID); }));
+}
+
+TEST_F(RescanTest, FingerprintsADirectoryWithFilesThatAreNotImported) {
+  cm = nullptr;
+  std::ifstream in(configFile);
+  std::string config((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  std::string ignore = "ignore-unknown=\"no\"";
+  size_t pos = config.find(ignore);
+  ASSERT_NE(pos, std::string::npos);
+  std::ofstream(configFile) << config.replace(pos, ignore.length(), "ignore-unknown=\"yes\"");
+  restart();
+  cm = ContentManager::getInstance();
+
+  std::ofstream(media + "/notes.unknown") << "";
+  int dirID = cm->ensurePathExistence(_(media.c_str()));
+  addAutoscan(dirID);
+
+  EXPECT_TRUE(eventually([&]() { return hasFingerprint(dirID); }));
+  EXPECT_GT(objectID(media + "/a.mp3"), 0);
+  EXPECT_LT(objectID(media + "/notes.unknown"), 0);
+}
+
+#endif // HAVE_SQLITE3
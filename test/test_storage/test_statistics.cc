@@ -0,0 +1,198 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_statistics.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#ifdef HAVE_SQLITE3
+
+#include <map>
+
+#include "storage_test_fixture.h"
+#include "session_manager.h"
+#include "web/pages.h"
+
+using namespace zmm;
+using namespace mxml;
+
+// Runs the statistics page of the web UI and hands out what it rendered.
+class StatisticsPage : public web::statistics {
+ public:
+  Ref<Element> render(String sessionID) {
+    params->put(_("sid"), sessionID);
+    root = Ref<Element>(new Element(_("root")));
+    process();
+    return root->getChildByName(_("statistics"));
+  }
+};
+
+class StatisticsTest : public StorageTestFixture {
+ public:
+  // what the storage counted must be what it loads from the database
+  void expectReloadedCounts() {
+    std::map<std::string, int> mimeTypes = storage->getMimeTypeCounts();
+    std::map<int, int> objectTypes = storage->getObjectTypeCounts();
+    off_t rootBytes = storage->getDirectoryBytes(_("/"));
+    off_t musicBytes = storage->getDirectoryBytes(_("/music"));
+
+    restart();
+    EXPECT_EQ(storage->getMimeTypeCounts(), mimeTypes);
+    EXPECT_EQ(storage->getObjectTypeCounts(), objectTypes);
+    EXPECT_EQ(storage->getDirectoryBytes(_("/")), rootBytes);
+    EXPECT_EQ(storage->getDirectoryBytes(_("/music")), musicBytes);
+  }
+
+  Ref<CdsObject> cloneOf(int objectID) {
+    Ref<CdsObject> obj = storage->loadObject(objectID);
+    Ref<CdsObject> clone = CdsObject::createObject(obj->getObjectType());
+    obj->copyTo(clone);
+    return clone;
+  }
+
+  void setSize(Ref<CdsObject> obj, off_t size) {
+    obj->getResource(0)->addAttribute(MetadataHandler::getResAttrName(R_SIZE), String::from((long long)size));
+  }
+};
+
+TEST_F(StatisticsTest, CountsAddedFiles) {
+  addItem("/music/a/1.mp3", "1", 1000);
+  addItem("/music/b/2.mp3", "2", 2000);
+  addItem("/video/3.mkv", "3", 4000, "video/x-matroska");
+
+  EXPECT_EQ(storage->getTotalFiles(), 3);
+  EXPECT_EQ(storage->getObjectTypeCounts()[OBJECT_TYPE_ITEM], 3);
+  std::map<std::string, int> mimeTypes { { "audio/mpeg", 2 }, { "video/x-matroska", 1 } };
+  EXPECT_EQ(storage->getMimeTypeCounts(), mimeTypes);
+  EXPECT_EQ(storage->getDirectoryBytes(_("/music/a")), 1000);
+  EXPECT_EQ(storage->getDirectoryBytes(_("/music/")), 3000);
+  EXPECT_EQ(storage->getDirectoryBytes(_("/")), 7000);
+  EXPECT_EQ(storage->getDirectoryBytes(_("/nothing")), 0);
+
+  expectReloadedCounts();
+}
+
+TEST_F(StatisticsTest, MovesCountsOnUpdate) {
+  int objectID = addItem("/music/a/1.mp3", "1", 1000)->getID();
+  addItem("/music/b/2.mp3", "2", 2000);
+
+  Ref<CdsObject> clone = cloneOf(objectID);
+  RefCast(clone, CdsItem)->setMimeType(_("audio/flac"));
+  setSize(clone, 5000);
+  int changedContainer = INVALID_OBJECT_ID;
+  storage->updateObject(clone, &changedContainer);
+
+  std::map<std::string, int> mimeTypes { { "audio/flac", 1 }, { "audio/mpeg", 1 } };
+  EXPECT_EQ(storage->getMimeTypeCounts(), mimeTypes);
+  EXPECT_EQ(storage->getTotalFiles(), 2);
+  EXPECT_EQ(storage->getDirectoryBytes(_("/music/a")), 5000);
+  EXPECT_EQ(storage->getDirectoryBytes(_("/music")), 7000);
+
+  // updated again with what the first update counted
+  setSize(clone, 3000);
+  storage->updateObject(clone, &changedContainer);
+  EXPECT_EQ(storage->getDirectoryBytes(_("/music")), 5000);
+  EXPECT_EQ(storage->getTotalFiles(), 2);
+
+  expectReloadedCounts();
+}
+
+TEST_F(StatisticsTest, MovesCountsOfAnObjectThatWasNotLoaded) {
+  Ref<CdsItem> item = addItem("/music/a/1.mp3", "1", 1000);
+
+  Ref<CdsItem> other(new CdsItem());
+  other->setID(item->getID());
+  other->setLocation(item->getLocation());
+  other->setMimeType(_("audio/ogg"));
+  other->setTitle(_("1"));
+  Ref<CdsResource> resource(new CdsResource(CH_DEFAULT));
+  resource->addAttribute(MetadataHandler::getResAttrName(R_PROTOCOLINFO), renderProtocolInfo(_("audio/ogg")));
+  other->addResource(resource);
+  setSize(RefCast(other, CdsObject), 1500);
+  int changedContainer = INVALID_OBJECT_ID;
+  storage->updateObject(RefCast(other, CdsObject), &changedContainer);
+
+  std::map<std::string, int> mimeTypes { { "audio/ogg", 1 } };
+  EXPECT_EQ(storage->getMimeTypeCounts(), mimeTypes);
+  EXPECT_EQ(storage->getDirectoryBytes(_("/music")), 1500);
+
+  expectReloadedCounts();
+}
+
+TEST_F(StatisticsTest, TakesOutRemovedFiles) {
+  int dirID = addItem("/music/a/1.mp3", "1", 1000)->getParentID();
+  addItem("/music/a/2.mp3", "2", 2000);
+  int objectID = addItem("/music/b/3.mp3", "3", 4000)->getID();
+  addItem("/video/4.mkv", "4", 8000, "video/x-matroska");
+
+  storage->removeObject(objectID, false);
+  EXPECT_EQ(storage->getTotalFiles(), 3);
+  EXPECT_EQ(storage->getDirectoryBytes(_("/music/b")), 0);
+  EXPECT_EQ(storage->getDirectoryBytes(_("/music")), 3000);
+
+  storage->removeObject(dirID, false);
+  EXPECT_EQ(storage->getTotalFiles(), 1);
+  std::map<std::string, int> mimeTypes { { "video/x-matroska", 1 } };
+  EXPECT_EQ(storage->getMimeTypeCounts(), mimeTypes);
+  EXPECT_EQ(storage->getDirectoryBytes(_("/music")), 0);
+  EXPECT_EQ(storage->getDirectoryBytes(_("/")), 8000);
+
+  expectReloadedCounts();
+}
+
+TEST_F(StatisticsTest, FillsTheFileSizesOfAnOlderDatabase) {
+  addItem("/music/a/1.mp3", "1", 1000);
+  addItem("/music/b/2.mp3", "2", 2000);
+  execSQL("UPDATE mt_cds_object SET file_size = NULL");
+  execSQL("DELETE FROM mt_internal_setting WHERE key = 'file_size'");
+
+  restart();
+  EXPECT_EQ(storage->getDirectoryBytes(_("/music")), 3000);
+  EXPECT_EQ(selectInt("SELECT SUM(file_size) FROM mt_cds_object"), 3000);
+}
+
+TEST_F(StatisticsTest, RendersTheCountsInTheWebUI) {
+  addItem("/music/a/1.mp3", "1", 1000);
+  addItem("/music/b/2.mp3", "2", 2000);
+  addItem("/video/3.mkv", "3", 4000, "video/x-matroska");
+
+  Ref<Session> session = SessionManager::getInstance()->createSession(60);
+  session->logIn();
+  Ref<StatisticsPage> page(new StatisticsPage());
+  Ref<Element> statistics = page->render(session->getID());
+  ASSERT_NE(statistics, nullptr);
+  EXPECT_EQ(statistics->getAttribute(_("total_files")), "3");
+
+  std::map<std::string, std::string> objectTypes;
+  Ref<Element> objectTypesEl = statistics->getChildByName(_("object_types"));
+  for (int i = 0; i < objectTypesEl->elementChildCount(); i++) {
+    Ref<Element> el = objectTypesEl->getElementChild(i);
+    objectTypes[el->getText().c_str()] = el->getAttribute(_("count")).c_str();
+  }
+  EXPECT_EQ(objectTypes["item"], "3");
+
+  std::map<std::string, std::string> mimeTypes;
+  Ref<Element> mimeTypesEl = statistics->getChildByName(_("mime_types"));
+  for (int i = 0; i < mimeTypesEl->elementChildCount(); i++) {
+    Ref<Element> el = mimeTypesEl->getElementChild(i);
+    mimeTypes[el->getText().c_str()] = el->getAttribute(_("count")).c_str();
+  }
+  std::map<std::string, std::string> expected { { "audio/mpeg", "2" }, { "video/x-matroska", "1" } };
+  EXPECT_EQ(mimeTypes, expected);
+}
+
+#endif // HAVE_SQLITE3
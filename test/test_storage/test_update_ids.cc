@@ -0,0 +1,78 @@
+/*GRB*
+  Gerbera - https://gerbera.io/
+
+  test_update_ids.cc - this file is part of Gerbera.
+
+  Copyright (C) 2016-2018 Gerbera Contributors
+
+  Gerbera is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  Gerbera is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gerbera.  If not, see <http://www.gnu.org/licenses/>.
+
+  $Id$
+*/
+#ifdef HAVE_SQLITE3
+
+#include <memory>
+#include <unordered_set>
+
+#include "storage_test_fixture.h"
+
+using namespace zmm;
+
+class UpdateIDsTest : public StorageTestFixture {
+ public:
+  int storedUpdateID(int id) {
+    return selectInt("SELECT update_id FROM mt_cds_object WHERE id = " + std::to_string(id));
+  }
+
+  void increment(int id) {
+    auto ids = std::make_shared<std::unordered_set<int>>();
+    ids->insert(id);
+    storage->incrementUpdateIDs(ids);
+  }
+};
+
+TEST_F(UpdateIDsTest, FlushesIncrementedIDs) {
+  int parentID = addItem("/music/a.mp3", "a")->getParentID();
+  int before = storedUpdateID(parentID);
+
+  increment(parentID);
+  increment(parentID);
+  // write-behind, nothing is stored yet
+  EXPECT_EQ(storedUpdateID(parentID), before);
+
+  storage->flushUpdateIDs();
+  EXPECT_EQ(storedUpdateID(parentID), before + 2);
+}
+
+TEST_F(UpdateIDsTest, KeepsIDsOfAFailedFlushForTheNextOne) {
+  int firstID = addItem("/music/a/a.mp3", "a")->getParentID();
+  int secondID = addItem("/music/b/b.mp3", "b")->getParentID();
+  int firstBefore = storedUpdateID(firstID);
+  int secondBefore = storedUpdateID(secondID);
+
+  execSQL("CREATE TRIGGER fail_update BEFORE UPDATE OF update_id ON mt_cds_object "
+          "BEGIN SELECT RAISE(ABORT, 'update ids are read only'); END");
+  increment(firstID);
+  increment(secondID);
+  EXPECT_THROW(storage->flushUpdateIDs(), Exception);
+  EXPECT_EQ(storedUpdateID(firstID), firstBefore);
+
+  // incremented again while the database was failing
+  increment(firstID);
+  execSQL("DROP TRIGGER fail_update");
+  storage->flushUpdateIDs();
+  EXPECT_EQ(storedUpdateID(firstID), firstBefore + 2);
+  EXPECT_EQ(storedUpdateID(secondID), secondBefore + 1);
+}
+
+#endif // HAVE_SQLITE3
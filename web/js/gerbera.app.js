@@ -123,6 +123,7 @@ GERBERA.App = (function () {
       GERBERA.Trail.initialize()
       GERBERA.Autoscan.initialize()
       GERBERA.Updates.initialize()
+      GERBERA.Updates.watch()
     } else {
       $('.login-field').show()
       $('#login-form').submit(function (event) {
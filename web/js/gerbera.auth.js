@@ -127,6 +127,7 @@ GERBERA.Auth = (function () {
       GERBERA.Menu.initialize()
       GERBERA.Autoscan.initialize()
       GERBERA.Updates.initialize()
+      GERBERA.Updates.watch()
     }
   }
 
@@ -28,8 +28,9 @@ if (typeof (GERBERA) === 'undefined') {
 GERBERA.Updates = (function () {
   'use strict'
 
-  var POLLING_INTERVAL
   var UI_TIMEOUT
+  var WATCHING = false
+  var EVENTS_TIMEOUT = 25
 
   var initialize = function () {
     $('#toast').toast()
@@ -39,6 +40,46 @@ GERBERA.Updates = (function () {
     return $.Deferred().resolve().promise()
   }
 
+  // the server answers when containers or the current task changed,
+  // so an idle UI only keeps one request open instead of polling. Is
+  // started once the user is logged in.
+  var watch = function () {
+    if (WATCHING || !GERBERA.Auth.isLoggedIn()) {
+      return $.Deferred().resolve().promise()
+    }
+    WATCHING = true
+    return $.ajax({
+      url: GERBERA.App.clientConfig.api,
+      type: 'get',
+      data: {
+        req_type: 'events',
+        sid: GERBERA.Auth.getSessionId(),
+        timeout: EVENTS_TIMEOUT
+      }
+    })
+      .done(function (response) {
+        WATCHING = false
+        if (response.success) {
+          if (response.task && response.task.id !== -1) {
+            showTask(response.task.text, undefined, 'info', 'fa-refresh fa-spin fa-fw')
+          }
+          if (GERBERA.App.getType() === 'db') {
+            GERBERA.Updates.updateTreeByIds(response)
+          }
+          if (response.retry) {
+            // the server has enough waiting requests already
+            window.setTimeout(GERBERA.Updates.watch, response.retry * 1000)
+          } else {
+            GERBERA.Updates.watch()
+          }
+        }
+      })
+      .fail(function () {
+        WATCHING = false
+        window.setTimeout(GERBERA.Updates.watch, GERBERA.App.serverConfig['poll-interval'])
+      })
+  }
+
   var errorCheck = function (event, xhr) {
     var response = xhr.responseJSON
     if (response && !response.success) {
@@ -91,7 +132,6 @@ GERBERA.Updates = (function () {
         type: 'get',
         data: requestData
       })
-        .then(GERBERA.Updates.updateTask)
         .done(GERBERA.Updates.updateUi)
         .fail(GERBERA.Updates.clearAll)
     } else {
@@ -99,27 +139,6 @@ GERBERA.Updates = (function () {
     }
   }
 
-  var updateTask = function (response) {
-    var promise
-    if (response.success) {
-      if (response.task) {
-        var taskId = response.task.id
-        if (taskId === -1) {
-          promise = GERBERA.Updates.clearTaskInterval(response)
-        } else {
-          showTask(response.task.text, undefined, 'info', 'fa-refresh fa-spin fa-fw')
-          GERBERA.Updates.addTaskInterval()
-          promise = $.Deferred().resolve(response).promise()
-        }
-      } else {
-        promise = GERBERA.Updates.clearTaskInterval(response)
-      }
-    } else {
-      promise = $.Deferred().resolve(response).promise()
-    }
-    return promise
-  }
-
   var updateUi = function (response) {
     if (response.success) {
       updateTreeByIds(response)
@@ -128,14 +147,6 @@ GERBERA.Updates = (function () {
     return $.Deferred().resolve(response).promise()
   }
 
-  var clearTaskInterval = function (response) {
-    if (GERBERA.Updates.isPolling()) {
-      window.clearInterval(POLLING_INTERVAL)
-      POLLING_INTERVAL = false
-    }
-    return $.Deferred().resolve(response).promise()
-  }
-
   var clearUiTimer = function (response) {
     if (GERBERA.Updates.isTimer()) {
       window.clearTimeout(UI_TIMEOUT)
@@ -146,7 +157,6 @@ GERBERA.Updates = (function () {
 
   var clearAll = function (response) {
     GERBERA.Updates.clearUiTimer(response)
-    GERBERA.Updates.clearTaskInterval(response)
   }
 
   var addUiTimer = function (interval) {
@@ -158,22 +168,10 @@ GERBERA.Updates = (function () {
     }
   }
 
-  var addTaskInterval = function () {
-    if (!GERBERA.Updates.isPolling()) {
-      POLLING_INTERVAL = window.setInterval(function () {
-        GERBERA.Updates.getUpdates(false)
-      }, GERBERA.App.serverConfig['poll-interval'])
-    }
-  }
-
   var isTimer = function () {
     return UI_TIMEOUT
   }
 
-  var isPolling = function () {
-    return POLLING_INTERVAL
-  }
-
   var updateTreeByIds = function (response) {
     if (response && response.success) {
       if (response.update_ids) {
@@ -211,14 +209,11 @@ GERBERA.Updates = (function () {
     initialize: initialize,
     showMessage: showMessage,
     getUpdates: getUpdates,
-    updateTask: updateTask,
+    watch: watch,
     updateUi: updateUi,
-    clearTaskInterval: clearTaskInterval,
     clearUiTimer: clearUiTimer,
     clearAll: clearAll,
     addUiTimer: addUiTimer,
-    addTaskInterval: addTaskInterval,
-    isPolling: isPolling,
     isTimer: isTimer,
     updateTreeByIds: updateTreeByIds,
     errorCheck: errorCheck